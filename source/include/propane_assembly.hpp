@@ -5,19 +5,112 @@
 
 namespace propane
 {
+    // Link cache retains the resolved bytecode of methods between links.
+    // Methods of which the definition and every referenced type, signature,
+    // method and global is unchanged since the previous link reuse their
+    // resolved bytecode instead of being linked again.
+    // The cache only retains the methods of the most recent link, and
+    // cannot be used by multiple links at the same time.
+    class link_cache : public handle<class link_cache_data, sizeof(size_t) * 16>
+    {
+    public:
+        link_cache();
+        ~link_cache();
+
+        void clear();
+
+        // Amount of methods reused from and relinked during the most recent link
+        size_t reused_count() const noexcept;
+        size_t relinked_count() const noexcept;
+
+    private:
+        friend class assembly;
+    };
+
+    // Execution counts collected from previous runs, for profile guided linking and translation.
+    // Counts are keyed by method name and bytecode offset, and every method is stored along with a
+    // fingerprint of its bytecode layout. The counts of a method apply to any later link in which the
+    // method resolves to the same layout, regardless of changes to other methods or indices.
+    // Profiles should be collected from assemblies that were linked without a profile, since methods
+    // that are laid out by a profile no longer match the fingerprint of the original bytecode.
+    class link_profile : public handle<class link_profile_data, sizeof(size_t) * 8>
+    {
+    public:
+        link_profile();
+        ~link_profile();
+
+        // Add the execution profile of a run of the provided assembly
+        // (see runtime_parameters::profile). Counts of methods that are
+        // already in the profile with a different fingerprint are replaced.
+        void append(const class assembly& profiled_assembly, const runtime_profile& profile);
+        void clear();
+
+        bool empty() const noexcept;
+        // Amount of methods with execution counts
+        size_t method_count() const noexcept;
+
+        // Profiles are stored as text, one line per method followed by its instruction counts:
+        //   method <fingerprint> <calls> <name>
+        //   <offset> <count>
+        // Loading replaces the current content, and fails on malformed files.
+        bool load(const char* file_path);
+        bool save(const char* file_path) const;
+
+    private:
+        friend class assembly;
+        friend class translator_c;
+    };
+
+    // Bytecode sizes of the most recent link (see link_parameters::statistics)
+    struct link_statistics
+    {
+        // Size of all method bytecode in the standard encoding
+        size_t standard_bytecode_size = 0;
+        // Size of all method bytecode in the encoding of the assembly
+        size_t bytecode_size = 0;
+    };
+
+    struct link_parameters
+    {
+        // Methods are linked on multiple threads for large assemblies
+        // (a thread count of zero uses the hardware concurrency)
+        size_t thread_count = 0;
+        // Optimize the linked bytecode (constant folding and propagation,
+        // copy propagation, dead code and unreachable label elimination)
+        bool optimize = false;
+        // Inline calls to methods of up to this amount of bytes of bytecode (when optimizing).
+        // Inlined calls are inlined as well, up to the depth limit. Set either to zero to disable inlining.
+        size_t inline_size_limit = 64;
+        size_t inline_depth_limit = 2;
+        // Resolve the symbols of external calls while linking, which reports missing symbols as link errors.
+        // Disable when linking without the dynamic libraries present (e.g. for translation only).
+        bool resolve_symbols = true;
+        // Execution profile of a previous run. Hot paths are laid out to fall through and
+        // methods are ordered from hot to cold (see assembly_data::method_order).
+        const link_profile* profile = nullptr;
+        // Encode method bytecode with variable-length addresses and constants
+        // (see bytecode_encoding::compact). Compact assemblies are smaller but
+        // decode slightly slower in the raw interpreter. Profiles collected from
+        // compact assemblies do not match the standard layout of relinked methods.
+        bool compact_bytecode = false;
+        // Receives the bytecode sizes of the link, if provided
+        link_statistics* statistics = nullptr;
+    };
+
     class assembly
     {
     public:
         assembly() = default;
-        explicit assembly(const class intermediate&, const class runtime&);
-        explicit assembly(const class intermediate&);
-        ~assembly() = default;
+        explicit assembly(const class intermediate&, const class runtime&, link_parameters parameters = link_parameters());
+        explicit assembly(const class intermediate&, const class runtime&, link_cache& cache, link_parameters parameters = link_parameters());
+        explicit assembly(const class intermediate&, link_parameters parameters = link_parameters());
+        ~assembly();
 
-        assembly(const assembly&) = default;
-        assembly& operator=(const assembly&) = default;
+        assembly(const assembly&);
+        assembly& operator=(const assembly&);
 
-        assembly(assembly&&) noexcept = default;
-        assembly& operator=(assembly&&) noexcept = default;
+        assembly(assembly&&) noexcept;
+        assembly& operator=(assembly&&) noexcept;
 
         bool is_valid() const noexcept;
         operator bool() const noexcept;
@@ -36,11 +129,23 @@ namespace propane
         span<const uint8_t> data() const noexcept;
 
         // Load assembly from binary
+        // (copies the binary into read-only memory pages, returns false if the binary
+        // is invalid or the pages could not be allocated, the assembly is left unchanged)
         bool load(span<const uint8_t> from_bytes);
+        // Load assembly by mapping a file into memory
+        // (the binary is used in-place without copying)
+        bool load_mapped(const char* file_path);
 
     private:
         friend class asm_assembly_data;
-        block<uint8_t> content;
+
+        void release() noexcept;
+
+        // Assembly content lives in read-only host memory pages, which are
+        // either a protected copy or a read-only file mapping
+        span<const uint8_t> content;
+        size_t pages_size = 0;
+        bool mapped = false;
     };
 }
 
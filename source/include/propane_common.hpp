@@ -105,8 +105,9 @@ namespace propane
 
     // Specializing this template allows for binding native structs to the runtime,
     // so they can be used as parameters in native library calls.
-    // Since the runtime has no notion of padding, extra caution needs to be taken to ensure
-    // the structs are properly packed have the same layout in both runtime and native environments.
+    // The runtime lays out struct fields at their natural alignment (the same way native compilers do),
+    // so structs have the same layout in both runtime and native environments. Native structs that
+    // use custom packing or alignment are not supported.
     template<typename value_t> inline constexpr native_type_info native_type_info_v = make_type<value_t>(std::string_view());
     template<> inline constexpr native_type_info native_type_info_v<int8_t> = make_type<int8_t>("byte");
     template<> inline constexpr native_type_info native_type_info_v<uint8_t> = make_type<uint8_t>("ubyte");
@@ -340,6 +341,7 @@ namespace propane
         none = 0,
         is_union = 1 << 0,
         is_external = 1 << 1,
+        is_packed = 1 << 2,
 
         is_pointer_type = 1 << 8,
         is_array_type = 1 << 9,
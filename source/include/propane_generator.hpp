@@ -71,6 +71,15 @@ namespace propane
         }
     };
 
+    // Sparse switch case
+    // Values are converted to the type of the switch operand,
+    // unsigned 64-bit values above the signed range are provided as their two's complement.
+    struct switch_case
+    {
+        int64_t value;
+        label_idx label;
+    };
+
     struct invalid_address : public constant
     {
     public:
@@ -181,6 +190,32 @@ namespace propane
         }
     };
 
+    // Identifier table that can be shared by generators on multiple threads
+    // Intermediates of generators that use the same interner store the interned index of
+    // every name, which the merger uses to translate names without looking up the strings.
+    // The interner has to outlive the generators that use it.
+    class identifier_interner final : public handle<class identifier_interner_data, sizeof(size_t) * 40>
+    {
+    public:
+        identifier_interner();
+        ~identifier_interner();
+
+        identifier_interner(const identifier_interner&) = delete;
+        identifier_interner& operator=(const identifier_interner&) = delete;
+
+        // Returns the same index for the same identifier (thread-safe)
+        name_idx intern(std::string_view identifier);
+        // Name of an interned identifier (thread-safe)
+        std::string_view name(name_idx index) const;
+        // Number of interned identifiers
+        size_t size() const noexcept;
+
+    private:
+        friend class generator;
+
+        uint64_t identity() const noexcept;
+    };
+
     // Experimental Propane bytecode generator
     // Inherit from this to implement a parser
     class generator : public handle<class generator_impl, sizeof(size_t) * 128>
@@ -189,6 +224,8 @@ namespace propane
         generator();
         // String name of the file (will be included in type/method metadata)
         generator(std::string_view name);
+        // Generator that takes its name indices from a shared interner
+        generator(std::string_view name, identifier_interner& interner);
         ~generator();
 
         generator(const generator&) = delete;
@@ -209,6 +246,10 @@ namespace propane
 
             span<const field> fields() const;
 
+            // Packed types have no padding between fields (alignment of 1)
+            void set_packed();
+            bool is_packed() const;
+
             // Finalize
             void finalize();
 
@@ -223,6 +264,8 @@ namespace propane
             file_meta get_meta() const;
         };
 
+        class instruction_block;
+
         class method_writer final : public handle<class method_writer_impl, sizeof(size_t) * 128>
         {
         public:
@@ -232,6 +275,10 @@ namespace propane
             name_idx name() const;
             method_idx index() const;
 
+            // Allocate the bytecode and labels of the method up front
+            // (writers are reused between methods, so this only has effect when exceeding previous methods)
+            void reserve(size_t bytecode_size, size_t label_count = 0);
+
             // Variable stack
             void push(span<const type_idx> types);
             inline void push(std::initializer_list<type_idx> types)
@@ -299,6 +346,11 @@ namespace propane
             {
                 write_sw(addr, init_span(switch_labels));
             }
+            void write_sws(address addr, span<const switch_case> switch_cases);
+            inline void write_sws(address addr, std::initializer_list<switch_case> switch_cases)
+            {
+                write_sws(addr, init_span(switch_cases));
+            }
 
             void write_call(method_idx method, span<const address> args = span<const address>());
             inline void write_call(method_idx method, std::initializer_list<address> args)
@@ -315,6 +367,35 @@ namespace propane
 
             void write_dump(address addr);
 
+            // Vector instructions (operands must be vector types, see LANGUAGE.md)
+            void write_vadd(address lhs, address rhs);
+            void write_vsub(address lhs, address rhs);
+            void write_vmul(address lhs, address rhs);
+            void write_vdiv(address lhs, address rhs);
+            void write_vmin(address lhs, address rhs);
+            void write_vmax(address lhs, address rhs);
+            void write_vceq(address lhs, address rhs);
+            void write_vcne(address lhs, address rhs);
+            void write_vcgt(address lhs, address rhs);
+            void write_vcge(address lhs, address rhs);
+            void write_vclt(address lhs, address rhs);
+            void write_vcle(address lhs, address rhs);
+            void write_vshf(address lhs, address rhs);
+
+            // Bulk memory instructions (length is in elements of the destination pointer type, see LANGUAGE.md)
+            void write_mcpy(address dst, address src, address length);
+            void write_mset(address dst, address value, address length);
+            void write_mcmp(address lhs, address rhs, address length);
+
+            // Instruction blocks
+            // Instructions written between begin_block and end_block are encoded once into a block, which can be
+            // appended to any method using a single copy. Block operands can only be stack variables, parameters
+            // and constants (globals and fields are indexed per method), and blocks can not contain branches,
+            // switches, calls or returns.
+            void begin_block();
+            instruction_block end_block();
+            void write_block(const instruction_block& block);
+
             // Finalize
             void finalize();
 
@@ -329,6 +410,31 @@ namespace propane
             file_meta get_meta() const;
         };
 
+        // Pre-encoded instructions (see method_writer::begin_block)
+        class instruction_block final
+        {
+        public:
+            instruction_block() = default;
+
+            // Size of the encoded instructions in bytes
+            inline size_t size() const noexcept
+            {
+                return bytecode.size();
+            }
+            inline bool empty() const noexcept
+            {
+                return bytecode.empty();
+            }
+
+        private:
+            friend class method_writer;
+
+            block<uint8_t> bytecode;
+            // Amount of stack variables and parameters the instructions require
+            size_t stack_count = 0;
+            size_t parameter_count = 0;
+        };
+
         // Declare a unique identifier. If 'name' has already been used,
         // this method will return the same index
         name_idx make_identifier(std::string_view name);
@@ -4,6 +4,8 @@
 #include "propane_common.hpp"
 #include "propane_block.hpp"
 
+#include <memory>
+
 namespace propane
 {
     class intermediate
@@ -12,11 +14,12 @@ namespace propane
         intermediate() = default;
         ~intermediate() = default;
 
+        // Intermediate content is immutable, copies share the same storage
         intermediate(const intermediate&) = default;
         intermediate& operator=(const intermediate&) = default;
 
-        intermediate(intermediate&&) noexcept = default;
-        intermediate& operator=(intermediate&&) noexcept = default;
+        intermediate(intermediate&&) noexcept;
+        intermediate& operator=(intermediate&&) noexcept;
 
         bool is_valid() const noexcept;
         operator bool() const noexcept;
@@ -26,14 +29,90 @@ namespace propane
 
         span<const uint8_t> data() const noexcept;
         bool load(span<const uint8_t> from_bytes);
+        // Load intermediate by mapping a file into memory
+        // (the binary is used in-place without copying)
+        bool load_mapped(const char* file_path);
+
+        // Find a type or method definition by name, using the name index of the intermediate.
+        // Queries run in place, without deserializing the intermediate.
+        // Returns invalid if the name is not defined by this intermediate.
+        type_idx find_type(std::string_view name) const noexcept;
+        method_idx find_method(std::string_view name) const noexcept;
 
         intermediate operator+(const intermediate&) const;
         intermediate& operator+=(const intermediate&);
+        intermediate& operator+=(intermediate&&);
+        friend intermediate operator+(intermediate&&, intermediate&&);
 
     private:
         friend class gen_intermediate_data;
-        block<uint8_t> content;
+
+        // Content is either an owned copy or a read-only file mapping
+        std::shared_ptr<const void> storage;
+        span<const uint8_t> content;
     };
+
+    // Accumulates intermediates into one, keeping the merged result deserialized in between.
+    // The lookup tables of the result are restored once, every appended intermediate is only
+    // deserialized and translated once, and the result is only serialized when finalized.
+    // This makes repeated accumulation proportional to the size of the appended intermediates,
+    // instead of the size of everything merged so far.
+    class intermediate_builder : public handle<class intermediate_builder_data, sizeof(size_t) * 8>
+    {
+    public:
+        intermediate_builder();
+        ~intermediate_builder();
+
+        intermediate_builder& operator+=(const intermediate&);
+        void append(const intermediate&);
+
+        // Amount of (non-empty) intermediates appended since the last finalize
+        size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        // Serialize the merged intermediates, this resets the builder
+        intermediate finalize();
+    };
+
+    // On-disk cache of intermediates, stored under a hash of the input they were generated from.
+    // Keys include the toolchain version, so entries made by a different toolchain are never returned.
+    // Entries are written to a temporary file that is renamed into place afterwards,
+    // which allows concurrent builds to share the same cache directory.
+    class intermediate_cache
+    {
+    public:
+        // The directory is created if it does not exist yet
+        explicit intermediate_cache(std::string_view directory_path);
+
+        // Make a key out of the input of an intermediate.
+        // Keys can be chained by passing the previous key as seed, for inputs that consist of multiple parts.
+        static uint64_t make_key(span<const uint8_t> input, uint64_t seed = 0) noexcept;
+        static uint64_t make_key(std::string_view input, uint64_t seed = 0) noexcept;
+
+        // Load the intermediate stored under the key by mapping it into memory
+        // (returns an invalid intermediate if the cache does not contain the key)
+        intermediate find(uint64_t key) const;
+        // Store an intermediate under the key (returns false if the entry could not be written)
+        bool store(uint64_t key, const intermediate& im) const;
+
+        inline const std::string& directory() const noexcept
+        {
+            return directory_path;
+        }
+
+    private:
+        std::string make_path(uint64_t key) const;
+
+        std::string directory_path;
+    };
+
+    // Merges all provided intermediates into one. The intermediates are divided
+    // over the specified amount of threads (zero uses the hardware concurrency),
+    // which each merge their range in a single pass. The results are then merged
+    // in a balanced reduction tree. Intermediate data is only deserialized and
+    // serialized once. If the merge fails, it is redone serially to report the
+    // same error as merging the intermediates one by one.
+    intermediate merge_all(span<const intermediate> intermediates, size_t thread_count = 0);
 }
 
 #endif
\ No newline at end of file
@@ -3,7 +3,8 @@
 
 #include "propane_runtime.hpp"
 
-#include <tuple>
+#include <cstring>
+#include <utility>
 
 #define BIND_NATIVE_FIELD(type, name) propane::make_field<uint8_t>(#name, offsetof(type, name))
 #define BIND_NATIVE_TYPE(type, name, fields) template<> constexpr propane::native_type_info propane::native_type_info_v<type> = propane::make_type<type>(name, fields)
@@ -48,6 +49,23 @@ namespace propane
 
         template <typename value_t> using decay_base_t = typename decay_base<value_t, std::is_pointer_v<value_t>>::type;
 
+        // Parameter offsets of a bound method (a base class, so it is constructed before the binding)
+        template<size_t count> struct parameter_offsets
+        {
+            // Array size cannot be 0
+            size_t offsets[count == 0 ? 1 : count] = {};
+        };
+
+        // Type declaration of a native type (base type and pointer depth)
+        template<typename value_t> constexpr typedecl make_typedecl() noexcept
+        {
+            typedef decay_base_t<value_t> value_type;
+            typedef typename derive_pointer_info<value_type>::base_type value_base_type;
+            constexpr native_type_info type_info = native_type_info_v<value_base_type>;
+            static_assert(!type_info.name.empty(), "Undefined type");
+            return typedecl(type_info, derive_pointer_depth_v<value_type>);
+        }
+
         // Recursive method signature
         template<typename... param_t> class method_signature_param;
         template<> class method_signature_param<>
@@ -56,10 +74,6 @@ namespace propane
             static inline void generate_signature(parameter* result, size_t& offset) noexcept
             {
 
-            }
-            template<size_t idx, typename... tuple_args> static inline void read_argument(std::tuple<tuple_args...>& tup, const void*& data) noexcept
-            {
-
             }
         };
         template<typename value_t, typename... param_t> class method_signature_param<value_t, param_t...> : public method_signature_param<param_t...>
@@ -76,49 +90,41 @@ namespace propane
                 offset += pointer_depth == 0 ? type_info.size : sizeof(void*);
                 method_signature_param<param_t...>::generate_signature(result, offset);
             }
-            template<size_t idx, typename... tuple_args> static inline void read_argument(std::tuple<tuple_args...>& tup, const void*& data) noexcept
-            {
-                std::get<idx>(tup) = *reinterpret_cast<const value_t*&>(data)++;
-                method_signature_param<param_t...>::template read_argument<idx + 1>(tup, data);
-            }
         };
 
-        // Tuple expansion into static fuction
-        template <typename function, typename tuple_type, size_t... indices> static inline auto expand_sequence(function func, const tuple_type& tup, std::index_sequence<indices...>)
+        // Parameter byte offset (parameters are tightly packed, see generate_signature)
+        template<typename... param_t> constexpr size_t parameter_offset(size_t idx) noexcept
         {
-            return func(std::get<indices>(tup)...);
-        }
-        template <typename function, typename tuple_type> static inline auto expand(function func, const tuple_type& tup)
-        {
-            return expand_sequence(func, tup, std::make_index_sequence<std::tuple_size_v<tuple_type>>{});
+            constexpr size_t sizes[] = { sizeof(param_t)..., 0 };
+            size_t offset = 0;
+            for (size_t i = 0; i < idx; i++) offset += sizes[i];
+            return offset;
         }
 
+        // Call thunk
+        // Arguments are read straight from the parameter buffer at their compile-time offsets,
+        // and the return value is written in place.
         template<typename retval_t, typename... param_t> class method_invoke
         {
             typedef retval_t(*invoke_method_handle)(param_t...);
 
-        public:
-            static inline void invoke(void* ret_val, const void* param, invoke_method_handle call)
+            template<size_t... indices> static inline retval_t invoke_sequence([[maybe_unused]] const uint8_t* param, invoke_method_handle call, std::index_sequence<indices...>)
             {
-                std::tuple<std::decay_t<param_t>...> tup;
-
-                method_signature_param<param_t...>::template read_argument<0>(tup, param);
-
-                *reinterpret_cast<retval_t*>(ret_val) = expand(call, tup);
+                return call(*reinterpret_cast<const std::decay_t<param_t>*>(param + std::integral_constant<size_t, parameter_offset<param_t...>(indices)>::value)...);
             }
-        };
-        template<typename... param_t> class method_invoke<void, param_t...>
-        {
-            typedef void(*invoke_method_handle)(param_t...);
 
         public:
             static inline void invoke(void* ret_val, const void* param, invoke_method_handle call)
             {
-                std::tuple<std::decay_t<param_t>...> tup;
-
-                method_signature_param<param_t...>::template read_argument<0>(tup, param);
-
-                expand(call, tup);
+                const uint8_t* const param_bytes = static_cast<const uint8_t*>(param);
+                if constexpr (std::is_void_v<retval_t>)
+                {
+                    invoke_sequence(param_bytes, call, std::index_sequence_for<param_t...>{});
+                }
+                else
+                {
+                    *reinterpret_cast<retval_t*>(ret_val) = invoke_sequence(param_bytes, call, std::index_sequence_for<param_t...>{});
+                }
             }
         };
     }
@@ -161,14 +167,8 @@ namespace propane
 
             static const bind instance;
 
-            typedef native::decay_base_t<retval_t> return_type;
-            typedef derive_pointer_info<return_type>::base_type retval_base_type;
-            constexpr native_type_info type_info = native_type_info_v<retval_base_type>;
-            static_assert(!type_info.name.empty(), "Undefined type");
-            constexpr size_t pointer_depth = derive_pointer_depth_v<return_type>;
-
             call.forward = bind::forward_call;
-            call.return_type = native::typedecl(type_info, pointer_depth);
+            call.return_type = native::make_typedecl<retval_t>();
             call.parameters = span<const native::parameter>(instance.parameters, sizeof...(param_t));
             call.parameters_size = instance.parameters_size;
             call.handle = reinterpret_cast<method_handle>(method);
@@ -192,10 +192,89 @@ namespace propane
         }
     };
 
+    // Method of an assembly bound to a native signature (see bound_method below)
+    class method_binding
+    {
+    public:
+        inline method_idx index() const noexcept
+        {
+            return method;
+        }
+        inline explicit operator bool() const noexcept
+        {
+            return method != method_idx::invalid;
+        }
+
+    protected:
+        method_binding() = default;
+        // Find a method by name and validate its signature against the native signature.
+        // The byte offsets of the parameters in the entry frame are written to offsets.
+        method_binding(const execution_context& context, std::string_view name, const native::typedecl& return_type, span<const native::parameter> parameters, size_t* offsets);
+
+        // Push the entry frame of the method (returns the parameters, to which the arguments are written)
+        uint8_t* begin_invoke(execution_context& context) const;
+        // Execute the method after the arguments have been written (returns the return value)
+        const uint8_t* end_invoke(execution_context& context) const;
+
+    private:
+        method_idx method = method_idx::invalid;
+        size_t return_size = 0;
+    };
+
+    // Handle to a method of an assembly, invoked from native code through a native signature.
+    // The method is looked up by name and its signature is validated once, when binding. Invoking the
+    // handle writes the arguments straight into the entry frame without any further lookup or validation.
+    // Handles can be used with any context of the assembly (or program) they were bound with, but
+    // using them with contexts of other assemblies is not detected.
+    template<typename signature_t> class bound_method;
+    template<typename retval_t, typename... param_t> class bound_method<retval_t(param_t...)> : private native::parameter_offsets<sizeof...(param_t)>, public method_binding
+    {
+        struct bind
+        {
+            bind()
+            {
+                size_t parameters_size = 0;
+                native::method_signature_param<param_t...>::generate_signature(parameters, parameters_size);
+            }
+
+            // Array size cannot be 0
+            native::parameter parameters[sizeof...(param_t) == 0 ? 1 : sizeof...(param_t)];
+        };
+
+        template<size_t... indices> inline void write_arguments([[maybe_unused]] uint8_t* param, std::index_sequence<indices...>, const std::decay_t<param_t>&... arg) const
+        {
+            (std::memcpy(param + this->offsets[indices], &arg, sizeof(arg)), ...);
+        }
+
+    public:
+        bound_method() = default;
+        bound_method(const execution_context& context, std::string_view name) :
+            method_binding(context, name, native::make_typedecl<retval_t>(), span<const native::parameter>(instance().parameters, sizeof...(param_t)), this->offsets) {}
+
+        retval_t operator()(execution_context& context, param_t... arg) const
+        {
+            write_arguments(begin_invoke(context), std::index_sequence_for<param_t...>{}, arg...);
+            const uint8_t* const return_value = end_invoke(context);
+            if constexpr (!std::is_void_v<retval_t>)
+            {
+                std::decay_t<retval_t> result;
+                std::memcpy(&result, return_value, sizeof(result));
+                return result;
+            }
+        }
+
+    private:
+        static const bind& instance()
+        {
+            static const bind result;
+            return result;
+        }
+    };
+
     // Library object that contains external method definitions. If the list of external calls
-    // contains any null handles during execution, the library will attempt to load a
-    // dynamic library file at specified path.
-    // Symbols are loaded lazily at runtime unless specified otherwise.
+    // contains any null handles, the runtime will attempt to load a dynamic library file at specified path.
+    // Symbols are resolved once per runtime when an assembly is first linked or executed,
+    // unless preloading is specified, in which case they are resolved when the runtime is constructed.
     class library : public handle<class library_data, sizeof(size_t) * 16>
     {
     public:
@@ -3,8 +3,12 @@
 
 #include "propane_intermediate.hpp"
 
+#include <vector>
+
 namespace propane
 {
+    class identifier_interner;
+
     template<uint32_t language> class parser
     {
     public:
@@ -16,6 +20,15 @@ namespace propane
     {
     public:
         static intermediate parse(const char* file_path);
+        // Parse through an intermediate cache, files are only parsed if the cache
+        // does not contain an intermediate for the file name and contents
+        static intermediate parse(const char* file_path, const intermediate_cache& cache);
+        // Parse with name indices taken from a shared interner (see identifier_interner)
+        static intermediate parse(const char* file_path, identifier_interner& interner);
+        // Parse multiple files in parallel into separate intermediates (see merge_all)
+        // Thread count of zero uses the hardware concurrency
+        static std::vector<intermediate> parse_all(span<const char* const> file_paths, size_t thread_count = 0);
+        static std::vector<intermediate> parse_all(span<const char* const> file_paths, identifier_interner& interner, size_t thread_count = 0);
     };
 
     template<> class parser<language_propane> : public parser_propane {};
@@ -4,6 +4,9 @@
 #include "propane_common.hpp"
 #include "propane_block.hpp"
 
+#include <chrono>
+#include <memory>
+
 namespace propane
 {
     // Field
@@ -129,8 +132,10 @@ namespace propane
         generated_type generated;
         // List of fields
         static_block<field> fields;
-        // Total type size (in bytes)
+        // Total type size (in bytes, including padding)
         aligned_size_t total_size;
+        // Type alignment (in bytes, 1 for packed types)
+        aligned_size_t alignment;
         // Index to the pointer type that uses this type as underlying
         // This is optional, some types might not have need for a pointer type
         type_idx pointer_type;
@@ -180,6 +185,10 @@ namespace propane
         {
             return flags & type_flags::is_union;
         }
+        inline bool is_packed() const noexcept
+        {
+            return flags & type_flags::is_packed;
+        }
     };
 
     // Method signature
@@ -292,6 +301,15 @@ namespace propane
         }
     };
 
+    // Bytecode encoding of the methods in an assembly
+    enum class bytecode_encoding : uint32_t
+    {
+        // Fixed size addresses and constants at full type width
+        standard = 0,
+        // Variable-length addresses and constants (see link_parameters::compact_bytecode)
+        compact,
+    };
+
     // Actual assembly data
     // Contains all types, methods, signatures and offsets required to
     // A) Generate a program in any programming language or assembler
@@ -325,6 +343,11 @@ namespace propane
         method_idx main;
         // Runtime hash for validation checking
         aligned_size_t runtime_hash;
+        // Encoding of the method bytecode
+        bytecode_encoding encoding;
+        // Methods ordered from hot to cold by the profile the assembly was linked with
+        // (empty if the assembly was linked without a profile)
+        static_block<method_idx> method_order;
 
         // Utility function for generating a full typename.
         // Generated type names don't get exported into the database,
@@ -337,11 +360,195 @@ namespace propane
     // If left unassigned, output is redirected to stdout.
     typedef void(*print_method_handle)(const char*, size_t);
 
+    // Allow custom allocation of the runtime stack and globals.
+    // The size of the allocation is passed to the free method as well.
+    // If left unassigned, memory is allocated using malloc/free.
+    typedef void*(*allocate_method_handle)(size_t);
+    typedef void(*free_method_handle)(void*, size_t);
+
+    // Determines when the output of dump instructions gets passed to the print method.
+    // Batched output contains multiple dumps, separated by newlines.
+    enum class output_flush_policy : uint8_t
+    {
+        // Print every dump separately
+        every_dump,
+        // Print once the buffered output exceeds the output flush threshold
+        threshold,
+        // Print once per invocation (or fiber resume)
+        end_of_invoke,
+    };
+
     struct runtime_parameters
     {
         size_t max_stack_size = 1 << 20;
         size_t min_stack_size = 1 << 15;
         uint32_t max_callstack_depth = 1024;
+        // Detect stack overflows using an inaccessible guard region after the stack, instead of
+        // checking the stack size on every call (requires predecode). The callstack depth is still checked.
+        // The stack is reserved at max_stack_size and only takes up memory once it is used.
+        bool guard_pages = false;
+        print_method_handle print_method = nullptr;
+        // Buffer dump output and print it in batches, see output_flush_policy.
+        // Remaining output is always printed when an invocation returns or throws.
+        output_flush_policy output_flush = output_flush_policy::every_dump;
+        // Amount of buffered bytes after which output is printed (threshold policy only)
+        size_t output_flush_threshold = 1 << 16;
+        // Decode bytecode into a direct-dispatch instruction stream at load time.
+        // Disable to execute the original bytecode (slower, but useful for debugging).
+        bool predecode = true;
+        // Decode methods on their first call instead of decoding the entire assembly at load time
+        // (requires predecode). Methods can be decoded ahead of time using prewarm.
+        bool lazy_decode = true;
+        // Fuse frequent instruction pairs into superinstructions while pre-decoding
+        // (this also forwards external calls without pushing a stack frame).
+        bool superinstructions = true;
+        // Execute calls that are directly followed by a return in the stack frame of the caller
+        // (requires predecode, opt-in). Tail calls do not count towards the callstack depth.
+        // Methods that take the address of a parameter or stack variable never make tail calls.
+        bool tail_calls = false;
+        // Compile frequently called methods to native code (requires predecode).
+        // Methods that can not be compiled keep running in the interpreter.
+        bool jit = false;
+        // Amount of calls after which a method gets compiled
+        uint32_t jit_threshold = 1000;
+        // Amount of hot stack variables that compiled methods keep in registers
+        // instead of the stack frame (at most 5, zero disables register caching)
+        uint32_t jit_register_count = 5;
+        // Count executed instructions and time every call (requires predecode).
+        // Profiling runs on a separate instantiation of the interpreter, which disables jit and guard pages.
+        // Execution without profiling is not affected. See execution_context::profile.
+        bool profile = false;
+        // Sample the callstack at this interval (requires predecode, zero disables sampling).
+        // Samples are taken at branches and calls, execution suspends every few thousand steps
+        // to check the clock. See execution_context::samples.
+        std::chrono::microseconds sample_interval = std::chrono::microseconds::zero();
+        // Record the most recent calls, returns and taken branches in a ring buffer of this many entries
+        // (requires predecode, zero disables tracing). Runtime exceptions raised during execution get the
+        // trace appended to their message. Calls made by compiled (jit) methods are not recorded.
+        // See execution_context::trace.
+        size_t trace_size = 0;
+        // Allocate the stack (unless guarded) and the globals of interpreters through these methods
+        // (either both or neither need to be assigned). Globals that are mapped copy-on-write, and
+        // tables like the decoded methods and output buffer use the default allocator.
+        allocate_method_handle allocate_method = nullptr;
+        free_method_handle free_method = nullptr;
+    };
+
+    // Execution statistics.
+    // Counters are collected per execution context (only when running pre-decoded bytecode).
+    struct runtime_statistics
+    {
+        // Virtual calls that were resolved by the inline cache of the call site
+        uint64_t inline_cache_hits = 0;
+        // Virtual calls that required a full method handle lookup
+        uint64_t inline_cache_misses = 0;
+    };
+
+    // Memory usage in bytes (see runtime::memory_usage and execution_context::memory_usage).
+    // Contexts of a shared program include the memory they share with the program.
+    struct memory_statistics
+    {
+        // Memory reserved for the runtime stack (guarded stacks only take up the pages that were touched)
+        size_t stack_reserved = 0;
+        // Largest stack size reached since creation (or the last reset), which bounds the touched stack memory
+        size_t stack_high_water = 0;
+        // Assembly binary (read-only pages, or the mapped file)
+        size_t assembly_bytes = 0;
+        // Globals (copy-on-write globals only take up the pages that were written to) and their initial values
+        size_t global_bytes = 0;
+        size_t initial_global_bytes = 0;
+        // Pre-decoded methods and inline caches
+        size_t decoded_bytes = 0;
+        // Capacity of the output buffer
+        size_t output_buffer_bytes = 0;
+        // Library and external call tables of the runtime
+        size_t library_bytes = 0;
+    };
+
+    // Execution profile (see runtime_parameters::profile).
+    // Times are measured in timestamp ticks (processor cycles on x86, nanoseconds otherwise).
+    // Names refer to the assembly of the execution context.
+    struct method_profile
+    {
+        method_idx method = method_idx::invalid;
+        std::string_view name;
+        bool external = false;
+        uint64_t calls = 0;
+        // Ticks spent in the method including its callees (recursive calls are counted once)
+        uint64_t inclusive_ticks = 0;
+        // Ticks spent in the method itself
+        uint64_t exclusive_ticks = 0;
+    };
+    struct opcode_profile
+    {
+        // Opcode (or superinstruction) name
+        std::string_view name;
+        uint64_t count = 0;
+    };
+    struct instruction_profile
+    {
+        method_idx method = method_idx::invalid;
+        // Byte offset of the instruction in the method bytecode
+        uint32_t offset = 0;
+        std::string_view name;
+        uint64_t count = 0;
+    };
+    struct runtime_profile
+    {
+        // Ticks spent in all invocations that returned
+        uint64_t total_ticks = 0;
+        // Called methods, sorted by exclusive ticks
+        block<method_profile> methods;
+        // Executed opcodes, sorted by count. Fused instruction pairs are counted as their superinstruction.
+        block<opcode_profile> opcodes;
+        // Executed instructions, in method and bytecode order
+        block<instruction_profile> instructions;
+        // Exclusive ticks per call path in folded stack format (one 'main;caller;callee ticks' line per path),
+        // which can be turned into a flame graph directly
+        std::string folded_stacks;
+    };
+
+    // Sampled execution profile (see runtime_parameters::sample_interval).
+    // Methods are attributed to the source file and line they were declared at.
+    // Names refer to the assembly of the execution context.
+    struct method_samples
+    {
+        method_idx method = method_idx::invalid;
+        std::string_view name;
+        file_meta meta;
+        // Samples taken while the method was executing
+        uint64_t self_samples = 0;
+        // Samples taken while the method was on the callstack (recursive calls are counted once)
+        uint64_t total_samples = 0;
+    };
+    struct instruction_samples
+    {
+        method_idx method = method_idx::invalid;
+        // Byte offset of the instruction in the method bytecode
+        uint32_t offset = 0;
+        uint64_t samples = 0;
+    };
+    struct sample_profile
+    {
+        uint64_t sample_count = 0;
+        // Sampled methods, sorted by self samples
+        block<method_samples> methods;
+        // Sampled instructions (the instruction that was about to execute), sorted by samples
+        block<instruction_samples> instructions;
+        // Samples per callstack in folded stack format (one 'main (file:line);callee (file:line) samples' line per callstack)
+        std::string folded_stacks;
+    };
+
+    struct batch_parameters
+    {
+        // Amount of worker threads (zero uses the hardware concurrency, the calling thread participates)
+        size_t worker_count = 0;
+        // Amount of invocations a worker takes from its queue at once
+        size_t chunk_size = 64;
+        // Restore the globals of the worker before every invocation, so that results
+        // do not depend on how the invocations are distributed over the workers
+        bool reset_globals = true;
+        // Print method of the worker contexts (print method of the program parameters if null)
         print_method_handle print_method = nullptr;
     };
 
@@ -362,6 +569,8 @@ namespace propane
 
     // Runtime object.
     // When executing an assembly, make sure the assembly was linked with the same environment.
+    // Runtimes are immutable after construction, execute can be called from multiple threads at once
+    // (every call sets up its own interpreter, see program below to share the setup between executions).
     class runtime : public handle<class runtime_data, sizeof(size_t) * 32>
     {
     public:
@@ -370,9 +579,221 @@ namespace propane
         ~runtime();
 
         int32_t execute(const class assembly& linked_assembly, runtime_parameters parameters = runtime_parameters()) const;
+        // Invoke a method count times on a pool of worker threads (see batch_executor below).
+        // Arguments and return values are laid out back to back, one per invocation.
+        void execute_batch(const class assembly& linked_assembly, method_idx method, size_t count, span<const uint8_t> arguments, span<uint8_t> return_values,
+            batch_parameters batch = batch_parameters(), runtime_parameters parameters = runtime_parameters()) const;
+
+        // Memory used by the libraries and external call tables (only library_bytes is set)
+        memory_statistics memory_usage() const;
 
     private:
         friend class assembly_linker;
+        friend class execution_context_data;
+        friend class program_data;
+    };
+
+    // Shared program.
+    // Prepares an assembly for execution once (decoded methods and resolved external calls),
+    // after which the program is immutable and can be executed concurrently by any number of
+    // execution contexts. Every thread should use its own context, which owns the stack and globals.
+    // Programs are always pre-decoded, and native code compilation (jit) is not available.
+    // The runtime needs to outlive the program, the assembly is copied.
+    class program : public handle<class program_data, sizeof(size_t) * 256>
+    {
+    public:
+        program(const class assembly& linked_assembly, const runtime& rt, runtime_parameters parameters = runtime_parameters());
+        ~program();
+
+        // Decode methods ahead of their first call (see runtime_parameters::lazy_decode).
+        // Decoding is thread-safe, contexts of the program can be executing while prewarming.
+        void prewarm(span<const method_idx> methods);
+
+        // Assembly data of the program
+        const assembly_data& assembly_ref() const noexcept;
+
+    private:
+        friend class execution_context_data;
+        friend class fiber_data;
+        friend class batch_executor_data;
+    };
+
+    // Program registry.
+    // Holds the current version of a program, which can be replaced without waiting for executions
+    // of previous versions to finish. Publishing prepares the new program up front and then swaps
+    // it in atomically. Executions that start afterwards use the new version, executions that
+    // acquired a previous version keep running on it, and a version is released once the last
+    // reference to it is gone. All versions are executed on the same runtime, so libraries are
+    // loaded and their symbols resolved only once. To decode every method before it is published
+    // (instead of on the first call), disable runtime_parameters::lazy_decode.
+    // Registries are thread-safe, the runtime needs to outlive the registry and all acquired programs.
+    class program_registry : public handle<class program_registry_data, sizeof(size_t) * 48>
+    {
+    public:
+        explicit program_registry(const runtime& rt, runtime_parameters parameters = runtime_parameters());
+        ~program_registry();
+
+        // Prepare a program for the assembly and make it the current version
+        // (returns the version number, the first published version is one)
+        uint64_t publish(const class assembly& linked_assembly);
+
+        // Current version of the program (null if nothing was published yet).
+        // Contexts created from the program need to be destroyed before the reference is released.
+        std::shared_ptr<const program> acquire() const;
+        // Number of the current version (zero if nothing was published yet).
+        // While publishing, the number can be ahead of the program returned by acquire.
+        uint64_t version() const noexcept;
+    };
+
+    // Execution context.
+    // Prepares an assembly for execution once (stack, globals, libraries and decoded methods),
+    // after which methods can be invoked repeatedly without any additional setup.
+    // Globals retain their values between invocations.
+    // Contexts are not thread-safe, create a separate context per thread.
+    // The runtime needs to outlive the context, the assembly is copied.
+    class execution_context : public handle<class execution_context_data, sizeof(size_t) * 256>
+    {
+    public:
+        execution_context(const class assembly& linked_assembly, const runtime& rt, runtime_parameters parameters = runtime_parameters());
+        // Create a context for a shared program, with its own stack and globals.
+        // The program needs to outlive the context. If no print method is provided,
+        // the print method of the program parameters is used.
+        explicit execution_context(const program& shared_program, print_method_handle print_method = nullptr);
+        ~execution_context();
+
+        // Find a method by name (returns method_idx::invalid if not found).
+        // Names are looked up in an index that is built once per assembly (or program).
+        // To invoke a method repeatedly, bind it once instead (see bound_method).
+        method_idx find_method(std::string_view name) const;
+
+        // Invoke the main entrypoint
+        int32_t execute();
+        // Invoke a method.
+        // Arguments are provided as bytes, laid out according to the parameter offsets of the method signature.
+        // The return value (if any) is copied into return_value, which must be big enough to hold the return type.
+        void invoke(method_idx method, span<const uint8_t> arguments = span<const uint8_t>(), span<uint8_t> return_value = span<uint8_t>());
+
+        // Decode methods ahead of their first call (see runtime_parameters::lazy_decode)
+        void prewarm(span<const method_idx> methods);
+
+        // Restore all globals to their initial values
+        void reset_globals();
+        // Restore all globals to the values of a snapshot
+        // (the snapshot needs to be taken from a context of the same assembly, which is checked against the assembly binary)
+        void restore(const class context_snapshot& snapshot);
+
+        // Profiling counters accumulated since creation (or the last reset)
+        runtime_statistics statistics() const;
+        // Execution profile accumulated since creation (or the last reset).
+        // Empty unless the context was created with runtime_parameters::profile.
+        runtime_profile profile() const;
+        // Callstack samples accumulated since creation (or the last reset).
+        // Empty unless the context was created with runtime_parameters::sample_interval.
+        sample_profile samples() const;
+        void reset_statistics();
+        // Most recent calls, returns and taken branches (oldest first, one per line).
+        // Empty unless the context was created with runtime_parameters::trace_size.
+        std::string trace() const;
+        // Memory currently used by the context (the stack high-water mark is reset by reset_statistics)
+        memory_statistics memory_usage() const;
+
+        // Assembly data of the executing assembly
+        const assembly_data& assembly_ref() const noexcept;
+
+    private:
+        friend class context_snapshot_data;
+        friend class method_binding;
+    };
+
+    // Context snapshot.
+    // Captures the globals of an execution context, which is all the state a context retains between
+    // invocations (the stack is reset on every invocation). A context that was initialized once can be
+    // snapshotted, after which restoring the snapshot into fresh contexts of the same program skips the
+    // initialization. Restored globals share their memory with the snapshot until they are written to
+    // (where supported by the platform), so restoring is cheap regardless of the size of the globals.
+    // Pointers in the globals that point into the globals or constants of the snapshotted context are
+    // rebased onto the context they are restored into, other pointers (such as into the stack) are copied as-is.
+    // Snapshots are immutable and can be restored into any number of contexts concurrently,
+    // and do not need to outlive the contexts they were restored into.
+    class context_snapshot : public handle<class context_snapshot_data, sizeof(size_t) * 16>
+    {
+    public:
+        explicit context_snapshot(const execution_context& context);
+        ~context_snapshot();
+
+    private:
+        friend class execution_context;
+    };
+
+    // Fiber.
+    // Resumable invocation of a method of a shared program. Execution suspends once the step budget
+    // of a resume runs out, and continues where it left off on the next resume. Branches and calls
+    // each take one step, which bounds the amount of work done between suspensions.
+    // Every fiber has its own stack and globals. Fibers are not thread-safe, but a suspended fiber
+    // can be resumed on a different thread. The program needs to outlive the fiber.
+    class fiber : public handle<class fiber_data, sizeof(size_t) * 256>
+    {
+    public:
+        fiber(const program& shared_program, method_idx method, span<const uint8_t> arguments = span<const uint8_t>(), print_method_handle print_method = nullptr);
+        ~fiber();
+
+        // Continue execution for at most step_budget steps.
+        // Returns true once the method has returned.
+        bool resume(uint64_t step_budget);
+        // Continue execution until the time budget has passed (checked every check_interval steps).
+        // Returns true once the method has returned.
+        bool resume_for(std::chrono::nanoseconds time_budget, uint64_t check_interval = 1 << 12);
+
+        // Start a new invocation (interrupting the current one, if any)
+        void restart(method_idx method, span<const uint8_t> arguments = span<const uint8_t>());
+        // Restore all globals to their initial values
+        void reset_globals();
+
+        // True once the method has returned (or execution has thrown an exception)
+        bool finished() const noexcept;
+        // Return value of the method (empty until the method has returned)
+        span<const uint8_t> return_value() const noexcept;
+    };
+
+    // Fiber scheduler.
+    // Multiplexes fibers over a pool of worker threads. Workers take the next fiber from a shared queue,
+    // resume it for one step budget and queue it again if it has not finished yet.
+    // Fibers that throw are removed from the queue, the first exception is rethrown once all workers are done.
+    class fiber_scheduler : public handle<class fiber_scheduler_data, sizeof(size_t) * 16>
+    {
+    public:
+        // A worker count of zero uses the hardware concurrency
+        fiber_scheduler(size_t worker_count = 0, uint64_t step_budget = 1 << 16);
+        ~fiber_scheduler();
+
+        // Queue a fiber, which needs to stay alive until it has finished
+        // (fibers that are already queued or have finished are ignored)
+        void add(fiber& queued_fiber);
+        // Amount of queued fibers that have not finished yet
+        size_t size() const noexcept;
+
+        // Resume every queued fiber once, finished fibers are removed from the queue
+        void step();
+        // Resume the queued fibers until all of them have finished
+        void run();
+    };
+
+    // Batch executor.
+    // Invokes a method of a shared program on many independent inputs, distributed over worker threads.
+    // Invocations are split evenly over the workers up front, workers that run out of work steal
+    // half of the remaining invocations of another worker. Every worker executes on its own context
+    // (stack and globals), which is kept and reused by subsequent batches.
+    // Executors are not thread-safe. The program needs to outlive the executor.
+    class batch_executor : public handle<class batch_executor_data, sizeof(size_t) * 16>
+    {
+    public:
+        batch_executor(const program& shared_program, batch_parameters parameters = batch_parameters());
+        ~batch_executor();
+
+        // Invoke a method count times. Arguments contains count argument blobs back to back (laid out according
+        // to the parameter offsets of the method signature), return values receives count return values back to back.
+        // If any invocation throws, the remaining invocations are abandoned and the first exception is rethrown.
+        void execute(method_idx method, size_t count, span<const uint8_t> arguments, span<uint8_t> return_values = span<uint8_t>());
     };
 }
 
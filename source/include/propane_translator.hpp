@@ -12,11 +12,28 @@ namespace propane
         translator() = delete;
     };
 
+    struct translator_c_parameters
+    {
+        // Method definitions are generated on multiple threads
+        // (a thread count of zero uses the hardware concurrency)
+        size_t thread_count = 0;
+        // Split the output over multiple files: a header ("<output>.h") with all type definitions and
+        // declarations, the output file with the globals and constants, and this amount of translation
+        // units ("<output>_<index>.c") with the method definitions. Zero writes a single output file.
+        size_t translation_units = 0;
+        // Optimized output: locals of which the address is never taken are declared register, calls
+        // through constant method pointers are made directly and small leaf methods are static inline
+        bool optimize = false;
+        // Execution profile (see link_profile), used by optimized output to hint the likelihood of conditional
+        // branches. Methods that were laid out by the same profile when linking already fall through on hot paths.
+        const link_profile* profile = nullptr;
+    };
+
     // Experimental translator for generating C code out of Propane assemblies
     class translator_c
     {
     public:
-        static void generate(const char* out_file, const class assembly& linked_assembly);
+        static void generate(const char* out_file, const class assembly& linked_assembly, translator_c_parameters parameters = translator_c_parameters());
     };
 
     template<> class translator<language_c> : public translator_c {};
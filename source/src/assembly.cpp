@@ -1,9 +1,72 @@
 #include "propane_assembly.hpp"
 #include "constants.hpp"
 #include "name_generator.hpp"
+#include "host.hpp"
 
 namespace propane
 {
+    assembly::~assembly()
+    {
+        release();
+    }
+
+    assembly::assembly(const assembly& other)
+    {
+        if (other.content.size() > 0)
+        {
+            load(other.content);
+        }
+    }
+    assembly& assembly::operator=(const assembly& other)
+    {
+        if (this != &other)
+        {
+            release();
+            if (other.content.size() > 0)
+            {
+                load(other.content);
+            }
+        }
+        return *this;
+    }
+
+    assembly::assembly(assembly&& other) noexcept :
+        content(other.content),
+        pages_size(other.pages_size),
+        mapped(other.mapped)
+    {
+        other.content = span<const uint8_t>();
+        other.pages_size = 0;
+        other.mapped = false;
+    }
+    assembly& assembly::operator=(assembly&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            content = other.content;
+            pages_size = other.pages_size;
+            mapped = other.mapped;
+            other.content = span<const uint8_t>();
+            other.pages_size = 0;
+            other.mapped = false;
+        }
+        return *this;
+    }
+
+    void assembly::release() noexcept
+    {
+        if (content.data())
+        {
+            const hostmem mem = { const_cast<uint8_t*>(content.data()), pages_size };
+            if (mapped) host::unmap_file(mem);
+            else host::free(mem);
+        }
+        content = span<const uint8_t>();
+        pages_size = 0;
+        mapped = false;
+    }
+
     bool assembly::is_valid() const noexcept
     {
         return constants::validate_assembly_header(content);
@@ -55,7 +118,38 @@ namespace propane
     {
         if (!constants::validate_assembly_header(from_bytes)) return false;
 
-        content = block<uint8_t>(from_bytes.data(), from_bytes.size());
+        // Copy into memory pages and protect them, so the interpreter
+        // can execute directly from this memory without making another copy
+        const hostmem mem = host::allocate(from_bytes.size());
+        if (!mem) return false;
+        memcpy(mem.address, from_bytes.data(), from_bytes.size());
+        if (!host::protect(mem))
+        {
+            host::free(mem);
+            return false;
+        }
+
+        release();
+        content = span<const uint8_t>(reinterpret_cast<const uint8_t*>(mem.address), from_bytes.size());
+        pages_size = mem.size;
+        return true;
+    }
+    bool assembly::load_mapped(const char* file_path)
+    {
+        const hostmem mem = host::map_file(file_path);
+        if (!mem) return false;
+
+        const span<const uint8_t> mapped_bytes(reinterpret_cast<const uint8_t*>(mem.address), mem.size);
+        if (!constants::validate_assembly_header(mapped_bytes))
+        {
+            host::unmap_file(mem);
+            return false;
+        }
+
+        release();
+        content = mapped_bytes;
+        pages_size = mem.size;
+        mapped = true;
         return true;
     }
 
@@ -19,6 +19,21 @@ namespace propane
     public:
         asm_method() = default;
         asm_method(gen_method&& base) : gen_method(std::move(base)) {}
+
+        // Stack variables are placed behind the parameters at their natural alignment.
+        // The method stack size is padded so that the return value and the next stack frame are aligned.
+        template<typename type_list_t> inline void layout_stack(const type_list_t& types, size_t parameters_size)
+        {
+            size_t offset = parameters_size;
+            for (auto& sv : stackvars)
+            {
+                const auto& sv_type = types[sv.type];
+                offset = align_size(offset, sv_type.alignment);
+                sv.offset = offset - parameters_size;
+                offset += sv_type.total_size;
+            }
+            method_stack_size = align_size(offset, stack_alignment);
+        }
     };
 
     class asm_signature : public gen_signature
@@ -89,6 +104,8 @@ namespace propane
         asm_metatable metatable;
         method_idx main = method_idx::invalid;
         size_t runtime_hash = 0;
+        bytecode_encoding encoding = bytecode_encoding::standard;
+        vector<method_idx> method_order;
 
         inline file_meta make_meta(type_idx type) const noexcept
         {
@@ -128,13 +145,13 @@ namespace propane
         }
     };
 
-    SERIALIZABLE_PAIR(asm_type, type, name, index, flags, generated, fields, total_size, pointer_type, meta);
+    SERIALIZABLE_PAIR(asm_type, type, name, index, flags, generated, fields, total_size, alignment, pointer_type, meta);
     SERIALIZABLE_PAIR(asm_signature, signature, index, return_type, parameters, parameters_size);
     SERIALIZABLE_PAIR(asm_method, method, name, index, flags, signature, bytecode, labels, stackvars, method_stack_size, total_stack_size, meta);
     SERIALIZABLE_PAIR(asm_field_address, field_address, object_type, field_names);
     SERIALIZABLE_PAIR(asm_field_offset, field_offset, name, type, offset);
     SERIALIZABLE_PAIR(asm_data_table, data_table, info, data);
-    SERIALIZABLE_PAIR(asm_assembly_data, assembly_data, types, methods, signatures, offsets, globals, constants, database, metatable, main, runtime_hash);
+    SERIALIZABLE_PAIR(asm_assembly_data, assembly_data, types, methods, signatures, offsets, globals, constants, database, metatable, main, runtime_hash, encoding, method_order);
 }
 
 #endif
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define _HEADER_BLOCK_WRITER
 
 #include "common.hpp"
+#include "errors.hpp"
+
+#include <memory>
 
 namespace propane
 {
@@ -10,14 +13,19 @@ namespace propane
         template<typename value_t> struct serializer;
     }
 
+    // Binary writer for serializing nested blocks
+    // All writers of a serialization share one arena: written bytes are appended to a single
+    // buffer, and deferred writers are allocated in pages. Each writer keeps track of the
+    // ranges it wrote, which are laid out in their final order by finalize. Finalize makes
+    // a size pass first, and then writes the result into one preallocated buffer.
     class block_writer final
     {
     public:
-        block_writer() : offset(0), element_count(0) {}
-        ~block_writer()
-        {
-            free_children();
-        }
+        block_writer() :
+            offset(0),
+            arena_ptr(new arena()),
+            arena_ref(arena_ptr.get()) {}
+        ~block_writer() = default;
 
         block_writer(const block_writer&) = delete;
         block_writer& operator=(const block_writer&) = delete;
@@ -47,43 +55,34 @@ namespace propane
         // Write deferred
         block_writer& write_deferred()
         {
-            const uint32_t current_offset = static_cast<uint32_t>(binary.size());
+            const uint32_t current_offset = length;
             reserve(static_cast<uint32_t>(sizeof(uint32_t) * 2));
-            block_writer* ptr = new block_writer(current_offset);
-            children.push_back(ptr);
-            return *ptr;
+            block_writer& child = arena_ref->allocate(current_offset);
+            if (last_child) last_child->next_sibling = &child;
+            else first_child = &child;
+            last_child = &child;
+            return child;
         }
 
         // Combine data
         // All references to block_writers created by write_deferred will become invalid
-        // after calling this.
-        vector<uint8_t> finalize()
+        // after calling this. Extra capacity can be reserved for data that is appended afterwards.
+        vector<uint8_t> finalize(size_t reserve_capacity = 0)
         {
-            for (auto& it : children)
-            {
-                uint32_t write_offset = static_cast<uint32_t>(binary.size());
-
-                // Pad to ensure 32 bit alignment
-                constexpr size_t alignment = sizeof(uint32_t);
-                const uint32_t remaining = write_offset & (alignment - 1);
-                if (remaining != 0)
-                {
-                    write_offset += (alignment - remaining);
-                    binary.resize(write_offset);
-                }
-
-                const vector<uint8_t> cb = it->finalize();
-                append(cb.data(), static_cast<uint32_t>(cb.size()));
-
-                // Write header
-                uint32_t* write = reinterpret_cast<uint32_t*>(binary.data() + it->offset);
-                *write++ = (write_offset - it->offset);
-                *write++ = it->element_count;
-            }
-            free_children();
+            ASSERT(arena_ptr, "Only the root block_writer can be finalized");
 
+            const uint32_t total_size = compute_size();
             vector<uint8_t> result;
-            swap(result, binary);
+            result.reserve(size_t(total_size) + reserve_capacity);
+            result.resize(total_size);
+            write_to(result.data());
+
+            arena_ptr.reset(new arena());
+            arena_ref = arena_ptr.get();
+            length = 0;
+            element_count = 0;
+            first_chunk = last_chunk = invalid_chunk;
+            first_child = last_child = nullptr;
             return result;
         }
 
@@ -95,29 +94,142 @@ namespace propane
         }
 
     private:
-        block_writer(uint32_t offset) : offset(offset), element_count(0) {}
+        static constexpr uint32_t invalid_chunk = uint32_t(-1);
+        static constexpr size_t alignment = sizeof(uint32_t);
 
-        uint32_t element_count;
+        // Range of bytes in the arena written by a single writer
+        struct chunk
+        {
+            uint32_t address;
+            uint32_t length;
+            uint32_t next;
+        };
 
-        inline void append(const uint8_t* ptr, uint32_t length)
+        class arena final
         {
-            binary.insert(binary.end(), ptr, ptr + length);
+        public:
+            arena() = default;
+
+            arena(const arena&) = delete;
+            arena& operator=(const arena&) = delete;
+
+            block_writer& allocate(uint32_t offset)
+            {
+                if (page_count == page_size || pages.empty())
+                {
+                    pages.emplace_back(static_cast<block_writer*>(::operator new(sizeof(block_writer) * page_size)));
+                    page_count = 0;
+                }
+                block_writer* ptr = pages.back().get() + page_count++;
+                return *new (ptr) block_writer(this, offset);
+            }
+
+            vector<uint8_t> bytes;
+            vector<chunk> chunks;
+
+        private:
+            // Deferred writers do not own any resources, so pages are released without destructing them
+            static constexpr size_t page_size = 256;
+
+            struct page_deleter { void operator()(block_writer* ptr) const noexcept { ::operator delete(ptr); } };
+            vector<std::unique_ptr<block_writer, page_deleter>> pages;
+            size_t page_count = 0;
+        };
+
+        block_writer(arena* arena_ref, uint32_t offset) :
+            offset(offset),
+            arena_ref(arena_ref) {}
+
+        inline void append(const uint8_t* ptr, uint32_t len)
+        {
+            uint8_t* dst = extend(len);
+            if (len > 0) memcpy(dst, ptr, len);
         }
 
-        inline void reserve(uint32_t length)
+        inline void reserve(uint32_t len)
         {
-            binary.resize(binary.size() + length);
+            uint8_t* dst = extend(len);
+            if (len > 0) memset(dst, 0, len);
         }
 
-        void free_children()
+        inline uint8_t* extend(uint32_t len)
         {
-            for (auto it : children)
-                delete it;
-            children.clear();
+            vector<uint8_t>& bytes = arena_ref->bytes;
+            vector<chunk>& chunks = arena_ref->chunks;
+            const uint32_t address = static_cast<uint32_t>(bytes.size());
+
+            // Extend the last range if nothing else was written in between
+            if (last_chunk != invalid_chunk && chunks[last_chunk].address + chunks[last_chunk].length == address)
+            {
+                chunks[last_chunk].length += len;
+            }
+            else
+            {
+                const uint32_t index = static_cast<uint32_t>(chunks.size());
+                chunks.push_back(chunk{ address, len, invalid_chunk });
+                if (last_chunk != invalid_chunk) chunks[last_chunk].next = index;
+                else first_chunk = index;
+                last_chunk = index;
+            }
+
+            length += len;
+            bytes.resize(bytes.size() + len);
+            return bytes.data() + address;
+        }
+
+        static inline uint32_t align(uint32_t address)
+        {
+            return (address + uint32_t(alignment - 1)) & ~uint32_t(alignment - 1);
+        }
+
+        // Size of this block, followed by all of its deferred blocks padded to 32 bit alignment
+        uint32_t compute_size() const
+        {
+            uint32_t size = length;
+            for (const block_writer* child = first_child; child; child = child->next_sibling)
+            {
+                size = align(size) + child->compute_size();
+            }
+            return size;
+        }
+        // Destination is expected to be zero-initialized and 32 bit aligned
+        uint32_t write_to(uint8_t* dst) const
+        {
+            const vector<uint8_t>& bytes = arena_ref->bytes;
+            const vector<chunk>& chunks = arena_ref->chunks;
+
+            uint32_t size = 0;
+            for (uint32_t idx = first_chunk; idx != invalid_chunk; idx = chunks[idx].next)
+            {
+                const chunk& c = chunks[idx];
+                if (c.length > 0) memcpy(dst + size, bytes.data() + c.address, c.length);
+                size += c.length;
+            }
+
+            for (const block_writer* child = first_child; child; child = child->next_sibling)
+            {
+                const uint32_t write_offset = align(size);
+
+                // Write header
+                uint32_t header[2] = { write_offset - child->offset, child->element_count };
+                memcpy(dst + child->offset, header, sizeof(header));
+
+                size = write_offset + child->write_to(dst + write_offset);
+            }
+            return size;
         }
 
-        vector<uint8_t> binary;
-        vector<block_writer*> children;
+        // Only set for the root writer
+        std::unique_ptr<arena> arena_ptr;
+        arena* arena_ref;
+
+        uint32_t length = 0;
+        uint32_t element_count = 0;
+        uint32_t first_chunk = invalid_chunk;
+        uint32_t last_chunk = invalid_chunk;
+        block_writer* first_child = nullptr;
+        block_writer* last_child = nullptr;
+        block_writer* next_sibling = nullptr;
     };
 }
 
@@ -28,6 +28,7 @@ using std::stringstream;
 
 #include <utility>
 #include <cstring>
+#include <charconv>
 
 #define CLASS_DEFAULT(type, copy, move, ...)    \
 type(const type&) = copy;                       \
@@ -88,6 +89,22 @@ namespace propane
             return append(fnv::offset<fnv::architecture>, ptr, len);
         }
 
+        // Fixed width version (for hashes that are stored in binaries)
+        inline uint64_t append64(uint64_t hash, const char* const ptr, const size_t len) noexcept
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                hash ^= static_cast<uint64_t>(static_cast<uint8_t>(ptr[i]));
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+        inline uint64_t hash64(const char* const ptr, const size_t len) noexcept
+        {
+            return append64(14695981039346656037ull, ptr, len);
+        }
+
         // Template version
         template<typename value_t> inline size_t append(size_t hash, const value_t& val) noexcept
         {
@@ -303,6 +320,55 @@ namespace propane
         }
     };
 
+    // Formatting writer, appends text and numbers into a reusable buffer
+    // (numbers are formatted with to_chars, floating point values match the default ostream format)
+    class format_writer : public string_writer_base
+    {
+    public:
+        using string_writer_base::write;
+
+        template<typename value_t> inline std::enable_if_t<std::is_integral_v<value_t>> write(value_t val)
+        {
+            char buf[24];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), val);
+            write(buf, size_t(result.ptr - buf));
+        }
+        template<typename value_t> inline std::enable_if_t<std::is_floating_point_v<value_t>> write(value_t val)
+        {
+            char buf[32];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), val, std::chars_format::general, 6);
+            write(buf, size_t(result.ptr - buf));
+        }
+        inline void write(const void* ptr)
+        {
+            char buf[2 + sizeof(uintptr_t) * 2];
+            buf[0] = '0';
+            buf[1] = 'x';
+            const auto result = std::to_chars(buf + 2, buf + sizeof(buf), reinterpret_cast<uintptr_t>(ptr), 16);
+            write(buf, size_t(result.ptr - buf));
+        }
+        inline void write(const char* str)
+        {
+            write(string_view(str));
+        }
+        // Char and bool overloads are listed explicitly so they are not formatted as integers
+        inline void write(const char c)
+        {
+            push_back(c);
+        }
+        inline void write(bool b)
+        {
+            if (b) write("true", 4);
+            else write("false", 5);
+        }
+
+        template<typename value_t> inline format_writer& operator<<(const value_t& val)
+        {
+            write(val);
+            return *this;
+        }
+    };
+
     struct address_info
     {
         inline address_info(address_header header) noexcept
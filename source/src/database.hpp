@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include "propane_block.hpp"
 #include "block_writer.hpp"
+#include "flat_map.hpp"
 
 namespace propane
 {
@@ -171,6 +172,38 @@ namespace propane
         }
     };
 
+    // Static database with a prebuilt name index, which can be queried in place.
+    // The index is an open addressing hash table (power of two size, linear probing),
+    // buckets contain the entry index plus one (zero marks an empty bucket).
+    // Names are hashed with the 64 bit hash, so the index is the same on all architectures.
+    template<typename key_t, typename value_t> struct static_indexed_database
+    {
+        using const_find_result_type = typename database_content<key_t, value_t>::const_find_result_type;
+
+        static_database<key_t, value_t> table;
+        static_block<uint32_t> index;
+
+        inline const_find_result_type find(string_view name) const noexcept
+        {
+            if (!index.empty())
+            {
+                const size_t mask = index.size() - 1;
+                for (size_t bucket = static_cast<size_t>(fnv::hash64(name.data(), name.size()) & mask);; bucket = (bucket + 1) & mask)
+                {
+                    const uint32_t entry_index = index[bucket];
+                    if (entry_index == 0) break;
+
+                    const auto& entry = table.entries[entry_index - 1];
+                    if (entry.length == name.size() && memcmp(table.strings.data() + entry.offset, name.data(), name.size()) == 0)
+                    {
+                        return entry.value.make_result();
+                    }
+                }
+            }
+            return invalid_result<key_t, value_t, true>::make();
+        }
+    };
+
     template<typename key_t, typename value_t> class database
     {
     public:
@@ -228,11 +261,9 @@ namespace propane
 
         template <typename... arg_t> inline find_result_type emplace(string_view name, arg_t&&... arg)
         {
-            const char* ptr = name.data();
-            const database_string_view view(&ptr, static_cast<uint32_t>(name.size()));
-
-            auto find = lookup.find(view);
-            if (find == lookup.end())
+            const size_t hash = fnv::hash(name.data(), name.size());
+            const uint32_t find = find_entry(name, hash);
+            if (find == flat_hash_index::invalid_entry)
             {
                 const size_t idx = entries.size();
                 const uint32_t offset = static_cast<uint32_t>(strings.size());
@@ -240,45 +271,46 @@ namespace propane
 
                 // Insert entry
                 entries.push_back(entry_type(offset, length, key_t(idx), std::forward<arg_t>(arg)...));
-                // Insert string and update pointer (in case it changed)
+                // Insert string
                 strings.insert(strings.end(), name.begin(), name.end());
-                string_data = strings.data();
                 // Insert lookup
-                lookup.emplace(database_string_view(&string_data, offset, length), key_t(idx));
+                lookup.insert(hash, static_cast<uint32_t>(idx));
 
                 return entries.back().value.make_result();
             }
 
-            auto& replace = entries[static_cast<size_t>(find->second)];
+            auto& replace = entries[find];
             replace = entry_type(replace.offset, replace.length, replace.value.key, std::forward<arg_t>(arg)...);
             return replace.value.make_result();
         }
 
         inline find_result_type find(string_view name) noexcept
         {
-            const char* ptr = name.data();
-            const database_string_view view(&ptr, static_cast<uint32_t>(name.size()));
-
-            auto find = lookup.find(view);
-            if (find == lookup.end())
+            const uint32_t find = find_entry(name, fnv::hash(name.data(), name.size()));
+            if (find == flat_hash_index::invalid_entry)
             {
                 return invalid_result<key_t, value_t, false>::make();
             }
 
-            return entries[static_cast<size_t>(find->second)].value.make_result();
+            return entries[find].value.make_result();
         }
         inline const_find_result_type find(string_view name) const noexcept
         {
-            const char* ptr = name.data();
-            const database_string_view view(&ptr, static_cast<uint32_t>(name.size()));
-
-            auto find = lookup.find(view);
-            if (find == lookup.end())
+            const uint32_t find = find_entry(name, fnv::hash(name.data(), name.size()));
+            if (find == flat_hash_index::invalid_entry)
             {
                 return invalid_result<key_t, value_t, true>::make();
             }
 
-            return entries[static_cast<size_t>(find->second)].value.make_result();
+            return entries[find].value.make_result();
+        }
+
+        // Allocates storage for the provided amount of entries (and total name length) up front
+        inline void reserve(size_t entry_count, size_t string_size = 0)
+        {
+            entries.reserve(entry_count);
+            strings.reserve(string_size);
+            lookup.reserve(entry_count);
         }
 
         inline void clear() noexcept
@@ -311,21 +343,44 @@ namespace propane
             write_strings.write_direct(strings.data(), static_cast<uint32_t>(strings.size()));
             write_strings.increment_length(static_cast<uint32_t>(strings.size()));
         }
+        // Serialize as static_indexed_database
+        inline void serialize_indexed_database(block_writer& writer) const
+        {
+            serialize_database(writer);
+
+            // Keep the load factor at or below one half
+            size_t bucket_count = entries.empty() ? 0 : 2;
+            while (bucket_count < entries.size() * 2) bucket_count <<= 1;
+
+            vector<uint32_t> index(bucket_count, 0);
+            const size_t mask = bucket_count - 1;
+            for (size_t idx = 0; idx < entries.size(); idx++)
+            {
+                const auto& entry = entries[idx];
+                size_t bucket = static_cast<size_t>(fnv::hash64(strings.data() + entry.offset, entry.length) & mask);
+                while (index[bucket] != 0) bucket = (bucket + 1) & mask;
+                index[bucket] = static_cast<uint32_t>(idx + 1);
+            }
+
+            auto& write_index = writer.write_deferred();
+            write_index.write_direct(index.data(), static_cast<uint32_t>(index.size()));
+            write_index.increment_length(static_cast<uint32_t>(index.size()));
+        }
         inline void deserialize_database(const static_database<key_t, value_t>& t)
         {
             strings.clear();
             strings.insert(strings.end(), t.strings.begin(), t.strings.end());
-            string_data = strings.data();
 
             entries.clear();
             entries.insert(entries.end(), t.entries.begin(), t.entries.end());
 
             // Recreate the lookup table
             lookup.clear();
+            lookup.reserve(entries.size());
             for (size_t idx = 0; idx < entries.size(); idx++)
             {
                 const auto& entry = entries[idx];
-                lookup.emplace(database_string_view(&string_data, entry.offset, entry.length), key_t(idx));
+                lookup.insert(fnv::hash(strings.data() + entry.offset, entry.length), static_cast<uint32_t>(idx));
             }
         }
 
@@ -348,59 +403,25 @@ namespace propane
         void take_from(database&& other) noexcept
         {
             strings = std::move(other.strings);
-            string_data = strings.data();
             entries = std::move(other.entries);
-
-            // Move the lookups and update the pointer to the string data
-            // (use extract to prevent reallocation)
-            lookup.clear();
-            while (!other.lookup.empty())
-            {
-                auto pair = other.lookup.extract(other.lookup.begin());
-                pair.key().ptr = &string_data;
-                lookup.insert(std::move(pair));
-            }
+            lookup = std::move(other.lookup);
+            other.strings.clear();
+            other.entries.clear();
+            other.lookup.clear();
         }
 
-        class database_string_view
-        {
-        public:
-            database_string_view() = default;
-            database_string_view(const char** ptr, uint32_t length) :
-                offset(0, length),
-                ptr(ptr) {}
-            database_string_view(const char** ptr, uint32_t offset, uint32_t length) :
-                offset(offset, length),
-                ptr(ptr) {}
-
-            string_offset offset = string_offset(0, 0);
-            const char** ptr = nullptr;
-        };
-
-        struct database_hash
+        inline uint32_t find_entry(string_view name, size_t hash) const noexcept
         {
-            inline size_t operator()(const database_string_view& str) const
+            return lookup.find(hash, [&](uint32_t idx)
             {
-                return fnv::hash(*str.ptr + str.offset.offset, str.offset.length);
-            }
-        };
-
-        struct database_compare
-        {
-            inline bool operator()(const database_string_view& lhs, const database_string_view& rhs) const
-            {
-                if (lhs.offset.length == rhs.offset.length)
-                {
-                    return memcmp(*lhs.ptr + lhs.offset.offset, *rhs.ptr + rhs.offset.offset, lhs.offset.length) == 0;
-                }
-                return false;
-            }
-        };
+                const auto& entry = entries[idx];
+                return entry.length == name.size() && memcmp(strings.data() + entry.offset, name.data(), name.size()) == 0;
+            });
+        }
 
         string strings;
-        const char* string_data = nullptr;
         vector<entry_type> entries;
-        unordered_map<database_string_view, key_t, database_hash, database_compare> lookup;
+        flat_hash_index lookup;
     };
 
     inline string_view get_database_entry(const string_table<name_idx>& database, name_idx name)
@@ -0,0 +1,200 @@
+#ifndef _HEADER_DECODED_BYTECODE
+#define _HEADER_DECODED_BYTECODE
+
+#include "assembly_data.hpp"
+#include "jit.hpp"
+
+#include <atomic>
+
+namespace propane
+{
+    // Pre-decoded operand
+    // Operand addresses get resolved once at load time into a base and an offset,
+    // the header type/modifier/prefix fields are not parsed again during execution.
+    enum class operand_base : uint8_t
+    {
+        // Relative to the parameters of the current stack frame
+        // (parameters, stack variables and the return value)
+        frame,
+        // Relative to the front of the global data
+        global,
+        // Offset is an absolute address (constants)
+        absolute,
+        // Offset contains the value (constant literals and sizeof)
+        immediate,
+    };
+
+    enum class operand_flags : uint8_t
+    {
+        none = 0,
+        // Dereference and add the dereference offset (indirect field or pointer offset)
+        dereference = 1 << 0,
+        // Dereference (indirection prefix)
+        indirection = 1 << 1,
+        // Take the address of the result (address-of prefix)
+        address_of = 1 << 2,
+    };
+    inline constexpr operand_flags operator|(operand_flags lhs, operand_flags rhs) noexcept
+    {
+        return operand_flags(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+    }
+    inline constexpr operand_flags& operator|=(operand_flags& lhs, operand_flags rhs) noexcept
+    {
+        lhs = lhs | rhs;
+        return lhs;
+    }
+    inline constexpr bool operator&(operand_flags lhs, operand_flags rhs) noexcept
+    {
+        return operand_flags(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs)) != operand_flags::none;
+    }
+
+    struct decoded_operand
+    {
+        operand_base base = operand_base::frame;
+        operand_flags flags = operand_flags::none;
+        // Type of the operand after all modifiers and prefixes have been applied
+        type_idx type = type_idx::invalid;
+        // Offset relative to base (or absolute address/immediate value)
+        size_t offset = 0;
+        // Offset applied after dereferencing
+        size_t deref_offset = 0;
+    };
+
+    struct decoded_argument
+    {
+        subcode sub;
+        // Byte size of the argument (for struct copies)
+        size_t size;
+        // Parameter offset relative to the parameters of the new stack frame
+        size_t offset;
+        decoded_operand operand;
+    };
+
+    // Bulk argument copy (one or more contiguous frame variables)
+    struct decoded_copy
+    {
+        // Offset relative to the parameters of the calling frame
+        size_t src_offset;
+        // Parameter offset relative to the parameters of the new stack frame
+        size_t dst_offset;
+        size_t size;
+    };
+
+    // Lowering of sparse switches (subcode of decoded sws instructions)
+    namespace switch_lowering
+    {
+        // Labels are indexed by the case key relative to the lowest key (the only key stored)
+        constexpr subcode jump_table = subcode(0);
+        // Labels correspond to the sorted case keys
+        constexpr subcode binary_search = subcode(1);
+    }
+
+    // Superinstructions (pre-decoded only, these are not part of the bytecode format)
+    // Frequent instruction pairs are fused into a single dispatch. The second instruction
+    // of a pair remains in the instruction stream, so it can still be jumped to.
+    namespace superinstruction
+    {
+        // Operation (set, conversion or arithmetic) followed by a conditional branch
+        constexpr opcode operation_branch = opcode(opcode_count + 0);
+        // Comparison followed by a zero-comparison branch on the return value
+        constexpr opcode compare_branch = opcode(opcode_count + 1);
+        // Call followed by a set of the return value to a frame variable
+        constexpr opcode call_set = opcode(opcode_count + 2);
+        // Call followed by a return of its result (executed in the stack frame of the caller)
+        constexpr opcode tail_call = opcode(opcode_count + 3);
+        // Call to an external method (forwarded without pushing a stack frame)
+        constexpr opcode call_native = opcode(opcode_count + 4);
+
+        constexpr size_t count = 5;
+    }
+
+    // Inline cache for virtual calls (one per callv call site, owned by the interpreter)
+    // Maps raw method handles to previously resolved call targets, so that repeated calls
+    // to the same target skip the handle validation and lookup.
+    // Monomorphic sites only ever use the first entry, polymorphic sites replace entries round-robin.
+    struct inline_cache
+    {
+        static constexpr size_t capacity = 4;
+
+        size_t handles[capacity] = {};
+        const struct decoded_method* targets[capacity] = {};
+        uint32_t next = 0;
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    class interpreter;
+    struct decoded_instruction;
+    typedef void(*operation_handler)(interpreter&, const decoded_instruction&);
+    typedef int32_t(*comparison_handler)(interpreter&, const decoded_instruction&);
+
+    // Pre-decoded instruction
+    // Branch targets are pointers to other decoded instructions within the same method
+    struct decoded_instruction
+    {
+        // Handler address (only used with threaded dispatch)
+        const void* handler = nullptr;
+        // Handler specialized for the subcode and operand layout of this instruction
+        union
+        {
+            operation_handler operation = nullptr;
+            comparison_handler comparison;
+        };
+        opcode op = opcode::noop;
+        // Opcode as it appears in the bytecode (op is replaced for superinstructions)
+        opcode base_op = opcode::noop;
+        subcode sub = subcode(0);
+        // Argument count (call/callv, excluding bulk copies) or label count (sw/sws)
+        uint32_t count = 0;
+        decoded_operand lhs;
+        decoded_operand rhs;
+        // Branch target
+        const decoded_instruction* target = nullptr;
+        union
+        {
+            // Switch labels
+            const decoded_instruction* const* labels = nullptr;
+            // Call arguments that are copied in bulk (copy_count)
+            const decoded_copy* copies;
+        };
+        // Call arguments that need to be resolved or converted (count), or the length operand (mcpy/mset/mcmp)
+        const decoded_argument* args = nullptr;
+        union
+        {
+            // Call target (call)
+            const struct decoded_method* call_target = nullptr;
+            // Call site inline cache index (callv)
+            size_t cache_index;
+            // Sorted case keys, or the lowest key for jump tables (sws)
+            const uint64_t* keys;
+        };
+        // Instruction specific value (copy size, pointer underlying size or calling signature)
+        size_t value = 0;
+        // Byte offset of the original instruction (relative to start of the method bytecode)
+        uint32_t offset = 0;
+        // Amount of bulk argument copies (call/callv)
+        uint32_t copy_count = 0;
+    };
+
+    struct decoded_method
+    {
+        const method* source = nullptr;
+        const signature* method_signature = nullptr;
+        vector<decoded_instruction> instructions;
+        vector<decoded_argument> arguments;
+        vector<decoded_copy> copies;
+        vector<uint64_t> switch_keys;
+        vector<const decoded_instruction*> labels;
+        // Stack size required when calling this method (including the stack frame)
+        size_t frame_size = 0;
+        // Set once the instructions are decoded (methods can be decoded on their first call)
+        std::atomic<bool> ready = false;
+
+        // Native code, compiled once the call count reaches the JIT threshold
+        mutable native_code native;
+        mutable uint32_t call_count = 0;
+    };
+}
+
+#endif
\ No newline at end of file
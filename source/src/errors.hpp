@@ -32,6 +32,8 @@ enum class ERRC : uint32_t
     GNR_INVALID_CONSTANT = 0x1303,
     GNR_MISSING_RET_VAL = 0x1304,
     GNR_INVALID_CONSTANT_ADDR = 0x1305,
+    GNR_INVALID_BLOCK = 0x1306,
+    GNR_INVALID_BLOCK_INSTRUCTION = 0x1307,
     // Parser errors
     PRS_FILE_EXCEPTION = 0x2000,
     PRS_UNEXPECTED_EXPRESSION = 0x2100,
@@ -65,6 +67,7 @@ enum class ERRC : uint32_t
     LNK_UNDEFINED_METHOD = 0x4102,
     LNK_UNDEFINED_GLOBAL = 0x4103,
     LNK_TYPE_SIZE_ZERO = 0x4104,
+    LNK_UNRESOLVED_EXTERNAL_SYMBOL = 0x4105,
     LNK_UNINITIALIZED_METHOD_PTR = 0x4200,
     LNK_UNDEFINED_METHOD_INITIALIZER = 0x4201,
     LNK_INVALID_METHOD_INITIALIZER = 0x4202,
@@ -86,6 +89,9 @@ enum class ERRC : uint32_t
     LNK_INVALID_POINTER_DEREFERENCE = 0x430D,
     LNK_ABSTRACT_POINTER_DEREFERENCE = 0x430E,
     LNK_INVALID_FIELD_DEREFERENCE = 0x430F,
+    LNK_INVALID_SWITCH_CASE = 0x4310,
+    LNK_INVALID_VECTOR_EXPRESSION = 0x4311,
+    LNK_INVALID_MEMORY_EXPRESSION = 0x4312,
     // Runtime errors
     RTM_INVALID_ASSEMBLY = 0x5000,
     RTM_INCOMPATIBLE_ASSEMBLY = 0x5001,
@@ -94,6 +100,12 @@ enum class ERRC : uint32_t
     RTM_STACK_OVERFLOW = 0x5004,
     RTM_CALLSTACK_LIMIT_REACHED = 0x5005,
     RTM_RUNTIME_HASH_MISMATCH = 0x5006,
+    RTM_INVALID_METHOD_INVOKE = 0x5007,
+    RTM_INVOKE_ARGUMENT_MISMATCH = 0x5008,
+    RTM_UNRESOLVED_EXTERNAL_SYMBOL = 0x5009,
+    RTM_SNAPSHOT_MISMATCH = 0x500A,
+    RTM_INVALID_ALLOCATOR = 0x500B,
+    RTM_ALLOCATION_FAILURE = 0x500C,
 };
 
 inline uint32_t errc_to_uint(ERRC errc) noexcept
@@ -0,0 +1,214 @@
+#ifndef _HEADER_FLAT_MAP
+#define _HEADER_FLAT_MAP
+
+#include "common.hpp"
+
+namespace propane
+{
+    // Open addressing hash index (power of two size, linear probing) over an external array of entries.
+    // Buckets contain the precomputed hash of an entry along with the entry index plus one (zero marks an
+    // empty bucket), so probing stays within the bucket array and only entries of which the hash matches
+    // are compared. Rehashing uses the stored hashes and does not touch the entries.
+    class flat_hash_index
+    {
+    public:
+        static constexpr uint32_t invalid_entry = uint32_t(-1);
+
+        // Returns the index of the entry with the provided hash for which equal(index) holds,
+        // or invalid_entry if there is no such entry
+        template<typename equal_t> inline uint32_t find(size_t hash, equal_t equal) const
+        {
+            if (count == 0) return invalid_entry;
+
+            const uint32_t entry_hash = static_cast<uint32_t>(hash);
+            const size_t mask = buckets.size() - 1;
+            for (size_t idx = entry_hash & mask;; idx = (idx + 1) & mask)
+            {
+                const bucket& b = buckets[idx];
+                if (b.entry == 0) return invalid_entry;
+                if (b.hash == entry_hash && equal(b.entry - 1)) return b.entry - 1;
+            }
+        }
+        // Adds an entry, which should not be in the index yet
+        inline void insert(size_t hash, uint32_t entry)
+        {
+            if ((count + 1) * 2 > buckets.size()) rehash(std::max(buckets.size() * 2, min_bucket_count));
+            place(static_cast<uint32_t>(hash), entry + 1);
+            count++;
+        }
+        // Allocates the buckets for the provided amount of entries up front
+        // (the load factor is kept at or below one half)
+        inline void reserve(size_t entry_count)
+        {
+            size_t bucket_count = min_bucket_count;
+            while (bucket_count < entry_count * 2) bucket_count <<= 1;
+            if (bucket_count > buckets.size()) rehash(bucket_count);
+        }
+
+        inline void clear() noexcept
+        {
+            buckets.clear();
+            count = 0;
+        }
+        inline size_t size() const noexcept
+        {
+            return count;
+        }
+        // Allocated size of the buckets in bytes
+        inline size_t memory_usage() const noexcept
+        {
+            return buckets.capacity() * sizeof(bucket);
+        }
+
+    private:
+        struct bucket
+        {
+            uint32_t hash = 0;
+            uint32_t entry = 0;
+        };
+        static constexpr size_t min_bucket_count = 16;
+
+        inline void place(uint32_t hash, uint32_t entry) noexcept
+        {
+            const size_t mask = buckets.size() - 1;
+            size_t idx = hash & mask;
+            while (buckets[idx].entry != 0) idx = (idx + 1) & mask;
+            buckets[idx].hash = hash;
+            buckets[idx].entry = entry;
+        }
+        void rehash(size_t bucket_count)
+        {
+            vector<bucket> previous(bucket_count);
+            std::swap(previous, buckets);
+            for (const bucket& b : previous)
+            {
+                if (b.entry != 0) place(b.hash, b.entry);
+            }
+        }
+
+        vector<bucket> buckets;
+        size_t count = 0;
+    };
+
+    // Hash map with byte string keys, built on the flat hash index. Keys are copied into a single
+    // string arena and referred to by offset (which remains valid when the arena grows), values are
+    // stored contiguously in insertion order. Entries cannot be removed other than by clearing the map.
+    template<typename value_t> class flat_map
+    {
+    public:
+        struct entry
+        {
+            template<typename... arg_t> entry(uint32_t offset, uint32_t length, arg_t&&... arg) :
+                offset(offset),
+                length(length),
+                value(std::forward<arg_t>(arg)...) {}
+
+            uint32_t offset;
+            uint32_t length;
+            value_t value;
+        };
+
+        inline value_t* find(string_view key) noexcept
+        {
+            const uint32_t idx = find_entry(key);
+            return idx == flat_hash_index::invalid_entry ? nullptr : &entries[idx].value;
+        }
+        inline const value_t* find(string_view key) const noexcept
+        {
+            const uint32_t idx = find_entry(key);
+            return idx == flat_hash_index::invalid_entry ? nullptr : &entries[idx].value;
+        }
+        inline value_t* find(const vector<uint8_t>& key) noexcept
+        {
+            return find(make_key_view(key));
+        }
+        inline const value_t* find(const vector<uint8_t>& key) const noexcept
+        {
+            return find(make_key_view(key));
+        }
+
+        // Inserts the value if the key is not in the map yet,
+        // returns false (and leaves the current value) otherwise
+        template<typename... arg_t> inline bool emplace(string_view key, arg_t&&... arg)
+        {
+            const size_t hash = fnv::hash(key.data(), key.size());
+            if (find_entry(key, hash) != flat_hash_index::invalid_entry) return false;
+
+            const uint32_t idx = static_cast<uint32_t>(entries.size());
+            entries.emplace_back(static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(key.size()), std::forward<arg_t>(arg)...);
+            strings.insert(strings.end(), key.begin(), key.end());
+            index.insert(hash, idx);
+            return true;
+        }
+        template<typename... arg_t> inline bool emplace(const vector<uint8_t>& key, arg_t&&... arg)
+        {
+            return emplace(make_key_view(key), std::forward<arg_t>(arg)...);
+        }
+
+        // Allocates storage for the provided amount of entries (and total key length) up front
+        inline void reserve(size_t entry_count, size_t key_size = 0)
+        {
+            entries.reserve(entry_count);
+            strings.reserve(key_size);
+            index.reserve(entry_count);
+        }
+        inline void clear() noexcept
+        {
+            entries.clear();
+            strings.clear();
+            index.clear();
+        }
+
+        // Key of an entry (valid until the next insertion)
+        inline string_view key(const entry& e) const noexcept
+        {
+            return string_view(strings.data() + e.offset, e.length);
+        }
+
+        inline bool empty() const noexcept
+        {
+            return entries.empty();
+        }
+        inline size_t size() const noexcept
+        {
+            return entries.size();
+        }
+        // Allocated size of the entries, keys and index in bytes
+        inline size_t memory_usage() const noexcept
+        {
+            return entries.capacity() * sizeof(entry) + strings.capacity() + index.memory_usage();
+        }
+        inline const entry* begin() const noexcept
+        {
+            return entries.data();
+        }
+        inline const entry* end() const noexcept
+        {
+            return entries.data() + entries.size();
+        }
+
+    private:
+        static inline string_view make_key_view(const vector<uint8_t>& key) noexcept
+        {
+            return string_view(reinterpret_cast<const char*>(key.data()), key.size());
+        }
+        inline uint32_t find_entry(string_view key) const noexcept
+        {
+            return find_entry(key, fnv::hash(key.data(), key.size()));
+        }
+        inline uint32_t find_entry(string_view key, size_t hash) const noexcept
+        {
+            return index.find(hash, [&](uint32_t idx)
+            {
+                const entry& e = entries[idx];
+                return e.length == key.size() && memcmp(strings.data() + e.offset, key.data(), key.size()) == 0;
+            });
+        }
+
+        vector<entry> entries;
+        string strings;
+        flat_hash_index index;
+    };
+}
+
+#endif
\ No newline at end of file
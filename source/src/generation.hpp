@@ -55,6 +55,7 @@ namespace propane
 
             flags |= (extended_flags::is_defined | extended_flags::is_resolved);
             total_size = btype_info.size;
+            alignment = get_base_type_alignment(btype_info.index);
         }
 
         // Type
@@ -83,6 +84,7 @@ namespace propane
         vector<field> fields;
 
         size_t total_size = 0;
+        size_t alignment = 1;
 
         inline bool is_integral() const noexcept
         {
@@ -127,6 +129,10 @@ namespace propane
         {
             return flags & type_flags::is_union;
         }
+        inline bool is_packed() const noexcept
+        {
+            return flags & type_flags::is_packed;
+        }
 
         inline bool is_defined() const noexcept
         {
@@ -351,6 +357,8 @@ namespace propane
 
         static gen_intermediate_data merge(gen_intermediate_data&& lhs_data, gen_intermediate_data&& rhs_data);
         static gen_intermediate_data merge(const intermediate& lhs, const intermediate& rhs);
+        // Merges all sources into the first one (contents of the sources are consumed)
+        static gen_intermediate_data merge(span<gen_intermediate_data> sources);
 
         void initialize_base_types();
         void restore_lookup_tables();
@@ -359,16 +367,20 @@ namespace propane
         indexed_vector<type_idx, gen_type> types;
         indexed_vector<method_idx, gen_method> methods;
         indexed_vector<signature_idx, gen_signature> signatures;
-        unordered_map<vector<uint8_t>, signature_idx, key_hash, key_compare> signature_lookup;
+        flat_map<signature_idx> signature_lookup;
 
         indexed_vector<offset_idx, gen_field_offset> offsets;
-        unordered_map<vector<uint8_t>, offset_idx, key_hash, key_compare> offset_lookup;
+        flat_map<offset_idx> offset_lookup;
 
         gen_data_table globals;
         gen_data_table constants;
 
         gen_database database;
         gen_metatable metatable;
+        // Identity of the shared identifier interner the names were interned in (zero if none),
+        // and the interner index of every name in the database
+        uint64_t name_table = 0;
+        indexed_vector<name_idx, name_idx> name_keys;
 
         inline file_meta make_meta(type_idx type) const noexcept
         {
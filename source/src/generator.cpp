@@ -49,6 +49,10 @@
     "Method is expecting a return value (see declaration for '%' at %)", method_name, method_meta)
 #define VALIDATE_CONST_ADDR(expr) VALIDATE(ERRC::GNR_INVALID_CONSTANT_ADDR, expr, \
     "Constant address cannot have modifiers or prefixes")
+#define VALIDATE_BLOCK_STATE(expr, block_state) VALIDATE(ERRC::GNR_INVALID_BLOCK, expr, \
+    "Instruction block %", block_state)
+#define VALIDATE_BLOCK_INSTRUCTION(expr, instruction) VALIDATE(ERRC::GNR_INVALID_BLOCK_INSTRUCTION, expr, \
+    "% can not be recorded in an instruction block", instruction)
 
 #define VALIDATE_INDEX(id, max) { VALIDATE_INDEX_VALUE(id); VALIDATE_INDEX_RANGE(id, max); }
 #define VALIDATE_TYPE(id, max) { VALIDATE_INDEX(id, max); VALIDATE_NONVOID(id); }
@@ -74,7 +78,9 @@ namespace propane
             }
             else
             {
-                return database.emplace(identifier, lookup_idx::make_identifier()).key;
+                const name_idx key = database.emplace(identifier, lookup_idx::make_identifier()).key;
+                if (interner) name_keys.push_back(interner->intern(identifier));
+                return key;
             }
         }
 
@@ -124,6 +130,12 @@ namespace propane
             }
         }
 
+        void release_method_writers()
+        {
+            for (auto& it : free_method_writers) delete it;
+            free_method_writers.clear();
+        }
+
         inline gen_data_table& get_data_table(lookup_type type)
         {
             switch (type)
@@ -138,6 +150,9 @@ namespace propane
         // Writer objects, get released in the deconstructor or in finalize
         indexed_vector<type_idx, generator::type_writer*> type_writers;
         indexed_vector<method_idx, generator::method_writer*> method_writers;
+        // Writers of finalized methods, reused by the next method definitions
+        // (their tables retain their memory, all writers are released together)
+        vector<generator::method_writer*> free_method_writers;
 
         // Meta index for the current intermediate (0 if defined)
         meta_idx meta_index = meta_idx::invalid;
@@ -145,6 +160,9 @@ namespace propane
 
         vector<uint8_t> keybuf;
 
+        // Shared identifier table (optional)
+        identifier_interner* interner = nullptr;
+
 
         inline file_meta get_meta() const
         {
@@ -194,6 +212,39 @@ namespace propane
         NOCOPY_CLASS_DEFAULT(method_writer_impl, generator_impl&, name_idx name, method_idx index, signature_idx signature);
         ~method_writer_impl();
 
+        // Prepare a writer of a finalized method for the next method
+        // (tables are cleared, but retain their memory)
+        void reset(name_idx new_name, method_idx new_index, signature_idx new_signature)
+        {
+            vector<uint8_t> buffer = std::move(bytecode);
+            static_cast<gen_method&>(*this) = gen_method(new_name, new_index);
+            bytecode = std::move(buffer);
+            bytecode.clear();
+
+            call_lookup.clear();
+            global_lookup.clear();
+            offset_index_lookup.clear();
+            label_locations.clear();
+            branch_locations.clear();
+            named_labels.clear();
+            label_declarations.clear();
+            last_return = 0;
+            block_offset = no_block;
+
+            initialize(new_signature);
+        }
+        void initialize(signature_idx method_signature)
+        {
+            flags |= extended_flags::is_defined;
+            signature = method_signature;
+            const auto& sig = gen.signatures[signature];
+            parameter_count = sig.parameters.size();
+            expects_return_value = sig.has_return_value();
+
+            meta.index = gen.meta_index;
+            meta.line_number = gen.line_number;
+        }
+
 
         // Lookup tables, to prevent duplicate indices
         unordered_map<method_idx, uint32_t> call_lookup;
@@ -201,8 +252,14 @@ namespace propane
         unordered_map<offset_idx, uint32_t> offset_index_lookup;
 
         // Labels
-        unordered_map<label_idx, uint32_t> label_locations;
-        unordered_map<label_idx, vector<uint32_t>> unresolved_branches;
+        struct branch_location
+        {
+            label_idx label;
+            // Offset of the label operand in the bytecode
+            uint32_t offset;
+        };
+        indexed_vector<label_idx, uint32_t> label_locations; // Labels that have not been written yet are 'invalid_index'
+        vector<branch_location> branch_locations;
         database<uint32_t, label_idx> named_labels;
         indexed_vector<label_idx, uint32_t> label_declarations; // Unnamed labels will be added to the declarations list as 'invalid_index'
 
@@ -210,6 +267,12 @@ namespace propane
         size_t last_return = 0;
         bool expects_return_value = false;
 
+        // Instruction block that is being recorded (see begin_block)
+        static constexpr size_t no_block = size_t(-1);
+        size_t block_offset = no_block;
+        size_t block_stack_count = 0;
+        size_t block_parameter_count = 0;
+
         generator_impl& gen;
 
 
@@ -245,46 +308,36 @@ namespace propane
 
         void resolve_labels()
         {
-            // Fetch all labels that have been referenced by a branch
-            map<uint32_t, vector<label_idx>> write_labels;
-            for (auto& branch : unresolved_branches)
+            // Write the locations of all labels that have been referenced by a branch
+            labels.reserve(branch_locations.size());
+            for (const auto& branch : branch_locations)
             {
-                auto label = label_locations.find(branch.first);
-                if (label == label_locations.end())
+                const uint32_t location = label_locations[branch.label];
+                if (location == invalid_index)
                 {
                     // Label location not known
-                    const auto label_name_index = label_declarations[branch.first];
+                    const auto label_name_index = label_declarations[branch.label];
                     if (label_name_index == invalid_index)
                     {
-                        VALIDATE_LABEL_DEF(false, static_cast<uint32_t>(branch.first));
+                        VALIDATE_LABEL_DEF(false, static_cast<uint32_t>(branch.label));
                     }
                     else
                     {
                         VALIDATE_LABEL_DEF(false, named_labels[label_name_index].name);
                     }
                 }
-                write_labels[label->second].push_back(label->first);
+                *reinterpret_cast<uint32_t*>(bytecode.data() + branch.offset) = location;
+                labels.push_back(location);
             }
 
-            // Export labels
-            labels.reserve(write_labels.size());
-            for (auto& label : write_labels)
+            // Export labels (sorted by location)
+            std::sort(labels.begin(), labels.end());
+            labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+            if (!labels.empty() && labels.back() >= bytecode.size())
             {
-                for (auto& branch_index : label.second)
-                {
-                    auto locations = unresolved_branches.find(branch_index);
-                    for (auto& offset : locations->second)
-                    {
-                        *reinterpret_cast<uint32_t*>(bytecode.data() + offset) = label.first;
-                    }
-                }
-                if (label.first >= bytecode.size())
-                {
-                    const bool expected = !gen.signatures[signature].has_return_value();
-                    VALIDATE_RET_VAL(expected, gen.database[name].name, gen.make_meta(index));
-                    write_ret();
-                }
-                labels.push_back(label.first);
+                const bool expected = !gen.signatures[signature].has_return_value();
+                VALIDATE_RET_VAL(expected, gen.database[name].name, gen.make_meta(index));
+                write_ret();
             }
         }
 
@@ -306,6 +359,13 @@ namespace propane
 
         bool validate_address(address addr) const
         {
+            if (block_offset != no_block)
+            {
+                // Global and field indices are local to the method
+                VALIDATE_BLOCK_INSTRUCTION(addr.header.type() != address_type::global, "Globals");
+                VALIDATE_BLOCK_INSTRUCTION(addr.header.modifier() != address_modifier::direct_field && addr.header.modifier() != address_modifier::indirect_field, "Fields");
+            }
+
             switch (addr.header.type())
             {
                 case address_type::stackvar:
@@ -355,8 +415,34 @@ namespace propane
             return true;
         }
 
+        inline void validate_unrecorded(const char* instruction) const
+        {
+            VALIDATE_BLOCK_INSTRUCTION(block_offset == no_block, instruction);
+        }
+        // Stack variables and parameters used by the block that is being recorded
+        inline void record_block_address(address addr) noexcept
+        {
+            const size_t count = size_t(addr.header.index()) + 1;
+            switch (addr.header.type())
+            {
+                case address_type::stackvar:
+                {
+                    if (addr.header.index() != address_header_constants::index_max) block_stack_count = std::max(block_stack_count, count);
+                }
+                break;
+
+                case address_type::parameter:
+                {
+                    block_parameter_count = std::max(block_parameter_count, count);
+                }
+                break;
+            }
+        }
+
         void write_address(address addr)
         {
+            if (block_offset != no_block) record_block_address(addr);
+
             address_data_t data(0);
 
             data.header = addr.header;
@@ -430,9 +516,7 @@ namespace propane
 
         void write_label(label_idx label)
         {
-            auto branch = unresolved_branches.find(label);
-            vector<uint32_t>& list = branch == unresolved_branches.end() ? unresolved_branches.emplace(label, vector<uint32_t>()).first->second : branch->second;
-            list.push_back(uint32_t(bytecode.size()));
+            branch_locations.push_back(branch_location{ label, uint32_t(bytecode.size()) });
 
             append_bytecode(uint32_t(0));
         }
@@ -478,6 +562,7 @@ namespace propane
         void write_branch(opcode op, label_idx label)
         {
             VALIDATE_INDEX(label, label_declarations.size());
+            validate_unrecorded("Branches");
 
             append_bytecode(op);
             write_label(label);
@@ -485,6 +570,7 @@ namespace propane
         void write_branch(opcode op, label_idx label, address lhs)
         {
             VALIDATE_INDEX(label, label_declarations.size());
+            validate_unrecorded("Branches");
             if (validate_address(lhs))
             {
                 append_bytecode(op);
@@ -496,6 +582,7 @@ namespace propane
         void write_branch(opcode op, label_idx label, address lhs, address rhs)
         {
             VALIDATE_INDEX(label, label_declarations.size());
+            validate_unrecorded("Branches");
             if (validate_address(lhs) && validate_operand(rhs))
             {
                 append_bytecode(op);
@@ -510,6 +597,7 @@ namespace propane
         {
             VALIDATE_ARRAY_LENGTH(switch_labels.size());
             VALIDATE_INDICES(switch_labels, label_declarations.size());
+            validate_unrecorded("Switches");
             if (validate_address(addr))
             {
                 append_bytecode(opcode::sw);
@@ -522,11 +610,38 @@ namespace propane
                 }
             }
         }
+        void write_sws(address addr, span<const switch_case> switch_cases)
+        {
+            VALIDATE_ARRAY_LENGTH(switch_cases.size());
+            for (const auto& it : switch_cases)
+            {
+                VALIDATE_INDEX(it.label, label_declarations.size());
+            }
+            validate_unrecorded("Switches");
+            if (validate_address(addr))
+            {
+                // Case values are followed by the labels,
+                // the linker sorts the cases and validates them against the operand type
+                append_bytecode(opcode::sws);
+                write_address(addr);
+
+                append_bytecode(static_cast<uint32_t>(switch_cases.size()));
+                for (const auto& it : switch_cases)
+                {
+                    append_bytecode(it.value);
+                }
+                for (const auto& it : switch_cases)
+                {
+                    write_label(it.label);
+                }
+            }
+        }
 
         void write_call(method_idx method, span<const address> args)
         {
             VALIDATE_INDEX(method, gen.methods.size());
             VALIDATE_PARAM_COUNT(args.size());
+            validate_unrecorded("Calls");
             if (validate_operands(args))
             {
                 append_bytecode(opcode::call);
@@ -555,6 +670,7 @@ namespace propane
         void write_callv(address addr, span<const address> args)
         {
             VALIDATE_PARAM_COUNT(args.size());
+            validate_unrecorded("Calls");
             if (validate_address(addr) && validate_operands(args))
             {
                 append_bytecode(opcode::callv);
@@ -570,6 +686,7 @@ namespace propane
         }
         void write_ret()
         {
+            validate_unrecorded("Returns");
             const bool expected = !gen.signatures[signature].has_return_value();
             VALIDATE_RET_VAL(expected, gen.database[name].name, gen.make_meta(index));
 
@@ -579,6 +696,7 @@ namespace propane
         }
         void write_retv(address addr)
         {
+            validate_unrecorded("Returns");
             const bool expected = gen.signatures[signature].has_return_value();
             VALIDATE_RET_VAL(expected, gen.database[name].name, gen.make_meta(index));
             if (validate_operand(addr))
@@ -600,6 +718,33 @@ namespace propane
             }
         }
 
+        // Vector operands are always addresses (there are no vector constants)
+        void write_vector_expression(opcode op, address lhs, address rhs)
+        {
+            if (validate_address(lhs) && validate_address(rhs))
+            {
+                append_bytecode(op);
+                write_subcode_zero();
+                write_address(lhs);
+                write_address(rhs);
+            }
+        }
+
+        // Bulk memory instructions take the length as third operand,
+        // only the fill value of mset can be a constant
+        void write_memory_expression(opcode op, address lhs, address rhs, address length)
+        {
+            const bool is_valid_rhs = op == opcode::mset ? validate_operand(rhs) : validate_address(rhs);
+            if (validate_address(lhs) && is_valid_rhs && validate_operand(length))
+            {
+                append_bytecode(op);
+                write_subcode_zero();
+                write_address(lhs);
+                write_operand(rhs);
+                write_operand(length);
+            }
+        }
+
         inline file_meta get_meta() const
         {
             return gen.get_meta();
@@ -675,6 +820,15 @@ namespace propane
         return self().fields;
     }
 
+    void generator::type_writer::set_packed()
+    {
+        self().flags |= type_flags::is_packed;
+    }
+    bool generator::type_writer::is_packed() const
+    {
+        return self().is_packed();
+    }
+
     void generator::type_writer::finalize()
     {
         auto& writer = self();
@@ -701,14 +855,7 @@ namespace propane
         gen_method(name, index),
         gen(gen)
     {
-        flags |= extended_flags::is_defined;
-        this->signature = signature;
-        const auto& sig = gen.signatures[signature];
-        this->parameter_count = sig.parameters.size();
-        this->expects_return_value = sig.has_return_value();
-
-        meta.index = gen.meta_index;
-        meta.line_number = gen.line_number;
+        initialize(signature);
     }
     method_writer_impl::~method_writer_impl()
     {
@@ -734,6 +881,16 @@ namespace propane
         return self().index;
     }
 
+    void generator::method_writer::reserve(size_t bytecode_size, size_t label_count)
+    {
+        auto& writer = self();
+
+        writer.bytecode.reserve(bytecode_size);
+        writer.label_declarations.reserve(label_count);
+        writer.label_locations.reserve(label_count);
+        writer.branch_locations.reserve(label_count);
+    }
+
     void generator::method_writer::push(span<const type_idx> types)
     {
         auto& writer = self();
@@ -763,6 +920,7 @@ namespace propane
             // New named label
             const label_idx next = label_idx(writer.label_declarations.size());
             writer.label_declarations.push_back(writer.named_labels.emplace(label_name, next).key);
+            writer.label_locations.push_back(invalid_index);
             return next;
         }
         return *find;
@@ -774,6 +932,7 @@ namespace propane
         // New unnamed label
         const label_idx next = label_idx(writer.label_declarations.size());
         writer.label_declarations.push_back(invalid_index);
+        writer.label_locations.push_back(invalid_index);
         return next;
     }
     void generator::method_writer::write_label(label_idx label)
@@ -782,8 +941,8 @@ namespace propane
 
         VALIDATE_INDEX(label, writer.label_declarations.size());
 
-        const auto find = writer.label_locations.find(label);
-        if (find != writer.label_locations.end())
+        uint32_t& location = writer.label_locations[label];
+        if (location != invalid_index)
         {
             const auto label_name_index = writer.label_declarations[label];
             if (label_name_index == invalid_index)
@@ -796,7 +955,7 @@ namespace propane
             }
         }
 
-        writer.label_locations.emplace(label, uint32_t(writer.bytecode.size()));
+        location = uint32_t(writer.bytecode.size());
     }
 
     void generator::method_writer::write_noop()
@@ -953,6 +1112,10 @@ namespace propane
     {
         self().write_sw(addr, switch_labels);
     }
+    void generator::method_writer::write_sws(address addr, span<const switch_case> switch_cases)
+    {
+        self().write_sws(addr, switch_cases);
+    }
 
     void generator::method_writer::write_call(method_idx method, span<const address> args)
     {
@@ -976,12 +1139,118 @@ namespace propane
         self().write_dump(addr);
     }
 
+    void generator::method_writer::write_vadd(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vadd, lhs, rhs);
+    }
+    void generator::method_writer::write_vsub(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vsub, lhs, rhs);
+    }
+    void generator::method_writer::write_vmul(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vmul, lhs, rhs);
+    }
+    void generator::method_writer::write_vdiv(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vdiv, lhs, rhs);
+    }
+    void generator::method_writer::write_vmin(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vmin, lhs, rhs);
+    }
+    void generator::method_writer::write_vmax(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vmax, lhs, rhs);
+    }
+    void generator::method_writer::write_vceq(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vceq, lhs, rhs);
+    }
+    void generator::method_writer::write_vcne(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vcne, lhs, rhs);
+    }
+    void generator::method_writer::write_vcgt(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vcgt, lhs, rhs);
+    }
+    void generator::method_writer::write_vcge(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vcge, lhs, rhs);
+    }
+    void generator::method_writer::write_vclt(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vclt, lhs, rhs);
+    }
+    void generator::method_writer::write_vcle(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vcle, lhs, rhs);
+    }
+    void generator::method_writer::write_vshf(address lhs, address rhs)
+    {
+        self().write_vector_expression(opcode::vshf, lhs, rhs);
+    }
+
+    void generator::method_writer::write_mcpy(address dst, address src, address length)
+    {
+        self().write_memory_expression(opcode::mcpy, dst, src, length);
+    }
+    void generator::method_writer::write_mset(address dst, address value, address length)
+    {
+        self().write_memory_expression(opcode::mset, dst, value, length);
+    }
+    void generator::method_writer::write_mcmp(address lhs, address rhs, address length)
+    {
+        self().write_memory_expression(opcode::mcmp, lhs, rhs, length);
+    }
+
+    void generator::method_writer::begin_block()
+    {
+        auto& writer = self();
+
+        VALIDATE_BLOCK_STATE(writer.block_offset == method_writer_impl::no_block, "has already been started");
+
+        writer.block_offset = writer.bytecode.size();
+        writer.block_stack_count = 0;
+        writer.block_parameter_count = 0;
+    }
+    generator::instruction_block generator::method_writer::end_block()
+    {
+        auto& writer = self();
+
+        VALIDATE_BLOCK_STATE(writer.block_offset != method_writer_impl::no_block, "has not been started");
+
+        // The instructions have been written into the method as well
+        instruction_block result;
+        result.bytecode = block<uint8_t>(writer.bytecode.data() + writer.block_offset, writer.bytecode.size() - writer.block_offset);
+        result.stack_count = writer.block_stack_count;
+        result.parameter_count = writer.block_parameter_count;
+        writer.block_offset = method_writer_impl::no_block;
+        return result;
+    }
+    void generator::method_writer::write_block(const instruction_block& instructions)
+    {
+        auto& writer = self();
+
+        if (instructions.stack_count > 0) VALIDATE_STACK_INDEX(instructions.stack_count - 1, writer.stackvars.size());
+        if (instructions.parameter_count > 0) VALIDATE_PARAM_INDEX(instructions.parameter_count - 1, writer.parameter_count);
+
+        if (writer.block_offset != method_writer_impl::no_block)
+        {
+            writer.block_stack_count = std::max(writer.block_stack_count, instructions.stack_count);
+            writer.block_parameter_count = std::max(writer.block_parameter_count, instructions.parameter_count);
+        }
+        writer.append_bytecode(instructions.bytecode.data(), instructions.bytecode.size());
+    }
+
     void generator::method_writer::finalize()
     {
         auto& writer = self();
         auto& gen = writer.gen;
 
         ASSERT(writer.bytecode.size() <= static_cast<size_t>(~uint32_t(0)), "Method bytecode exceeds maximum supported value");
+        VALIDATE_BLOCK_STATE(writer.block_offset == method_writer_impl::no_block, "has not been ended");
 
         // Ensure the method has returned a value
         if (writer.expects_return_value)
@@ -991,10 +1260,16 @@ namespace propane
 
         writer.resolve_labels();
 
-        gen.methods[writer.index] = std::move(writer);
-        gen.method_writers[writer.index] = nullptr;
+        // The method gets a copy of the bytecode that fits exactly,
+        // the buffer of the writer is kept for the next method
+        vector<uint8_t> buffer = std::move(writer.bytecode);
+        writer.bytecode.assign(buffer.begin(), buffer.end());
+        const method_idx index = writer.index;
+        gen.methods[index] = std::move(writer);
+        gen.method_writers[index] = nullptr;
+        writer.bytecode = std::move(buffer);
 
-        delete this;
+        gen.free_method_writers.push_back(this);
     }
 
 
@@ -1015,6 +1290,7 @@ namespace propane
         {
             if (it) delete it;
         }
+        release_method_writers();
     }
 
     generator::generator()
@@ -1026,6 +1302,16 @@ namespace propane
         auto& gen = self();
         gen.meta_index = gen.metatable.emplace(name);
     }
+    generator::generator(string_view name, identifier_interner& interner) : generator(name)
+    {
+        auto& gen = self();
+        gen.interner = &interner;
+        gen.name_table = interner.identity();
+        for (size_t i = 0; i < gen.database.size(); i++)
+        {
+            gen.name_keys.push_back(interner.intern(gen.database[name_idx(i)].name));
+        }
+    }
     generator::~generator()
     {
 
@@ -1048,7 +1334,7 @@ namespace propane
 
         make_key(return_type, parameter_types, gen.keybuf);
         auto find = gen.signature_lookup.find(gen.keybuf);
-        if (find == gen.signature_lookup.end())
+        if (!find)
         {
             const signature_idx index = signature_idx(gen.signatures.size());
 
@@ -1067,7 +1353,7 @@ namespace propane
         }
         else
         {
-            return find->second;
+            return *find;
         }
     }
 
@@ -1081,7 +1367,7 @@ namespace propane
 
         make_key(type, fields, gen.keybuf);
         auto find = gen.offset_lookup.find(gen.keybuf);
-        if (find == gen.offset_lookup.end())
+        if (!find)
         {
             // New offset
             block<name_idx> field_indices(fields.data(), fields.size());
@@ -1093,7 +1379,7 @@ namespace propane
         }
         else
         {
-            return find->second;
+            return *find;
         }
     }
 
@@ -1119,7 +1405,7 @@ namespace propane
         }
 
         auto find = gen.offset_lookup.find(gen.keybuf);
-        if (find == gen.offset_lookup.end())
+        if (!find)
         {
             block<name_idx> field_indices(base.name.field_names.size() + fields.size());
             name_idx* dst = field_indices.data();
@@ -1135,7 +1421,7 @@ namespace propane
         }
         else
         {
-            return find->second;
+            return *find;
         }
     }
 
@@ -1154,6 +1440,12 @@ namespace propane
 
         if (find->lookup == lookup_type::identifier)
         {
+            // Built-in vector types resolve to their array type
+            if (const vector_type_info* vector_type = find_vector_type(find.name))
+            {
+                return declare_array_type(vector_type->element, vector_type->lanes);
+            }
+
             // New type
             const type_idx index = type_idx(gen.types.size());
             *find = index;
@@ -1294,7 +1586,16 @@ namespace propane
         dst.meta.index = gen.meta_index;
         dst.meta.line_number = gen.line_number;
 
-        writer = new generator::method_writer(gen, dst.name, dst.index, signature);
+        if (gen.free_method_writers.empty())
+        {
+            writer = new generator::method_writer(gen, dst.name, dst.index, signature);
+        }
+        else
+        {
+            writer = gen.free_method_writers.back();
+            gen.free_method_writers.pop_back();
+            writer->self().reset(dst.name, dst.index, signature);
+        }
         return *writer;
     }
 
@@ -1317,6 +1618,7 @@ namespace propane
         {
             if (it) it->finalize();
         }
+        gen.release_method_writers();
 
         intermediate result;
         gen_intermediate_data::serialize(result, gen);
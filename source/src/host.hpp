@@ -9,6 +9,25 @@
 #define HOST_SYSTEM_OTHER 1
 #endif
 
+// Guard region faults can be trapped using signals (posix) or structured exception handling (msvc)
+#if defined(HOST_SYSTEM_OTHER) || defined(_MSC_VER)
+#define HOST_GUARDED_INVOKE 1
+#else
+#define HOST_GUARDED_INVOKE 0
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HOST_TIMESTAMP_COUNTER 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define HOST_TIMESTAMP_COUNTER 0
+#include <chrono>
+#endif
+
 namespace propane
 {
     struct hostmem
@@ -22,15 +41,69 @@ namespace propane
         }
     };
 
+    // Read-only memory image of which private views can be mapped
+    struct hostimage
+    {
+        // File descriptor or mapping handle
+        intptr_t handle;
+        // Read-only view of the image
+        hostmem memory;
+
+        inline operator bool() const noexcept
+        {
+            return memory.address != nullptr;
+        }
+    };
+
     namespace host
     {
         hostmem allocate(size_t);
-        bool protect(hostmem);
+        // Switch allocated memory to read-only
+        // (or read and execute, for generated code)
+        bool protect(hostmem, bool executable = false);
         void free(hostmem);
 
+        // Reserve read/write memory followed by an inaccessible guard region.
+        // Pages are only committed once they are accessed.
+        // (size of the returned memory excludes the guard region)
+        hostmem reserve_guarded(size_t len, size_t guard_len);
+        void free_guarded(hostmem, size_t guard_len);
+        // Invoke a function, trapping any access to the guard region of the memory.
+        // Returns false if the function was interrupted by such an access.
+        // The function can not have objects with destructors on the stack at the time of the access.
+        bool invoke_guarded(hostmem, size_t guard_len, void(*func)(void*), void* arg);
+
+        // Create an image containing a copy of the data. Images are backed by anonymous shared
+        // memory, which is not available on every platform (an empty image is returned instead).
+        hostimage create_image(const void* data, size_t len);
+        void free_image(hostimage);
+        // Map a private copy-on-write view of an image, which shares its pages with
+        // the image until they are written to. Views remain valid after freeing the image.
+        hostmem map_view(hostimage);
+        // Replace the contents of a view with an image of the same size in place
+        // (writes to the view are discarded, pages are shared with the new image again)
+        void remap_view(hostmem, hostimage);
+        void unmap_view(hostmem);
+
+        // Map a file into read-only memory
+        // (size of the returned memory is the file size)
+        hostmem map_file(const char*);
+        void unmap_file(hostmem);
+
         void* openlib(const char*);
         void closelib(void*);
         method_handle loadsym(void*, const char*);
+
+        // Monotonic timestamp for profiling
+        // (processor timestamp counter where available, nanoseconds otherwise)
+        inline uint64_t timestamp() noexcept
+        {
+#if HOST_TIMESTAMP_COUNTER
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
     }
 }
 
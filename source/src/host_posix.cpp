@@ -8,7 +8,14 @@
 #include <unistd.h>
 #include <cstdlib>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <dlfcn.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <atomic>
+#include <mutex>
+#include <string>
 
 namespace propane
 {
@@ -24,18 +31,232 @@ namespace propane
         const size_t full_size = ceil_page_size(len, page_size);
 
         // Allocate
-        void* address;
-        const int result = ::posix_memalign(&address, page_size, full_size);
-        return hostmem{ result == 0 ? address : nullptr, full_size };
+        void* const address = ::mmap(nullptr, full_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return hostmem{ address == MAP_FAILED ? nullptr : address, full_size };
     }
-    bool host::protect(hostmem mem)
+    bool host::protect(hostmem mem, bool executable)
     {
-        const int result = ::mprotect(mem.address, mem.size, PROT_READ);
+        const int result = ::mprotect(mem.address, mem.size, executable ? (PROT_READ | PROT_EXEC) : PROT_READ);
         return result == 0;
     }
     void host::free(hostmem mem)
     {
-        ::free(mem.address);
+        const int result = ::munmap(mem.address, mem.size);
+        ASSERT(result == 0, "Failed to release memory");
+    }
+
+    hostmem host::reserve_guarded(size_t len, size_t guard_len)
+    {
+        ASSERT(len, "Allocation length cannot be zero");
+
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        ASSERT(page_size, "Page size is zero");
+        const size_t full_size = ceil_page_size(len, page_size);
+        const size_t full_guard_size = ceil_page_size(guard_len, page_size);
+
+        // Reserve the entire range inaccessible, then open up everything before the guard
+        void* const address = ::mmap(nullptr, full_size + full_guard_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (address == MAP_FAILED) return hostmem{ nullptr, 0 };
+        if (::mprotect(address, full_size, PROT_READ | PROT_WRITE) != 0)
+        {
+            ::munmap(address, full_size + full_guard_size);
+            return hostmem{ nullptr, 0 };
+        }
+        return hostmem{ address, full_size };
+    }
+    void host::free_guarded(hostmem mem, size_t guard_len)
+    {
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const int result = ::munmap(mem.address, mem.size + ceil_page_size(guard_len, page_size));
+        ASSERT(result == 0, "Failed to release memory");
+    }
+
+    namespace
+    {
+        // Guard region of the innermost guarded invocation on this thread
+        struct guarded_invocation
+        {
+            const uint8_t* guard_begin;
+            const uint8_t* guard_end;
+            sigjmp_buf jump;
+            guarded_invocation* previous;
+        };
+        thread_local guarded_invocation* current_invocation = nullptr;
+
+        struct sigaction previous_segv_action;
+        struct sigaction previous_bus_action;
+
+        void guard_signal_handler(int sig, siginfo_t* info, void* context)
+        {
+            guarded_invocation* const invocation = current_invocation;
+            const uint8_t* const fault_address = static_cast<const uint8_t*>(info->si_addr);
+            if (invocation && fault_address >= invocation->guard_begin && fault_address < invocation->guard_end)
+            {
+                siglongjmp(invocation->jump, 1);
+            }
+
+            // Not ours, forward to the previous handler
+            const struct sigaction& previous = sig == SIGBUS ? previous_bus_action : previous_segv_action;
+            if (previous.sa_flags & SA_SIGINFO)
+            {
+                previous.sa_sigaction(sig, info, context);
+            }
+            else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+            {
+                previous.sa_handler(sig);
+            }
+            else
+            {
+                // Restore the default action, the fault triggers again after returning
+                ::sigaction(sig, &previous, nullptr);
+            }
+        }
+
+        void install_guard_signal_handler()
+        {
+            static std::once_flag installed;
+            std::call_once(installed, []()
+            {
+                struct sigaction action = {};
+                action.sa_sigaction = guard_signal_handler;
+                action.sa_flags = SA_SIGINFO | SA_NODEFER;
+                sigemptyset(&action.sa_mask);
+                ::sigaction(SIGSEGV, &action, &previous_segv_action);
+                ::sigaction(SIGBUS, &action, &previous_bus_action);
+            });
+        }
+    }
+
+    bool host::invoke_guarded(hostmem mem, size_t guard_len, void(*func)(void*), void* arg)
+    {
+        install_guard_signal_handler();
+
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        guarded_invocation invocation;
+        invocation.guard_begin = static_cast<const uint8_t*>(mem.address) + mem.size;
+        invocation.guard_end = invocation.guard_begin + ceil_page_size(guard_len, page_size);
+        invocation.previous = current_invocation;
+
+        if (sigsetjmp(invocation.jump, 1) != 0)
+        {
+            current_invocation = invocation.previous;
+            return false;
+        }
+
+        current_invocation = &invocation;
+        try
+        {
+            func(arg);
+        }
+        catch (...)
+        {
+            current_invocation = invocation.previous;
+            throw;
+        }
+        current_invocation = invocation.previous;
+        return true;
+    }
+
+    namespace
+    {
+        // Anonymous shared memory file (sealed against modification where possible)
+        int create_shared_file(size_t len)
+        {
+#if defined(__linux__) && defined(MFD_ALLOW_SEALING)
+            const int fd = ::memfd_create("propane_image", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+            static std::atomic<uint32_t> image_counter = 0;
+            const std::string name = "/propane_image_" + std::to_string(::getpid()) + '_' + std::to_string(image_counter++);
+            const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+            if (fd >= 0) ::shm_unlink(name.c_str());
+#endif
+            if (fd < 0) return -1;
+            if (::ftruncate(fd, static_cast<off_t>(len)) != 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+            return fd;
+        }
+    }
+
+    hostimage host::create_image(const void* data, size_t len)
+    {
+        ASSERT(len, "Image length cannot be zero");
+
+        const int fd = create_shared_file(len);
+        if (fd < 0) return hostimage{ -1, hostmem{ nullptr, 0 } };
+
+        // Write the data through a temporary shared mapping
+        void* const address = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            ::close(fd);
+            return hostimage{ -1, hostmem{ nullptr, 0 } };
+        }
+        memcpy(address, data, len);
+        ::munmap(address, len);
+
+#if defined(__linux__) && defined(F_ADD_SEALS)
+        ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+
+        void* const view = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(fd);
+            return hostimage{ -1, hostmem{ nullptr, 0 } };
+        }
+        return hostimage{ fd, hostmem{ view, len } };
+    }
+    void host::free_image(hostimage image)
+    {
+        const int result = ::munmap(image.memory.address, image.memory.size);
+        ASSERT(result == 0, "Failed to release image");
+        ::close(static_cast<int>(image.handle));
+    }
+    hostmem host::map_view(hostimage image)
+    {
+        void* const address = ::mmap(nullptr, image.memory.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, static_cast<int>(image.handle), 0);
+        return hostmem{ address == MAP_FAILED ? nullptr : address, image.memory.size };
+    }
+    void host::remap_view(hostmem view, hostimage image)
+    {
+        ASSERT(view.size == image.memory.size, "View size mismatch");
+
+        // Replacing the mapping discards the private copies of written pages
+        void* const address = ::mmap(view.address, view.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, static_cast<int>(image.handle), 0);
+        if (address == MAP_FAILED) memcpy(view.address, image.memory.address, view.size);
+    }
+    void host::unmap_view(hostmem view)
+    {
+        const int result = ::munmap(view.address, view.size);
+        ASSERT(result == 0, "Failed to unmap view");
+    }
+
+    hostmem host::map_file(const char* path)
+    {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return hostmem{ nullptr, 0 };
+
+        // Get file size
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+        {
+            ::close(fd);
+            return hostmem{ nullptr, 0 };
+        }
+        const size_t file_size = static_cast<size_t>(file_stat.st_size);
+
+        // Map (the mapping remains valid after closing the descriptor)
+        void* const address = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        return hostmem{ address == MAP_FAILED ? nullptr : address, file_size };
+    }
+    void host::unmap_file(hostmem mem)
+    {
+        const int result = ::munmap(mem.address, mem.size);
+        ASSERT(result == 0, "Failed to unmap file");
     }
 
     void* host::openlib(const char* path)
@@ -31,10 +31,11 @@ namespace propane
         void* const address = VirtualAlloc(nullptr, full_size, MEM_COMMIT, PAGE_READWRITE);
         return hostmem{ address, full_size };
     }
-    bool host::protect(hostmem mem)
+    bool host::protect(hostmem mem, bool executable)
     {
         DWORD old_protect;
-        const BOOL result = VirtualProtect(mem.address, mem.size, PAGE_READONLY, &old_protect);
+        const BOOL result = VirtualProtect(mem.address, mem.size, executable ? PAGE_EXECUTE_READ : PAGE_READONLY, &old_protect);
+        if (result && executable) FlushInstructionCache(GetCurrentProcess(), mem.address, mem.size);
         return result;
     }
     void host::free(hostmem mem)
@@ -43,6 +44,156 @@ namespace propane
         ASSERT(result, "Failed to release memory");
     }
 
+    hostmem host::reserve_guarded(size_t len, size_t guard_len)
+    {
+        ASSERT(len, "Allocation length cannot be zero");
+
+        SYSTEM_INFO system_info = { 0 };
+        GetSystemInfo(&system_info);
+        const size_t page_size = static_cast<size_t>(system_info.dwPageSize);
+        ASSERT(page_size, "Page size is zero");
+        const size_t full_size = ceil_page_size(len, page_size);
+        const size_t full_guard_size = ceil_page_size(guard_len, page_size);
+
+        // Reserve the entire range, then commit everything before the guard
+        // (committed pages do not take up physical memory until they are accessed)
+        void* const address = VirtualAlloc(nullptr, full_size + full_guard_size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!address) return hostmem{ nullptr, 0 };
+        if (!VirtualAlloc(address, full_size, MEM_COMMIT, PAGE_READWRITE))
+        {
+            VirtualFree(address, 0, MEM_RELEASE);
+            return hostmem{ nullptr, 0 };
+        }
+        return hostmem{ address, full_size };
+    }
+    void host::free_guarded(hostmem mem, size_t)
+    {
+        const BOOL result = VirtualFree(mem.address, 0, MEM_RELEASE);
+        ASSERT(result, "Failed to release memory");
+    }
+
+#if defined(_MSC_VER)
+    namespace
+    {
+        int guard_exception_filter(const EXCEPTION_POINTERS* exception, const uint8_t* guard_begin, const uint8_t* guard_end)
+        {
+            const EXCEPTION_RECORD& record = *exception->ExceptionRecord;
+            if (record.ExceptionCode == EXCEPTION_ACCESS_VIOLATION && record.NumberParameters >= 2)
+            {
+                const uint8_t* const fault_address = reinterpret_cast<const uint8_t*>(record.ExceptionInformation[1]);
+                if (fault_address >= guard_begin && fault_address < guard_end) return EXCEPTION_EXECUTE_HANDLER;
+            }
+            return EXCEPTION_CONTINUE_SEARCH;
+        }
+    }
+
+    bool host::invoke_guarded(hostmem mem, size_t guard_len, void(*func)(void*), void* arg)
+    {
+        SYSTEM_INFO system_info = { 0 };
+        GetSystemInfo(&system_info);
+        const uint8_t* const guard_begin = static_cast<const uint8_t*>(mem.address) + mem.size;
+        const uint8_t* const guard_end = guard_begin + ceil_page_size(guard_len, static_cast<size_t>(system_info.dwPageSize));
+
+        __try
+        {
+            func(arg);
+        }
+        __except (guard_exception_filter(GetExceptionInformation(), guard_begin, guard_end))
+        {
+            return false;
+        }
+        return true;
+    }
+#else
+    bool host::invoke_guarded(hostmem, size_t, void(*func)(void*), void* arg)
+    {
+        // Guard region faults can not be trapped without structured exception handling
+        func(arg);
+        return true;
+    }
+#endif
+
+    hostimage host::create_image(const void* data, size_t len)
+    {
+        ASSERT(len, "Image length cannot be zero");
+
+        // Pagefile-backed section
+        const uint64_t size = static_cast<uint64_t>(len);
+        HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+        if (!mapping) return hostimage{ 0, hostmem{ nullptr, 0 } };
+
+        // Write the data through a temporary view
+        void* const address = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, len);
+        if (!address)
+        {
+            CloseHandle(mapping);
+            return hostimage{ 0, hostmem{ nullptr, 0 } };
+        }
+        memcpy(address, data, len);
+        UnmapViewOfFile(address);
+
+        void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, len);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            return hostimage{ 0, hostmem{ nullptr, 0 } };
+        }
+        return hostimage{ reinterpret_cast<intptr_t>(mapping), hostmem{ view, len } };
+    }
+    void host::free_image(hostimage image)
+    {
+        const BOOL result = UnmapViewOfFile(image.memory.address);
+        ASSERT(result, "Failed to release image");
+        CloseHandle(reinterpret_cast<HANDLE>(image.handle));
+    }
+    hostmem host::map_view(hostimage image)
+    {
+        void* const address = MapViewOfFile(reinterpret_cast<HANDLE>(image.handle), FILE_MAP_COPY, 0, 0, image.memory.size);
+        return hostmem{ address, image.memory.size };
+    }
+    void host::remap_view(hostmem view, hostimage image)
+    {
+        ASSERT(view.size == image.memory.size, "View size mismatch");
+
+        // Views can not be replaced in place without releasing the address range first
+        memcpy(view.address, image.memory.address, view.size);
+    }
+    void host::unmap_view(hostmem view)
+    {
+        const BOOL result = UnmapViewOfFile(view.address);
+        ASSERT(result, "Failed to unmap view");
+    }
+
+    hostmem host::map_file(const char* path)
+    {
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return hostmem{ nullptr, 0 };
+
+        // Get file size
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0)
+        {
+            CloseHandle(file);
+            return hostmem{ nullptr, 0 };
+        }
+
+        // Map (the view remains valid after closing the handles)
+        void* address = nullptr;
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return hostmem{ address, static_cast<size_t>(file_size.QuadPart) };
+    }
+    void host::unmap_file(hostmem mem)
+    {
+        const BOOL result = UnmapViewOfFile(mem.address);
+        ASSERT(result, "Failed to unmap file");
+    }
+
     void* host::openlib(const char* path)
     {
         return LoadLibraryA(path);
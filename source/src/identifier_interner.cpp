@@ -0,0 +1,187 @@
+#include "propane_generator.hpp"
+#include "runtime.hpp"
+#include "errors.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace propane
+{
+    // Identifiers are divided over shards by hash, each with their own lock and storage.
+    // Indices are assigned from a shared counter, and the index to name table is stored in
+    // chunks that double in size, so entries never move once they have been published.
+    class identifier_interner_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(identifier_interner_data) :
+            shards(new shard[shard_count])
+        {
+            for (auto& it : chunks) it.store(nullptr, std::memory_order_relaxed);
+
+            // Unique per interner, so intermediates of different interners are never mistaken
+            // for each other (intermediates can outlive the process when stored on disk)
+            std::random_device device;
+            identity = (uint64_t(device()) << 32) ^ uint64_t(device()) ^
+                uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                uint64_t(reinterpret_cast<uintptr_t>(this));
+            if (identity == 0) identity = 1;
+
+            // Same order as the base types of every generator
+            for (size_t i = 0; i < base_type_count; i++) intern(base_types[i].name);
+            for (size_t i = 0; i < alias_type_count; i++) intern(alias_types[i].name);
+        }
+        ~identifier_interner_data()
+        {
+            for (size_t i = 0; i < chunk_count; i++)
+            {
+                delete[] chunks[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        name_idx intern(string_view identifier)
+        {
+            shard& dst = shards[fnv::hash(identifier.data(), identifier.size()) & (shard_count - 1)];
+
+            std::lock_guard<std::mutex> lock(dst.mutex);
+            auto find = dst.lookup.find(identifier);
+            if (find != dst.lookup.end()) return find->second;
+
+            const size_t next = count.fetch_add(1, std::memory_order_relaxed);
+            ASSERT(next < size_t(name_idx::invalid), "Identifier interner overflow");
+            const name_idx index = name_idx(next);
+
+            const string_view stored = dst.store(identifier);
+            entry& e = get_entry(index);
+            e.length = uint32_t(stored.size());
+            e.str.store(stored.data(), std::memory_order_release);
+
+            dst.lookup.emplace(stored, index);
+            return index;
+        }
+
+        string_view name(name_idx index) const
+        {
+            ASSERT(size_t(index) < count.load(std::memory_order_relaxed), "Identifier index out of range");
+
+            // Another thread might have reserved the index and not published the name yet
+            const entry& e = get_entry(index);
+            const char* str = e.str.load(std::memory_order_acquire);
+            while (!str)
+            {
+                std::this_thread::yield();
+                str = e.str.load(std::memory_order_acquire);
+            }
+            return string_view(str, e.length);
+        }
+
+        inline size_t size() const noexcept
+        {
+            return count.load(std::memory_order_relaxed);
+        }
+
+        uint64_t identity;
+
+    private:
+        static constexpr size_t shard_count = 16;
+        static constexpr size_t first_chunk_bits = 10;
+        static constexpr size_t chunk_count = 32 - first_chunk_bits + 1;
+        static constexpr size_t page_size = 1 << 14;
+
+        struct entry
+        {
+            std::atomic<const char*> str = nullptr;
+            uint32_t length = 0;
+        };
+
+        struct shard
+        {
+            std::mutex mutex;
+            unordered_map<string_view, name_idx> lookup;
+
+            string_view store(string_view str)
+            {
+                // Large strings get their own allocation
+                if (str.size() > page_size / 4)
+                {
+                    large.emplace_back(new char[str.size()]);
+                    memcpy(large.back().get(), str.data(), str.size());
+                    return string_view(large.back().get(), str.size());
+                }
+                if (pages.empty() || page_offset + str.size() > page_size)
+                {
+                    pages.emplace_back(new char[page_size]);
+                    page_offset = 0;
+                }
+                char* const dst = pages.back().get() + page_offset;
+                memcpy(dst, str.data(), str.size());
+                page_offset += str.size();
+                return string_view(dst, str.size());
+            }
+
+        private:
+            vector<std::unique_ptr<char[]>> pages;
+            vector<std::unique_ptr<char[]>> large;
+            size_t page_offset = 0;
+        };
+
+        entry& get_entry(name_idx index) const
+        {
+            // Chunk n contains (1 << first_chunk_bits) << n entries
+            const uint64_t position = uint64_t(index) + (uint64_t(1) << first_chunk_bits);
+            size_t bit = 63;
+            while (!(position & (uint64_t(1) << bit))) bit--;
+            const size_t chunk = bit - first_chunk_bits;
+            const size_t offset = size_t(position - (uint64_t(1) << bit));
+
+            entry* ptr = chunks[chunk].load(std::memory_order_acquire);
+            if (!ptr)
+            {
+                entry* allocated = new entry[(size_t(1) << first_chunk_bits) << chunk];
+                if (chunks[chunk].compare_exchange_strong(ptr, allocated, std::memory_order_acq_rel))
+                {
+                    ptr = allocated;
+                }
+                else
+                {
+                    delete[] allocated;
+                }
+            }
+            return ptr[offset];
+        }
+
+        std::unique_ptr<shard[]> shards;
+        mutable std::atomic<entry*> chunks[chunk_count];
+        std::atomic<size_t> count = 0;
+    };
+    constexpr size_t identifier_interner_data_handle_size = approximate_handle_size(sizeof(identifier_interner_data));
+
+    identifier_interner::identifier_interner()
+    {
+
+    }
+    identifier_interner::~identifier_interner()
+    {
+
+    }
+
+    name_idx identifier_interner::intern(string_view identifier)
+    {
+        return self().intern(identifier);
+    }
+    string_view identifier_interner::name(name_idx index) const
+    {
+        return self().name(index);
+    }
+    size_t identifier_interner::size() const noexcept
+    {
+        return self().size();
+    }
+
+    uint64_t identifier_interner::identity() const noexcept
+    {
+        return self().identity;
+    }
+}
\ No newline at end of file
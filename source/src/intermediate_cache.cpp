@@ -0,0 +1,108 @@
+#include "propane_intermediate.hpp"
+#include "common.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace propane
+{
+    namespace
+    {
+        // Keys are stored on disk, so the hash is 64 bit on all architectures (FNV-1a)
+        constexpr uint64_t key_offset = 14695981039346656037ull;
+        constexpr uint64_t key_prime = 1099511628211ull;
+
+        inline uint64_t append_key(uint64_t hash, const uint8_t* ptr, size_t len) noexcept
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                hash ^= uint64_t(ptr[i]);
+                hash *= key_prime;
+            }
+            return hash;
+        }
+
+        std::atomic<uint64_t> temporary_file_counter = 0;
+    }
+
+    intermediate_cache::intermediate_cache(string_view directory_path) :
+        directory_path(directory_path)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(this->directory_path), error);
+    }
+
+    uint64_t intermediate_cache::make_key(span<const uint8_t> input, uint64_t seed) noexcept
+    {
+        // Hash the version first, so entries of different toolchains never collide
+        const toolchain_version version = toolchain_version::current();
+        uint64_t hash = append_key(key_offset ^ seed, reinterpret_cast<const uint8_t*>(&version), sizeof(version));
+        const uint64_t length = uint64_t(input.size());
+        hash = append_key(hash, reinterpret_cast<const uint8_t*>(&length), sizeof(length));
+        return append_key(hash, input.data(), input.size());
+    }
+    uint64_t intermediate_cache::make_key(string_view input, uint64_t seed) noexcept
+    {
+        return make_key(span<const uint8_t>(reinterpret_cast<const uint8_t*>(input.data()), input.size()), seed);
+    }
+
+    intermediate intermediate_cache::find(uint64_t key) const
+    {
+        intermediate result;
+        if (!result.load_mapped(make_path(key).c_str()) || !result.is_compatible())
+        {
+            return intermediate();
+        }
+        return result;
+    }
+    bool intermediate_cache::store(uint64_t key, const intermediate& im) const
+    {
+        if (!im.is_valid()) return false;
+
+        const string path = make_path(key);
+
+        // Temporary file names are unique per process, thread and write
+        const uint64_t unique = append_key(key_offset,
+            reinterpret_cast<const uint8_t*>(&key), sizeof(key)) ^
+            uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id())) ^
+            uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+            (temporary_file_counter.fetch_add(1, std::memory_order_relaxed) << 48);
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%016llx.tmp", static_cast<unsigned long long>(unique));
+        const string temporary_path = path + suffix;
+
+        {
+            const span<const uint8_t> bytes = im.data();
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+            file.close();
+            if (!file)
+            {
+                std::error_code error;
+                std::filesystem::remove(temporary_path, error);
+                return false;
+            }
+        }
+
+        // Replace atomically, readers either see the previous entry or the complete new entry
+        std::error_code error;
+        std::filesystem::rename(temporary_path, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    string intermediate_cache::make_path(uint64_t key) const
+    {
+        char file_name[32];
+        snprintf(file_name, sizeof(file_name), "%016llx.pint", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(directory_path) / file_name).string();
+    }
+}
\ No newline at end of file
@@ -1,8 +1,26 @@
 #include "intermediate_data.hpp"
 #include "constants.hpp"
+#include "host.hpp"
 
 namespace propane
 {
+    intermediate::intermediate(intermediate&& other) noexcept :
+        storage(std::move(other.storage)),
+        content(other.content)
+    {
+        other.content = span<const uint8_t>();
+    }
+    intermediate& intermediate::operator=(intermediate&& other) noexcept
+    {
+        if (this != &other)
+        {
+            storage = std::move(other.storage);
+            content = other.content;
+            other.content = span<const uint8_t>();
+        }
+        return *this;
+    }
+
     bool intermediate::is_valid() const noexcept
     {
         return constants::validate_intermediate_header(content);
@@ -33,10 +51,60 @@ namespace propane
     {
         if (!constants::validate_intermediate_header(from_bytes)) return false;
 
-        content = block<uint8_t>(from_bytes.data(), from_bytes.size());
+        auto copy = std::make_shared<block<uint8_t>>(from_bytes.data(), from_bytes.size());
+        content = span<const uint8_t>(copy->data(), copy->size());
+        storage = std::move(copy);
+        return true;
+    }
+    bool intermediate::load_mapped(const char* file_path)
+    {
+        const hostmem mem = host::map_file(file_path);
+        if (!mem) return false;
+
+        const span<const uint8_t> mapped_bytes(reinterpret_cast<const uint8_t*>(mem.address), mem.size);
+        if (!constants::validate_intermediate_header(mapped_bytes))
+        {
+            host::unmap_file(mem);
+            return false;
+        }
+
+        storage = std::shared_ptr<const void>(mem.address, [size = mem.size](const void* address)
+        {
+            host::unmap_file(hostmem{ const_cast<void*>(address), size });
+        });
+        content = mapped_bytes;
         return true;
     }
 
+    type_idx intermediate::find_type(string_view name) const noexcept
+    {
+        if (is_valid() && is_compatible())
+        {
+            const im_assembly_data& im_data = *reinterpret_cast<const im_assembly_data*>(content.data() + constants::im_data_offset);
+            const auto find = im_data.database.find(name);
+            if (find && find->lookup == lookup_type::type)
+            {
+                const im_type& t = im_data.types[find->type];
+                if (t.flags & extended_flags::is_defined) return t.index;
+            }
+        }
+        return type_idx::invalid;
+    }
+    method_idx intermediate::find_method(string_view name) const noexcept
+    {
+        if (is_valid() && is_compatible())
+        {
+            const im_assembly_data& im_data = *reinterpret_cast<const im_assembly_data*>(content.data() + constants::im_data_offset);
+            const auto find = im_data.database.find(name);
+            if (find && find->lookup == lookup_type::method)
+            {
+                const im_method& m = im_data.methods[find->method];
+                if (m.flags & extended_flags::is_defined) return m.index;
+            }
+        }
+        return method_idx::invalid;
+    }
+
     intermediate intermediate::operator+(const intermediate& other) const
     {
         if (&other != this && !other.content.empty())
@@ -61,15 +129,36 @@ namespace propane
         {
             if (content.empty())
             {
-                content = other.content;
+                *this = other;
+            }
+            else
+            {
+                gen_intermediate_data::serialize(*this, gen_intermediate_data::merge(*this, other));
+            }
+        }
+        return *this;
+    }
+    intermediate& intermediate::operator+=(intermediate&& other)
+    {
+        if (&other != this && !other.content.empty())
+        {
+            if (content.empty())
+            {
+                *this = std::move(other);
             }
             else
             {
                 gen_intermediate_data::serialize(*this, gen_intermediate_data::merge(*this, other));
+                other = intermediate();
             }
         }
         return *this;
     }
+    intermediate operator+(intermediate&& lhs, intermediate&& rhs)
+    {
+        lhs += std::move(rhs);
+        return std::move(lhs);
+    }
 
 
     void gen_intermediate_data::serialize(intermediate& dst, const gen_intermediate_data& data)
@@ -78,10 +167,12 @@ namespace propane
         writer.write_direct(constants::intermediate_header);
         writer.write_direct(toolchain_version::current());
         writer.write(data);
-        vector<uint8_t> serialized = writer.finalize();
+        vector<uint8_t> serialized = writer.finalize(constants::footer.size());
         append_bytecode(serialized, constants::footer);
 
-        dst.content = block<uint8_t>(serialized.data(), serialized.size());
+        auto result = std::make_shared<vector<uint8_t>>(std::move(serialized));
+        dst.content = span<const uint8_t>(result->data(), result->size());
+        dst.storage = std::move(result);
     }
     gen_intermediate_data gen_intermediate_data::deserialize(const intermediate& im)
     {
@@ -116,6 +207,8 @@ namespace propane
         vector<uint8_t> keybuf;
         keybuf.reserve(32);
 
+        signature_lookup.reserve(signatures.size());
+        offset_lookup.reserve(offsets.size());
         for (size_t i = 0; i < signatures.size(); i++)
         {
             const signature_idx index = signature_idx(i);
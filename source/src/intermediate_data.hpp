@@ -51,20 +51,23 @@ namespace propane
         im_data_table globals;
         im_data_table constants;
 
-        static_database<name_idx, lookup_idx> database;
+        // Names are indexed, so intermediates can be queried in place
+        static_indexed_database<name_idx, lookup_idx> database;
         static_database<meta_idx, void> metatable;
+        aligned_t<uint64_t, alignof(uint32_t)> name_table;
+        indexed_static_block<name_idx, name_idx> name_keys;
     };
 
-    using static_lookup_database_t = static_database<name_idx, lookup_idx>;
+    using static_lookup_database_t = static_indexed_database<name_idx, lookup_idx>;
     CUSTOM_SERIALIZER(gen_database, static_lookup_database_t)
     {
         inline static void write(block_writer & writer, const gen_database & value)
         {
-            value.serialize_database(writer);
+            value.serialize_indexed_database(writer);
         }
         inline static void read(const void*& data, gen_database & value)
         {
-            value.deserialize_database(*reinterpret_cast<const static_lookup_database_t*&>(data)++);
+            value.deserialize_database(reinterpret_cast<const static_lookup_database_t*&>(data)++->table);
         }
     };
 
@@ -81,13 +84,13 @@ namespace propane
         }
     };
 
-    SERIALIZABLE_PAIR(gen_type, im_type, name, index, flags, generated, fields, total_size, pointer_type, meta);
+    SERIALIZABLE_PAIR(gen_type, im_type, name, index, flags, generated, fields, total_size, alignment, pointer_type, meta);
     SERIALIZABLE_PAIR(gen_signature, im_signature, index, return_type, parameters, parameters_size);
     SERIALIZABLE_PAIR(gen_method, im_method, name, index, flags, signature, bytecode, labels, stackvars, method_stack_size, total_stack_size, calls, globals, offsets, meta);
     SERIALIZABLE_PAIR(gen_field_address, im_field_address, object_type, field_names);
     SERIALIZABLE_PAIR(gen_field_offset, im_field_offset, name, type, offset);
     SERIALIZABLE_PAIR(gen_data_table, im_data_table, info, data);
-    SERIALIZABLE_PAIR(gen_intermediate_data, im_assembly_data, types, methods, signatures, offsets, globals, constants, database, metatable);
+    SERIALIZABLE_PAIR(gen_intermediate_data, im_assembly_data, types, methods, signatures, offsets, globals, constants, database, metatable, name_table, name_keys);
 }
 
 #endif
\ No newline at end of file
@@ -1,10 +1,16 @@
 #include "assembly_data.hpp"
+#include "decoded_bytecode.hpp"
 #include "database.hpp"
 #include "errors.hpp"
 #include "library.hpp"
+#include "profiler.hpp"
+#include "utility.hpp"
+#include "vector_operations.hpp"
 
 #include <cmath>
+#include <deque>
 #include <iostream>
+#include <mutex>
 
 #define VALIDATE(errc, expr, ...) ENSURE(errc, expr, propane::runtime_exception, __VA_ARGS__)
 
@@ -22,83 +28,196 @@
     "Maximum callstack depth of % exceeded", max_depth)
 #define VALIDATE_RUNTIME_HASH(expr) VALIDATE(ERRC::RTM_RUNTIME_HASH_MISMATCH, expr, \
     "Runtime hash value mismatch")
+#define VALIDATE_INVOKE(expr, fmt, ...) VALIDATE(ERRC::RTM_INVALID_METHOD_INVOKE, expr, \
+    fmt, __VA_ARGS__)
+#define VALIDATE_INVOKE_ARGUMENTS(expr, fmt, ...) VALIDATE(ERRC::RTM_INVOKE_ARGUMENT_MISMATCH, expr, \
+    fmt, __VA_ARGS__)
+#define VALIDATE_EXTERNAL_SYMBOL(expr, name, library) VALIDATE(ERRC::RTM_UNRESOLVED_EXTERNAL_SYMBOL, expr, \
+    "Failed to resolve symbol for external method '%' (library '%')", name, library)
+#define VALIDATE_METHOD_BINDING(expr, name) VALIDATE(ERRC::RTM_INVOKE_ARGUMENT_MISMATCH, expr, \
+    "Signature of method '%' does not match the native signature it is bound to", name)
+#define VALIDATE_SNAPSHOT(expr) VALIDATE(ERRC::RTM_SNAPSHOT_MISMATCH, expr, \
+    "Attempted to restore a snapshot of a different assembly")
+#define VALIDATE_ALLOCATOR(expr) VALIDATE(ERRC::RTM_INVALID_ALLOCATOR, expr, \
+    "Runtime allocator requires both an allocate and a free method")
+#define VALIDATE_ALLOCATION(expr, size) VALIDATE(ERRC::RTM_ALLOCATION_FAILURE, expr, \
+    "Failed to allocate % bytes of runtime memory", size)
+
+// Computed goto dispatch for the pre-decoded instruction stream
+#if defined(__GNUC__) || defined(__clang__)
+#define INTERPRETER_THREADED_DISPATCH 1
+#else
+#define INTERPRETER_THREADED_DISPATCH 0
+#endif
+
+// Op implementations are forced inline so that the specialized handlers
+// can resolve the subcode switch at compile time
+#if defined(_MSC_VER)
+#define INTERPRETER_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define INTERPRETER_INLINE inline __attribute__((always_inline))
+#else
+#define INTERPRETER_INLINE inline
+#endif
 
 namespace propane
 {
-    class host_memory final
+    // Allocation methods of the runtime parameters (malloc/free if unassigned)
+    struct runtime_allocator
     {
-    public:
-        NOCOPY_CLASS_DEFAULT(host_memory, size_t len)
+        runtime_allocator() = default;
+        runtime_allocator(const runtime_parameters& parameters) :
+            allocate_method(parameters.allocate_method),
+            free_method(parameters.free_method) {}
+
+        inline uint8_t* allocate(size_t size) const
         {
-            handle = host::allocate(len);
+            return static_cast<uint8_t*>(allocate_method ? allocate_method(size) : malloc(size));
         }
-        ~host_memory()
+        inline void free(void* address, size_t size) const
         {
-            host::free(handle);
+            if (free_method) free_method(address, size);
+            else ::free(address);
         }
 
-        inline bool protect()
+        allocate_method_handle allocate_method = nullptr;
+        free_method_handle free_method = nullptr;
+    };
+
+    // Fixed size buffer allocated by a runtime allocator
+    class allocated_block final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(allocated_block) = default;
+        allocated_block(const uint8_t* data, size_t size, runtime_allocator allocator) :
+            allocator(allocator),
+            ptr(allocator.allocate(size)),
+            len(size)
+        {
+            VALIDATE_ALLOCATION(ptr != nullptr, size);
+            memcpy(ptr, data, size);
+        }
+        ~allocated_block()
         {
-            return host::protect(handle);
+            if (ptr) allocator.free(ptr, len);
         }
 
-        inline void* data() const noexcept
+        inline uint8_t* data() noexcept
         {
-            return handle.address;
+            return ptr;
         }
-        inline size_t size() const noexcept
+        inline const uint8_t* data() const noexcept
         {
-            return handle.size;
+            return ptr;
         }
-        inline operator bool() const noexcept
+        inline size_t size() const noexcept
         {
-            return handle;
+            return len;
         }
 
     private:
-        hostmem handle;
+        runtime_allocator allocator;
+        uint8_t* ptr = nullptr;
+        size_t len = 0;
     };
 
     struct stack_data_t
     {
-        stack_data_t(uint8_t* data, size_t capacity) :
-            data(data), capacity(capacity) {}
+        stack_data_t(uint8_t* data, size_t capacity, size_t guard_size = 0, runtime_allocator allocator = runtime_allocator()) :
+            data(data), capacity(capacity), guard_size(guard_size), allocator(allocator) {}
 
         ~stack_data_t()
         {
             if (data != nullptr)
             {
-                free(data);
+                if (guard_size > 0) host::free_guarded(hostmem{ data, capacity }, guard_size);
+                else allocator.free(data, capacity);
             }
         }
 
         uint8_t* const data;
         const size_t capacity;
+        // Size of the inaccessible region after the stack (zero if not guarded)
+        const size_t guard_size;
+        const runtime_allocator allocator;
         size_t size = 0;
+        // Largest size since creation (or the last reset)
+        size_t high_water = 0;
     };
 
-    class runtime_library
+    // Image of global values. Globals of interpreters are mapped as private copy-on-write views
+    // of an image, so only the pages that get written to are copied. Small globals (for which a
+    // mapping costs more than a copy) and platforms without anonymous shared memory use a plain
+    // copy of the values instead.
+    class global_image final
     {
     public:
-        struct call
+        static constexpr size_t min_image_size = 1 << 16;
+
+        NOCOPY_CLASS_DEFAULT(global_image) :
+            image{ 0, hostmem{ nullptr, 0 } } {}
+        global_image(const uint8_t* data, size_t size, runtime_allocator allocator = runtime_allocator()) :
+            image(size >= min_image_size ? host::create_image(data, size) : hostimage{ 0, hostmem{ nullptr, 0 } }),
+            copy((!image && size > 0) ? allocated_block(data, size, allocator) : allocated_block()) {}
+        ~global_image()
         {
-            call() = default;
-            call(const external_call_info& cinf) :
-                name(cinf.name),
-                forward(cinf.forward),
-                handle(cinf.handle) {}
+            if (image) host::free_image(image);
+        }
 
-            string_view name;
-            external_call::forward_method_handle forward = nullptr;
-            method_handle handle = nullptr;
-        };
+        inline const uint8_t* data() const noexcept
+        {
+            return image ? static_cast<const uint8_t*>(image.memory.address) : copy.data();
+        }
+        inline size_t size() const noexcept
+        {
+            return image ? image.memory.size : copy.size();
+        }
+
+        hostimage image;
+        allocated_block copy;
+    };
+
+    class global_memory final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(global_memory, const global_image& initial, runtime_allocator allocator) :
+            view(initial.image ? host::map_view(initial.image) : hostmem{ nullptr, 0 }),
+            copy((!view && initial.size() > 0) ? allocated_block(initial.data(), initial.size(), allocator) : allocated_block()) {}
+        ~global_memory()
+        {
+            if (view) host::unmap_view(view);
+        }
+
+        // Replace all values with the values of an image of the same size (in place)
+        void assign(const global_image& values)
+        {
+            if (size() == 0) return;
+            if (view && values.image) host::remap_view(view, values.image);
+            else memcpy(data(), values.data(), size());
+        }
+
+        inline uint8_t* data() noexcept
+        {
+            return view ? static_cast<uint8_t*>(view.address) : copy.data();
+        }
+        inline const uint8_t* data() const noexcept
+        {
+            return view ? static_cast<const uint8_t*>(view.address) : copy.data();
+        }
+        inline size_t size() const noexcept
+        {
+            return view ? view.size : copy.size();
+        }
 
-        runtime_library() = default;
-        runtime_library(string_view path) :
-            handle(path) {}
+        // Globals are mapped copy-on-write
+        inline bool is_mapped() const noexcept
+        {
+            return view;
+        }
 
-        host_library handle;
-        indexed_block<uint32_t, call> calls;
+    private:
+        hostmem view;
+        allocated_block copy;
     };
 
     struct data_table_view
@@ -117,6 +236,18 @@ namespace propane
         uint8_t* data;
     };
 
+    // Operand layouts that get their own handler specialization
+    enum class operand_layout : uint8_t
+    {
+        // No assumptions about either operand
+        generic,
+        // Both operands are plain frame variables (parameters, stack variables or return value)
+        frame_frame,
+        // Left hand side is a plain frame variable, right hand side is an immediate value
+        frame_immediate,
+    };
+    constexpr size_t operand_layout_count = 3;
+
     // Stack frame
     struct stack_frame_t
     {
@@ -126,9 +257,19 @@ namespace propane
             rptr(rptr),
             sptr(sptr),
             mptr(mptr) {}
+        stack_frame_t(const decoded_instruction* dptr, uint8_t* rptr, uint8_t* sptr, const method* mptr) :
+            dptr(dptr),
+            rptr(rptr),
+            sptr(sptr),
+            mptr(mptr) {}
 
-        // Current instruction at the time of calling
-        const uint8_t* iptr = nullptr;
+        union
+        {
+            // Current instruction at the time of calling
+            const uint8_t* iptr = nullptr;
+            // Current instruction at the time of calling (pre-decoded)
+            const decoded_instruction* dptr;
+        };
         //Address on the previous stack frame where the return value should go
         uint8_t* rptr = nullptr;
         // Position of the stack at the time of calling
@@ -141,76 +282,600 @@ namespace propane
     class interpreter final
     {
     public:
-        NOCOPY_CLASS_DEFAULT(interpreter, const assembly_data& asm_data, const method& main, const runtime_data& runtime, runtime_parameters parameters) :
-            stack(allocate_stack(parameters.min_stack_size, parameters.max_stack_size)),
-            global_data(asm_data.globals.data.data(), asm_data.globals.data.size()),
+        NOCOPY_CLASS_DEFAULT(interpreter, const assembly_data& asm_data, const runtime_data& runtime, runtime_parameters parameters) :
+            stack(allocate_stack(asm_data, parameters)),
+            owned_initial_globals(asm_data.globals.data.data(), asm_data.globals.data.size(), runtime_allocator(parameters)),
+            initial_globals(owned_initial_globals),
+            global_data(initial_globals, runtime_allocator(parameters)),
             global_tables(),
+            libraries(runtime.libraries),
+            rt_data(runtime),
             database(asm_data.database),
+            decoded_methods(owned_methods),
+            decoding(owned_decoding),
             data(asm_data),
             parameters(parameters),
             print_method(parameters.print_method == nullptr ? default_print_method : parameters.print_method)
         {
-            // Initialize externals
-            for (size_t i = 0; i < runtime.libraries.size(); i++)
+            // Externals are resolved once per runtime (usually already done while linking)
+            runtime.resolve_symbols();
+
+            global_tables[0] = data_table_view(asm_data.globals.info.data(), global_data.data());
+            global_tables[1] = data_table_view(asm_data.constants.info.data(), const_cast<uint8_t*>(asm_data.constants.data.data()));
+
+            // Decode all methods up front, or on their first call
+            if (parameters.predecode)
             {
-                const auto& init_lib = runtime.libraries[name_idx(i)];
+                allocate_methods();
+                if (!parameters.lazy_decode) decode_assembly();
+                inline_caches.resize(decoding.inline_cache_count);
+                if (parameters.profile) profiler.initialize(decoded_methods);
+                trace.initialize(parameters.trace_size);
+            }
+        }
+        // Create an interpreter that shares the decoded methods of a prototype.
+        // Only the stack, globals and inline caches are owned by the new interpreter, which
+        // allows any number of interpreters to execute the same prototype concurrently.
+        // Globals share their memory with the initial values of the prototype until written to.
+        // Methods that are not decoded yet get decoded by the first interpreter that calls them.
+        // The prototype needs to be pre-decoded, and can not use native code.
+        interpreter(const interpreter& prototype, print_method_handle print_method) :
+            stack(allocate_stack(prototype.data, prototype.parameters)),
+            initial_globals(prototype.initial_globals),
+            global_data(initial_globals, runtime_allocator(prototype.parameters)),
+            global_tables(),
+            libraries(prototype.libraries),
+            rt_data(prototype.rt_data),
+            database(prototype.database),
+            decoded_methods(prototype.decoded_methods),
+            decoding(prototype.decoding),
+            inline_caches(prototype.decoding.inline_cache_count),
+            data(prototype.data),
+            parameters(prototype.parameters),
+            print_method(print_method == nullptr ? prototype.print_method : print_method)
+        {
+            ASSERT(parameters.predecode && !parameters.jit, "Invalid prototype interpreter");
 
-                runtime_library lib(init_lib.name);
+            global_tables[0] = data_table_view(data.globals.info.data(), global_data.data());
+            global_tables[1] = prototype.global_tables[1];
 
-                lib.calls = indexed_block<uint32_t, runtime_library::call>(init_lib.calls.size());
-                auto src = init_lib.calls.data();
-                for (auto& it : lib.calls)
-                {
-                    it = runtime_library::call(*src++);
-                }
+            if (parameters.profile) profiler.initialize(decoded_methods);
+            trace.initialize(parameters.trace_size);
+        }
+
+        // Invoke a method with arguments laid out according to the parameter offsets of its signature.
+        // Only the stack and callstack are reset, globals retain their values between invocations.
+        void invoke(const method& entry, const uint8_t* arguments, size_t arguments_size, uint8_t* return_value, size_t return_value_size)
+        {
+            const size_t return_size = begin_invoke(entry, arguments, arguments_size);
+            VALIDATE_INVOKE_ARGUMENTS(return_value_size >= return_size,
+                "Return value buffer too small (% bytes provided where % were expected)", return_value_size, return_size);
 
-                // Preload symbols
-                if (init_lib.preload_symbols)
+            end_invoke(return_size);
+            if (return_size > 0) memcpy(return_value, stack.data, return_size);
+        }
+        // Execute the invocation of which the entry frame has been pushed (see begin_invoke).
+        // The return value is located at the front of the stack afterwards.
+        void end_invoke([[maybe_unused]] size_t return_size)
+        {
+            try
+            {
+                if (parameters.predecode)
                 {
-                    for (auto& call : lib.calls)
+                    if (parameters.sample_interval.count() > 0)
                     {
-                        if (call.handle) continue;
-
-                        if (!lib.handle.is_open())
-                        {
-                            const bool opened = lib.handle.open();
-                            ASSERT(opened, "Failed to load library");
-                        }
-                        call.handle = lib.handle.get_proc(call.name.data());
-                        ASSERT(call.handle, "Failed to find function");
+                        execute_sampled();
+                    }
+                    else
+                    {
+                        resume_decoded(std::numeric_limits<uint64_t>::max());
                     }
                 }
-
-                libraries.push_back(std::move(lib));
+                else
+                {
+                    execute();
+                }
+            }
+            catch (const runtime_exception& e)
+            {
+                flush_output();
+                if (is_traced()) throw_traced(e);
+                throw;
+            }
+            catch (...)
+            {
+                flush_output();
+                throw;
             }
+            flush_output();
 
-            global_tables[0] = data_table_view(asm_data.globals.info.data(), global_data.data());
-            global_tables[1] = data_table_view(asm_data.constants.info.data(), const_cast<uint8_t*>(asm_data.constants.data.data()));
+            ASSERT(stack.size == return_size, "Invalid stack size: %", stack.size);
+            ASSERT(callstack_depth == 0, "Invalid callstack depth: %", callstack_depth);
+        }
+        // Pass the buffered output to the print method (buffer capacity is retained)
+        void flush_output()
+        {
+            if (output_buffer.empty()) return;
+
+            // Strip the separator of the last batched dump
+            if (parameters.output_flush != output_flush_policy::every_dump) output_buffer.pop_back();
+            print_method(output_buffer.data(), output_buffer.size());
+            output_buffer.clear();
+        }
+        inline bool is_traced() const noexcept
+        {
+            return trace.enabled();
+        }
+        // Rethrow a runtime exception with the execution trace appended to the message
+        [[noreturn]] void throw_traced(const runtime_exception& e) const
+        {
+            string message = e.what();
+            message += "\nExecution trace (oldest first):\n";
+            message += format_trace();
+            message.pop_back();
+            throw runtime_exception(e.error_code(), message.c_str());
+        }
+        // Push the entry frame of an invocation without executing it.
+        // Returns the size of the return value, which is located at the front of the stack once the method has returned.
+        size_t begin_invoke(const method& entry, const uint8_t* arguments, size_t arguments_size)
+        {
+            VALIDATE_INVOKE(!entry.is_external(), "Method '%' is external and can not be invoked directly", database[entry.name]);
+            const signature& entry_signature = get_signature(entry.signature);
+            VALIDATE_INVOKE_ARGUMENTS(arguments_size == entry_signature.parameters_size,
+                "Argument size mismatch (% bytes provided where % were expected)", arguments_size, size_t(entry_signature.parameters_size));
+            const size_t return_size = get_type(entry_signature.return_type).total_size;
+
+            uint8_t* const param_ptr = push_entry_frame(entry, return_size);
+            if (arguments_size > 0) memcpy(param_ptr, arguments, arguments_size);
+
+            return return_size;
+        }
+        // Push the entry frame of an invocation without validating the method (see method_binding).
+        // Returns the parameters of the entry frame, to which the arguments have to be written before executing.
+        uint8_t* push_entry_frame(const method& entry, size_t return_size)
+        {
+            const signature& entry_signature = get_signature(entry.signature);
+
+            // Reset stack (in case a previous invocation was interrupted)
+            callstack_depth = 0;
+            clear_return_value();
 
             // Push space for the return value
-            constexpr size_t int_size = get_base_type_size(type_idx::i32);
-            stack.size = int_size;
+            VALIDATE_STACK_OVERFLOW(return_size <= stack.capacity, return_size, stack.capacity);
+            stack.size = return_size;
 
             // Push return type and stack frame
             stack_end = stack.data;
             param_offset = stack_offset = stack.data + stack.size;
-            sf = stack_frame_t(nullptr, stack.data, stack_end, nullptr);
-            push_stack_frame(main, get_signature(main.signature));
-
-            // Execute
-            execute();
+            if (parameters.predecode)
+            {
+                sf = stack_frame_t(static_cast<const decoded_instruction*>(nullptr), stack.data, stack_end, nullptr);
+                const decoded_method& entry_method = decoded_methods[entry.index];
+                push_decoded_frame<false, false>(entry_method, nullptr, stack_end);
+                if (parameters.profile)
+                {
+                    profiler.interrupt();
+                    profiler.enter(entry_method, host::timestamp());
+                }
+            }
+            else
+            {
+                sf = stack_frame_t(static_cast<const uint8_t*>(nullptr), stack.data, stack_end, nullptr);
+                push_stack_frame(entry, entry_signature);
+            }
+            return param_offset;
+        }
+        inline const uint8_t* return_value() const noexcept
+        {
+            return stack.data;
+        }
+        // Continue pre-decoded execution of the current invocation until the entry method returns,
+        // or until the step budget runs out (branches and calls each take one step).
+        // Returns true once the entry method has returned.
+        bool resume_decoded(uint64_t budget)
+        {
+            ASSERT(parameters.predecode, "Resumable execution requires pre-decoded methods");
 
-            // Fetch return code
-            ASSERT(stack.size >= int_size, "Invalid stack size: %", stack.size);
-            ASSERT(callstack_depth == 0, "Invalid callstack depth: %", callstack_depth);
-            return_code = *reinterpret_cast<const int32_t*>(stack.data);
+            step_budget = budget;
+            if (stack.guard_size > 0)
+            {
+                // Stack overflows fault on the guard region, which interrupts execution
+                const bool completed = host::invoke_guarded(hostmem{ stack.data, stack.capacity }, stack.guard_size, [](void* ctx)
+                {
+                    static_cast<interpreter*>(ctx)->execute_decoded<true, false>();
+                }, this);
+                VALIDATE_STACK_OVERFLOW(completed, stack.size, stack.capacity);
+            }
+            else if (parameters.profile)
+            {
+                execute_decoded<false, true>();
+            }
+            else
+            {
+                execute_decoded<false, false>();
+            }
+            return is_finished();
+        }
+        // Sampled execution suspends every sample_check_interval steps to check the clock,
+        // the callstack gets sampled once the sample interval has passed
+        void execute_sampled()
+        {
+            if (stack.guard_size > 0)
+            {
+                // Guarded once for the whole invocation rather than for every suspension
+                const bool completed = host::invoke_guarded(hostmem{ stack.data, stack.capacity }, stack.guard_size, [](void* ctx)
+                {
+                    static_cast<interpreter*>(ctx)->execute_sampled<true, false>();
+                }, this);
+                VALIDATE_STACK_OVERFLOW(completed, stack.size, stack.capacity);
+            }
+            else if (parameters.profile)
+            {
+                execute_sampled<false, true>();
+            }
+            else
+            {
+                execute_sampled<false, false>();
+            }
         }
+        template<bool guarded, bool profiled> void execute_sampled()
+        {
+            using clock = std::chrono::steady_clock;
+            clock::time_point next_sample = clock::now() + parameters.sample_interval;
+            step_budget = sample_check_interval;
+            for (;;)
+            {
+                execute_decoded<guarded, profiled>();
+                if (is_finished()) return;
 
-        inline operator int32_t() const noexcept
+                const clock::time_point now = clock::now();
+                if (now >= next_sample)
+                {
+                    sample_callstack();
+                    next_sample = now + parameters.sample_interval;
+                }
+            }
+        }
+        void sample_callstack()
+        {
+            // Suspended execution has written the current instruction back into the stack frame,
+            // the frames of the calling methods are stored at the start of every frame
+            sample_frames.clear();
+            for (stack_frame_t frame = sf; frame.mptr != nullptr; frame = *reinterpret_cast<const stack_frame_t*>(frame.sptr))
+            {
+                sample_frames.push_back(frame.mptr->index);
+            }
+            sampler.record(sample_frames, sf.dptr->offset);
+        }
+        // The entry frame restores the null instruction pointer of the initial frame once it returns
+        inline bool is_finished() const noexcept
+        {
+            return sf.dptr == nullptr;
+        }
+        inline const uint8_t* stack_data() const noexcept
         {
+            return stack.data;
+        }
+        int32_t execute_main(const method& main)
+        {
+            int32_t return_code = 0;
+            invoke(main, nullptr, 0, reinterpret_cast<uint8_t*>(&return_code), sizeof(return_code));
             return return_code;
         }
 
+        // Decode methods ahead of their first call (no effect for methods that are already decoded)
+        void prewarm(span<const method_idx> methods)
+        {
+            for (const method_idx method : methods)
+            {
+                VALIDATE_INVOKE(data.methods.is_valid_index(method), "Attempted to prewarm an invalid method (%)", static_cast<uint32_t>(method));
+                if (parameters.predecode) ensure_decoded(decoded_methods[method]);
+            }
+        }
+
+        // Restore globals to their initial values
+        void reset_globals()
+        {
+            global_data.assign(initial_globals);
+        }
+        // Restore globals from a snapshot (see context_snapshot)
+        void restore_globals(const global_image& values)
+        {
+            global_data.assign(values);
+        }
+        inline const global_memory& globals() const noexcept
+        {
+            return global_data;
+        }
+        inline global_memory& globals() noexcept
+        {
+            return global_data;
+        }
+
+        // Accumulate the counters of all call site caches
+        runtime_statistics statistics() const
+        {
+            runtime_statistics result;
+            for (const auto& cache : inline_caches)
+            {
+                result.inline_cache_hits += cache.hits;
+                result.inline_cache_misses += cache.misses;
+            }
+            return result;
+        }
+        void reset_statistics()
+        {
+            for (auto& cache : inline_caches)
+            {
+                cache.hits = 0;
+                cache.misses = 0;
+            }
+            if (parameters.profile) profiler.reset();
+            sampler.reset();
+            stack.high_water = stack.size;
+        }
+
+        // Memory used by the interpreter (assembly bytes are added by the owner of the assembly)
+        memory_statistics memory_usage() const
+        {
+            memory_statistics result;
+            result.stack_reserved = stack.capacity;
+            result.stack_high_water = stack.high_water;
+            result.global_bytes = global_data.size();
+            result.initial_global_bytes = initial_globals.size();
+            for (const decoded_method& it : decoded_methods)
+            {
+                // Methods that are not decoded yet can be decoding on another thread
+                if (!it.ready.load(std::memory_order_acquire)) continue;
+
+                result.decoded_bytes += it.instructions.capacity() * sizeof(decoded_instruction);
+                result.decoded_bytes += it.arguments.capacity() * sizeof(decoded_argument);
+                result.decoded_bytes += it.copies.capacity() * sizeof(decoded_copy);
+                result.decoded_bytes += it.switch_keys.capacity() * sizeof(uint64_t);
+                result.decoded_bytes += it.labels.capacity() * sizeof(const decoded_instruction*);
+            }
+            result.decoded_bytes += decoded_methods.capacity() * sizeof(decoded_method);
+            result.decoded_bytes += inline_caches.capacity() * sizeof(inline_cache);
+            result.output_buffer_bytes = output_buffer.capacity();
+            result.library_bytes = rt_data.memory_usage();
+            return result;
+        }
+
+        // Aggregate the call tree and instruction counts of the profiler
+        runtime_profile profile() const
+        {
+            runtime_profile result;
+            if (!parameters.profile || !parameters.predecode) return result;
+
+            const auto& nodes = profiler.call_tree();
+            for (uint32_t child = nodes[0].first_child; child != profile_node::invalid; child = nodes[child].next_sibling)
+            {
+                result.total_ticks += nodes[child].inclusive_ticks;
+            }
+
+            // Methods (inclusive ticks of recursive calls are already part of the outermost call)
+            vector<method_profile> methods(data.methods.size());
+            for (size_t i = 1; i < nodes.size(); i++)
+            {
+                const profile_node& node = nodes[i];
+                method_profile& dst = methods[size_t(node.method)];
+                dst.calls += node.calls;
+                dst.exclusive_ticks += node.exclusive_ticks;
+
+                bool recursive = false;
+                for (uint32_t parent = node.parent; parent != 0 && !recursive; parent = nodes[parent].parent)
+                {
+                    recursive = nodes[parent].method == node.method;
+                }
+                if (!recursive) dst.inclusive_ticks += node.inclusive_ticks;
+            }
+            vector<method_profile> called_methods;
+            for (size_t i = 0; i < methods.size(); i++)
+            {
+                if (methods[i].calls == 0) continue;
+
+                const method& m = data.methods[method_idx(i)];
+                method_profile& it = called_methods.emplace_back(methods[i]);
+                it.method = m.index;
+                it.name = database[m.name];
+                it.external = m.is_external();
+            }
+            std::stable_sort(called_methods.begin(), called_methods.end(), [](const method_profile& lhs, const method_profile& rhs)
+            {
+                return lhs.exclusive_ticks > rhs.exclusive_ticks;
+            });
+            result.methods = block<method_profile>(called_methods.data(), called_methods.size());
+
+            // Instructions and opcodes
+            vector<instruction_profile> instructions;
+            uint64_t opcode_counts[opcode_count + superinstruction::count] = {};
+            for (const auto& m : decoded_methods)
+            {
+                // Methods that were never entered have no counts (and might not be decoded)
+                const vector<uint64_t>& counts = profiler.counts(m.source->index);
+                for (size_t i = 0; i < counts.size(); i++)
+                {
+                    if (counts[i] == 0) continue;
+
+                    const decoded_instruction& ins = m.instructions[i];
+                    opcode_counts[size_t(ins.op)] += counts[i];
+                    instructions.push_back(instruction_profile{ m.source->index, ins.offset, profile_opcode_name(ins.op), counts[i] });
+                }
+            }
+            result.instructions = block<instruction_profile>(instructions.data(), instructions.size());
+
+            vector<opcode_profile> opcodes;
+            for (size_t i = 0; i < std::size(opcode_counts); i++)
+            {
+                if (opcode_counts[i] > 0) opcodes.push_back(opcode_profile{ profile_opcode_name(opcode(i)), opcode_counts[i] });
+            }
+            std::stable_sort(opcodes.begin(), opcodes.end(), [](const opcode_profile& lhs, const opcode_profile& rhs)
+            {
+                return lhs.count > rhs.count;
+            });
+            result.opcodes = block<opcode_profile>(opcodes.data(), opcodes.size());
+
+            // Folded stacks
+            string path;
+            for (size_t i = 1; i < nodes.size(); i++)
+            {
+                if (nodes[i].exclusive_ticks == 0) continue;
+
+                path.clear();
+                for (uint32_t node = uint32_t(i); node != 0; node = nodes[node].parent)
+                {
+                    const string_view name = database[data.methods[nodes[node].method].name];
+                    path.insert(0, name);
+                    if (nodes[node].parent != 0) path.insert(path.begin(), ';');
+                }
+                result.folded_stacks += path;
+                result.folded_stacks += ' ';
+                result.folded_stacks += std::to_string(nodes[i].exclusive_ticks);
+                result.folded_stacks += '\n';
+            }
+
+            return result;
+        }
+        // Aggregate the sampled callstacks
+        sample_profile samples() const
+        {
+            sample_profile result;
+            result.sample_count = sampler.samples();
+
+            const auto& nodes = sampler.call_tree();
+            vector<method_samples> methods(data.methods.size());
+            for (size_t i = 1; i < nodes.size(); i++)
+            {
+                const sample_node& node = nodes[i];
+                if (node.samples == 0) continue;
+
+                // Every sample counts once for every distinct method on its callstack
+                methods[size_t(node.method)].self_samples += node.samples;
+                for (uint32_t it = uint32_t(i); it != 0; it = nodes[it].parent)
+                {
+                    bool recursive = false;
+                    for (uint32_t parent = nodes[it].parent; parent != 0 && !recursive; parent = nodes[parent].parent)
+                    {
+                        recursive = nodes[parent].method == nodes[it].method;
+                    }
+                    if (!recursive) methods[size_t(nodes[it].method)].total_samples += node.samples;
+                }
+            }
+            vector<method_samples> sampled_methods;
+            for (size_t i = 0; i < methods.size(); i++)
+            {
+                if (methods[i].total_samples == 0) continue;
+
+                const method_idx index = method_idx(i);
+                method_samples& it = sampled_methods.emplace_back(methods[i]);
+                it.method = index;
+                it.name = database[data.methods[index].name];
+                it.meta = get_meta(data.methods[index]);
+            }
+            std::stable_sort(sampled_methods.begin(), sampled_methods.end(), [](const method_samples& lhs, const method_samples& rhs)
+            {
+                return lhs.self_samples > rhs.self_samples;
+            });
+            result.methods = block<method_samples>(sampled_methods.data(), sampled_methods.size());
+
+            vector<instruction_samples> instructions;
+            for (const auto& it : sampler.instructions())
+            {
+                instructions.push_back(instruction_samples{ method_idx(it.first >> 32), uint32_t(it.first), it.second });
+            }
+            std::sort(instructions.begin(), instructions.end(), [](const instruction_samples& lhs, const instruction_samples& rhs)
+            {
+                if (lhs.samples != rhs.samples) return lhs.samples > rhs.samples;
+                if (lhs.method != rhs.method) return lhs.method < rhs.method;
+                return lhs.offset < rhs.offset;
+            });
+            result.instructions = block<instruction_samples>(instructions.data(), instructions.size());
+
+            // Folded stacks
+            string path, frame_name;
+            for (size_t i = 1; i < nodes.size(); i++)
+            {
+                if (nodes[i].samples == 0) continue;
+
+                path.clear();
+                for (uint32_t node = uint32_t(i); node != 0; node = nodes[node].parent)
+                {
+                    const method_idx index = nodes[node].method;
+                    const file_meta meta = get_meta(data.methods[index]);
+                    frame_name = database[data.methods[index].name];
+                    if (!meta.file_name.empty())
+                    {
+                        frame_name += " (";
+                        frame_name += meta.file_name;
+                        frame_name += ':';
+                        frame_name += std::to_string(meta.line_number);
+                        frame_name += ')';
+                    }
+                    if (nodes[node].parent != 0) frame_name.insert(frame_name.begin(), ';');
+                    path.insert(0, frame_name);
+                }
+                result.folded_stacks += path;
+                result.folded_stacks += ' ';
+                result.folded_stacks += std::to_string(nodes[i].samples);
+                result.folded_stacks += '\n';
+            }
+
+            return result;
+        }
+        inline file_meta get_meta(const method& m) const
+        {
+            if (m.meta.index == meta_idx::invalid) return file_meta();
+            return file_meta(data.metatable[m.meta.index], m.meta.line_number);
+        }
+        // Format the trace buffer, one 'method (file:line) +offset: event' line per entry
+        string format_trace() const
+        {
+            format_writer result;
+            for (size_t i = 0; i < trace.size(); i++)
+            {
+                const trace_entry& entry = trace[i];
+                if (entry.method == method_idx::invalid)
+                {
+                    result << "invoke " << database[data.methods[method_idx(entry.value)].name] << '\n';
+                    continue;
+                }
+
+                const method& m = data.methods[entry.method];
+                result << database[m.name];
+                if (m.meta.index != meta_idx::invalid)
+                {
+                    result << " (" << data.metatable[m.meta.index] << ':' << m.meta.line_number << ')';
+                }
+                result << " +" << entry.offset << ": ";
+                switch (entry.event)
+                {
+                    case trace_event::call: result << "call " << database[data.methods[method_idx(entry.value)].name]; break;
+                    case trace_event::tail_call: result << "tail call " << database[data.methods[method_idx(entry.value)].name]; break;
+                    case trace_event::ret: result << "return"; break;
+                    case trace_event::branch: result << "branch to +" << entry.value; break;
+                }
+                result << '\n';
+            }
+            return result;
+        }
+        static string_view profile_opcode_name(opcode op)
+        {
+            switch (op)
+            {
+                case superinstruction::operation_branch: return "operation_branch";
+                case superinstruction::compare_branch: return "compare_branch";
+                case superinstruction::call_set: return "call_set";
+                case superinstruction::tail_call: return "tail_call";
+                case superinstruction::call_native: return "call_native";
+                default: return opcode_str(op);
+            }
+        }
+
+        inline const assembly_data& assembly_ref() const noexcept
+        {
+            return data;
+        }
+
     private:
         void execute()
         {
@@ -265,6 +930,7 @@ namespace propane
                     case opcode::bnz: bnz(); break;
 
                     case opcode::sw: sw(); break;
+                    case opcode::sws: sws(); break;
 
                     case opcode::call: call(); break;
                     case opcode::callv: callv(); break;
@@ -273,2252 +939,5130 @@ namespace propane
 
                     case opcode::dump: dump(); break;
 
+                    case opcode::vadd: vadd(); break;
+                    case opcode::vsub: vsub(); break;
+                    case opcode::vmul: vmul(); break;
+                    case opcode::vdiv: vdiv(); break;
+                    case opcode::vmin: vmin(); break;
+                    case opcode::vmax: vmax(); break;
+                    case opcode::vceq: vceq(); break;
+                    case opcode::vcne: vcne(); break;
+                    case opcode::vcgt: vcgt(); break;
+                    case opcode::vcge: vcge(); break;
+                    case opcode::vclt: vclt(); break;
+                    case opcode::vcle: vcle(); break;
+                    case opcode::vshf: vshf(); break;
+
+                    case opcode::mcpy: mcpy(); break;
+                    case opcode::mset: mset(); break;
+                    case opcode::mcmp: write<int32_t>(push_return_value(type_idx::i32)) = mcmp(); break;
+
                     default: ASSERT(false, "Malformed opcode: %", static_cast<uint32_t>(op));
                 }
             }
         }
 
-        void dump_assembly()
+        // Execute the pre-decoded instruction stream
+        // When compiled with threaded dispatch, the handler addresses get bound to the
+        // instructions during decoding (see decode_assembly)
+        // Guarded execution relies on the stack guard region instead of checking the stack size on every call.
+        // Branches and calls consume the step budget, once it runs out execution suspends at the current
+        // instruction (stored in the stack frame) and can be continued by calling this method again.
+        // The profiled instantiation counts every dispatch and times every call (see call_profiler).
+        template<bool guarded, bool profiled> void execute_decoded(const void* const** handler_table = nullptr)
         {
-            // Types
-            output_stream << "TYPES: " << std::endl;
-            for (size_t tidx = 0; tidx < data.types.size(); tidx++)
+#if INTERPRETER_THREADED_DISPATCH
+            static const void* const handlers[] =
             {
-                auto& t = data.types[type_idx(tidx)];
-
-                output_stream << tidx << ": " << get_name(t);
+                &&op_noop,
+                &&op_set,
+                &&op_conv,
+                &&op_ari_not,
+                &&op_ari_neg,
+                &&op_ari_mul,
+                &&op_ari_div,
+                &&op_ari_mod,
+                &&op_ari_add,
+                &&op_ari_sub,
+                &&op_ari_lsh,
+                &&op_ari_rsh,
+                &&op_ari_and,
+                &&op_ari_xor,
+                &&op_ari_or,
+                &&op_padd,
+                &&op_psub,
+                &&op_pdif,
+                &&op_cmp,
+                &&op_ceq,
+                &&op_cne,
+                &&op_cgt,
+                &&op_cge,
+                &&op_clt,
+                &&op_cle,
+                &&op_cze,
+                &&op_cnz,
+                &&op_br,
+                &&op_beq,
+                &&op_bne,
+                &&op_bgt,
+                &&op_bge,
+                &&op_blt,
+                &&op_ble,
+                &&op_bze,
+                &&op_bnz,
+                &&op_sw,
+                &&op_sws,
+                &&op_call,
+                &&op_callv,
+                &&op_ret,
+                &&op_retv,
+                &&op_dump,
+                &&op_vadd,
+                &&op_vsub,
+                &&op_vmul,
+                &&op_vdiv,
+                &&op_vmin,
+                &&op_vmax,
+                &&op_vceq,
+                &&op_vcne,
+                &&op_vcgt,
+                &&op_vcge,
+                &&op_vclt,
+                &&op_vcle,
+                &&op_vshf,
+                &&op_mcpy,
+                &&op_mset,
+                &&op_mcmp,
+                &&op_operation_branch,
+                &&op_compare_branch,
+                &&op_call_set,
+                &&op_tail_call,
+                &&op_call_native,
+            };
+            static_assert(sizeof(handlers) / sizeof(handlers[0]) == opcode_count + superinstruction::count, "Handler table size mismatch");
+
+            if (handler_table)
+            {
+                *handler_table = handlers;
+                return;
+            }
+
+#define DECODED_OP(name) op_##name
+#define DECODED_SUPERINSTRUCTION(name) op_##name
+#define DECODED_NEXT() if constexpr (profiled) profiler.count(ins); goto *ins->handler
+#else
+#define DECODED_OP(name) case opcode::name
+#define DECODED_SUPERINSTRUCTION(name) case superinstruction::name
+#define DECODED_NEXT() if constexpr (profiled) profiler.count(ins); continue
+#endif
+#define DECODED_STEP() if (steps-- == 0) { if constexpr (profiled) profiler.uncount(ins); sf.dptr = ins; return; }
+#define DECODED_LEAVE() if constexpr (profiled) profiler.leave(host::timestamp())
+#define DECODED_TRACE(event, from, value) if (trace.enabled()) trace.record(trace_event::event, sf.mptr->index, (from)->offset, (value))
+#define DECODED_BRANCH(from, taken, dst, next) if (taken) { DECODED_TRACE(branch, from, (dst)->offset); ins = (dst); } else { ins = (next); }
+
+            const decoded_instruction* ins = sf.dptr;
+            if (!ins) return;
+            uint64_t steps = step_budget;
+
+#if INTERPRETER_THREADED_DISPATCH
+            DECODED_NEXT();
+#else
+            for (;;) switch (ins->op)
+            {
+#endif
+                DECODED_OP(noop):
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(set):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(conv):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(ari_not):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_neg):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_mul):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_div):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_mod):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_add):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_sub):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_lsh):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_rsh):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_and):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_xor):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ari_or):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(padd):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(psub):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(pdif):
+                {
+                    const offset_t lhs = reinterpret_cast<offset_t>(dereference(resolve(ins->lhs, tmp_var[0])));
+                    const offset_t rhs = reinterpret_cast<offset_t>(dereference(resolve(ins->rhs, tmp_var[1])));
+                    write<offset_t>(stack_end) = (lhs - rhs) / offset_t(ins->value);
+                    ins++;
+                    DECODED_NEXT();
+                }
+
+                DECODED_OP(cmp):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(ceq):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cne):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cgt):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cge):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(clt):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cle):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cze):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(cnz):
+                    write<int32_t>(stack_end) = ins->comparison(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(br):
+                    DECODED_STEP();
+                    DECODED_TRACE(branch, ins, ins->target->offset);
+                    ins = ins->target;
+                    DECODED_NEXT();
+                DECODED_OP(beq):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(bne):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(bgt):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(bge):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(blt):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(ble):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(bze):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+                DECODED_OP(bnz):
+                    DECODED_STEP();
+                    DECODED_BRANCH(ins, ins->comparison(*this, *ins), ins->target, ins + 1);
+                    DECODED_NEXT();
+
+                DECODED_OP(sw):
+                {
+                    DECODED_STEP();
+                    const uint32_t idx = read_switch_index(ins->lhs.type, resolve(ins->lhs, tmp_var[0]));
+                    DECODED_BRANCH(ins, idx < ins->count, ins->labels[idx], ins + 1);
+                    DECODED_NEXT();
+                }
+
+                DECODED_OP(sws):
+                {
+                    DECODED_STEP();
+                    const uint64_t key = get_switch_key(ins->lhs.type, read_switch_value(ins->lhs.type, resolve(ins->lhs, tmp_var[0])));
+                    const decoded_instruction* const dst = select_switch_case(*ins, key);
+                    DECODED_BRANCH(ins, dst != ins + 1, dst, dst);
+                    DECODED_NEXT();
+                }
+
+                DECODED_OP(call):
+                    DECODED_STEP();
+                    sf.dptr = ins + 1;
+                    ins = push_decoded_frame<guarded, profiled>(*ins->call_target, ins, stack_end);
+                    DECODED_NEXT();
+                DECODED_OP(callv):
+                {
+                    DECODED_STEP();
+                    const size_t method_handle = read<size_t>(resolve(ins->lhs, tmp_var[0]));
+                    sf.dptr = ins + 1;
+                    ins = push_decoded_frame<guarded, profiled>(lookup_virtual(get_inline_cache(ins->cache_index), method_handle, signature_idx(ins->value)), ins, stack_end);
+                    DECODED_NEXT();
+                }
+                DECODED_OP(ret):
+                    DECODED_TRACE(ret, ins, 0);
+                    DECODED_LEAVE();
+                    pop_stack_frame();
+                    ins = sf.dptr;
+                    if (!ins) return;
+                    DECODED_NEXT();
+                DECODED_OP(retv):
+                    ins->operation(*this, *ins);
+                    DECODED_TRACE(ret, ins, 0);
+                    DECODED_LEAVE();
+                    pop_stack_frame();
+                    ins = sf.dptr;
+                    if (!ins) return;
+                    DECODED_NEXT();
+
+                DECODED_OP(dump):
+                    dump_recursive(resolve(ins->rhs, tmp_var[1]), get_type(ins->rhs.type));
+                    print_output();
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(vadd):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vsub):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vmul):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vdiv):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vmin):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vmax):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vceq):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vcne):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vcgt):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vcge):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vclt):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vcle):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+                DECODED_OP(vshf):
+                    ins->operation(*this, *ins);
+                    ins++;
+                    DECODED_NEXT();
+
+                DECODED_OP(mcpy):
+                {
+                    uint8_t* const dst = dereference(resolve(ins->lhs, tmp_var[0]));
+                    const uint8_t* const src = dereference(resolve(ins->rhs, tmp_var[1]));
+                    size_t tmp;
+                    const size_t length = read_integral(memory_length_type(ins->sub), resolve(ins->args->operand, tmp));
+                    memmove(dst, src, length * ins->value);
+                    ins++;
+                    DECODED_NEXT();
+                }
+                DECODED_OP(mset):
+                {
+                    uint8_t* const dst = dereference(resolve(ins->lhs, tmp_var[0]));
+                    const size_t value = read_integral(memory_value_type(ins->sub), resolve(ins->rhs, tmp_var[1]));
+                    size_t tmp;
+                    const size_t length = read_integral(memory_length_type(ins->sub), resolve(ins->args->operand, tmp));
+                    memset(dst, int(uint8_t(value)), length * ins->value);
+                    ins++;
+                    DECODED_NEXT();
+                }
+                DECODED_OP(mcmp):
+                {
+                    const uint8_t* const lhs = dereference(resolve(ins->lhs, tmp_var[0]));
+                    const uint8_t* const rhs = dereference(resolve(ins->rhs, tmp_var[1]));
+                    size_t tmp;
+                    const size_t length = read_integral(memory_length_type(ins->sub), resolve(ins->args->operand, tmp));
+                    write<int32_t>(stack_end) = compare(memcmp(lhs, rhs, length * ins->value), 0);
+                    ins++;
+                    DECODED_NEXT();
+                }
+
+                DECODED_SUPERINSTRUCTION(operation_branch):
+                {
+                    DECODED_STEP();
+                    ins->operation(*this, *ins);
+                    const decoded_instruction* const branch = ins + 1;
+                    DECODED_BRANCH(branch, branch->comparison(*this, *branch), branch->target, ins + 2);
+                    DECODED_NEXT();
+                }
+                DECODED_SUPERINSTRUCTION(compare_branch):
+                {
+                    DECODED_STEP();
+                    // The branch consumes the return value, so it does not need to be written
+                    const decoded_instruction* const branch = ins + 1;
+                    const bool is_nonzero = ins->comparison(*this, *ins) != 0;
+                    DECODED_BRANCH(branch, is_nonzero == (branch->op == opcode::bnz), branch->target, ins + 2);
+                    DECODED_NEXT();
+                }
+                DECODED_SUPERINSTRUCTION(call_set):
+                    // The return value is written directly into the destination of the set
+                    DECODED_STEP();
+                    sf.dptr = ins + 2;
+                    ins = push_decoded_frame<guarded, profiled>(*ins->call_target, ins, param_offset + ins[1].lhs.offset);
+                    DECODED_NEXT();
+                DECODED_SUPERINSTRUCTION(tail_call):
+                    // The callee returns directly to the caller of the current method
+                    DECODED_STEP();
+                    ins = push_tail_frame<guarded, profiled>(*ins->call_target, *ins);
+                    if (!ins) return;
+                    DECODED_NEXT();
+                DECODED_SUPERINSTRUCTION(call_native):
+                    DECODED_STEP();
+                    DECODED_TRACE(call, ins, uint32_t(ins->call_target->source->index));
+                    call_native<guarded, profiled>(*ins);
+                    ins++;
+                    DECODED_NEXT();
+
+#if !INTERPRETER_THREADED_DISPATCH
+                default: ASSERT(false, "Malformed opcode: %", static_cast<uint32_t>(ins->op));
+            }
+#endif
+
+#undef DECODED_OP
+#undef DECODED_SUPERINSTRUCTION
+#undef DECODED_NEXT
+#undef DECODED_STEP
+#undef DECODED_LEAVE
+#undef DECODED_TRACE
+#undef DECODED_BRANCH
+        }
+
+        void dump_assembly()
+        {
+            // Types
+            output_buffer << "TYPES: " << '\n';
+            for (size_t tidx = 0; tidx < data.types.size(); tidx++)
+            {
+                auto& t = data.types[type_idx(tidx)];
+
+                output_buffer << tidx << ": " << get_name(t);
                 if (t.meta.index != meta_idx::invalid)
                 {
-                    output_stream << " (" << data.metatable[t.meta.index] << ':' << t.meta.line_number << ')';
+                    output_buffer << " (" << data.metatable[t.meta.index] << ':' << t.meta.line_number << ')';
                 }
                 if (!t.fields.empty())
                 {
-                    output_stream << " { ";
+                    output_buffer << " { ";
                     bool first = true;
                     for (auto& field : t.fields)
                     {
-                        if (!first) output_stream << ", ";
+                        if (!first) output_buffer << ", ";
                         first = false;
-                        output_stream << get_name(get_type(field.type)) << ' ' << database[field.name];
+                        output_buffer << get_name(get_type(field.type)) << ' ' << database[field.name];
                     }
-                    output_stream << " }";
+                    output_buffer << " }";
                 }
-                output_stream << std::endl;
+                output_buffer << '\n';
             }
-            output_stream << std::endl;
+            output_buffer << '\n';
 
             // Signatures
-            output_stream << "SIGNATURES: " << std::endl;
+            output_buffer << "SIGNATURES: " << '\n';
             for (size_t sidx = 0; sidx < data.signatures.size(); sidx++)
             {
                 auto& s = data.signatures[signature_idx(sidx)];
 
-                output_stream << sidx << ": " << get_name(get_type(s.return_type));
-                output_stream << '(';
+                output_buffer << sidx << ": " << get_name(get_type(s.return_type));
+                output_buffer << '(';
                 if (!s.parameters.empty())
                 {
                     for (size_t i = 0; i < s.parameters.size(); i++)
                     {
                         const auto& param = s.parameters[i];
 
-                        if (i > 0) output_stream << ", ";
-                        output_stream << get_name(get_type(param.type));
+                        if (i > 0) output_buffer << ", ";
+                        output_buffer << get_name(get_type(param.type));
                     }
                 }
-                output_stream << ')' << std::endl;
+                output_buffer << ')' << '\n';
             }
-            output_stream << std::endl;
+            output_buffer << '\n';
 
             // Methods
-            output_stream << "METHODS: " << std::endl;
+            output_buffer << "METHODS: " << '\n';
             for (size_t midx = 0; midx < data.methods.size(); midx++)
             {
                 auto& m = data.methods[method_idx(midx)];
                 auto& s = get_signature(m.signature);
 
-                output_stream << midx << ": " << get_name(get_type(s.return_type)) << ' ';
-                output_stream << database[m.name];
+                output_buffer << midx << ": " << get_name(get_type(s.return_type)) << ' ';
+                output_buffer << database[m.name];
 
-                output_stream << '(';
+                output_buffer << '(';
                 if (!s.parameters.empty())
                 {
                     for (size_t i = 0; i < s.parameters.size(); i++)
                     {
                         const auto& param = s.parameters[i];
 
-                        if (i > 0) output_stream << ", ";
-                        output_stream << get_name(get_type(param.type));
+                        if (i > 0) output_buffer << ", ";
+                        output_buffer << get_name(get_type(param.type));
                     }
                 }
-                output_stream << ')';
+                output_buffer << ')';
                 if (m.meta.index != meta_idx::invalid)
                 {
-                    output_stream << " (" << data.metatable[m.meta.index] << ':' << m.meta.line_number << ')';
+                    output_buffer << " (" << data.metatable[m.meta.index] << ':' << m.meta.line_number << ')';
+                }
+                output_buffer << '\n';
+            }
+            output_buffer << '\n';
+
+            // Handler specializations
+            if (!decoded_methods.empty())
+            {
+                unordered_set<const void*> specializations;
+                size_t instruction_count = 0;
+                for (const auto& m : decoded_methods)
+                {
+                    if (!m.ready.load(std::memory_order_acquire)) continue;
+                    for (const auto& ins : m.instructions)
+                    {
+                        if (ins.operation) specializations.emplace(reinterpret_cast<const void*>(ins.operation));
+                    }
+                    instruction_count += m.instructions.size();
                 }
-                output_stream << std::endl;
+                output_buffer << "SPECIALIZATIONS: " << '\n';
+                output_buffer << specializations.size() << " distinct handlers for " << instruction_count << " instructions" << '\n';
+                output_buffer << '\n';
             }
-            output_stream << std::endl;
 
             print_output();
         }
 
 
-        // Implementations of ops
-        inline void set() noexcept
-        {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            set(sub, lhs_addr, rhs_addr);
-        }
-        inline void set(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        // Pre-decoding
+        void allocate_methods()
         {
-            switch (sub)
+#if INTERPRETER_THREADED_DISPATCH
+            if (stack.guard_size > 0) execute_decoded<true, false>(&decoding.handlers);
+            else if (parameters.profile) execute_decoded<false, true>(&decoding.handlers);
+            else execute_decoded<false, false>(&decoding.handlers);
+#endif
+
+            // Allocate all methods first, so calls can refer to their targets
+            // (decoding only uses the fields that are set here of other methods)
+            owned_methods = indexed_vector<method_idx, decoded_method>(data.methods.size());
+            for (size_t i = 0; i < data.methods.size(); i++)
             {
-                case subcode(0): write<int8_t>(lhs_addr) = read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) = read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) = (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) = (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) = read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) = (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) = read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) = (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) = (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) = (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) = (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) = read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) = (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) = (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) = read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) = (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) = (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) = (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) = (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) = (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) = (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) = read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) = (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) = (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) = (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) = read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) = (float)read<int8_t>(rhs_addr); return;
-                case subcode(27): write<float>(lhs_addr) = (float)read<uint8_t>(rhs_addr); return;
-                case subcode(28): write<float>(lhs_addr) = (float)read<int16_t>(rhs_addr); return;
-                case subcode(29): write<float>(lhs_addr) = (float)read<uint16_t>(rhs_addr); return;
-                case subcode(30): write<float>(lhs_addr) = (float)read<int32_t>(rhs_addr); return;
-                case subcode(31): write<float>(lhs_addr) = (float)read<uint32_t>(rhs_addr); return;
-                case subcode(32): write<float>(lhs_addr) = (float)read<int64_t>(rhs_addr); return;
-                case subcode(33): write<float>(lhs_addr) = (float)read<uint64_t>(rhs_addr); return;
-                case subcode(34): write<float>(lhs_addr) = read<float>(rhs_addr); return;
-                case subcode(35): write<double>(lhs_addr) = (double)read<int8_t>(rhs_addr); return;
-                case subcode(36): write<double>(lhs_addr) = (double)read<uint8_t>(rhs_addr); return;
-                case subcode(37): write<double>(lhs_addr) = (double)read<int16_t>(rhs_addr); return;
-                case subcode(38): write<double>(lhs_addr) = (double)read<uint16_t>(rhs_addr); return;
-                case subcode(39): write<double>(lhs_addr) = (double)read<int32_t>(rhs_addr); return;
-                case subcode(40): write<double>(lhs_addr) = (double)read<uint32_t>(rhs_addr); return;
-                case subcode(41): write<double>(lhs_addr) = (double)read<int64_t>(rhs_addr); return;
-                case subcode(42): write<double>(lhs_addr) = (double)read<uint64_t>(rhs_addr); return;
-                case subcode(43): write<double>(lhs_addr) = (double)read<float>(rhs_addr); return;
-                case subcode(44): write<double>(lhs_addr) = read<double>(rhs_addr); return;
-                case subcode(45): memcpy(lhs_addr, rhs_addr, get_addr_type(true).total_size); break;
+                const method& source = get_method(method_idx(i));
+                decoded_method& dst = owned_methods[method_idx(i)];
+                dst.source = &source;
+                dst.method_signature = &get_signature(source.signature);
+                dst.frame_size = source.is_external() ? size_t(source.total_stack_size) : source.total_stack_size + stack_frame_size;
+                if (source.is_external()) dst.ready.store(true, std::memory_order_relaxed);
             }
         }
-        inline void conv() noexcept
+        void decode_assembly()
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            switch (sub)
+            // Assemblies that were linked with a profile are decoded from hot to cold,
+            // which keeps the instructions of hot methods close together in memory
+            // (lazily decoded methods are decoded in the order they are first called)
+            const auto decode = [&](method_idx index)
             {
-                case subcode(0): write<int8_t>(lhs_addr) = read<int8_t>(rhs_addr); return;
-                case subcode(1): write<int8_t>(lhs_addr) = (int8_t)read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int8_t>(lhs_addr) = (int8_t)read<int16_t>(rhs_addr); return;
-                case subcode(3): write<int8_t>(lhs_addr) = (int8_t)read<uint16_t>(rhs_addr); return;
-                case subcode(4): write<int8_t>(lhs_addr) = (int8_t)read<int32_t>(rhs_addr); return;
-                case subcode(5): write<int8_t>(lhs_addr) = (int8_t)read<uint32_t>(rhs_addr); return;
-                case subcode(6): write<int8_t>(lhs_addr) = (int8_t)read<int64_t>(rhs_addr); return;
-                case subcode(7): write<int8_t>(lhs_addr) = (int8_t)read<uint64_t>(rhs_addr); return;
-                case subcode(8): write<int8_t>(lhs_addr) = (int8_t)read<float>(rhs_addr); return;
-                case subcode(9): write<int8_t>(lhs_addr) = (int8_t)read<double>(rhs_addr); return;
-                case subcode(10): write<uint8_t>(lhs_addr) = (uint8_t)read<int8_t>(rhs_addr); return;
-                case subcode(11): write<uint8_t>(lhs_addr) = read<uint8_t>(rhs_addr); return;
-                case subcode(12): write<uint8_t>(lhs_addr) = (uint8_t)read<int16_t>(rhs_addr); return;
-                case subcode(13): write<uint8_t>(lhs_addr) = (uint8_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint8_t>(lhs_addr) = (uint8_t)read<int32_t>(rhs_addr); return;
-                case subcode(15): write<uint8_t>(lhs_addr) = (uint8_t)read<uint32_t>(rhs_addr); return;
-                case subcode(16): write<uint8_t>(lhs_addr) = (uint8_t)read<int64_t>(rhs_addr); return;
-                case subcode(17): write<uint8_t>(lhs_addr) = (uint8_t)read<uint64_t>(rhs_addr); return;
-                case subcode(18): write<uint8_t>(lhs_addr) = (uint8_t)read<float>(rhs_addr); return;
-                case subcode(19): write<uint8_t>(lhs_addr) = (uint8_t)read<double>(rhs_addr); return;
-                case subcode(20): write<int16_t>(lhs_addr) = (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(21): write<int16_t>(lhs_addr) = (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(22): write<int16_t>(lhs_addr) = read<int16_t>(rhs_addr); return;
-                case subcode(23): write<int16_t>(lhs_addr) = (int16_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<int16_t>(lhs_addr) = (int16_t)read<int32_t>(rhs_addr); return;
-                case subcode(25): write<int16_t>(lhs_addr) = (int16_t)read<uint32_t>(rhs_addr); return;
-                case subcode(26): write<int16_t>(lhs_addr) = (int16_t)read<int64_t>(rhs_addr); return;
-                case subcode(27): write<int16_t>(lhs_addr) = (int16_t)read<uint64_t>(rhs_addr); return;
-                case subcode(28): write<int16_t>(lhs_addr) = (int16_t)read<float>(rhs_addr); return;
-                case subcode(29): write<int16_t>(lhs_addr) = (int16_t)read<double>(rhs_addr); return;
-                case subcode(30): write<uint16_t>(lhs_addr) = (uint16_t)read<int8_t>(rhs_addr); return;
-                case subcode(31): write<uint16_t>(lhs_addr) = (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(32): write<uint16_t>(lhs_addr) = (uint16_t)read<int16_t>(rhs_addr); return;
-                case subcode(33): write<uint16_t>(lhs_addr) = read<uint16_t>(rhs_addr); return;
-                case subcode(34): write<uint16_t>(lhs_addr) = (uint16_t)read<int32_t>(rhs_addr); return;
-                case subcode(35): write<uint16_t>(lhs_addr) = (uint16_t)read<uint32_t>(rhs_addr); return;
-                case subcode(36): write<uint16_t>(lhs_addr) = (uint16_t)read<int64_t>(rhs_addr); return;
-                case subcode(37): write<uint16_t>(lhs_addr) = (uint16_t)read<uint64_t>(rhs_addr); return;
-                case subcode(38): write<uint16_t>(lhs_addr) = (uint16_t)read<float>(rhs_addr); return;
-                case subcode(39): write<uint16_t>(lhs_addr) = (uint16_t)read<double>(rhs_addr); return;
-                case subcode(40): write<int32_t>(lhs_addr) = (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(41): write<int32_t>(lhs_addr) = (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(42): write<int32_t>(lhs_addr) = (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(43): write<int32_t>(lhs_addr) = (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(44): write<int32_t>(lhs_addr) = read<int32_t>(rhs_addr); return;
-                case subcode(45): write<int32_t>(lhs_addr) = (int32_t)read<uint32_t>(rhs_addr); return;
-                case subcode(46): write<int32_t>(lhs_addr) = (int32_t)read<int64_t>(rhs_addr); return;
-                case subcode(47): write<int32_t>(lhs_addr) = (int32_t)read<uint64_t>(rhs_addr); return;
-                case subcode(48): write<int32_t>(lhs_addr) = (int32_t)read<float>(rhs_addr); return;
-                case subcode(49): write<int32_t>(lhs_addr) = (int32_t)read<double>(rhs_addr); return;
-                case subcode(50): write<uint32_t>(lhs_addr) = (uint32_t)read<int8_t>(rhs_addr); return;
-                case subcode(51): write<uint32_t>(lhs_addr) = (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(52): write<uint32_t>(lhs_addr) = (uint32_t)read<int16_t>(rhs_addr); return;
-                case subcode(53): write<uint32_t>(lhs_addr) = (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(54): write<uint32_t>(lhs_addr) = (uint32_t)read<int32_t>(rhs_addr); return;
-                case subcode(55): write<uint32_t>(lhs_addr) = read<uint32_t>(rhs_addr); return;
-                case subcode(56): write<uint32_t>(lhs_addr) = (uint32_t)read<int64_t>(rhs_addr); return;
-                case subcode(57): write<uint32_t>(lhs_addr) = (uint32_t)read<uint64_t>(rhs_addr); return;
-                case subcode(58): write<uint32_t>(lhs_addr) = (uint32_t)read<float>(rhs_addr); return;
-                case subcode(59): write<uint32_t>(lhs_addr) = (uint32_t)read<double>(rhs_addr); return;
-                case subcode(60): write<int64_t>(lhs_addr) = (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(61): write<int64_t>(lhs_addr) = (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(62): write<int64_t>(lhs_addr) = (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(63): write<int64_t>(lhs_addr) = (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(64): write<int64_t>(lhs_addr) = (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(65): write<int64_t>(lhs_addr) = (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(66): write<int64_t>(lhs_addr) = read<int64_t>(rhs_addr); return;
-                case subcode(67): write<int64_t>(lhs_addr) = (int64_t)read<uint64_t>(rhs_addr); return;
-                case subcode(68): write<int64_t>(lhs_addr) = (int64_t)read<float>(rhs_addr); return;
-                case subcode(69): write<int64_t>(lhs_addr) = (int64_t)read<double>(rhs_addr); return;
-                case subcode(70): write<uint64_t>(lhs_addr) = (uint64_t)read<int8_t>(rhs_addr); return;
-                case subcode(71): write<uint64_t>(lhs_addr) = (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(72): write<uint64_t>(lhs_addr) = (uint64_t)read<int16_t>(rhs_addr); return;
-                case subcode(73): write<uint64_t>(lhs_addr) = (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(74): write<uint64_t>(lhs_addr) = (uint64_t)read<int32_t>(rhs_addr); return;
-                case subcode(75): write<uint64_t>(lhs_addr) = (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(76): write<uint64_t>(lhs_addr) = (uint64_t)read<int64_t>(rhs_addr); return;
-                case subcode(77): write<uint64_t>(lhs_addr) = read<uint64_t>(rhs_addr); return;
-                case subcode(78): write<uint64_t>(lhs_addr) = (uint64_t)read<float>(rhs_addr); return;
-                case subcode(79): write<uint64_t>(lhs_addr) = (uint64_t)read<double>(rhs_addr); return;
-                case subcode(80): write<float>(lhs_addr) = (float)read<int8_t>(rhs_addr); return;
-                case subcode(81): write<float>(lhs_addr) = (float)read<uint8_t>(rhs_addr); return;
-                case subcode(82): write<float>(lhs_addr) = (float)read<int16_t>(rhs_addr); return;
-                case subcode(83): write<float>(lhs_addr) = (float)read<uint16_t>(rhs_addr); return;
-                case subcode(84): write<float>(lhs_addr) = (float)read<int32_t>(rhs_addr); return;
-                case subcode(85): write<float>(lhs_addr) = (float)read<uint32_t>(rhs_addr); return;
-                case subcode(86): write<float>(lhs_addr) = (float)read<int64_t>(rhs_addr); return;
-                case subcode(87): write<float>(lhs_addr) = (float)read<uint64_t>(rhs_addr); return;
-                case subcode(88): write<float>(lhs_addr) = read<float>(rhs_addr); return;
-                case subcode(89): write<float>(lhs_addr) = (float)read<double>(rhs_addr); return;
-                case subcode(90): write<double>(lhs_addr) = (double)read<int8_t>(rhs_addr); return;
-                case subcode(91): write<double>(lhs_addr) = (double)read<uint8_t>(rhs_addr); return;
-                case subcode(92): write<double>(lhs_addr) = (double)read<int16_t>(rhs_addr); return;
-                case subcode(93): write<double>(lhs_addr) = (double)read<uint16_t>(rhs_addr); return;
-                case subcode(94): write<double>(lhs_addr) = (double)read<int32_t>(rhs_addr); return;
-                case subcode(95): write<double>(lhs_addr) = (double)read<uint32_t>(rhs_addr); return;
-                case subcode(96): write<double>(lhs_addr) = (double)read<int64_t>(rhs_addr); return;
-                case subcode(97): write<double>(lhs_addr) = (double)read<uint64_t>(rhs_addr); return;
-                case subcode(98): write<double>(lhs_addr) = (double)read<float>(rhs_addr); return;
-                case subcode(99): write<double>(lhs_addr) = read<double>(rhs_addr); return;
-            }
-        }
+                if (!owned_methods.is_valid_index(index)) return;
 
-        inline void ari_not() noexcept
+                decoded_method& it = owned_methods[index];
+                if (!it.ready.load(std::memory_order_relaxed))
+                {
+                    decode_method(it, decoding.handlers);
+                    it.ready.store(true, std::memory_order_relaxed);
+                }
+            };
+            for (const method_idx index : data.method_order) decode(index);
+            for (size_t i = 0; i < owned_methods.size(); i++) decode(method_idx(i));
+        }
+        // Decode a method on its first call. Decoded methods are published with a release store,
+        // so only the first call has to take the lock (which is shared by all interpreters of a prototype).
+        inline void ensure_decoded(const decoded_method& target)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-
-            switch (sub)
-            {
-                case subcode(0): write<int8_t>(lhs_addr) = ~read<int8_t>(lhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) = ~read<uint8_t>(lhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) = ~read<int16_t>(lhs_addr); return;
-                case subcode(3): write<uint16_t>(lhs_addr) = ~read<uint16_t>(lhs_addr); return;
-                case subcode(4): write<int32_t>(lhs_addr) = ~read<int32_t>(lhs_addr); return;
-                case subcode(5): write<uint32_t>(lhs_addr) = ~read<uint32_t>(lhs_addr); return;
-                case subcode(6): write<int64_t>(lhs_addr) = ~read<int64_t>(lhs_addr); return;
-                case subcode(7): write<uint64_t>(lhs_addr) = ~read<uint64_t>(lhs_addr); return;
-            }
+            if (!target.ready.load(std::memory_order_acquire)) decode_lazily(target.source->index);
         }
-        inline void ari_neg() noexcept
+        void decode_lazily(method_idx index)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
+            const std::lock_guard<std::mutex> lock(decoding.mutex);
 
-            switch (sub)
-            {
-                case subcode(0): write<int8_t>(lhs_addr) = -read<int8_t>(lhs_addr); return;
-                case subcode(1): write<int16_t>(lhs_addr) = -read<int16_t>(lhs_addr); return;
-                case subcode(2): write<int32_t>(lhs_addr) = -read<int32_t>(lhs_addr); return;
-                case subcode(3): write<int64_t>(lhs_addr) = -read<int64_t>(lhs_addr); return;
-                case subcode(4): write<float>(lhs_addr) = -read<float>(lhs_addr); return;
-                case subcode(5): write<double>(lhs_addr) = -read<double>(lhs_addr); return;
-            }
+            decoded_method& it = decoded_methods[index];
+            if (it.ready.load(std::memory_order_relaxed)) return;
+            decode_method(it, decoding.handlers);
+            it.ready.store(true, std::memory_order_release);
         }
-        inline void ari_mul() noexcept
+        void decode_method(decoded_method& dst, const void* const* handlers)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            switch (sub)
+            const method& source = *dst.source;
+            const auto& bytecode = source.bytecode;
+
+            const uint8_t* const ibeg = bytecode.data();
+            const uint8_t* const iend = ibeg + bytecode.size();
+            const uint8_t* iptr = ibeg;
+
+            // Instruction index per bytecode offset (for resolving branch targets)
+            vector<uint32_t> instruction_index(bytecode.size(), uint32_t(-1));
+            // Instructions that still need their argument or label pointers
+            vector<size_t> argument_start;
+            vector<size_t> copy_start;
+            vector<size_t> key_start;
+            vector<size_t> label_start;
+            vector<uint32_t> label_offsets;
+
+            // Keep track of the return value type the same way the linker does
+            type_idx return_type = type_idx::voidtype;
+            size_t label_idx = 0;
+
+            while (iptr < iend)
             {
-                case subcode(0): write<int8_t>(lhs_addr) *= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) *= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) *= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) *= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) *= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) *= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) *= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) *= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) *= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) *= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) *= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) *= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) *= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) *= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) *= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) *= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) *= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) *= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) *= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) *= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) *= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) *= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) *= read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) *= (float)read<int8_t>(rhs_addr); return;
-                case subcode(27): write<float>(lhs_addr) *= (float)read<uint8_t>(rhs_addr); return;
-                case subcode(28): write<float>(lhs_addr) *= (float)read<int16_t>(rhs_addr); return;
-                case subcode(29): write<float>(lhs_addr) *= (float)read<uint16_t>(rhs_addr); return;
-                case subcode(30): write<float>(lhs_addr) *= (float)read<int32_t>(rhs_addr); return;
-                case subcode(31): write<float>(lhs_addr) *= (float)read<uint32_t>(rhs_addr); return;
-                case subcode(32): write<float>(lhs_addr) *= (float)read<int64_t>(rhs_addr); return;
-                case subcode(33): write<float>(lhs_addr) *= (float)read<uint64_t>(rhs_addr); return;
-                case subcode(34): write<float>(lhs_addr) *= read<float>(rhs_addr); return;
-                case subcode(35): write<double>(lhs_addr) *= (double)read<int8_t>(rhs_addr); return;
-                case subcode(36): write<double>(lhs_addr) *= (double)read<uint8_t>(rhs_addr); return;
-                case subcode(37): write<double>(lhs_addr) *= (double)read<int16_t>(rhs_addr); return;
-                case subcode(38): write<double>(lhs_addr) *= (double)read<uint16_t>(rhs_addr); return;
-                case subcode(39): write<double>(lhs_addr) *= (double)read<int32_t>(rhs_addr); return;
-                case subcode(40): write<double>(lhs_addr) *= (double)read<uint32_t>(rhs_addr); return;
-                case subcode(41): write<double>(lhs_addr) *= (double)read<int64_t>(rhs_addr); return;
-                case subcode(42): write<double>(lhs_addr) *= (double)read<uint64_t>(rhs_addr); return;
-                case subcode(43): write<double>(lhs_addr) *= (double)read<float>(rhs_addr); return;
-                case subcode(44): write<double>(lhs_addr) *= read<double>(rhs_addr); return;
+                const uint32_t offset = static_cast<uint32_t>(iptr - ibeg);
+                while (label_idx < source.labels.size() && offset >= source.labels[label_idx])
+                {
+                    label_idx++;
+                    return_type = type_idx::voidtype;
+                }
+
+                instruction_index[offset] = static_cast<uint32_t>(dst.instructions.size());
+
+                decoded_instruction ins;
+                ins.offset = offset;
+                ins.op = ins.base_op = read_bytecode<opcode>(iptr);
+                argument_start.push_back(dst.arguments.size());
+                copy_start.push_back(dst.copies.size());
+                key_start.push_back(dst.switch_keys.size());
+                label_start.push_back(label_offsets.size());
+
+                switch (ins.op)
+                {
+                    case opcode::noop: break;
+
+                    case opcode::set:
+                    case opcode::conv:
+                    case opcode::ari_mul:
+                    case opcode::ari_div:
+                    case opcode::ari_mod:
+                    case opcode::ari_add:
+                    case opcode::ari_sub:
+                    case opcode::ari_lsh:
+                    case opcode::ari_rsh:
+                    case opcode::ari_and:
+                    case opcode::ari_xor:
+                    case opcode::ari_or:
+                    case opcode::padd:
+                    case opcode::psub:
+                    case opcode::vadd:
+                    case opcode::vsub:
+                    case opcode::vmul:
+                    case opcode::vdiv:
+                    case opcode::vmin:
+                    case opcode::vmax:
+                    case opcode::vceq:
+                    case opcode::vcne:
+                    case opcode::vcgt:
+                    case opcode::vcge:
+                    case opcode::vclt:
+                    case opcode::vcle:
+                    case opcode::vshf:
+                    {
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        if (ins.op == opcode::set)
+                        {
+                            ins.value = get_type(ins.rhs.type).total_size;
+                        }
+                        else if (ins.op == opcode::padd || ins.op == opcode::psub)
+                        {
+                            ins.value = get_type(ins.lhs.type).generated.pointer.underlying_size;
+                        }
+                    }
+                    break;
+
+                    case opcode::ari_not:
+                    case opcode::ari_neg:
+                    {
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                    }
+                    break;
+
+                    case opcode::pdif:
+                    {
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        ins.value = get_type(ins.lhs.type).generated.pointer.underlying_size;
+                        return_type = derive_type_index_v<offset_t>;
+                    }
+                    break;
+
+                    case opcode::cmp:
+                    case opcode::ceq:
+                    case opcode::cne:
+                    case opcode::cgt:
+                    case opcode::cge:
+                    case opcode::clt:
+                    case opcode::cle:
+                    {
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        return_type = type_idx::i32;
+                    }
+                    break;
+
+                    case opcode::cze:
+                    case opcode::cnz:
+                    {
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        return_type = type_idx::i32;
+                    }
+                    break;
+
+                    case opcode::br:
+                    {
+                        ins.value = read_bytecode<uint32_t>(iptr);
+                        return_type = type_idx::voidtype;
+                    }
+                    break;
+
+                    case opcode::beq:
+                    case opcode::bne:
+                    case opcode::bgt:
+                    case opcode::bge:
+                    case opcode::blt:
+                    case opcode::ble:
+                    {
+                        ins.value = read_bytecode<uint32_t>(iptr);
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        return_type = type_idx::voidtype;
+                    }
+                    break;
+
+                    case opcode::bze:
+                    case opcode::bnz:
+                    {
+                        ins.value = read_bytecode<uint32_t>(iptr);
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        return_type = type_idx::voidtype;
+                    }
+                    break;
+
+                    case opcode::sw:
+                    {
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.count = read_bytecode<uint32_t>(iptr);
+                        for (uint32_t i = 0; i < ins.count; i++)
+                        {
+                            label_offsets.push_back(read_bytecode<uint32_t>(iptr));
+                        }
+                        return_type = type_idx::voidtype;
+                    }
+                    break;
+
+                    case opcode::sws:
+                    {
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        decode_switch_cases(iptr, ibeg, dst, ins, label_offsets);
+                        return_type = type_idx::voidtype;
+                    }
+                    break;
+
+                    case opcode::call:
+                    {
+                        const method_idx call_idx = read_bytecode<method_idx>(iptr);
+                        ASSERT(is_valid_method(call_idx), "Attempted to invoke an invalid method");
+                        const decoded_method& call_method = decoded_methods[call_idx];
+                        ins.call_target = &call_method;
+                        decode_arguments(iptr, dst, *call_method.method_signature, ins, return_type);
+                        return_type = call_method.method_signature->return_type;
+                    }
+                    break;
+
+                    case opcode::callv:
+                    {
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        const signature_idx calling_signature = get_type(ins.lhs.type).generated.signature.index;
+                        ins.value = static_cast<size_t>(calling_signature);
+                        const signature& signature = get_signature(calling_signature);
+                        decode_arguments(iptr, dst, signature, ins, return_type);
+                        ins.cache_index = decoding.inline_cache_count++;
+                        return_type = signature.return_type;
+                    }
+                    break;
+
+                    case opcode::ret: break;
+
+                    case opcode::retv:
+                    {
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        ins.value = get_type(ins.rhs.type).total_size;
+                    }
+                    break;
+
+                    case opcode::dump:
+                    {
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                    }
+                    break;
+
+                    case opcode::mcpy:
+                    case opcode::mset:
+                    case opcode::mcmp:
+                    {
+                        // The length operand is stored as the only argument
+                        ins.sub = read_bytecode<subcode>(iptr);
+                        ins.lhs = decode_operand(iptr, dst, return_type);
+                        ins.rhs = decode_operand(iptr, dst, return_type);
+                        dst.arguments.push_back(decoded_argument{ subcode(0), 0, 0, decode_operand(iptr, dst, return_type) });
+                        ins.count = 1;
+                        ins.value = memory_element_size(get_type(ins.lhs.type));
+                        if (ins.op == opcode::mcmp) return_type = type_idx::i32;
+                    }
+                    break;
+
+                    default: ASSERT(false, "Malformed opcode: %", static_cast<uint32_t>(ins.op));
+                }
+
+                specialize(ins);
+                if (handlers) ins.handler = handlers[static_cast<size_t>(ins.op)];
+                dst.instructions.push_back(ins);
             }
-        }
-        inline void ari_div() noexcept
-        {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
+            ASSERT(!dst.instructions.empty(), "Method contains no instructions");
 
-            switch (sub)
+            // Resolve labels and arguments now that the instruction list is complete
+            const auto find_instruction = [&](uint32_t target) -> const decoded_instruction*
             {
-                case subcode(0): write<int8_t>(lhs_addr) /= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) /= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) /= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) /= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) /= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) /= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) /= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) /= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) /= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) /= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) /= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) /= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) /= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) /= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) /= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) /= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) /= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) /= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) /= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) /= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) /= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) /= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) /= read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) /= (float)read<int8_t>(rhs_addr); return;
-                case subcode(27): write<float>(lhs_addr) /= (float)read<uint8_t>(rhs_addr); return;
-                case subcode(28): write<float>(lhs_addr) /= (float)read<int16_t>(rhs_addr); return;
-                case subcode(29): write<float>(lhs_addr) /= (float)read<uint16_t>(rhs_addr); return;
-                case subcode(30): write<float>(lhs_addr) /= (float)read<int32_t>(rhs_addr); return;
-                case subcode(31): write<float>(lhs_addr) /= (float)read<uint32_t>(rhs_addr); return;
-                case subcode(32): write<float>(lhs_addr) /= (float)read<int64_t>(rhs_addr); return;
-                case subcode(33): write<float>(lhs_addr) /= (float)read<uint64_t>(rhs_addr); return;
-                case subcode(34): write<float>(lhs_addr) /= read<float>(rhs_addr); return;
-                case subcode(35): write<double>(lhs_addr) /= (double)read<int8_t>(rhs_addr); return;
-                case subcode(36): write<double>(lhs_addr) /= (double)read<uint8_t>(rhs_addr); return;
-                case subcode(37): write<double>(lhs_addr) /= (double)read<int16_t>(rhs_addr); return;
-                case subcode(38): write<double>(lhs_addr) /= (double)read<uint16_t>(rhs_addr); return;
-                case subcode(39): write<double>(lhs_addr) /= (double)read<int32_t>(rhs_addr); return;
-                case subcode(40): write<double>(lhs_addr) /= (double)read<uint32_t>(rhs_addr); return;
-                case subcode(41): write<double>(lhs_addr) /= (double)read<int64_t>(rhs_addr); return;
-                case subcode(42): write<double>(lhs_addr) /= (double)read<uint64_t>(rhs_addr); return;
-                case subcode(43): write<double>(lhs_addr) /= (double)read<float>(rhs_addr); return;
-                case subcode(44): write<double>(lhs_addr) /= read<double>(rhs_addr); return;
+                ASSERT(target < instruction_index.size() && instruction_index[target] != uint32_t(-1), "Branch target out of range");
+                return &dst.instructions[instruction_index[target]];
+            };
+            dst.labels.resize(label_offsets.size());
+            for (size_t i = 0; i < label_offsets.size(); i++)
+            {
+                dst.labels[i] = find_instruction(label_offsets[i]);
+            }
+            for (size_t i = 0; i < dst.instructions.size(); i++)
+            {
+                decoded_instruction& ins = dst.instructions[i];
+                switch (ins.op)
+                {
+                    case opcode::br:
+                    case opcode::beq:
+                    case opcode::bne:
+                    case opcode::bgt:
+                    case opcode::bge:
+                    case opcode::blt:
+                    case opcode::ble:
+                    case opcode::bze:
+                    case opcode::bnz:
+                        ins.target = find_instruction(static_cast<uint32_t>(ins.value));
+                        break;
+
+                    case opcode::sw:
+                        ins.labels = dst.labels.data() + label_start[i];
+                        break;
+
+                    case opcode::sws:
+                        ins.labels = dst.labels.data() + label_start[i];
+                        ins.keys = dst.switch_keys.data() + key_start[i];
+                        break;
+
+                    case opcode::call:
+                    case opcode::callv:
+                        ins.args = dst.arguments.data() + argument_start[i];
+                        ins.copies = dst.copies.data() + copy_start[i];
+                        break;
+
+                    case opcode::mcpy:
+                    case opcode::mset:
+                    case opcode::mcmp:
+                        ins.args = dst.arguments.data() + argument_start[i];
+                        break;
+
+                    default: break;
+                }
+            }
+
+            if (parameters.tail_calls)
+            {
+                mark_tail_calls(dst, handlers);
+            }
+            if (parameters.superinstructions)
+            {
+                fuse_instructions(dst, handlers);
             }
         }
-        inline void ari_mod() noexcept
+        // Calls that are immediately followed by a return of their result (or a return without value
+        // after calling a void method) can reuse the stack frame of the calling method.
+        // Methods that take the address of anything in their frame are skipped, since the pointer
+        // could be passed on (directly or through memory) and would point into the callee frame.
+        void mark_tail_calls(decoded_method& dst, const void* const* handlers)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
+            auto& instructions = dst.instructions;
 
-            switch (sub)
+            const auto takes_frame_address = [](const decoded_operand& operand)
             {
-                case subcode(0): write<int8_t>(lhs_addr) %= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) %= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) %= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) %= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) %= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) %= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) %= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) %= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) %= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) %= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) %= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) %= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) %= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) %= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) %= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) %= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) %= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) %= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) %= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) %= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) %= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) %= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) %= read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int8_t>(rhs_addr)); return;
-                case subcode(27): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint8_t>(rhs_addr)); return;
-                case subcode(28): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int16_t>(rhs_addr)); return;
-                case subcode(29): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint16_t>(rhs_addr)); return;
-                case subcode(30): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int32_t>(rhs_addr)); return;
-                case subcode(31): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint32_t>(rhs_addr)); return;
-                case subcode(32): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int64_t>(rhs_addr)); return;
-                case subcode(33): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint64_t>(rhs_addr)); return;
-                case subcode(34): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), read<float>(rhs_addr)); return;
-                case subcode(35): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int8_t>(rhs_addr)); return;
-                case subcode(36): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint8_t>(rhs_addr)); return;
-                case subcode(37): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int16_t>(rhs_addr)); return;
-                case subcode(38): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint16_t>(rhs_addr)); return;
-                case subcode(39): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int32_t>(rhs_addr)); return;
-                case subcode(40): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint32_t>(rhs_addr)); return;
-                case subcode(41): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int64_t>(rhs_addr)); return;
-                case subcode(42): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint64_t>(rhs_addr)); return;
-                case subcode(43): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<float>(rhs_addr)); return;
-                case subcode(44): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), read<double>(rhs_addr)); return;
+                return operand.base == operand_base::frame && (operand.flags & operand_flags::address_of);
+            };
+            for (const auto& ins : instructions)
+            {
+                if (takes_frame_address(ins.lhs) || takes_frame_address(ins.rhs)) return;
+            }
+            for (const auto& arg : dst.arguments)
+            {
+                if (takes_frame_address(arg.operand)) return;
+            }
+            const size_t return_value_offset = dst.source->method_stack_size;
+            const type_idx method_return_type = dst.method_signature->return_type;
+
+            for (size_t i = 0; i + 1 < instructions.size(); i++)
+            {
+                decoded_instruction& ins = instructions[i];
+                if (ins.op != opcode::call || ins.call_target->source->is_external()) continue;
+
+                const decoded_instruction& next = instructions[i + 1];
+                const type_idx call_return_type = ins.call_target->method_signature->return_type;
+                bool is_tail_call = false;
+                if (next.op == opcode::ret)
+                {
+                    is_tail_call = call_return_type == type_idx::voidtype;
+                }
+                else if (next.op == opcode::retv)
+                {
+                    // The return value has to be passed on without conversion
+                    const decoded_operand& value = next.rhs;
+                    is_tail_call = value.base == operand_base::frame && value.flags == operand_flags::none &&
+                        value.offset == return_value_offset && value.type == call_return_type && value.type == method_return_type;
+                }
+
+                if (is_tail_call)
+                {
+                    ins.op = superinstruction::tail_call;
+                    if (handlers) ins.handler = handlers[static_cast<size_t>(ins.op)];
+                }
             }
         }
-        inline void ari_add() noexcept
+        void fuse_instructions(decoded_method& dst, const void* const* handlers)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
+            auto& instructions = dst.instructions;
 
-            switch (sub)
+            // Return value is located at the end of the method stack (see decode_operand)
+            const size_t return_value_offset = dst.source->method_stack_size;
+            const auto is_return_value = [&](const decoded_operand& operand)
             {
-                case subcode(0): write<int8_t>(lhs_addr) += read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) += read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) += (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) += (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) += read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) += (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) += read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) += (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) += (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) += (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) += (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) += read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) += (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) += (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) += read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) += (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) += (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) += (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) += (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) += (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) += (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) += read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) += (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) += (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) += (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) += read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) += (float)read<int8_t>(rhs_addr); return;
-                case subcode(27): write<float>(lhs_addr) += (float)read<uint8_t>(rhs_addr); return;
-                case subcode(28): write<float>(lhs_addr) += (float)read<int16_t>(rhs_addr); return;
-                case subcode(29): write<float>(lhs_addr) += (float)read<uint16_t>(rhs_addr); return;
-                case subcode(30): write<float>(lhs_addr) += (float)read<int32_t>(rhs_addr); return;
-                case subcode(31): write<float>(lhs_addr) += (float)read<uint32_t>(rhs_addr); return;
-                case subcode(32): write<float>(lhs_addr) += (float)read<int64_t>(rhs_addr); return;
-                case subcode(33): write<float>(lhs_addr) += (float)read<uint64_t>(rhs_addr); return;
-                case subcode(34): write<float>(lhs_addr) += read<float>(rhs_addr); return;
-                case subcode(35): write<double>(lhs_addr) += (double)read<int8_t>(rhs_addr); return;
-                case subcode(36): write<double>(lhs_addr) += (double)read<uint8_t>(rhs_addr); return;
-                case subcode(37): write<double>(lhs_addr) += (double)read<int16_t>(rhs_addr); return;
-                case subcode(38): write<double>(lhs_addr) += (double)read<uint16_t>(rhs_addr); return;
-                case subcode(39): write<double>(lhs_addr) += (double)read<int32_t>(rhs_addr); return;
-                case subcode(40): write<double>(lhs_addr) += (double)read<uint32_t>(rhs_addr); return;
-                case subcode(41): write<double>(lhs_addr) += (double)read<int64_t>(rhs_addr); return;
-                case subcode(42): write<double>(lhs_addr) += (double)read<uint64_t>(rhs_addr); return;
-                case subcode(43): write<double>(lhs_addr) += (double)read<float>(rhs_addr); return;
-                case subcode(44): write<double>(lhs_addr) += read<double>(rhs_addr); return;
-            }
-        }
-        inline void ari_sub() noexcept
-        {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
+                return operand.base == operand_base::frame && operand.flags == operand_flags::none && operand.offset == return_value_offset;
+            };
+            const auto reads_return_value = [&](const decoded_operand& operand)
+            {
+                return operand.base == operand_base::frame && operand.offset >= return_value_offset;
+            };
 
-            switch (sub)
+            // Instructions that can be jumped to
+            vector<bool> is_target(instructions.size(), false);
+            for (const auto& ins : instructions)
             {
-                case subcode(0): write<int8_t>(lhs_addr) -= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) -= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) -= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) -= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) -= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) -= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) -= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) -= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) -= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) -= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) -= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) -= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) -= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) -= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) -= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) -= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) -= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) -= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) -= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) -= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) -= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) -= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) -= read<uint64_t>(rhs_addr); return;
-                case subcode(26): write<float>(lhs_addr) -= (float)read<int8_t>(rhs_addr); return;
-                case subcode(27): write<float>(lhs_addr) -= (float)read<uint8_t>(rhs_addr); return;
-                case subcode(28): write<float>(lhs_addr) -= (float)read<int16_t>(rhs_addr); return;
-                case subcode(29): write<float>(lhs_addr) -= (float)read<uint16_t>(rhs_addr); return;
-                case subcode(30): write<float>(lhs_addr) -= (float)read<int32_t>(rhs_addr); return;
-                case subcode(31): write<float>(lhs_addr) -= (float)read<uint32_t>(rhs_addr); return;
-                case subcode(32): write<float>(lhs_addr) -= (float)read<int64_t>(rhs_addr); return;
-                case subcode(33): write<float>(lhs_addr) -= (float)read<uint64_t>(rhs_addr); return;
-                case subcode(34): write<float>(lhs_addr) -= read<float>(rhs_addr); return;
-                case subcode(35): write<double>(lhs_addr) -= (double)read<int8_t>(rhs_addr); return;
-                case subcode(36): write<double>(lhs_addr) -= (double)read<uint8_t>(rhs_addr); return;
-                case subcode(37): write<double>(lhs_addr) -= (double)read<int16_t>(rhs_addr); return;
-                case subcode(38): write<double>(lhs_addr) -= (double)read<uint16_t>(rhs_addr); return;
-                case subcode(39): write<double>(lhs_addr) -= (double)read<int32_t>(rhs_addr); return;
-                case subcode(40): write<double>(lhs_addr) -= (double)read<uint32_t>(rhs_addr); return;
-                case subcode(41): write<double>(lhs_addr) -= (double)read<int64_t>(rhs_addr); return;
-                case subcode(42): write<double>(lhs_addr) -= (double)read<uint64_t>(rhs_addr); return;
-                case subcode(43): write<double>(lhs_addr) -= (double)read<float>(rhs_addr); return;
-                case subcode(44): write<double>(lhs_addr) -= read<double>(rhs_addr); return;
+                if (ins.target) is_target[static_cast<size_t>(ins.target - instructions.data())] = true;
             }
-        }
-        inline void ari_lsh() noexcept
-        {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            switch (sub)
+            for (const auto label : dst.labels)
             {
-                case subcode(0): write<int8_t>(lhs_addr) <<= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) <<= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) <<= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) <<= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) <<= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) <<= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) <<= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) <<= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) <<= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) <<= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) <<= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) <<= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) <<= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) <<= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) <<= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) <<= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) <<= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) <<= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) <<= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) <<= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) <<= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) <<= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) <<= read<uint64_t>(rhs_addr); return;
+                is_target[static_cast<size_t>(label - instructions.data())] = true;
             }
-        }
-        inline void ari_rsh() noexcept
-        {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
 
-            switch (sub)
+            // Returns true if the return value is read again after the instruction at idx
+            // (until the return value gets replaced or invalidated by a branch or label)
+            const auto is_return_value_used = [&](size_t idx)
             {
-                case subcode(0): write<int8_t>(lhs_addr) >>= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) >>= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) >>= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) >>= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) >>= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) >>= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) >>= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) >>= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) >>= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) >>= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) >>= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) >>= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) >>= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) >>= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) >>= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) >>= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) >>= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) >>= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) >>= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) >>= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) >>= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) >>= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) >>= read<uint64_t>(rhs_addr); return;
+                for (size_t i = idx; i < instructions.size() && !is_target[i]; i++)
+                {
+                    const auto& ins = instructions[i];
+                    if (reads_return_value(ins.lhs) || reads_return_value(ins.rhs)) return true;
+                    if (ins.base_op == opcode::call || ins.base_op == opcode::callv)
+                    {
+                        for (uint32_t j = 0; j < ins.count; j++)
+                        {
+                            if (reads_return_value(ins.args[j].operand)) return true;
+                        }
+                        for (uint32_t j = 0; j < ins.copy_count; j++)
+                        {
+                            if (ins.copies[j].src_offset + ins.copies[j].size > return_value_offset) return true;
+                        }
+                    }
+                    else if (is_memory_op(ins.op))
+                    {
+                        if (reads_return_value(ins.args->operand)) return true;
+                        if (ins.op == opcode::mcmp) break;
+                        continue;
+                    }
+                    // Dump only reads its operand (checked above), so it does not end the scan
+                    if ((ins.op >= opcode::pdif && ins.op <= opcode::cnz) || (ins.op >= opcode::br && ins.op <= opcode::retv)) break;
+                }
+                return false;
+            };
+
+            for (size_t i = 0; i + 1 < instructions.size(); i++)
+            {
+                decoded_instruction& ins = instructions[i];
+                const decoded_instruction& next = instructions[i + 1];
+
+                opcode fused = opcode::noop;
+                if (ins.op >= opcode::set && ins.op <= opcode::psub && ins.op != opcode::pdif)
+                {
+                    if (next.op >= opcode::beq && next.op <= opcode::bnz) fused = superinstruction::operation_branch;
+                }
+                else if (ins.op >= opcode::cmp && ins.op <= opcode::cnz)
+                {
+                    if ((next.op == opcode::bze || next.op == opcode::bnz) && is_return_value(next.lhs)) fused = superinstruction::compare_branch;
+                }
+                else if (ins.op == opcode::call)
+                {
+                    // The set has to be a plain copy into a frame variable of the same type
+                    if (next.op == opcode::set && is_return_value(next.rhs) &&
+                        next.lhs.base == operand_base::frame && next.lhs.flags == operand_flags::none &&
+                        next.lhs.type == next.rhs.type && !reads_return_value(next.lhs) &&
+                        !is_return_value_used(i + 2))
+                    {
+                        fused = superinstruction::call_set;
+                    }
+                    else if (ins.call_target->source->is_external())
+                    {
+                        fused = superinstruction::call_native;
+                    }
+                }
+
+                if (fused != opcode::noop)
+                {
+                    ins.op = fused;
+                    if (handlers) ins.handler = handlers[static_cast<size_t>(fused)];
+                }
             }
         }
-        inline void ari_and() noexcept
+        // Sparse switches are lowered into a jump table if at least half of the table would be occupied,
+        // otherwise the runtime binary searches over the sorted case keys.
+        // Jump table entries without a case continue at the next instruction.
+        void decode_switch_cases(const uint8_t*& iptr, const uint8_t* ibeg, decoded_method& dst, decoded_instruction& ins, vector<uint32_t>& label_offsets)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            switch (sub)
+            const uint32_t case_count = read_bytecode<uint32_t>(iptr);
+            const uint64_t* values = reinterpret_cast<const uint64_t*>(iptr);
+            iptr += sizeof(uint64_t) * case_count;
+            const uint32_t* labels = reinterpret_cast<const uint32_t*>(iptr);
+            iptr += sizeof(uint32_t) * case_count;
+            ASSERT(case_count > 0, "Switch contains no cases");
+
+            const type_idx type = ins.lhs.type;
+            const uint64_t min_key = get_switch_key(type, values[0]);
+            const uint64_t range = get_switch_key(type, values[case_count - 1]) - min_key;
+            if (range < uint64_t(case_count) * 2)
             {
-                case subcode(0): write<int8_t>(lhs_addr) &= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) &= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) &= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) &= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) &= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) &= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) &= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) &= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) &= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) &= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) &= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) &= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) &= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) &= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) &= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) &= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) &= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) &= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) &= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) &= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) &= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) &= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) &= read<uint64_t>(rhs_addr); return;
+                ins.sub = switch_lowering::jump_table;
+                dst.switch_keys.push_back(min_key);
+                ins.count = static_cast<uint32_t>(range + 1);
+
+                const uint32_t next_offset = static_cast<uint32_t>(iptr - ibeg);
+                const size_t table_start = label_offsets.size();
+                label_offsets.resize(table_start + ins.count, next_offset);
+                for (uint32_t i = 0; i < case_count; i++)
+                {
+                    label_offsets[table_start + size_t(get_switch_key(type, values[i]) - min_key)] = labels[i];
+                }
+            }
+            else
+            {
+                ins.sub = switch_lowering::binary_search;
+                ins.count = case_count;
+                for (uint32_t i = 0; i < case_count; i++)
+                {
+                    dst.switch_keys.push_back(get_switch_key(type, values[i]));
+                    label_offsets.push_back(labels[i]);
+                }
             }
         }
-        inline void ari_xor() noexcept
+        // Builds the argument copy plan of a call site. Arguments that are plain frame variables
+        // of the parameter type get copied in bulk (merged if contiguous on both ends),
+        // the remaining arguments get resolved and converted individually.
+        void decode_arguments(const uint8_t*& iptr, decoded_method& dst, const signature& calling_signature, decoded_instruction& ins, type_idx return_type)
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            switch (sub)
+            const size_t arg_count = read_bytecode<uint8_t>(iptr);
+            ASSERT(arg_count == calling_signature.parameters.size(), "Invalid argument count");
+            const size_t copy_begin = dst.copies.size();
+            for (size_t i = 0; i < arg_count; i++)
             {
-                case subcode(0): write<int8_t>(lhs_addr) ^= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) ^= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) ^= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) ^= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) ^= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) ^= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) ^= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) ^= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) ^= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) ^= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) ^= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) ^= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) ^= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) ^= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) ^= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) ^= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) ^= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) ^= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) ^= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) ^= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) ^= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) ^= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) ^= read<uint64_t>(rhs_addr); return;
+                decoded_argument arg;
+                arg.sub = read_bytecode<subcode>(iptr);
+                arg.offset = calling_signature.parameters[i].offset;
+                arg.operand = decode_operand(iptr, dst, return_type);
+                arg.size = get_type(arg.operand.type).total_size;
+
+                const bool is_copy = arg.operand.base == operand_base::frame && arg.operand.flags == operand_flags::none &&
+                    arg.operand.type == calling_signature.parameters[i].type;
+                if (is_copy)
+                {
+                    if (dst.copies.size() > copy_begin)
+                    {
+                        decoded_copy& last = dst.copies.back();
+                        if (last.src_offset + last.size == arg.operand.offset && last.dst_offset + last.size == arg.offset)
+                        {
+                            last.size += arg.size;
+                            continue;
+                        }
+                    }
+                    dst.copies.push_back(decoded_copy{ arg.operand.offset, arg.offset, arg.size });
+                }
+                else
+                {
+                    dst.arguments.push_back(arg);
+                    ins.count++;
+                }
             }
+            ins.copy_count = static_cast<uint32_t>(dst.copies.size() - copy_begin);
         }
-        inline void ari_or() noexcept
+        decoded_operand decode_operand(const uint8_t*& iptr, const decoded_method& dst, type_idx return_type) const
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
+            const method& source = *dst.source;
+            const signature& method_signature = *dst.method_signature;
 
-            switch (sub)
+            decoded_operand result;
+            uint64_t constant_buffer;
+            const uint8_t* constant = nullptr;
+            const address_data_t addr = read_address_data(iptr, data.encoding, constant_buffer, constant);
+            const uint32_t index = addr.header.index();
+            switch (addr.header.type())
             {
-                case subcode(0): write<int8_t>(lhs_addr) |= read<int8_t>(rhs_addr); return;
-                case subcode(1): write<uint8_t>(lhs_addr) |= read<uint8_t>(rhs_addr); return;
-                case subcode(2): write<int16_t>(lhs_addr) |= (int16_t)read<int8_t>(rhs_addr); return;
-                case subcode(3): write<int16_t>(lhs_addr) |= (int16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(4): write<int16_t>(lhs_addr) |= read<int16_t>(rhs_addr); return;
-                case subcode(5): write<uint16_t>(lhs_addr) |= (uint16_t)read<uint8_t>(rhs_addr); return;
-                case subcode(6): write<uint16_t>(lhs_addr) |= read<uint16_t>(rhs_addr); return;
-                case subcode(7): write<int32_t>(lhs_addr) |= (int32_t)read<int8_t>(rhs_addr); return;
-                case subcode(8): write<int32_t>(lhs_addr) |= (int32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(9): write<int32_t>(lhs_addr) |= (int32_t)read<int16_t>(rhs_addr); return;
-                case subcode(10): write<int32_t>(lhs_addr) |= (int32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(11): write<int32_t>(lhs_addr) |= read<int32_t>(rhs_addr); return;
-                case subcode(12): write<uint32_t>(lhs_addr) |= (uint32_t)read<uint8_t>(rhs_addr); return;
-                case subcode(13): write<uint32_t>(lhs_addr) |= (uint32_t)read<uint16_t>(rhs_addr); return;
-                case subcode(14): write<uint32_t>(lhs_addr) |= read<uint32_t>(rhs_addr); return;
-                case subcode(15): write<int64_t>(lhs_addr) |= (int64_t)read<int8_t>(rhs_addr); return;
-                case subcode(16): write<int64_t>(lhs_addr) |= (int64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(17): write<int64_t>(lhs_addr) |= (int64_t)read<int16_t>(rhs_addr); return;
-                case subcode(18): write<int64_t>(lhs_addr) |= (int64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(19): write<int64_t>(lhs_addr) |= (int64_t)read<int32_t>(rhs_addr); return;
-                case subcode(20): write<int64_t>(lhs_addr) |= (int64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(21): write<int64_t>(lhs_addr) |= read<int64_t>(rhs_addr); return;
-                case subcode(22): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint8_t>(rhs_addr); return;
-                case subcode(23): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint16_t>(rhs_addr); return;
-                case subcode(24): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint32_t>(rhs_addr); return;
-                case subcode(25): write<uint64_t>(lhs_addr) |= read<uint64_t>(rhs_addr); return;
+                case address_type::stackvar:
+                {
+                    if (index == address_header_constants::index_max)
+                    {
+                        // Return values are stored at the end of the method stack
+                        ASSERT(return_type != type_idx::voidtype, "Return value address is not valid here");
+                        result.offset = source.method_stack_size;
+                        result.type = return_type;
+                    }
+                    else
+                    {
+                        const auto& stack_var = source.stackvars[index];
+                        result.offset = method_signature.parameters_size + stack_var.offset;
+                        result.type = stack_var.type;
+                    }
+                }
+                break;
+
+                case address_type::parameter:
+                {
+                    const auto& param = method_signature.parameters[index];
+                    result.offset = param.offset;
+                    result.type = param.type;
+                }
+                break;
+
+                case address_type::global:
+                {
+                    global_idx global = (global_idx)index;
+                    const bool is_constant = is_constant_flag_set(global);
+                    const data_table_view& table = global_tables[is_constant];
+                    global &= global_flags::constant_mask;
+                    const auto& global_info = table[global];
+                    if (is_constant)
+                    {
+                        // Constants are read-only and can be addressed directly
+                        result.base = operand_base::absolute;
+                        result.offset = reinterpret_cast<size_t>(table.data + global_info.offset);
+                    }
+                    else
+                    {
+                        result.base = operand_base::global;
+                        result.offset = global_info.offset;
+                    }
+                    result.type = global_info.type;
+                }
+                break;
+
+                case address_type::constant:
+                {
+                    const type_idx btype_idx = type_idx(index);
+                    const size_t constant_size = get_type(btype_idx).total_size;
+                    ASSERT(constant_size <= sizeof(result.offset), "Malformed constant");
+                    result.base = operand_base::immediate;
+                    memcpy(&result.offset, constant, constant_size);
+                    result.type = btype_idx;
+                    return result;
+                }
+                break;
+            }
+
+            switch (addr.header.modifier())
+            {
+                case address_modifier::none: break;
+
+                case address_modifier::direct_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+                    result.offset += field.offset;
+                    result.type = field.type;
+                }
+                break;
+
+                case address_modifier::indirect_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+                    result.flags |= operand_flags::dereference;
+                    result.deref_offset = field.offset;
+                    result.type = field.type;
+                }
+                break;
+
+                case address_modifier::offset:
+                {
+                    const auto& current_type = get_type(result.type);
+                    if (current_type.is_pointer())
+                    {
+                        const type& underlying_type = get_type(current_type.generated.pointer.underlying_type);
+                        result.flags |= operand_flags::dereference;
+                        result.deref_offset = underlying_type.total_size * addr.offset;
+                        result.type = underlying_type.index;
+                    }
+                    else if (current_type.is_array())
+                    {
+                        const type& underlying_type = get_type(current_type.generated.array.underlying_type);
+                        result.offset += underlying_type.total_size * addr.offset;
+                        result.type = underlying_type.index;
+                    }
+                }
+                break;
+            }
+
+            switch (addr.header.prefix())
+            {
+                case address_prefix::none: break;
+
+                case address_prefix::indirection:
+                {
+                    result.flags |= operand_flags::indirection;
+                    result.type = get_type(result.type).generated.pointer.underlying_type;
+                }
+                break;
+
+                case address_prefix::address_of:
+                {
+                    result.flags |= operand_flags::address_of;
+                    const type_idx dst_type = get_type(result.type).pointer_type;
+                    result.type = dst_type == type_idx::invalid ? type_idx::vptr : dst_type;
+                }
+                break;
+
+                case address_prefix::size_of:
+                {
+                    // Size is known at load time
+                    const size_t type_size = get_type(result.type).total_size;
+                    result = decoded_operand();
+                    result.base = operand_base::immediate;
+                    result.offset = type_size;
+                    result.type = derive_type_index_v<size_t>;
+                }
+                break;
             }
+
+            return result;
         }
 
-        inline void padd() noexcept
+        // Implementations of ops
+        inline void set() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
             auto rhs_addr = read_address(true);
 
-            const size_t underlying_size = get_addr_type(false).generated.pointer.underlying_size;
-            switch (sub)
+            set(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void set(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr, size_t copy_size) noexcept
+        {
+            // Struct/array copies use the pre-decoded type size
+            if (sub == subcode(45))
             {
-                case subcode(0): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int8_t>(rhs_addr)); return;
-                case subcode(1): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint8_t>(rhs_addr)); return;
-                case subcode(2): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int16_t>(rhs_addr)); return;
-                case subcode(3): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint16_t>(rhs_addr)); return;
-                case subcode(4): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int32_t>(rhs_addr)); return;
-                case subcode(5): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint32_t>(rhs_addr)); return;
-                case subcode(6): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * read<size_t>(rhs_addr)); return;
-                case subcode(7): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint64_t>(rhs_addr)); return;
+                memcpy(lhs_addr, rhs_addr, copy_size);
+                return;
             }
+            set(sub, lhs_addr, rhs_addr);
         }
-        inline void psub() noexcept
+        INTERPRETER_INLINE void set(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
-            const size_t underlying_size = get_addr_type(false).generated.pointer.underlying_size;
             switch (sub)
             {
-                case subcode(0): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int8_t>(rhs_addr)); return;
-                case subcode(1): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint8_t>(rhs_addr)); return;
-                case subcode(2): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int16_t>(rhs_addr)); return;
-                case subcode(3): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint16_t>(rhs_addr)); return;
-                case subcode(4): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int32_t>(rhs_addr)); return;
-                case subcode(5): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint32_t>(rhs_addr)); return;
-                case subcode(6): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * read<size_t>(rhs_addr)); return;
-                case subcode(7): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint64_t>(rhs_addr)); return;
+                case subcode(0): write<int8_t>(lhs_addr) = read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) = read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) = (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) = (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) = read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) = (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) = read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) = (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) = (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) = (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) = (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) = read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) = (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) = (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) = read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) = (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) = (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) = (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) = (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) = (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) = (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) = read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) = (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) = (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) = (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) = read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) = (float)read<int8_t>(rhs_addr); return;
+                case subcode(27): write<float>(lhs_addr) = (float)read<uint8_t>(rhs_addr); return;
+                case subcode(28): write<float>(lhs_addr) = (float)read<int16_t>(rhs_addr); return;
+                case subcode(29): write<float>(lhs_addr) = (float)read<uint16_t>(rhs_addr); return;
+                case subcode(30): write<float>(lhs_addr) = (float)read<int32_t>(rhs_addr); return;
+                case subcode(31): write<float>(lhs_addr) = (float)read<uint32_t>(rhs_addr); return;
+                case subcode(32): write<float>(lhs_addr) = (float)read<int64_t>(rhs_addr); return;
+                case subcode(33): write<float>(lhs_addr) = (float)read<uint64_t>(rhs_addr); return;
+                case subcode(34): write<float>(lhs_addr) = read<float>(rhs_addr); return;
+                case subcode(35): write<double>(lhs_addr) = (double)read<int8_t>(rhs_addr); return;
+                case subcode(36): write<double>(lhs_addr) = (double)read<uint8_t>(rhs_addr); return;
+                case subcode(37): write<double>(lhs_addr) = (double)read<int16_t>(rhs_addr); return;
+                case subcode(38): write<double>(lhs_addr) = (double)read<uint16_t>(rhs_addr); return;
+                case subcode(39): write<double>(lhs_addr) = (double)read<int32_t>(rhs_addr); return;
+                case subcode(40): write<double>(lhs_addr) = (double)read<uint32_t>(rhs_addr); return;
+                case subcode(41): write<double>(lhs_addr) = (double)read<int64_t>(rhs_addr); return;
+                case subcode(42): write<double>(lhs_addr) = (double)read<uint64_t>(rhs_addr); return;
+                case subcode(43): write<double>(lhs_addr) = (double)read<float>(rhs_addr); return;
+                case subcode(44): write<double>(lhs_addr) = read<double>(rhs_addr); return;
+                case subcode(45): memcpy(lhs_addr, rhs_addr, get_addr_type(true).total_size); break;
             }
         }
-        inline void pdif() noexcept
+        inline void conv() noexcept
         {
+            const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
             auto rhs_addr = read_address(true);
 
-            const offset_t underlying_size = offset_t(get_addr_type(false).generated.pointer.underlying_size);
-            const offset_t lhs = reinterpret_cast<offset_t>(dereference(lhs_addr));
-            const offset_t rhs = reinterpret_cast<offset_t>(dereference(rhs_addr));
-            write<offset_t>(push_return_value(derive_type_index_v<offset_t>)) = (lhs - rhs) / underlying_size;
+            conv(sub, lhs_addr, rhs_addr);
         }
-
-        inline int32_t cmp() noexcept
+        INTERPRETER_INLINE void conv(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
             switch (sub)
             {
-                case subcode(0): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
-                case subcode(1): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
-                case subcode(2): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
-                case subcode(3): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
-                case subcode(4): return compare((int32_t)read<int8_t>(lhs_addr), read<int32_t>(rhs_addr));
-                case subcode(5): return compare((int64_t)read<int8_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(6): return compare((int64_t)read<int8_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(7): return compare((float)read<int8_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(8): return compare((double)read<int8_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(9): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
-                case subcode(10): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
-                case subcode(11): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
-                case subcode(12): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
-                case subcode(13): return compare((int32_t)read<uint8_t>(lhs_addr), read<int32_t>(rhs_addr));
-                case subcode(14): return compare((int64_t)read<uint8_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(15): return compare((int64_t)read<uint8_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(16): return compare((uint64_t)read<uint8_t>(lhs_addr), read<uint64_t>(rhs_addr));
-                case subcode(17): return compare((float)read<uint8_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(18): return compare((double)read<uint8_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(19): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
-                case subcode(20): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
-                case subcode(21): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
-                case subcode(22): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
-                case subcode(23): return compare((int32_t)read<int16_t>(lhs_addr), read<int32_t>(rhs_addr));
-                case subcode(24): return compare((int64_t)read<int16_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(25): return compare((int64_t)read<int16_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(26): return compare((float)read<int16_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(27): return compare((double)read<int16_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(28): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
-                case subcode(29): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
-                case subcode(30): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
-                case subcode(31): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
-                case subcode(32): return compare((int32_t)read<uint16_t>(lhs_addr), read<int32_t>(rhs_addr));
-                case subcode(33): return compare((int64_t)read<uint16_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(34): return compare((int64_t)read<uint16_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(35): return compare((uint64_t)read<uint16_t>(lhs_addr), read<uint64_t>(rhs_addr));
-                case subcode(36): return compare((float)read<uint16_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(37): return compare((double)read<uint16_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(38): return compare(read<int32_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
-                case subcode(39): return compare(read<int32_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
-                case subcode(40): return compare(read<int32_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
-                case subcode(41): return compare(read<int32_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
-                case subcode(42): return compare(read<int32_t>(lhs_addr), read<int32_t>(rhs_addr));
-                case subcode(43): return compare((int64_t)read<int32_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(44): return compare((int64_t)read<int32_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(45): return compare((float)read<int32_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(46): return compare((double)read<int32_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(47): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int8_t>(rhs_addr));
-                case subcode(48): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<uint8_t>(rhs_addr));
-                case subcode(49): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int16_t>(rhs_addr));
-                case subcode(50): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<uint16_t>(rhs_addr));
-                case subcode(51): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int32_t>(rhs_addr));
-                case subcode(52): return compare(read<uint32_t>(lhs_addr), read<uint32_t>(rhs_addr));
-                case subcode(53): return compare((int64_t)read<uint32_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(54): return compare((uint64_t)read<uint32_t>(lhs_addr), read<uint64_t>(rhs_addr));
-                case subcode(55): return compare((float)read<uint32_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(56): return compare((double)read<uint32_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(57): return compare(read<int64_t>(lhs_addr), (int64_t)read<int8_t>(rhs_addr));
-                case subcode(58): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint8_t>(rhs_addr));
-                case subcode(59): return compare(read<int64_t>(lhs_addr), (int64_t)read<int16_t>(rhs_addr));
-                case subcode(60): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint16_t>(rhs_addr));
-                case subcode(61): return compare(read<int64_t>(lhs_addr), (int64_t)read<int32_t>(rhs_addr));
-                case subcode(62): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
-                case subcode(63): return compare(read<int64_t>(lhs_addr), read<int64_t>(rhs_addr));
-                case subcode(64): return compare((float)read<int64_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(65): return compare((double)read<int64_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(66): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint8_t>(rhs_addr));
-                case subcode(67): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint16_t>(rhs_addr));
-                case subcode(68): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint32_t>(rhs_addr));
-                case subcode(69): return compare(read<uint64_t>(lhs_addr), read<uint64_t>(rhs_addr));
-                case subcode(70): return compare((float)read<uint64_t>(lhs_addr), read<float>(rhs_addr));
-                case subcode(71): return compare((double)read<uint64_t>(lhs_addr), read<double>(rhs_addr));
-                case subcode(72): return compare(read<float>(lhs_addr), (float)read<int8_t>(rhs_addr));
-                case subcode(73): return compare(read<float>(lhs_addr), (float)read<uint8_t>(rhs_addr));
-                case subcode(74): return compare(read<float>(lhs_addr), (float)read<int16_t>(rhs_addr));
-                case subcode(75): return compare(read<float>(lhs_addr), (float)read<uint16_t>(rhs_addr));
-                case subcode(76): return compare(read<float>(lhs_addr), (float)read<int32_t>(rhs_addr));
-                case subcode(77): return compare(read<float>(lhs_addr), (float)read<uint32_t>(rhs_addr));
-                case subcode(78): return compare(read<float>(lhs_addr), (float)read<int64_t>(rhs_addr));
-                case subcode(79): return compare(read<float>(lhs_addr), (float)read<uint64_t>(rhs_addr));
-                case subcode(80): return compare(read<float>(lhs_addr), read<float>(rhs_addr));
-                case subcode(81): return compare((double)read<float>(lhs_addr), read<double>(rhs_addr));
-                case subcode(82): return compare(read<double>(lhs_addr), (double)read<int8_t>(rhs_addr));
-                case subcode(83): return compare(read<double>(lhs_addr), (double)read<uint8_t>(rhs_addr));
-                case subcode(84): return compare(read<double>(lhs_addr), (double)read<int16_t>(rhs_addr));
-                case subcode(85): return compare(read<double>(lhs_addr), (double)read<uint16_t>(rhs_addr));
-                case subcode(86): return compare(read<double>(lhs_addr), (double)read<int32_t>(rhs_addr));
-                case subcode(87): return compare(read<double>(lhs_addr), (double)read<uint32_t>(rhs_addr));
-                case subcode(88): return compare(read<double>(lhs_addr), (double)read<int64_t>(rhs_addr));
-                case subcode(89): return compare(read<double>(lhs_addr), (double)read<uint64_t>(rhs_addr));
-                case subcode(90): return compare(read<double>(lhs_addr), (double)read<float>(rhs_addr));
-                case subcode(91): return compare(read<double>(lhs_addr), read<double>(rhs_addr));
+                case subcode(0): write<int8_t>(lhs_addr) = read<int8_t>(rhs_addr); return;
+                case subcode(1): write<int8_t>(lhs_addr) = (int8_t)read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int8_t>(lhs_addr) = (int8_t)read<int16_t>(rhs_addr); return;
+                case subcode(3): write<int8_t>(lhs_addr) = (int8_t)read<uint16_t>(rhs_addr); return;
+                case subcode(4): write<int8_t>(lhs_addr) = (int8_t)read<int32_t>(rhs_addr); return;
+                case subcode(5): write<int8_t>(lhs_addr) = (int8_t)read<uint32_t>(rhs_addr); return;
+                case subcode(6): write<int8_t>(lhs_addr) = (int8_t)read<int64_t>(rhs_addr); return;
+                case subcode(7): write<int8_t>(lhs_addr) = (int8_t)read<uint64_t>(rhs_addr); return;
+                case subcode(8): write<int8_t>(lhs_addr) = (int8_t)read<float>(rhs_addr); return;
+                case subcode(9): write<int8_t>(lhs_addr) = (int8_t)read<double>(rhs_addr); return;
+                case subcode(10): write<uint8_t>(lhs_addr) = (uint8_t)read<int8_t>(rhs_addr); return;
+                case subcode(11): write<uint8_t>(lhs_addr) = read<uint8_t>(rhs_addr); return;
+                case subcode(12): write<uint8_t>(lhs_addr) = (uint8_t)read<int16_t>(rhs_addr); return;
+                case subcode(13): write<uint8_t>(lhs_addr) = (uint8_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint8_t>(lhs_addr) = (uint8_t)read<int32_t>(rhs_addr); return;
+                case subcode(15): write<uint8_t>(lhs_addr) = (uint8_t)read<uint32_t>(rhs_addr); return;
+                case subcode(16): write<uint8_t>(lhs_addr) = (uint8_t)read<int64_t>(rhs_addr); return;
+                case subcode(17): write<uint8_t>(lhs_addr) = (uint8_t)read<uint64_t>(rhs_addr); return;
+                case subcode(18): write<uint8_t>(lhs_addr) = (uint8_t)read<float>(rhs_addr); return;
+                case subcode(19): write<uint8_t>(lhs_addr) = (uint8_t)read<double>(rhs_addr); return;
+                case subcode(20): write<int16_t>(lhs_addr) = (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(21): write<int16_t>(lhs_addr) = (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(22): write<int16_t>(lhs_addr) = read<int16_t>(rhs_addr); return;
+                case subcode(23): write<int16_t>(lhs_addr) = (int16_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<int16_t>(lhs_addr) = (int16_t)read<int32_t>(rhs_addr); return;
+                case subcode(25): write<int16_t>(lhs_addr) = (int16_t)read<uint32_t>(rhs_addr); return;
+                case subcode(26): write<int16_t>(lhs_addr) = (int16_t)read<int64_t>(rhs_addr); return;
+                case subcode(27): write<int16_t>(lhs_addr) = (int16_t)read<uint64_t>(rhs_addr); return;
+                case subcode(28): write<int16_t>(lhs_addr) = (int16_t)read<float>(rhs_addr); return;
+                case subcode(29): write<int16_t>(lhs_addr) = (int16_t)read<double>(rhs_addr); return;
+                case subcode(30): write<uint16_t>(lhs_addr) = (uint16_t)read<int8_t>(rhs_addr); return;
+                case subcode(31): write<uint16_t>(lhs_addr) = (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(32): write<uint16_t>(lhs_addr) = (uint16_t)read<int16_t>(rhs_addr); return;
+                case subcode(33): write<uint16_t>(lhs_addr) = read<uint16_t>(rhs_addr); return;
+                case subcode(34): write<uint16_t>(lhs_addr) = (uint16_t)read<int32_t>(rhs_addr); return;
+                case subcode(35): write<uint16_t>(lhs_addr) = (uint16_t)read<uint32_t>(rhs_addr); return;
+                case subcode(36): write<uint16_t>(lhs_addr) = (uint16_t)read<int64_t>(rhs_addr); return;
+                case subcode(37): write<uint16_t>(lhs_addr) = (uint16_t)read<uint64_t>(rhs_addr); return;
+                case subcode(38): write<uint16_t>(lhs_addr) = (uint16_t)read<float>(rhs_addr); return;
+                case subcode(39): write<uint16_t>(lhs_addr) = (uint16_t)read<double>(rhs_addr); return;
+                case subcode(40): write<int32_t>(lhs_addr) = (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(41): write<int32_t>(lhs_addr) = (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(42): write<int32_t>(lhs_addr) = (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(43): write<int32_t>(lhs_addr) = (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(44): write<int32_t>(lhs_addr) = read<int32_t>(rhs_addr); return;
+                case subcode(45): write<int32_t>(lhs_addr) = (int32_t)read<uint32_t>(rhs_addr); return;
+                case subcode(46): write<int32_t>(lhs_addr) = (int32_t)read<int64_t>(rhs_addr); return;
+                case subcode(47): write<int32_t>(lhs_addr) = (int32_t)read<uint64_t>(rhs_addr); return;
+                case subcode(48): write<int32_t>(lhs_addr) = (int32_t)read<float>(rhs_addr); return;
+                case subcode(49): write<int32_t>(lhs_addr) = (int32_t)read<double>(rhs_addr); return;
+                case subcode(50): write<uint32_t>(lhs_addr) = (uint32_t)read<int8_t>(rhs_addr); return;
+                case subcode(51): write<uint32_t>(lhs_addr) = (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(52): write<uint32_t>(lhs_addr) = (uint32_t)read<int16_t>(rhs_addr); return;
+                case subcode(53): write<uint32_t>(lhs_addr) = (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(54): write<uint32_t>(lhs_addr) = (uint32_t)read<int32_t>(rhs_addr); return;
+                case subcode(55): write<uint32_t>(lhs_addr) = read<uint32_t>(rhs_addr); return;
+                case subcode(56): write<uint32_t>(lhs_addr) = (uint32_t)read<int64_t>(rhs_addr); return;
+                case subcode(57): write<uint32_t>(lhs_addr) = (uint32_t)read<uint64_t>(rhs_addr); return;
+                case subcode(58): write<uint32_t>(lhs_addr) = (uint32_t)read<float>(rhs_addr); return;
+                case subcode(59): write<uint32_t>(lhs_addr) = (uint32_t)read<double>(rhs_addr); return;
+                case subcode(60): write<int64_t>(lhs_addr) = (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(61): write<int64_t>(lhs_addr) = (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(62): write<int64_t>(lhs_addr) = (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(63): write<int64_t>(lhs_addr) = (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(64): write<int64_t>(lhs_addr) = (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(65): write<int64_t>(lhs_addr) = (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(66): write<int64_t>(lhs_addr) = read<int64_t>(rhs_addr); return;
+                case subcode(67): write<int64_t>(lhs_addr) = (int64_t)read<uint64_t>(rhs_addr); return;
+                case subcode(68): write<int64_t>(lhs_addr) = (int64_t)read<float>(rhs_addr); return;
+                case subcode(69): write<int64_t>(lhs_addr) = (int64_t)read<double>(rhs_addr); return;
+                case subcode(70): write<uint64_t>(lhs_addr) = (uint64_t)read<int8_t>(rhs_addr); return;
+                case subcode(71): write<uint64_t>(lhs_addr) = (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(72): write<uint64_t>(lhs_addr) = (uint64_t)read<int16_t>(rhs_addr); return;
+                case subcode(73): write<uint64_t>(lhs_addr) = (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(74): write<uint64_t>(lhs_addr) = (uint64_t)read<int32_t>(rhs_addr); return;
+                case subcode(75): write<uint64_t>(lhs_addr) = (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(76): write<uint64_t>(lhs_addr) = (uint64_t)read<int64_t>(rhs_addr); return;
+                case subcode(77): write<uint64_t>(lhs_addr) = read<uint64_t>(rhs_addr); return;
+                case subcode(78): write<uint64_t>(lhs_addr) = (uint64_t)read<float>(rhs_addr); return;
+                case subcode(79): write<uint64_t>(lhs_addr) = (uint64_t)read<double>(rhs_addr); return;
+                case subcode(80): write<float>(lhs_addr) = (float)read<int8_t>(rhs_addr); return;
+                case subcode(81): write<float>(lhs_addr) = (float)read<uint8_t>(rhs_addr); return;
+                case subcode(82): write<float>(lhs_addr) = (float)read<int16_t>(rhs_addr); return;
+                case subcode(83): write<float>(lhs_addr) = (float)read<uint16_t>(rhs_addr); return;
+                case subcode(84): write<float>(lhs_addr) = (float)read<int32_t>(rhs_addr); return;
+                case subcode(85): write<float>(lhs_addr) = (float)read<uint32_t>(rhs_addr); return;
+                case subcode(86): write<float>(lhs_addr) = (float)read<int64_t>(rhs_addr); return;
+                case subcode(87): write<float>(lhs_addr) = (float)read<uint64_t>(rhs_addr); return;
+                case subcode(88): write<float>(lhs_addr) = read<float>(rhs_addr); return;
+                case subcode(89): write<float>(lhs_addr) = (float)read<double>(rhs_addr); return;
+                case subcode(90): write<double>(lhs_addr) = (double)read<int8_t>(rhs_addr); return;
+                case subcode(91): write<double>(lhs_addr) = (double)read<uint8_t>(rhs_addr); return;
+                case subcode(92): write<double>(lhs_addr) = (double)read<int16_t>(rhs_addr); return;
+                case subcode(93): write<double>(lhs_addr) = (double)read<uint16_t>(rhs_addr); return;
+                case subcode(94): write<double>(lhs_addr) = (double)read<int32_t>(rhs_addr); return;
+                case subcode(95): write<double>(lhs_addr) = (double)read<uint32_t>(rhs_addr); return;
+                case subcode(96): write<double>(lhs_addr) = (double)read<int64_t>(rhs_addr); return;
+                case subcode(97): write<double>(lhs_addr) = (double)read<uint64_t>(rhs_addr); return;
+                case subcode(98): write<double>(lhs_addr) = (double)read<float>(rhs_addr); return;
+                case subcode(99): write<double>(lhs_addr) = read<double>(rhs_addr); return;
             }
-            return 0;
         }
-        inline int32_t ceq() noexcept
+
+        inline void ari_not() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
 
+            ari_not(sub, lhs_addr);
+        }
+        INTERPRETER_INLINE void ari_not(subcode sub, uint8_t* lhs_addr) noexcept
+        {
             switch (sub)
             {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) == read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) == read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) == read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) == read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) == read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) == read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) == read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) == read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) == read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) == (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) == (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) == (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) == (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) == (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) == read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) == read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) == (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) == (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) == (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) == (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) == (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) == (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) == (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) == (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) == read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) == read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) == (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) == (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) == (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) == (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) == (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) == (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) == (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) == (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) == (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(0): write<int8_t>(lhs_addr) = ~read<int8_t>(lhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) = ~read<uint8_t>(lhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) = ~read<int16_t>(lhs_addr); return;
+                case subcode(3): write<uint16_t>(lhs_addr) = ~read<uint16_t>(lhs_addr); return;
+                case subcode(4): write<int32_t>(lhs_addr) = ~read<int32_t>(lhs_addr); return;
+                case subcode(5): write<uint32_t>(lhs_addr) = ~read<uint32_t>(lhs_addr); return;
+                case subcode(6): write<int64_t>(lhs_addr) = ~read<int64_t>(lhs_addr); return;
+                case subcode(7): write<uint64_t>(lhs_addr) = ~read<uint64_t>(lhs_addr); return;
             }
-            return 0;
         }
-        inline int32_t cne() noexcept
+        inline void ari_neg() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+
+            ari_neg(sub, lhs_addr);
+        }
+        INTERPRETER_INLINE void ari_neg(subcode sub, uint8_t* lhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) = -read<int8_t>(lhs_addr); return;
+                case subcode(1): write<int16_t>(lhs_addr) = -read<int16_t>(lhs_addr); return;
+                case subcode(2): write<int32_t>(lhs_addr) = -read<int32_t>(lhs_addr); return;
+                case subcode(3): write<int64_t>(lhs_addr) = -read<int64_t>(lhs_addr); return;
+                case subcode(4): write<float>(lhs_addr) = -read<float>(lhs_addr); return;
+                case subcode(5): write<double>(lhs_addr) = -read<double>(lhs_addr); return;
+            }
+        }
+        inline void ari_mul() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
             auto rhs_addr = read_address(true);
 
+            ari_mul(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_mul(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
             switch (sub)
             {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) != read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) != read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) != read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) != read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) != read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) != read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) != read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) != read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) != read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) != (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) != (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) != (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) != (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) != (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) != read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) != read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) != (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) != (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) != (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) != (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) != (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) != (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) != (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) != (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) != read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) != read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) != (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) != (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) != (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) != (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) != (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) != (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) != (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) != (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) != (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(0): write<int8_t>(lhs_addr) *= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) *= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) *= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) *= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) *= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) *= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) *= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) *= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) *= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) *= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) *= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) *= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) *= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) *= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) *= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) *= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) *= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) *= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) *= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) *= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) *= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) *= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) *= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) *= read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) *= (float)read<int8_t>(rhs_addr); return;
+                case subcode(27): write<float>(lhs_addr) *= (float)read<uint8_t>(rhs_addr); return;
+                case subcode(28): write<float>(lhs_addr) *= (float)read<int16_t>(rhs_addr); return;
+                case subcode(29): write<float>(lhs_addr) *= (float)read<uint16_t>(rhs_addr); return;
+                case subcode(30): write<float>(lhs_addr) *= (float)read<int32_t>(rhs_addr); return;
+                case subcode(31): write<float>(lhs_addr) *= (float)read<uint32_t>(rhs_addr); return;
+                case subcode(32): write<float>(lhs_addr) *= (float)read<int64_t>(rhs_addr); return;
+                case subcode(33): write<float>(lhs_addr) *= (float)read<uint64_t>(rhs_addr); return;
+                case subcode(34): write<float>(lhs_addr) *= read<float>(rhs_addr); return;
+                case subcode(35): write<double>(lhs_addr) *= (double)read<int8_t>(rhs_addr); return;
+                case subcode(36): write<double>(lhs_addr) *= (double)read<uint8_t>(rhs_addr); return;
+                case subcode(37): write<double>(lhs_addr) *= (double)read<int16_t>(rhs_addr); return;
+                case subcode(38): write<double>(lhs_addr) *= (double)read<uint16_t>(rhs_addr); return;
+                case subcode(39): write<double>(lhs_addr) *= (double)read<int32_t>(rhs_addr); return;
+                case subcode(40): write<double>(lhs_addr) *= (double)read<uint32_t>(rhs_addr); return;
+                case subcode(41): write<double>(lhs_addr) *= (double)read<int64_t>(rhs_addr); return;
+                case subcode(42): write<double>(lhs_addr) *= (double)read<uint64_t>(rhs_addr); return;
+                case subcode(43): write<double>(lhs_addr) *= (double)read<float>(rhs_addr); return;
+                case subcode(44): write<double>(lhs_addr) *= read<double>(rhs_addr); return;
             }
-            return 0;
         }
-        inline int32_t cgt() noexcept
+        inline void ari_div() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
             auto rhs_addr = read_address(true);
 
-            switch (sub)
-            {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) > read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) > read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) > read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) > read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) > read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) > read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) > read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) > read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) > read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) > (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) > (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) > (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) > (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) > (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) > read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) > read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) > (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) > (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) > (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) > (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) > (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) > (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) > (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) > (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) > read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) > read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) > (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) > (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) > (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) > (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) > (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) > (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) > (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) > (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) > (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) > read<double>(rhs_addr);
-            }
-            return 0;
+            ari_div(sub, lhs_addr, rhs_addr);
         }
-        inline int32_t cge() noexcept
+        INTERPRETER_INLINE void ari_div(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
             switch (sub)
             {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) >= read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) >= read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) >= read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) >= read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) >= read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) >= read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) >= (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) >= (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) >= (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) >= (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) >= (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) >= read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) >= (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) >= (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) >= (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) >= (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) >= (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) >= (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) >= (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) >= (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) >= read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) >= read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) >= (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) >= (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) >= (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) >= (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) >= (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) >= (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) >= (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) >= (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) >= (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(0): write<int8_t>(lhs_addr) /= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) /= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) /= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) /= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) /= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) /= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) /= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) /= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) /= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) /= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) /= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) /= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) /= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) /= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) /= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) /= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) /= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) /= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) /= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) /= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) /= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) /= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) /= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) /= read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) /= (float)read<int8_t>(rhs_addr); return;
+                case subcode(27): write<float>(lhs_addr) /= (float)read<uint8_t>(rhs_addr); return;
+                case subcode(28): write<float>(lhs_addr) /= (float)read<int16_t>(rhs_addr); return;
+                case subcode(29): write<float>(lhs_addr) /= (float)read<uint16_t>(rhs_addr); return;
+                case subcode(30): write<float>(lhs_addr) /= (float)read<int32_t>(rhs_addr); return;
+                case subcode(31): write<float>(lhs_addr) /= (float)read<uint32_t>(rhs_addr); return;
+                case subcode(32): write<float>(lhs_addr) /= (float)read<int64_t>(rhs_addr); return;
+                case subcode(33): write<float>(lhs_addr) /= (float)read<uint64_t>(rhs_addr); return;
+                case subcode(34): write<float>(lhs_addr) /= read<float>(rhs_addr); return;
+                case subcode(35): write<double>(lhs_addr) /= (double)read<int8_t>(rhs_addr); return;
+                case subcode(36): write<double>(lhs_addr) /= (double)read<uint8_t>(rhs_addr); return;
+                case subcode(37): write<double>(lhs_addr) /= (double)read<int16_t>(rhs_addr); return;
+                case subcode(38): write<double>(lhs_addr) /= (double)read<uint16_t>(rhs_addr); return;
+                case subcode(39): write<double>(lhs_addr) /= (double)read<int32_t>(rhs_addr); return;
+                case subcode(40): write<double>(lhs_addr) /= (double)read<uint32_t>(rhs_addr); return;
+                case subcode(41): write<double>(lhs_addr) /= (double)read<int64_t>(rhs_addr); return;
+                case subcode(42): write<double>(lhs_addr) /= (double)read<uint64_t>(rhs_addr); return;
+                case subcode(43): write<double>(lhs_addr) /= (double)read<float>(rhs_addr); return;
+                case subcode(44): write<double>(lhs_addr) /= read<double>(rhs_addr); return;
             }
-            return 0;
         }
-        inline int32_t clt() noexcept
+        inline void ari_mod() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
             auto rhs_addr = read_address(true);
 
-            switch (sub)
-            {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) < read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) < read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) < read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) < read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) < read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) < read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) < read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) < read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) < read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) < (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) < (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) < (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) < (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) < (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) < read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) < read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) < (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) < (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) < (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) < (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) < (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) < (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) < (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) < (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) < read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) < read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) < (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) < (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) < (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) < (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) < (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) < (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) < (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) < (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) < (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) < read<double>(rhs_addr);
-            }
-            return 0;
+            ari_mod(sub, lhs_addr, rhs_addr);
         }
-        inline int32_t cle() noexcept
+        INTERPRETER_INLINE void ari_mod(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
-            auto rhs_addr = read_address(true);
-
             switch (sub)
             {
-                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) <= read<int32_t>(rhs_addr);
-                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(7): return (float)read<int8_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(8): return (double)read<int8_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) <= read<int32_t>(rhs_addr);
-                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
-                case subcode(17): return (float)read<uint8_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(18): return (double)read<uint8_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) <= read<int32_t>(rhs_addr);
-                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(26): return (float)read<int16_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(27): return (double)read<int16_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) <= read<int32_t>(rhs_addr);
-                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
-                case subcode(36): return (float)read<uint16_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(37): return (double)read<uint16_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(38): return read<int32_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
-                case subcode(39): return read<int32_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
-                case subcode(40): return read<int32_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
-                case subcode(41): return read<int32_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
-                case subcode(42): return read<int32_t>(lhs_addr) <= read<int32_t>(rhs_addr);
-                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(45): return (float)read<int32_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(46): return (double)read<int32_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int8_t>(rhs_addr);
-                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int16_t>(rhs_addr);
-                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int32_t>(rhs_addr);
-                case subcode(52): return read<uint32_t>(lhs_addr) <= read<uint32_t>(rhs_addr);
-                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
-                case subcode(55): return (float)read<uint32_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(56): return (double)read<uint32_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(57): return read<int64_t>(lhs_addr) <= (int64_t)read<int8_t>(rhs_addr);
-                case subcode(58): return read<int64_t>(lhs_addr) <= (int64_t)read<uint8_t>(rhs_addr);
-                case subcode(59): return read<int64_t>(lhs_addr) <= (int64_t)read<int16_t>(rhs_addr);
-                case subcode(60): return read<int64_t>(lhs_addr) <= (int64_t)read<uint16_t>(rhs_addr);
-                case subcode(61): return read<int64_t>(lhs_addr) <= (int64_t)read<int32_t>(rhs_addr);
-                case subcode(62): return read<int64_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
-                case subcode(63): return read<int64_t>(lhs_addr) <= read<int64_t>(rhs_addr);
-                case subcode(64): return (float)read<int64_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(65): return (double)read<int64_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(66): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint8_t>(rhs_addr);
-                case subcode(67): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint16_t>(rhs_addr);
-                case subcode(68): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint32_t>(rhs_addr);
-                case subcode(69): return read<uint64_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
-                case subcode(70): return (float)read<uint64_t>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(71): return (double)read<uint64_t>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(72): return read<float>(lhs_addr) <= (float)read<int8_t>(rhs_addr);
-                case subcode(73): return read<float>(lhs_addr) <= (float)read<uint8_t>(rhs_addr);
-                case subcode(74): return read<float>(lhs_addr) <= (float)read<int16_t>(rhs_addr);
-                case subcode(75): return read<float>(lhs_addr) <= (float)read<uint16_t>(rhs_addr);
-                case subcode(76): return read<float>(lhs_addr) <= (float)read<int32_t>(rhs_addr);
-                case subcode(77): return read<float>(lhs_addr) <= (float)read<uint32_t>(rhs_addr);
-                case subcode(78): return read<float>(lhs_addr) <= (float)read<int64_t>(rhs_addr);
-                case subcode(79): return read<float>(lhs_addr) <= (float)read<uint64_t>(rhs_addr);
-                case subcode(80): return read<float>(lhs_addr) <= read<float>(rhs_addr);
-                case subcode(81): return (double)read<float>(lhs_addr) <= read<double>(rhs_addr);
-                case subcode(82): return read<double>(lhs_addr) <= (double)read<int8_t>(rhs_addr);
-                case subcode(83): return read<double>(lhs_addr) <= (double)read<uint8_t>(rhs_addr);
-                case subcode(84): return read<double>(lhs_addr) <= (double)read<int16_t>(rhs_addr);
-                case subcode(85): return read<double>(lhs_addr) <= (double)read<uint16_t>(rhs_addr);
-                case subcode(86): return read<double>(lhs_addr) <= (double)read<int32_t>(rhs_addr);
-                case subcode(87): return read<double>(lhs_addr) <= (double)read<uint32_t>(rhs_addr);
-                case subcode(88): return read<double>(lhs_addr) <= (double)read<int64_t>(rhs_addr);
-                case subcode(89): return read<double>(lhs_addr) <= (double)read<uint64_t>(rhs_addr);
-                case subcode(90): return read<double>(lhs_addr) <= (double)read<float>(rhs_addr);
-                case subcode(91): return read<double>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(0): write<int8_t>(lhs_addr) %= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) %= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) %= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) %= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) %= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) %= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) %= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) %= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) %= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) %= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) %= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) %= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) %= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) %= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) %= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) %= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) %= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) %= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) %= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) %= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) %= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) %= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) %= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) %= read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int8_t>(rhs_addr)); return;
+                case subcode(27): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint8_t>(rhs_addr)); return;
+                case subcode(28): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int16_t>(rhs_addr)); return;
+                case subcode(29): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint16_t>(rhs_addr)); return;
+                case subcode(30): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int32_t>(rhs_addr)); return;
+                case subcode(31): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint32_t>(rhs_addr)); return;
+                case subcode(32): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<int64_t>(rhs_addr)); return;
+                case subcode(33): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), (float)read<uint64_t>(rhs_addr)); return;
+                case subcode(34): write<float>(lhs_addr) = fmodf(read<float>(lhs_addr), read<float>(rhs_addr)); return;
+                case subcode(35): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int8_t>(rhs_addr)); return;
+                case subcode(36): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint8_t>(rhs_addr)); return;
+                case subcode(37): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int16_t>(rhs_addr)); return;
+                case subcode(38): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint16_t>(rhs_addr)); return;
+                case subcode(39): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int32_t>(rhs_addr)); return;
+                case subcode(40): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint32_t>(rhs_addr)); return;
+                case subcode(41): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<int64_t>(rhs_addr)); return;
+                case subcode(42): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<uint64_t>(rhs_addr)); return;
+                case subcode(43): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), (double)read<float>(rhs_addr)); return;
+                case subcode(44): write<double>(lhs_addr) = fmod(read<double>(lhs_addr), read<double>(rhs_addr)); return;
             }
-            return 0;
         }
-        inline int32_t cze() noexcept
+        inline void ari_add() noexcept
         {
             const subcode sub = read_subcode();
             auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
 
+            ari_add(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_add(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
             switch (sub)
             {
-                case subcode(0): return read<int8_t>(lhs_addr) == 0;
-                case subcode(1): return read<uint8_t>(lhs_addr) == 0;
-                case subcode(2): return read<int16_t>(lhs_addr) == 0;
-                case subcode(3): return read<uint16_t>(lhs_addr) == 0;
-                case subcode(4): return read<int32_t>(lhs_addr) == 0;
-                case subcode(5): return read<uint32_t>(lhs_addr) == 0;
-                case subcode(6): return read<int64_t>(lhs_addr) == 0;
-                case subcode(7): return read<uint64_t>(lhs_addr) == 0;
-                case subcode(8): return read<float>(lhs_addr) == 0;
-                case subcode(9): return read<double>(lhs_addr) == 0;
+                case subcode(0): write<int8_t>(lhs_addr) += read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) += read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) += (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) += (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) += read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) += (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) += read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) += (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) += (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) += (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) += (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) += read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) += (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) += (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) += read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) += (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) += (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) += (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) += (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) += (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) += (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) += read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) += (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) += (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) += (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) += read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) += (float)read<int8_t>(rhs_addr); return;
+                case subcode(27): write<float>(lhs_addr) += (float)read<uint8_t>(rhs_addr); return;
+                case subcode(28): write<float>(lhs_addr) += (float)read<int16_t>(rhs_addr); return;
+                case subcode(29): write<float>(lhs_addr) += (float)read<uint16_t>(rhs_addr); return;
+                case subcode(30): write<float>(lhs_addr) += (float)read<int32_t>(rhs_addr); return;
+                case subcode(31): write<float>(lhs_addr) += (float)read<uint32_t>(rhs_addr); return;
+                case subcode(32): write<float>(lhs_addr) += (float)read<int64_t>(rhs_addr); return;
+                case subcode(33): write<float>(lhs_addr) += (float)read<uint64_t>(rhs_addr); return;
+                case subcode(34): write<float>(lhs_addr) += read<float>(rhs_addr); return;
+                case subcode(35): write<double>(lhs_addr) += (double)read<int8_t>(rhs_addr); return;
+                case subcode(36): write<double>(lhs_addr) += (double)read<uint8_t>(rhs_addr); return;
+                case subcode(37): write<double>(lhs_addr) += (double)read<int16_t>(rhs_addr); return;
+                case subcode(38): write<double>(lhs_addr) += (double)read<uint16_t>(rhs_addr); return;
+                case subcode(39): write<double>(lhs_addr) += (double)read<int32_t>(rhs_addr); return;
+                case subcode(40): write<double>(lhs_addr) += (double)read<uint32_t>(rhs_addr); return;
+                case subcode(41): write<double>(lhs_addr) += (double)read<int64_t>(rhs_addr); return;
+                case subcode(42): write<double>(lhs_addr) += (double)read<uint64_t>(rhs_addr); return;
+                case subcode(43): write<double>(lhs_addr) += (double)read<float>(rhs_addr); return;
+                case subcode(44): write<double>(lhs_addr) += read<double>(rhs_addr); return;
+            }
+        }
+        inline void ari_sub() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_sub(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_sub(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) -= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) -= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) -= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) -= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) -= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) -= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) -= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) -= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) -= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) -= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) -= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) -= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) -= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) -= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) -= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) -= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) -= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) -= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) -= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) -= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) -= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) -= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) -= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) -= read<uint64_t>(rhs_addr); return;
+                case subcode(26): write<float>(lhs_addr) -= (float)read<int8_t>(rhs_addr); return;
+                case subcode(27): write<float>(lhs_addr) -= (float)read<uint8_t>(rhs_addr); return;
+                case subcode(28): write<float>(lhs_addr) -= (float)read<int16_t>(rhs_addr); return;
+                case subcode(29): write<float>(lhs_addr) -= (float)read<uint16_t>(rhs_addr); return;
+                case subcode(30): write<float>(lhs_addr) -= (float)read<int32_t>(rhs_addr); return;
+                case subcode(31): write<float>(lhs_addr) -= (float)read<uint32_t>(rhs_addr); return;
+                case subcode(32): write<float>(lhs_addr) -= (float)read<int64_t>(rhs_addr); return;
+                case subcode(33): write<float>(lhs_addr) -= (float)read<uint64_t>(rhs_addr); return;
+                case subcode(34): write<float>(lhs_addr) -= read<float>(rhs_addr); return;
+                case subcode(35): write<double>(lhs_addr) -= (double)read<int8_t>(rhs_addr); return;
+                case subcode(36): write<double>(lhs_addr) -= (double)read<uint8_t>(rhs_addr); return;
+                case subcode(37): write<double>(lhs_addr) -= (double)read<int16_t>(rhs_addr); return;
+                case subcode(38): write<double>(lhs_addr) -= (double)read<uint16_t>(rhs_addr); return;
+                case subcode(39): write<double>(lhs_addr) -= (double)read<int32_t>(rhs_addr); return;
+                case subcode(40): write<double>(lhs_addr) -= (double)read<uint32_t>(rhs_addr); return;
+                case subcode(41): write<double>(lhs_addr) -= (double)read<int64_t>(rhs_addr); return;
+                case subcode(42): write<double>(lhs_addr) -= (double)read<uint64_t>(rhs_addr); return;
+                case subcode(43): write<double>(lhs_addr) -= (double)read<float>(rhs_addr); return;
+                case subcode(44): write<double>(lhs_addr) -= read<double>(rhs_addr); return;
+            }
+        }
+        inline void ari_lsh() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_lsh(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_lsh(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) <<= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) <<= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) <<= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) <<= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) <<= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) <<= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) <<= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) <<= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) <<= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) <<= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) <<= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) <<= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) <<= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) <<= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) <<= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) <<= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) <<= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) <<= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) <<= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) <<= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) <<= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) <<= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) <<= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) <<= read<uint64_t>(rhs_addr); return;
+            }
+        }
+        inline void ari_rsh() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_rsh(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_rsh(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) >>= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) >>= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) >>= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) >>= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) >>= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) >>= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) >>= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) >>= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) >>= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) >>= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) >>= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) >>= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) >>= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) >>= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) >>= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) >>= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) >>= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) >>= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) >>= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) >>= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) >>= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) >>= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) >>= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) >>= read<uint64_t>(rhs_addr); return;
+            }
+        }
+        inline void ari_and() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_and(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_and(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) &= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) &= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) &= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) &= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) &= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) &= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) &= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) &= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) &= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) &= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) &= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) &= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) &= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) &= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) &= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) &= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) &= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) &= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) &= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) &= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) &= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) &= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) &= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) &= read<uint64_t>(rhs_addr); return;
+            }
+        }
+        inline void ari_xor() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_xor(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_xor(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) ^= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) ^= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) ^= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) ^= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) ^= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) ^= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) ^= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) ^= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) ^= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) ^= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) ^= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) ^= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) ^= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) ^= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) ^= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) ^= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) ^= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) ^= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) ^= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) ^= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) ^= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) ^= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) ^= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) ^= read<uint64_t>(rhs_addr); return;
+            }
+        }
+        inline void ari_or() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            ari_or(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void ari_or(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<int8_t>(lhs_addr) |= read<int8_t>(rhs_addr); return;
+                case subcode(1): write<uint8_t>(lhs_addr) |= read<uint8_t>(rhs_addr); return;
+                case subcode(2): write<int16_t>(lhs_addr) |= (int16_t)read<int8_t>(rhs_addr); return;
+                case subcode(3): write<int16_t>(lhs_addr) |= (int16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(4): write<int16_t>(lhs_addr) |= read<int16_t>(rhs_addr); return;
+                case subcode(5): write<uint16_t>(lhs_addr) |= (uint16_t)read<uint8_t>(rhs_addr); return;
+                case subcode(6): write<uint16_t>(lhs_addr) |= read<uint16_t>(rhs_addr); return;
+                case subcode(7): write<int32_t>(lhs_addr) |= (int32_t)read<int8_t>(rhs_addr); return;
+                case subcode(8): write<int32_t>(lhs_addr) |= (int32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(9): write<int32_t>(lhs_addr) |= (int32_t)read<int16_t>(rhs_addr); return;
+                case subcode(10): write<int32_t>(lhs_addr) |= (int32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(11): write<int32_t>(lhs_addr) |= read<int32_t>(rhs_addr); return;
+                case subcode(12): write<uint32_t>(lhs_addr) |= (uint32_t)read<uint8_t>(rhs_addr); return;
+                case subcode(13): write<uint32_t>(lhs_addr) |= (uint32_t)read<uint16_t>(rhs_addr); return;
+                case subcode(14): write<uint32_t>(lhs_addr) |= read<uint32_t>(rhs_addr); return;
+                case subcode(15): write<int64_t>(lhs_addr) |= (int64_t)read<int8_t>(rhs_addr); return;
+                case subcode(16): write<int64_t>(lhs_addr) |= (int64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(17): write<int64_t>(lhs_addr) |= (int64_t)read<int16_t>(rhs_addr); return;
+                case subcode(18): write<int64_t>(lhs_addr) |= (int64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(19): write<int64_t>(lhs_addr) |= (int64_t)read<int32_t>(rhs_addr); return;
+                case subcode(20): write<int64_t>(lhs_addr) |= (int64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(21): write<int64_t>(lhs_addr) |= read<int64_t>(rhs_addr); return;
+                case subcode(22): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint8_t>(rhs_addr); return;
+                case subcode(23): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint16_t>(rhs_addr); return;
+                case subcode(24): write<uint64_t>(lhs_addr) |= (uint64_t)read<uint32_t>(rhs_addr); return;
+                case subcode(25): write<uint64_t>(lhs_addr) |= read<uint64_t>(rhs_addr); return;
+            }
+        }
+
+        inline void padd() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            const size_t underlying_size = get_addr_type(false).generated.pointer.underlying_size;
+            padd(sub, lhs_addr, rhs_addr, underlying_size);
+        }
+        INTERPRETER_INLINE void padd(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr, size_t underlying_size) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int8_t>(rhs_addr)); return;
+                case subcode(1): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint8_t>(rhs_addr)); return;
+                case subcode(2): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int16_t>(rhs_addr)); return;
+                case subcode(3): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint16_t>(rhs_addr)); return;
+                case subcode(4): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<int32_t>(rhs_addr)); return;
+                case subcode(5): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint32_t>(rhs_addr)); return;
+                case subcode(6): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * read<size_t>(rhs_addr)); return;
+                case subcode(7): write<uint8_t*>(lhs_addr) += ((size_t)underlying_size * (size_t)read<uint64_t>(rhs_addr)); return;
+            }
+        }
+        inline void psub() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            const size_t underlying_size = get_addr_type(false).generated.pointer.underlying_size;
+            psub(sub, lhs_addr, rhs_addr, underlying_size);
+        }
+        INTERPRETER_INLINE void psub(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr, size_t underlying_size) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int8_t>(rhs_addr)); return;
+                case subcode(1): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint8_t>(rhs_addr)); return;
+                case subcode(2): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int16_t>(rhs_addr)); return;
+                case subcode(3): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint16_t>(rhs_addr)); return;
+                case subcode(4): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<int32_t>(rhs_addr)); return;
+                case subcode(5): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint32_t>(rhs_addr)); return;
+                case subcode(6): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * read<size_t>(rhs_addr)); return;
+                case subcode(7): write<uint8_t*>(lhs_addr) -= ((size_t)underlying_size * (size_t)read<uint64_t>(rhs_addr)); return;
+            }
+        }
+        inline void pdif() noexcept
+        {
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            const offset_t underlying_size = offset_t(get_addr_type(false).generated.pointer.underlying_size);
+            const offset_t lhs = reinterpret_cast<offset_t>(dereference(lhs_addr));
+            const offset_t rhs = reinterpret_cast<offset_t>(dereference(rhs_addr));
+            write<offset_t>(push_return_value(derive_type_index_v<offset_t>)) = (lhs - rhs) / underlying_size;
+        }
+
+        inline int32_t cmp() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return cmp(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cmp(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
+                case subcode(1): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
+                case subcode(2): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
+                case subcode(3): return compare((int32_t)read<int8_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
+                case subcode(4): return compare((int32_t)read<int8_t>(lhs_addr), read<int32_t>(rhs_addr));
+                case subcode(5): return compare((int64_t)read<int8_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(6): return compare((int64_t)read<int8_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(7): return compare((float)read<int8_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(8): return compare((double)read<int8_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(9): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
+                case subcode(10): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
+                case subcode(11): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
+                case subcode(12): return compare((int32_t)read<uint8_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
+                case subcode(13): return compare((int32_t)read<uint8_t>(lhs_addr), read<int32_t>(rhs_addr));
+                case subcode(14): return compare((int64_t)read<uint8_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(15): return compare((int64_t)read<uint8_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(16): return compare((uint64_t)read<uint8_t>(lhs_addr), read<uint64_t>(rhs_addr));
+                case subcode(17): return compare((float)read<uint8_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(18): return compare((double)read<uint8_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(19): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
+                case subcode(20): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
+                case subcode(21): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
+                case subcode(22): return compare((int32_t)read<int16_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
+                case subcode(23): return compare((int32_t)read<int16_t>(lhs_addr), read<int32_t>(rhs_addr));
+                case subcode(24): return compare((int64_t)read<int16_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(25): return compare((int64_t)read<int16_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(26): return compare((float)read<int16_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(27): return compare((double)read<int16_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(28): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
+                case subcode(29): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
+                case subcode(30): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
+                case subcode(31): return compare((int32_t)read<uint16_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
+                case subcode(32): return compare((int32_t)read<uint16_t>(lhs_addr), read<int32_t>(rhs_addr));
+                case subcode(33): return compare((int64_t)read<uint16_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(34): return compare((int64_t)read<uint16_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(35): return compare((uint64_t)read<uint16_t>(lhs_addr), read<uint64_t>(rhs_addr));
+                case subcode(36): return compare((float)read<uint16_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(37): return compare((double)read<uint16_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(38): return compare(read<int32_t>(lhs_addr), (int32_t)read<int8_t>(rhs_addr));
+                case subcode(39): return compare(read<int32_t>(lhs_addr), (int32_t)read<uint8_t>(rhs_addr));
+                case subcode(40): return compare(read<int32_t>(lhs_addr), (int32_t)read<int16_t>(rhs_addr));
+                case subcode(41): return compare(read<int32_t>(lhs_addr), (int32_t)read<uint16_t>(rhs_addr));
+                case subcode(42): return compare(read<int32_t>(lhs_addr), read<int32_t>(rhs_addr));
+                case subcode(43): return compare((int64_t)read<int32_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(44): return compare((int64_t)read<int32_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(45): return compare((float)read<int32_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(46): return compare((double)read<int32_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(47): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int8_t>(rhs_addr));
+                case subcode(48): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<uint8_t>(rhs_addr));
+                case subcode(49): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int16_t>(rhs_addr));
+                case subcode(50): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<uint16_t>(rhs_addr));
+                case subcode(51): return compare((int64_t)read<uint32_t>(lhs_addr), (int64_t)read<int32_t>(rhs_addr));
+                case subcode(52): return compare(read<uint32_t>(lhs_addr), read<uint32_t>(rhs_addr));
+                case subcode(53): return compare((int64_t)read<uint32_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(54): return compare((uint64_t)read<uint32_t>(lhs_addr), read<uint64_t>(rhs_addr));
+                case subcode(55): return compare((float)read<uint32_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(56): return compare((double)read<uint32_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(57): return compare(read<int64_t>(lhs_addr), (int64_t)read<int8_t>(rhs_addr));
+                case subcode(58): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint8_t>(rhs_addr));
+                case subcode(59): return compare(read<int64_t>(lhs_addr), (int64_t)read<int16_t>(rhs_addr));
+                case subcode(60): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint16_t>(rhs_addr));
+                case subcode(61): return compare(read<int64_t>(lhs_addr), (int64_t)read<int32_t>(rhs_addr));
+                case subcode(62): return compare(read<int64_t>(lhs_addr), (int64_t)read<uint32_t>(rhs_addr));
+                case subcode(63): return compare(read<int64_t>(lhs_addr), read<int64_t>(rhs_addr));
+                case subcode(64): return compare((float)read<int64_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(65): return compare((double)read<int64_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(66): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint8_t>(rhs_addr));
+                case subcode(67): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint16_t>(rhs_addr));
+                case subcode(68): return compare(read<uint64_t>(lhs_addr), (uint64_t)read<uint32_t>(rhs_addr));
+                case subcode(69): return compare(read<uint64_t>(lhs_addr), read<uint64_t>(rhs_addr));
+                case subcode(70): return compare((float)read<uint64_t>(lhs_addr), read<float>(rhs_addr));
+                case subcode(71): return compare((double)read<uint64_t>(lhs_addr), read<double>(rhs_addr));
+                case subcode(72): return compare(read<float>(lhs_addr), (float)read<int8_t>(rhs_addr));
+                case subcode(73): return compare(read<float>(lhs_addr), (float)read<uint8_t>(rhs_addr));
+                case subcode(74): return compare(read<float>(lhs_addr), (float)read<int16_t>(rhs_addr));
+                case subcode(75): return compare(read<float>(lhs_addr), (float)read<uint16_t>(rhs_addr));
+                case subcode(76): return compare(read<float>(lhs_addr), (float)read<int32_t>(rhs_addr));
+                case subcode(77): return compare(read<float>(lhs_addr), (float)read<uint32_t>(rhs_addr));
+                case subcode(78): return compare(read<float>(lhs_addr), (float)read<int64_t>(rhs_addr));
+                case subcode(79): return compare(read<float>(lhs_addr), (float)read<uint64_t>(rhs_addr));
+                case subcode(80): return compare(read<float>(lhs_addr), read<float>(rhs_addr));
+                case subcode(81): return compare((double)read<float>(lhs_addr), read<double>(rhs_addr));
+                case subcode(82): return compare(read<double>(lhs_addr), (double)read<int8_t>(rhs_addr));
+                case subcode(83): return compare(read<double>(lhs_addr), (double)read<uint8_t>(rhs_addr));
+                case subcode(84): return compare(read<double>(lhs_addr), (double)read<int16_t>(rhs_addr));
+                case subcode(85): return compare(read<double>(lhs_addr), (double)read<uint16_t>(rhs_addr));
+                case subcode(86): return compare(read<double>(lhs_addr), (double)read<int32_t>(rhs_addr));
+                case subcode(87): return compare(read<double>(lhs_addr), (double)read<uint32_t>(rhs_addr));
+                case subcode(88): return compare(read<double>(lhs_addr), (double)read<int64_t>(rhs_addr));
+                case subcode(89): return compare(read<double>(lhs_addr), (double)read<uint64_t>(rhs_addr));
+                case subcode(90): return compare(read<double>(lhs_addr), (double)read<float>(rhs_addr));
+                case subcode(91): return compare(read<double>(lhs_addr), read<double>(rhs_addr));
+            }
+            return 0;
+        }
+        inline int32_t ceq() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return ceq(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t ceq(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) == read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) == read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) == read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) == read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) == read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) == read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) == (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) == (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) == (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) == (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) == read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) == (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) == read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) == read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) == (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) == (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) == (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) == (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) == (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) == (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) == read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) == (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) == read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) == (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) == (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) == (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) == (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) == (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) == (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) == (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) == (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) == read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) == read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) == (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) == (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) == (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) == (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) == (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) == (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) == (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) == (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) == (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) == read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t cne() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return cne(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cne(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) != read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) != read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) != read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) != read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) != read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) != read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) != (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) != (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) != (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) != (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) != read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) != (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) != read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) != read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) != (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) != (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) != (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) != (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) != (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) != (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) != read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) != (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) != read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) != (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) != (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) != (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) != (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) != (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) != (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) != (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) != (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) != read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) != read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) != (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) != (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) != (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) != (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) != (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) != (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) != (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) != (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) != (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) != read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t cgt() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return cgt(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cgt(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) > read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) > read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) > read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) > read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) > read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) > read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) > (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) > (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) > (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) > (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) > read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) > (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) > read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) > read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) > (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) > (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) > (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) > (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) > (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) > (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) > read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) > (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) > read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) > (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) > (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) > (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) > (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) > (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) > (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) > (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) > (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) > read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) > read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) > (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) > (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) > (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) > (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) > (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) > (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) > (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) > (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) > (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) > read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t cge() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return cge(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cge(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) >= read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) >= read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) >= read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) >= read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) >= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) >= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) >= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) >= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) >= read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) >= (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) >= read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) >= (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) >= (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) >= (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) >= (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) >= (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) >= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) >= read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) >= (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) >= read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) >= (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) >= (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) >= (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) >= (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) >= (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) >= (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) >= (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) >= (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) >= read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) >= read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) >= (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) >= (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) >= (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) >= (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) >= (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) >= (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) >= (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) >= (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) >= (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) >= read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t clt() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return clt(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t clt(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) < read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) < read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) < read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) < read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) < read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) < read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) < (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) < (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) < (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) < (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) < read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) < (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) < read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) < read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) < (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) < (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) < (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) < (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) < (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) < (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) < read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) < (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) < read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) < (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) < (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) < (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) < (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) < (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) < (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) < (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) < (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) < read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) < read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) < (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) < (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) < (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) < (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) < (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) < (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) < (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) < (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) < (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) < read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t cle() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            return cle(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cle(subcode sub, const uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(1): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(2): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(3): return (int32_t)read<int8_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(4): return (int32_t)read<int8_t>(lhs_addr) <= read<int32_t>(rhs_addr);
+                case subcode(5): return (int64_t)read<int8_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(6): return (int64_t)read<int8_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(7): return (float)read<int8_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(8): return (double)read<int8_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(9): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(10): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(11): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(12): return (int32_t)read<uint8_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(13): return (int32_t)read<uint8_t>(lhs_addr) <= read<int32_t>(rhs_addr);
+                case subcode(14): return (int64_t)read<uint8_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(15): return (int64_t)read<uint8_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(16): return (uint64_t)read<uint8_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
+                case subcode(17): return (float)read<uint8_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(18): return (double)read<uint8_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(19): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(20): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(21): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(22): return (int32_t)read<int16_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(23): return (int32_t)read<int16_t>(lhs_addr) <= read<int32_t>(rhs_addr);
+                case subcode(24): return (int64_t)read<int16_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(25): return (int64_t)read<int16_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(26): return (float)read<int16_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(27): return (double)read<int16_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(28): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(29): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(30): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(31): return (int32_t)read<uint16_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(32): return (int32_t)read<uint16_t>(lhs_addr) <= read<int32_t>(rhs_addr);
+                case subcode(33): return (int64_t)read<uint16_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(34): return (int64_t)read<uint16_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(35): return (uint64_t)read<uint16_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
+                case subcode(36): return (float)read<uint16_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(37): return (double)read<uint16_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(38): return read<int32_t>(lhs_addr) <= (int32_t)read<int8_t>(rhs_addr);
+                case subcode(39): return read<int32_t>(lhs_addr) <= (int32_t)read<uint8_t>(rhs_addr);
+                case subcode(40): return read<int32_t>(lhs_addr) <= (int32_t)read<int16_t>(rhs_addr);
+                case subcode(41): return read<int32_t>(lhs_addr) <= (int32_t)read<uint16_t>(rhs_addr);
+                case subcode(42): return read<int32_t>(lhs_addr) <= read<int32_t>(rhs_addr);
+                case subcode(43): return (int64_t)read<int32_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(44): return (int64_t)read<int32_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(45): return (float)read<int32_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(46): return (double)read<int32_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(47): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int8_t>(rhs_addr);
+                case subcode(48): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(49): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int16_t>(rhs_addr);
+                case subcode(50): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(51): return (int64_t)read<uint32_t>(lhs_addr) <= (int64_t)read<int32_t>(rhs_addr);
+                case subcode(52): return read<uint32_t>(lhs_addr) <= read<uint32_t>(rhs_addr);
+                case subcode(53): return (int64_t)read<uint32_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(54): return (uint64_t)read<uint32_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
+                case subcode(55): return (float)read<uint32_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(56): return (double)read<uint32_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(57): return read<int64_t>(lhs_addr) <= (int64_t)read<int8_t>(rhs_addr);
+                case subcode(58): return read<int64_t>(lhs_addr) <= (int64_t)read<uint8_t>(rhs_addr);
+                case subcode(59): return read<int64_t>(lhs_addr) <= (int64_t)read<int16_t>(rhs_addr);
+                case subcode(60): return read<int64_t>(lhs_addr) <= (int64_t)read<uint16_t>(rhs_addr);
+                case subcode(61): return read<int64_t>(lhs_addr) <= (int64_t)read<int32_t>(rhs_addr);
+                case subcode(62): return read<int64_t>(lhs_addr) <= (int64_t)read<uint32_t>(rhs_addr);
+                case subcode(63): return read<int64_t>(lhs_addr) <= read<int64_t>(rhs_addr);
+                case subcode(64): return (float)read<int64_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(65): return (double)read<int64_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(66): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint8_t>(rhs_addr);
+                case subcode(67): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint16_t>(rhs_addr);
+                case subcode(68): return read<uint64_t>(lhs_addr) <= (uint64_t)read<uint32_t>(rhs_addr);
+                case subcode(69): return read<uint64_t>(lhs_addr) <= read<uint64_t>(rhs_addr);
+                case subcode(70): return (float)read<uint64_t>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(71): return (double)read<uint64_t>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(72): return read<float>(lhs_addr) <= (float)read<int8_t>(rhs_addr);
+                case subcode(73): return read<float>(lhs_addr) <= (float)read<uint8_t>(rhs_addr);
+                case subcode(74): return read<float>(lhs_addr) <= (float)read<int16_t>(rhs_addr);
+                case subcode(75): return read<float>(lhs_addr) <= (float)read<uint16_t>(rhs_addr);
+                case subcode(76): return read<float>(lhs_addr) <= (float)read<int32_t>(rhs_addr);
+                case subcode(77): return read<float>(lhs_addr) <= (float)read<uint32_t>(rhs_addr);
+                case subcode(78): return read<float>(lhs_addr) <= (float)read<int64_t>(rhs_addr);
+                case subcode(79): return read<float>(lhs_addr) <= (float)read<uint64_t>(rhs_addr);
+                case subcode(80): return read<float>(lhs_addr) <= read<float>(rhs_addr);
+                case subcode(81): return (double)read<float>(lhs_addr) <= read<double>(rhs_addr);
+                case subcode(82): return read<double>(lhs_addr) <= (double)read<int8_t>(rhs_addr);
+                case subcode(83): return read<double>(lhs_addr) <= (double)read<uint8_t>(rhs_addr);
+                case subcode(84): return read<double>(lhs_addr) <= (double)read<int16_t>(rhs_addr);
+                case subcode(85): return read<double>(lhs_addr) <= (double)read<uint16_t>(rhs_addr);
+                case subcode(86): return read<double>(lhs_addr) <= (double)read<int32_t>(rhs_addr);
+                case subcode(87): return read<double>(lhs_addr) <= (double)read<uint32_t>(rhs_addr);
+                case subcode(88): return read<double>(lhs_addr) <= (double)read<int64_t>(rhs_addr);
+                case subcode(89): return read<double>(lhs_addr) <= (double)read<uint64_t>(rhs_addr);
+                case subcode(90): return read<double>(lhs_addr) <= (double)read<float>(rhs_addr);
+                case subcode(91): return read<double>(lhs_addr) <= read<double>(rhs_addr);
+            }
+            return 0;
+        }
+        inline int32_t cze() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+
+            return cze(sub, lhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cze(subcode sub, const uint8_t* lhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return read<int8_t>(lhs_addr) == 0;
+                case subcode(1): return read<uint8_t>(lhs_addr) == 0;
+                case subcode(2): return read<int16_t>(lhs_addr) == 0;
+                case subcode(3): return read<uint16_t>(lhs_addr) == 0;
+                case subcode(4): return read<int32_t>(lhs_addr) == 0;
+                case subcode(5): return read<uint32_t>(lhs_addr) == 0;
+                case subcode(6): return read<int64_t>(lhs_addr) == 0;
+                case subcode(7): return read<uint64_t>(lhs_addr) == 0;
+                case subcode(8): return read<float>(lhs_addr) == 0;
+                case subcode(9): return read<double>(lhs_addr) == 0;
+            }
+            return 0;
+        }
+        inline int32_t cnz() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+
+            return cnz(sub, lhs_addr);
+        }
+        INTERPRETER_INLINE int32_t cnz(subcode sub, const uint8_t* lhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): return read<int8_t>(lhs_addr) != 0;
+                case subcode(1): return read<uint8_t>(lhs_addr) != 0;
+                case subcode(2): return read<int16_t>(lhs_addr) != 0;
+                case subcode(3): return read<uint16_t>(lhs_addr) != 0;
+                case subcode(4): return read<int32_t>(lhs_addr) != 0;
+                case subcode(5): return read<uint32_t>(lhs_addr) != 0;
+                case subcode(6): return read<int64_t>(lhs_addr) != 0;
+                case subcode(7): return read<uint64_t>(lhs_addr) != 0;
+                case subcode(8): return read<float>(lhs_addr) != 0;
+                case subcode(9): return read<double>(lhs_addr) != 0;
+            }
+            return 0;
+        }
+
+        inline void br() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            jump(branch_location);
+        }
+        inline void beq() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (ceq()) jump(branch_location);
+        }
+        inline void bne() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cne()) jump(branch_location);
+        }
+        inline void bgt() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cgt()) jump(branch_location);
+        }
+        inline void bge() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cge()) jump(branch_location);
+        }
+        inline void blt() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (clt()) jump(branch_location);
+        }
+        inline void ble() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cle()) jump(branch_location);
+        }
+        inline void bze() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cze()) jump(branch_location);
+        }
+        inline void bnz() noexcept
+        {
+            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+
+            if (cnz()) jump(branch_location);
+        }
+
+        inline void sw() noexcept
+        {
+            const uint8_t* idx_addr = read_address(false);
+
+            const uint32_t idx = read_switch_index(addr_type[false], idx_addr);
+
+            const uint32_t label_count = read_bytecode<uint32_t>(sf.iptr);
+
+            const uint32_t* labels = reinterpret_cast<const uint32_t*>(sf.iptr);
+            if (idx < label_count)
+            {
+                jump(labels[idx]);
+            }
+            else
+            {
+                sf.iptr += sizeof(uint32_t) * label_count;
+            }
+        }
+
+        inline void sws() noexcept
+        {
+            const uint8_t* value_addr = read_address(false);
+
+            const type_idx type = addr_type[false];
+            const uint64_t key = get_switch_key(type, read_switch_value(type, value_addr));
+
+            const uint32_t case_count = read_bytecode<uint32_t>(sf.iptr);
+
+            // Cases are sorted by key
+            const uint64_t* values = reinterpret_cast<const uint64_t*>(sf.iptr);
+            const uint32_t* labels = reinterpret_cast<const uint32_t*>(sf.iptr + sizeof(uint64_t) * case_count);
+            uint32_t beg = 0, end = case_count;
+            while (beg < end)
+            {
+                const uint32_t mid = beg + (end - beg) / 2;
+                const uint64_t mid_key = get_switch_key(type, values[mid]);
+                if (mid_key == key)
+                {
+                    jump(labels[mid]);
+                    return;
+                }
+                if (mid_key < key) beg = mid + 1;
+                else end = mid;
+            }
+            sf.iptr += (sizeof(uint64_t) + sizeof(uint32_t)) * case_count;
+        }
+        inline const decoded_instruction* select_switch_case(const decoded_instruction& ins, uint64_t key) const noexcept
+        {
+            if (ins.sub == switch_lowering::jump_table)
+            {
+                const uint64_t idx = key - ins.keys[0];
+                return idx < ins.count ? ins.labels[idx] : &ins + 1;
+            }
+
+            const uint64_t* const beg = ins.keys;
+            const uint64_t* const end = beg + ins.count;
+            const uint64_t* const find = std::lower_bound(beg, end, key);
+            return find != end && *find == key ? ins.labels[find - beg] : &ins + 1;
+        }
+
+        inline uint64_t read_switch_value(type_idx type, const uint8_t* value_addr) const noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return (uint64_t)read<i8>(value_addr);
+                case type_idx::u8: return (uint64_t)read<u8>(value_addr);
+                case type_idx::i16: return (uint64_t)read<i16>(value_addr);
+                case type_idx::u16: return (uint64_t)read<u16>(value_addr);
+                case type_idx::i32: return (uint64_t)read<i32>(value_addr);
+                case type_idx::u32: return (uint64_t)read<u32>(value_addr);
+                case type_idx::i64: return (uint64_t)read<i64>(value_addr);
+                case type_idx::u64: return (uint64_t)read<u64>(value_addr);
+            }
+            return 0;
+        }
+        inline uint32_t read_switch_index(type_idx type, const uint8_t* idx_addr) const noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return (uint32_t)read<i8>(idx_addr);
+                case type_idx::u8: return (uint32_t)read<u8>(idx_addr);
+                case type_idx::i16: return (uint32_t)read<i16>(idx_addr);
+                case type_idx::u16: return (uint32_t)read<u16>(idx_addr);
+                case type_idx::i32: return (uint32_t)read<i32>(idx_addr);
+                case type_idx::u32: return (uint32_t)read<u32>(idx_addr);
+                case type_idx::i64: return (uint32_t)read<i64>(idx_addr);
+                case type_idx::u64: return (uint32_t)read<u64>(idx_addr);
+            }
+            return 0;
+        }
+
+        inline void jump(uint32_t target) noexcept
+        {
+            sf.iptr = ibeg + target;
+
+            clear_return_value();
+        }
+
+        inline void call()
+        {
+            const method_idx call_idx = read_bytecode<method_idx>(sf.iptr);
+            ASSERT(is_valid_method(call_idx), "Attempted to invoke an invalid method");
+            const auto& call_method = get_method(call_idx);
+            push_stack_frame(call_method, get_signature(call_method.signature));
+        }
+        inline void callv()
+        {
+            const uint8_t* method_ptr = read_address(false);
+            size_t method_handle = *reinterpret_cast<const size_t*>(method_ptr);
+            ASSERT(method_handle != 0, "Attempted to invoke a null method pointer");
+            method_handle ^= data.runtime_hash;
+            ASSERT(is_valid_method(method_handle), "Attempted to invoke an invalid method pointer");
+            const method& call_method = get_method(method_idx(method_handle));
+            push_stack_frame(call_method, get_signature(get_addr_type(false).generated.signature.index));
+        }
+        inline void ret()
+        {
+            clear_return_value();
+
+            pop_stack_frame();
+        }
+        inline void retv()
+        {
+            const subcode sub = read_subcode();
+            const uint8_t* ret_value = read_address(true);
+
+            // Set return value (of the current signature)
+            return_value_addr = sf.rptr;
+            return_value_type = method_return_type;
+
+            set(sub, return_value_addr, ret_value);
+
+            pop_stack_frame();
+        }
+
+        // Vector operations (see vector_operations.hpp)
+        inline void vadd() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vadd(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vadd(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::add>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vsub() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vsub(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vsub(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::sub>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vmul() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vmul(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vmul(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::mul>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vdiv() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vdiv(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vdiv(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::div>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vmin() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vmin(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vmin(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::min>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vmax() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vmax(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vmax(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::max>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vceq() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vceq(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vceq(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::ceq>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vcne() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vcne(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vcne(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::cne>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vcgt() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vcgt(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vcgt(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::cgt>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vcge() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vcge(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vcge(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::cge>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vclt() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vclt(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vclt(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::clt>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vcle() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vcle(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vcle(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::evaluate<vector_operations::vector_op::cle>(sub, lhs_addr, rhs_addr);
+        }
+        inline void vshf() noexcept
+        {
+            const subcode sub = read_subcode();
+            auto lhs_addr = read_address(false);
+            auto rhs_addr = read_address(true);
+
+            vshf(sub, lhs_addr, rhs_addr);
+        }
+        INTERPRETER_INLINE void vshf(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            vector_operations::shuffle(sub, lhs_addr, rhs_addr);
+        }
+
+        // Bulk memory operations
+        // The pointer and value operands are read before the length, as reading
+        // an operand can overwrite the temporary value of the previous operand
+        inline void mcpy() noexcept
+        {
+            const subcode sub = read_subcode();
+            uint8_t* const dst = dereference(read_address(false));
+            const size_t element_size = memory_element_size(get_addr_type(false));
+            const uint8_t* const src = dereference(read_address(true));
+            const size_t length = read_integral(memory_length_type(sub), read_address(true));
+
+            memmove(dst, src, length * element_size);
+        }
+        inline void mset() noexcept
+        {
+            const subcode sub = read_subcode();
+            uint8_t* const dst = dereference(read_address(false));
+            const size_t element_size = memory_element_size(get_addr_type(false));
+            const size_t value = read_integral(memory_value_type(sub), read_address(true));
+            const size_t length = read_integral(memory_length_type(sub), read_address(true));
+
+            memset(dst, int(uint8_t(value)), length * element_size);
+        }
+        inline int32_t mcmp() noexcept
+        {
+            const subcode sub = read_subcode();
+            const uint8_t* const lhs = dereference(read_address(false));
+            const size_t element_size = memory_element_size(get_addr_type(false));
+            const uint8_t* const rhs = dereference(read_address(true));
+            const size_t length = read_integral(memory_length_type(sub), read_address(true));
+
+            return compare(memcmp(lhs, rhs, length * element_size), 0);
+        }
+        // Lengths are in elements of the destination pointer type, or in bytes for void pointers
+        inline size_t memory_element_size(const type& pointer_type) const noexcept
+        {
+            return pointer_type.index == type_idx::vptr ? size_t(1) : size_t(pointer_type.generated.pointer.underlying_size);
+        }
+        inline size_t read_integral(type_idx type, const uint8_t* addr) const noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return (size_t)read<i8>(addr);
+                case type_idx::u8: return (size_t)read<u8>(addr);
+                case type_idx::i16: return (size_t)read<i16>(addr);
+                case type_idx::u16: return (size_t)read<u16>(addr);
+                case type_idx::i32: return (size_t)read<i32>(addr);
+                case type_idx::u32: return (size_t)read<u32>(addr);
+                case type_idx::i64: return (size_t)read<i64>(addr);
+                case type_idx::u64: return (size_t)read<u64>(addr);
+            }
+            return 0;
+        }
+
+        inline void dump()
+        {
+            const uint8_t* src_addr = read_address(true);
+
+            dump_recursive(src_addr, get_addr_type(true));
+
+            print_output();
+        }
+
+
+        void dump_recursive(const uint8_t* addr, const type& type)
+        {
+            output_buffer << get_name(type);
+            switch (type.index)
+            {
+                case type_idx::i8: dump_var<i8>(addr); break;
+                case type_idx::u8: dump_var<u8>(addr); break;
+                case type_idx::i16: dump_var<i16>(addr); break;
+                case type_idx::u16: dump_var<u16>(addr); break;
+                case type_idx::i32: dump_var<i32>(addr); break;
+                case type_idx::u32: dump_var<u32>(addr); break;
+                case type_idx::i64: dump_var<i64>(addr); break;
+                case type_idx::u64: dump_var<u64>(addr); break;
+                case type_idx::f32: dump_var<f32>(addr); break;
+                case type_idx::f64: dump_var<f64>(addr); break;
+                default:
+                {
+                    if (type.is_pointer() || type.is_signature())
+                    {
+                        output_buffer << '(' << (void*)*reinterpret_cast<const uint8_t* const*>(addr) << ')';
+                    }
+                    else if (type.is_array())
+                    {
+                        output_buffer << '{';
+                        const uint8_t* ptr = addr;
+                        const auto& underlying_type = get_type(type.generated.array.underlying_type);
+                        for (size_t i = 0; i < type.generated.array.array_size; i++)
+                        {
+                            output_buffer << (i == 0 ? " " : ", ");
+                            dump_recursive(ptr + underlying_type.total_size * i, get_type(underlying_type.index));
+                        }
+                        output_buffer << " }";
+                    }
+                    else if (!type.fields.empty())
+                    {
+                        output_buffer << '{';
+                        for (size_t i = 0; i < type.fields.size(); i++)
+                        {
+                            auto& field = type.fields[i];
+                            output_buffer << (i == 0 ? " " : ", ");
+                            output_buffer << database[field.name] << " = ";
+                            dump_recursive(addr + field.offset, get_type(field.type));
+                        }
+                        output_buffer << " }";
+                    }
+                    else
+                    {
+                        output_buffer << "(?)";
+                    }
+                }
+                break;
+            }
+        }
+        string_view get_name(const type& t) const
+        {
+            if (t.name != name_idx::invalid)
+            {
+                return database[t.name];
+            }
+            else
+            {
+                size_t& index = const_cast<size_t&>(generated_name_index);
+                string& buffer = const_cast<string*>(generated_name_buffers)[index];
+                data.generate_name(t.index, buffer);
+                index = (index + 1) & 1;
+                return buffer;
+            }
+        }
+
+
+        inline const type& get_type(type_idx type) const noexcept
+        {
+            return data.types[type];
+        }
+        inline const method& get_method(method_idx method) const noexcept
+        {
+            return data.methods[method];
+        }
+        inline const signature& get_signature(signature_idx signature) const noexcept
+        {
+            return data.signatures[signature];
+        }
+        inline bool is_valid_method(method_idx method) const noexcept
+        {
+            return static_cast<size_t>(method) < data.methods.size();
+        }
+        inline bool is_valid_method(size_t method_handle) const noexcept
+        {
+            return method_handle < data.methods.size();
+        }
+
+        inline subcode read_subcode() noexcept
+        {
+            return read_bytecode<subcode>(sf.iptr);
+        }
+        uint8_t* read_address(bool is_rhs) noexcept
+        {
+            uint8_t* result = nullptr;
+
+            // Compact addresses are decoded up front, constants are expanded into the temporary
+            const bool is_compact = data.encoding == bytecode_encoding::compact;
+            address_data_t compact_addr(0);
+            if (is_compact)
+            {
+                compact_addr = read_compact_address(sf.iptr, &tmp_var[is_rhs]);
+                if (compact_addr.header.type() == address_type::constant)
+                {
+                    addr_type[is_rhs] = type_idx(compact_addr.header.index());
+                    return reinterpret_cast<uint8_t*>(&tmp_var[is_rhs]);
+                }
+            }
+            const address_data_t& addr = is_compact ? compact_addr : *reinterpret_cast<const address_data_t*>(sf.iptr);
+
+            const uint32_t index = addr.header.index();
+            switch (addr.header.type())
+            {
+                case address_type::stackvar:
+                {
+                    if (index == address_header_constants::index_max)
+                    {
+                        result = return_value_addr;
+                        addr_type[is_rhs] = return_value_type;
+                    }
+                    else
+                    {
+                        const auto& stack_var = method_stackvars[index];
+                        result = stack_offset + stack_var.offset;
+                        addr_type[is_rhs] = stack_var.type;
+                    }
+                }
+                break;
+
+                case address_type::parameter:
+                {
+                    const auto& param = method_parameters[index];
+                    result = param_offset + param.offset;
+                    addr_type[is_rhs] = param.type;
+                }
+                break;
+
+                case address_type::global:
+                {
+                    global_idx global = (global_idx)index;
+
+                    const data_table_view& table = global_tables[is_constant_flag_set(global)];
+                    global &= global_flags::constant_mask;
+
+                    const auto& global_info = table[global];
+                    result = table.data + global_info.offset;
+                    addr_type[is_rhs] = global_info.type;
+                }
+                break;
+
+                case address_type::constant:
+                {
+                    const type_idx btype_idx = type_idx(index);
+                    sf.iptr += sizeof(address_header);
+                    uint8_t* ptr = const_cast<uint8_t*>(sf.iptr);
+                    sf.iptr += get_type(btype_idx).total_size;
+                    addr_type[is_rhs] = btype_idx;
+                    return ptr;
+                }
+                break;
+            }
+
+            switch (addr.header.modifier())
+            {
+                case address_modifier::none: break;
+
+                case address_modifier::direct_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+                    result += field.offset;
+                    addr_type[is_rhs] = field.type;
+                }
+                break;
+
+                case address_modifier::indirect_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+                    result = dereference(result) + field.offset;
+                    addr_type[is_rhs] = field.type;
+                }
+                break;
+
+                case address_modifier::offset:
+                {
+                    const auto& current_type = get_addr_type(is_rhs);
+                    if (current_type.is_pointer())
+                    {
+                        const type& underlying_type = get_type(current_type.generated.pointer.underlying_type);
+                        result = dereference(result) + underlying_type.total_size * addr.offset;
+                        addr_type[is_rhs] = underlying_type.index;
+                    }
+                    else if (current_type.is_array())
+                    {
+                        const type& underlying_type = get_type(current_type.generated.array.underlying_type);
+                        result = result + underlying_type.total_size * addr.offset;
+                        addr_type[is_rhs] = underlying_type.index;
+                    }
+                }
+                break;
+            }
+
+            switch (addr.header.prefix())
+            {
+                case address_prefix::none: break;
+
+                case address_prefix::indirection:
+                {
+                    const auto& current_type = get_addr_type(is_rhs);
+                    result = dereference(result);
+                    addr_type[is_rhs] = current_type.generated.pointer.underlying_type;
+                }
+                break;
+
+                case address_prefix::address_of:
+                {
+                    tmp_var[is_rhs] = reinterpret_cast<size_t>(result);
+                    result = reinterpret_cast<uint8_t*>(&tmp_var[is_rhs]);
+
+                    const auto& current_type = get_addr_type(is_rhs);
+                    const type_idx dst_type = current_type.pointer_type;
+                    addr_type[is_rhs] = dst_type == type_idx::invalid ? type_idx::vptr : dst_type;
+                }
+                break;
+
+                case address_prefix::size_of:
+                {
+                    tmp_var[is_rhs] = get_addr_type(is_rhs).total_size;
+                    result = reinterpret_cast<uint8_t*>(&tmp_var[is_rhs]);
+
+                    addr_type[is_rhs] = derive_type_index_v<size_t>;
+                }
+                break;
             }
-            return 0;
+
+            if (!is_compact) sf.iptr += sizeof(address_data_t);
+
+            return result;
         }
-        inline int32_t cnz() noexcept
+
+        inline uint8_t* resolve(const decoded_operand& operand, size_t& tmp) noexcept
         {
-            const subcode sub = read_subcode();
-            auto lhs_addr = read_address(false);
+            uint8_t* result;
+            switch (operand.base)
+            {
+                case operand_base::frame: result = param_offset + operand.offset; break;
+                case operand_base::global: result = global_tables[0].data + operand.offset; break;
+                case operand_base::absolute: result = reinterpret_cast<uint8_t*>(operand.offset); break;
+                default: return reinterpret_cast<uint8_t*>(const_cast<size_t*>(&operand.offset));
+            }
 
-            switch (sub)
+            if (operand.flags & operand_flags::dereference)
             {
-                case subcode(0): return read<int8_t>(lhs_addr) != 0;
-                case subcode(1): return read<uint8_t>(lhs_addr) != 0;
-                case subcode(2): return read<int16_t>(lhs_addr) != 0;
-                case subcode(3): return read<uint16_t>(lhs_addr) != 0;
-                case subcode(4): return read<int32_t>(lhs_addr) != 0;
-                case subcode(5): return read<uint32_t>(lhs_addr) != 0;
-                case subcode(6): return read<int64_t>(lhs_addr) != 0;
-                case subcode(7): return read<uint64_t>(lhs_addr) != 0;
-                case subcode(8): return read<float>(lhs_addr) != 0;
-                case subcode(9): return read<double>(lhs_addr) != 0;
+                result = dereference(result) + operand.deref_offset;
             }
-            return 0;
+            if (operand.flags & operand_flags::indirection)
+            {
+                result = dereference(result);
+            }
+            if (operand.flags & operand_flags::address_of)
+            {
+                tmp = reinterpret_cast<size_t>(result);
+                result = reinterpret_cast<uint8_t*>(&tmp);
+            }
+
+            return result;
         }
 
-        inline void br() noexcept
+        // Specialized operand resolving
+        template<operand_layout layout> INTERPRETER_INLINE uint8_t* resolve_lhs(const decoded_operand& operand) noexcept
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
-
-            jump(branch_location);
+            if constexpr (layout == operand_layout::generic) return resolve(operand, tmp_var[0]);
+            else return param_offset + operand.offset;
         }
-        inline void beq() noexcept
+        template<operand_layout layout> INTERPRETER_INLINE uint8_t* resolve_rhs(const decoded_operand& operand) noexcept
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
-
-            if (ceq()) jump(branch_location);
+            if constexpr (layout == operand_layout::frame_frame) return param_offset + operand.offset;
+            else if constexpr (layout == operand_layout::frame_immediate) return reinterpret_cast<uint8_t*>(const_cast<size_t*>(&operand.offset));
+            else return resolve(operand, tmp_var[1]);
         }
-        inline void bne() noexcept
+
+        // Specialized handlers
+        // Every handler gets instantiated for each subcode and operand layout.
+        // Because the op implementations are inlined with a constant subcode,
+        // the subcode switch is resolved at compile time.
+#define DEFINE_BINARY_HANDLER(name, count) struct name##_handler                                                \
+        {                                                                                                       \
+            static constexpr size_t subcode_count = count;                                                      \
+            template<subcode sub, operand_layout layout>                                                        \
+            static void invoke(interpreter& ip, const decoded_instruction& ins) noexcept                        \
+            {                                                                                                   \
+                ip.name(sub, ip.resolve_lhs<layout>(ins.lhs), ip.resolve_rhs<layout>(ins.rhs));                 \
+            }                                                                                                   \
+        };
+#define DEFINE_UNARY_HANDLER(name, count) struct name##_handler                                                 \
+        {                                                                                                       \
+            static constexpr size_t subcode_count = count;                                                      \
+            template<subcode sub, operand_layout layout>                                                        \
+            static void invoke(interpreter& ip, const decoded_instruction& ins) noexcept                        \
+            {                                                                                                   \
+                ip.name(sub, ip.resolve_lhs<layout>(ins.lhs));                                                  \
+            }                                                                                                   \
+        };
+#define DEFINE_SIZED_HANDLER(name, count) struct name##_handler                                                 \
+        {                                                                                                       \
+            static constexpr size_t subcode_count = count;                                                      \
+            template<subcode sub, operand_layout layout>                                                        \
+            static void invoke(interpreter& ip, const decoded_instruction& ins) noexcept                        \
+            {                                                                                                   \
+                ip.name(sub, ip.resolve_lhs<layout>(ins.lhs), ip.resolve_rhs<layout>(ins.rhs), ins.value);      \
+            }                                                                                                   \
+        };
+#define DEFINE_COMPARISON_HANDLER(name, count) struct name##_handler                                            \
+        {                                                                                                       \
+            static constexpr size_t subcode_count = count;                                                      \
+            template<subcode sub, operand_layout layout>                                                        \
+            static int32_t invoke(interpreter& ip, const decoded_instruction& ins) noexcept                     \
+            {                                                                                                   \
+                return ip.name(sub, ip.resolve_lhs<layout>(ins.lhs), ip.resolve_rhs<layout>(ins.rhs));          \
+            }                                                                                                   \
+        };
+#define DEFINE_ZERO_COMPARISON_HANDLER(name, count) struct name##_handler                                       \
+        {                                                                                                       \
+            static constexpr size_t subcode_count = count;                                                      \
+            template<subcode sub, operand_layout layout>                                                        \
+            static int32_t invoke(interpreter& ip, const decoded_instruction& ins) noexcept                     \
+            {                                                                                                   \
+                return ip.name(sub, ip.resolve_lhs<layout>(ins.lhs));                                           \
+            }                                                                                                   \
+        };
+
+        DEFINE_SIZED_HANDLER(set, 46)
+        DEFINE_BINARY_HANDLER(conv, 100)
+        DEFINE_UNARY_HANDLER(ari_not, 8)
+        DEFINE_UNARY_HANDLER(ari_neg, 6)
+        DEFINE_BINARY_HANDLER(ari_mul, 45)
+        DEFINE_BINARY_HANDLER(ari_div, 45)
+        DEFINE_BINARY_HANDLER(ari_mod, 45)
+        DEFINE_BINARY_HANDLER(ari_add, 45)
+        DEFINE_BINARY_HANDLER(ari_sub, 45)
+        DEFINE_BINARY_HANDLER(ari_lsh, 26)
+        DEFINE_BINARY_HANDLER(ari_rsh, 26)
+        DEFINE_BINARY_HANDLER(ari_and, 26)
+        DEFINE_BINARY_HANDLER(ari_xor, 26)
+        DEFINE_BINARY_HANDLER(ari_or, 26)
+        DEFINE_SIZED_HANDLER(padd, 8)
+        DEFINE_SIZED_HANDLER(psub, 8)
+        DEFINE_COMPARISON_HANDLER(cmp, 92)
+        DEFINE_COMPARISON_HANDLER(ceq, 92)
+        DEFINE_COMPARISON_HANDLER(cne, 92)
+        DEFINE_COMPARISON_HANDLER(cgt, 92)
+        DEFINE_COMPARISON_HANDLER(cge, 92)
+        DEFINE_COMPARISON_HANDLER(clt, 92)
+        DEFINE_COMPARISON_HANDLER(cle, 92)
+        DEFINE_ZERO_COMPARISON_HANDLER(cze, 10)
+        DEFINE_ZERO_COMPARISON_HANDLER(cnz, 10)
+        DEFINE_BINARY_HANDLER(vadd, vector_type_count)
+        DEFINE_BINARY_HANDLER(vsub, vector_type_count)
+        DEFINE_BINARY_HANDLER(vmul, vector_type_count)
+        DEFINE_BINARY_HANDLER(vdiv, vector_type_count)
+        DEFINE_BINARY_HANDLER(vmin, vector_type_count)
+        DEFINE_BINARY_HANDLER(vmax, vector_type_count)
+        DEFINE_BINARY_HANDLER(vceq, vector_type_count)
+        DEFINE_BINARY_HANDLER(vcne, vector_type_count)
+        DEFINE_BINARY_HANDLER(vcgt, vector_type_count)
+        DEFINE_BINARY_HANDLER(vcge, vector_type_count)
+        DEFINE_BINARY_HANDLER(vclt, vector_type_count)
+        DEFINE_BINARY_HANDLER(vcle, vector_type_count)
+        DEFINE_BINARY_HANDLER(vshf, vector_type_count)
+
+#undef DEFINE_BINARY_HANDLER
+#undef DEFINE_UNARY_HANDLER
+#undef DEFINE_SIZED_HANDLER
+#undef DEFINE_COMPARISON_HANDLER
+#undef DEFINE_ZERO_COMPARISON_HANDLER
+
+        // Return values are written into the previous stack frame
+        struct retv_handler
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+            static constexpr size_t subcode_count = set_handler::subcode_count;
+            template<subcode sub, operand_layout layout>
+            static void invoke(interpreter& ip, const decoded_instruction& ins) noexcept
+            {
+                ip.set(sub, ip.sf.rptr, ip.resolve_rhs<layout>(ins.rhs), ins.value);
+            }
+        };
 
-            if (cne()) jump(branch_location);
+        template<typename handler_t, size_t... sub>
+        static auto get_specialization(subcode sub_idx, operand_layout layout, std::index_sequence<sub...>) noexcept
+        {
+            typedef decltype(&handler_t::template invoke<subcode(0), operand_layout::generic>) handler_type;
+            static constexpr handler_type table[][operand_layout_count] =
+            {
+                {
+                    &handler_t::template invoke<subcode(sub), operand_layout::generic>,
+                    &handler_t::template invoke<subcode(sub), operand_layout::frame_frame>,
+                    &handler_t::template invoke<subcode(sub), operand_layout::frame_immediate>,
+                }...
+            };
+            return table[size_t(sub_idx)][size_t(layout)];
         }
-        inline void bgt() noexcept
+        template<typename handler_t>
+        static auto get_specialization(subcode sub_idx, operand_layout layout) noexcept
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
-
-            if (cgt()) jump(branch_location);
+            ASSERT(size_t(sub_idx) < handler_t::subcode_count, "Malformed subcode: %", size_t(sub_idx));
+            return get_specialization<handler_t>(sub_idx, layout, std::make_index_sequence<handler_t::subcode_count>());
         }
-        inline void bge() noexcept
+        static operand_layout get_operand_layout(const decoded_operand& lhs, const decoded_operand& rhs) noexcept
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
-
-            if (cge()) jump(branch_location);
+            const auto is_frame = [](const decoded_operand& operand)
+            {
+                return operand.base == operand_base::frame && operand.flags == operand_flags::none;
+            };
+            if (is_frame(lhs))
+            {
+                if (is_frame(rhs)) return operand_layout::frame_frame;
+                if (rhs.base == operand_base::immediate) return operand_layout::frame_immediate;
+            }
+            return operand_layout::generic;
         }
-        inline void blt() noexcept
+        static void specialize(decoded_instruction& ins) noexcept
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+            const operand_layout layout = get_operand_layout(ins.lhs, ins.rhs);
+            switch (ins.op)
+            {
+                case opcode::set: ins.operation = get_specialization<set_handler>(ins.sub, layout); break;
+                case opcode::conv: ins.operation = get_specialization<conv_handler>(ins.sub, layout); break;
+                case opcode::ari_not: ins.operation = get_specialization<ari_not_handler>(ins.sub, layout); break;
+                case opcode::ari_neg: ins.operation = get_specialization<ari_neg_handler>(ins.sub, layout); break;
+                case opcode::ari_mul: ins.operation = get_specialization<ari_mul_handler>(ins.sub, layout); break;
+                case opcode::ari_div: ins.operation = get_specialization<ari_div_handler>(ins.sub, layout); break;
+                case opcode::ari_mod: ins.operation = get_specialization<ari_mod_handler>(ins.sub, layout); break;
+                case opcode::ari_add: ins.operation = get_specialization<ari_add_handler>(ins.sub, layout); break;
+                case opcode::ari_sub: ins.operation = get_specialization<ari_sub_handler>(ins.sub, layout); break;
+                case opcode::ari_lsh: ins.operation = get_specialization<ari_lsh_handler>(ins.sub, layout); break;
+                case opcode::ari_rsh: ins.operation = get_specialization<ari_rsh_handler>(ins.sub, layout); break;
+                case opcode::ari_and: ins.operation = get_specialization<ari_and_handler>(ins.sub, layout); break;
+                case opcode::ari_xor: ins.operation = get_specialization<ari_xor_handler>(ins.sub, layout); break;
+                case opcode::ari_or: ins.operation = get_specialization<ari_or_handler>(ins.sub, layout); break;
+                case opcode::padd: ins.operation = get_specialization<padd_handler>(ins.sub, layout); break;
+                case opcode::psub: ins.operation = get_specialization<psub_handler>(ins.sub, layout); break;
+                case opcode::retv: ins.operation = get_specialization<retv_handler>(ins.sub, layout); break;
+                case opcode::vadd: ins.operation = get_specialization<vadd_handler>(ins.sub, layout); break;
+                case opcode::vsub: ins.operation = get_specialization<vsub_handler>(ins.sub, layout); break;
+                case opcode::vmul: ins.operation = get_specialization<vmul_handler>(ins.sub, layout); break;
+                case opcode::vdiv: ins.operation = get_specialization<vdiv_handler>(ins.sub, layout); break;
+                case opcode::vmin: ins.operation = get_specialization<vmin_handler>(ins.sub, layout); break;
+                case opcode::vmax: ins.operation = get_specialization<vmax_handler>(ins.sub, layout); break;
+                case opcode::vceq: ins.operation = get_specialization<vceq_handler>(ins.sub, layout); break;
+                case opcode::vcne: ins.operation = get_specialization<vcne_handler>(ins.sub, layout); break;
+                case opcode::vcgt: ins.operation = get_specialization<vcgt_handler>(ins.sub, layout); break;
+                case opcode::vcge: ins.operation = get_specialization<vcge_handler>(ins.sub, layout); break;
+                case opcode::vclt: ins.operation = get_specialization<vclt_handler>(ins.sub, layout); break;
+                case opcode::vcle: ins.operation = get_specialization<vcle_handler>(ins.sub, layout); break;
+                case opcode::vshf: ins.operation = get_specialization<vshf_handler>(ins.sub, layout); break;
+
+                case opcode::cmp: ins.comparison = get_specialization<cmp_handler>(ins.sub, layout); break;
+                case opcode::ceq: case opcode::beq: ins.comparison = get_specialization<ceq_handler>(ins.sub, layout); break;
+                case opcode::cne: case opcode::bne: ins.comparison = get_specialization<cne_handler>(ins.sub, layout); break;
+                case opcode::cgt: case opcode::bgt: ins.comparison = get_specialization<cgt_handler>(ins.sub, layout); break;
+                case opcode::cge: case opcode::bge: ins.comparison = get_specialization<cge_handler>(ins.sub, layout); break;
+                case opcode::clt: case opcode::blt: ins.comparison = get_specialization<clt_handler>(ins.sub, layout); break;
+                case opcode::cle: case opcode::ble: ins.comparison = get_specialization<cle_handler>(ins.sub, layout); break;
+                case opcode::cze: case opcode::bze: ins.comparison = get_specialization<cze_handler>(ins.sub, layout); break;
+                case opcode::cnz: case opcode::bnz: ins.comparison = get_specialization<cnz_handler>(ins.sub, layout); break;
+
+                default: break;
+            }
+        }
 
-            if (clt()) jump(branch_location);
+        void push_stack_frame(const method& method, const signature& calling_signature)
+        {
+            const signature& signature = get_signature(method.signature);
+            ASSERT(signature.index == calling_signature.index, "Call signature mismatch");
+
+            const auto& bytecode = method.bytecode;
+
+            const size_t current_stack_size = stack.size;
+            // Next stackframe pointer (end of total stack)
+            uint8_t* const sptr = stack.data + current_stack_size;
+            // Next return address (end of effective stack)
+            uint8_t* const rptr = stack_end;
+
+            if (!method.is_external())
+            {
+                callstack_depth++;
+                VALIDATE_CALLSTACK_LIMIT(callstack_depth <= parameters.max_callstack_depth, parameters.max_callstack_depth);
+
+                // Push method stack size
+                const size_t new_stack_size = stack.size + method.total_stack_size + stack_frame_size;
+                VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
+                stack.size = new_stack_size;
+                stack.high_water = std::max(stack.high_water, new_stack_size);
+
+                // Write parameters (entry frames get their arguments written by the caller)
+                uint8_t* const param_ptr = sptr + stack_frame_size;
+                const size_t parameter_count = calling_signature.parameters.size();
+                if (sf.iptr)
+                {
+                    const size_t arg_count = static_cast<size_t>(read_bytecode<uint8_t>(sf.iptr));
+                    ASSERT(arg_count == parameter_count, "Invalid argument count");
+                    for (size_t i = 0; i < parameter_count; i++)
+                    {
+                        const stackvar& parameter = calling_signature.parameters[i];
+                        const subcode sub = read_subcode();
+                        const uint8_t* arg_addr = read_address(true);
+                        set(sub, param_ptr + parameter.offset, arg_addr);
+                    }
+                }
+
+                // Update method lookup
+                method_return_type = signature.return_type;
+                method_stackvars = method.stackvars.data();
+                method_parameters = signature.parameters.data();
+
+                // Update offsets
+                param_offset = param_ptr;
+                stack_offset = param_offset + calling_signature.parameters_size;
+                stack_end = sptr + method.method_stack_size + stack_frame_size;
+
+                // Write stack frame
+                *reinterpret_cast<stack_frame_t*>(sptr) = sf;
+
+                // Call
+                sf = stack_frame_t(bytecode.data(), rptr, sptr, &method);
+                ibeg = sf.iptr;
+                iend = ibeg + bytecode.size();
+
+                // Clear return value after a call
+                clear_return_value();
+            }
+            else
+            {
+                const external_call_info& call = get_external_call(method);
+
+                // Push method stack size (parameters only for external methods)
+                if (method.total_stack_size > 0)
+                {
+                    const size_t new_stack_size = stack.size + method.total_stack_size;
+                    VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
+                    stack.size = new_stack_size;
+                }
+
+                // Write parameters
+                const size_t parameter_count = calling_signature.parameters.size();
+                uint8_t* const param_ptr = sptr;
+                if (sf.iptr)
+                {
+                    const size_t arg_count = static_cast<size_t>(read_bytecode<uint8_t>(sf.iptr));
+                    ASSERT(arg_count == parameter_count, "Invalid argument count");
+                    for (size_t i = 0; i < parameter_count; i++)
+                    {
+                        const stackvar& parameter = calling_signature.parameters[i];
+                        const subcode sub = read_subcode();
+                        const uint8_t* arg_addr = read_address(true);
+                        set(sub, param_ptr + parameter.offset, arg_addr);
+                    }
+                }
+
+                // Invoke external
+                call.forward(call.handle, rptr, param_ptr);
+
+                // Set return value here since we return immediately
+                const type_idx return_type_idx = calling_signature.return_type;
+                return_value_addr = rptr;
+                return_value_type = return_type_idx;
+
+                // Pop stackframe
+                stack.size = current_stack_size;
+            }
         }
-        inline void ble() noexcept
+        // Call sites of methods that were decoded after this interpreter was created
+        // get their inline caches on first use
+        inline inline_cache& get_inline_cache(size_t index)
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+            if (index >= inline_caches.size()) inline_caches.resize(std::max(decoding.inline_cache_count.load(std::memory_order_relaxed), index + 1));
+            return inline_caches[index];
+        }
+        // Resolve the target of a virtual call, cached per call site.
+        // Handles are compared before unmasking, a cache hit skips validation entirely
+        // since the entry has been validated when it was inserted.
+        inline const decoded_method& lookup_virtual(inline_cache& cache, size_t method_handle, signature_idx calling_signature)
+        {
+            if (method_handle != 0)
+            {
+                for (size_t i = 0; i < inline_cache::capacity; i++)
+                {
+                    if (cache.handles[i] == method_handle)
+                    {
+                        cache.hits++;
+                        return *cache.targets[i];
+                    }
+                }
+            }
+            cache.misses++;
 
-            if (cle()) jump(branch_location);
+            const size_t raw_handle = method_handle;
+            ASSERT(method_handle != 0, "Attempted to invoke a null method pointer");
+            method_handle ^= data.runtime_hash;
+            ASSERT(is_valid_method(method_handle), "Attempted to invoke an invalid method pointer");
+            const decoded_method& call_method = decoded_methods[method_idx(method_handle)];
+            ASSERT(call_method.source->signature == calling_signature, "Call signature mismatch");
+
+            const uint32_t slot = cache.next;
+            cache.handles[slot] = raw_handle;
+            cache.targets[slot] = &call_method;
+            cache.next = (slot + 1) % inline_cache::capacity;
+            return call_method;
         }
-        inline void bze() noexcept
+
+        // Return address is usually the end of the effective stack, unless the return value gets stored directly
+        // Call site is null for entry frames (which get their arguments written by the caller)
+        // Guarded frames skip the stack size check (see allocate_stack), but still check the callstack depth
+        // Profiled frames are timed from the push until the return, externals around the forwarded call
+        template<bool guarded, bool profiled> const decoded_instruction* push_decoded_frame(const decoded_method& target, const decoded_instruction* call_site, uint8_t* const rptr)
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+            const method& method = *target.source;
+            const signature& signature = *target.method_signature;
 
-            if (cze()) jump(branch_location);
+            const size_t current_stack_size = stack.size;
+            // Next stackframe pointer (end of total stack)
+            uint8_t* const sptr = stack.data + current_stack_size;
+
+            if (trace.enabled())
+            {
+                // Entry calls are recorded without calling method
+                if (call_site) trace.record(trace_event::call, sf.mptr->index, call_site->offset, uint32_t(method.index));
+                else trace.record(trace_event::call, method_idx::invalid, 0, uint32_t(method.index));
+            }
+
+            if (!method.is_external())
+            {
+                ensure_decoded(target);
+                callstack_depth++;
+
+                // Push method stack size
+                const size_t new_stack_size = stack.size + target.frame_size;
+                VALIDATE_CALLSTACK_LIMIT(callstack_depth <= parameters.max_callstack_depth, parameters.max_callstack_depth);
+                if constexpr (!guarded)
+                {
+                    VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
+                }
+                stack.size = new_stack_size;
+                stack.high_water = std::max(stack.high_water, new_stack_size);
+
+                // Write parameters (arguments are resolved relative to the calling frame)
+                uint8_t* const param_ptr = sptr + stack_frame_size;
+                if (call_site) write_arguments(param_ptr, *call_site);
+
+                // Entry frames get their arguments written after the push, so they always run interpreted
+                if (!profiled && sf.mptr != nullptr && parameters.jit)
+                {
+                    if (!target.native && ++target.call_count == parameters.jit_threshold)
+                    {
+                        target.native = compile_native(target, global_data.data(), parameters.jit_register_count);
+                    }
+                    if (target.native)
+                    {
+                        // Native code runs on the same stack frame layout, but never calls
+                        // back into the interpreter so the frame can be popped right away
+                        *reinterpret_cast<stack_frame_t*>(sptr) = sf;
+                        target.native.entry()(param_ptr, rptr);
+                        stack.size = current_stack_size;
+                        callstack_depth--;
+                        return sf.dptr;
+                    }
+                }
+
+                // Update offsets
+                param_offset = param_ptr;
+                stack_offset = param_offset + signature.parameters_size;
+                stack_end = sptr + method.method_stack_size + stack_frame_size;
+
+                // Write stack frame
+                *reinterpret_cast<stack_frame_t*>(sptr) = sf;
+
+                // Call
+                sf = stack_frame_t(target.instructions.data(), rptr, sptr, &method);
+                if constexpr (profiled) profiler.enter(target, host::timestamp());
+            }
+            else
+            {
+                const external_call_info& call = get_external_call(method);
+
+                // Push method stack size (parameters only for external methods)
+                if (method.total_stack_size > 0)
+                {
+                    const size_t new_stack_size = stack.size + method.total_stack_size;
+                    if constexpr (!guarded) VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
+                    stack.size = new_stack_size;
+                }
+
+                // Write parameters
+                uint8_t* const param_ptr = sptr;
+                if (call_site) write_arguments(param_ptr, *call_site);
+
+                // Invoke external
+                if constexpr (profiled)
+                {
+                    const uint64_t start = host::timestamp();
+                    call.forward(call.handle, rptr, param_ptr);
+                    profiler.record(target, host::timestamp() - start);
+                }
+                else
+                {
+                    call.forward(call.handle, rptr, param_ptr);
+                }
+
+                // Pop stackframe
+                stack.size = current_stack_size;
+            }
+
+            return sf.dptr;
         }
-        inline void bnz() noexcept
+        // Tail calls replace the current stack frame with the frame of the callee, which returns
+        // directly into the calling frame of the current method (constant stack usage for tail recursion)
+        template<bool guarded, bool profiled> const decoded_instruction* push_tail_frame(const decoded_method& target, const decoded_instruction& call_site)
         {
-            const uint32_t branch_location = read_bytecode<uint32_t>(sf.iptr);
+            const method& method = *target.source;
+            const signature& signature = *target.method_signature;
+            ensure_decoded(target);
+            if (trace.enabled()) trace.record(trace_event::tail_call, sf.mptr->index, call_site.offset, uint32_t(method.index));
+
+            // Arguments are resolved relative to the current frame, so they have to be written
+            // past the end of the stack before the parameters of the current frame get replaced
+            const size_t scratch_stack_size = stack.size + target.frame_size;
+            if constexpr (!guarded)
+            {
+                VALIDATE_STACK_OVERFLOW(scratch_stack_size <= stack.capacity, scratch_stack_size, stack.capacity);
+            }
+            stack.high_water = std::max(stack.high_water, scratch_stack_size);
+            uint8_t* const scratch_ptr = stack.data + stack.size + stack_frame_size;
+            write_arguments(scratch_ptr, call_site);
 
-            if (cnz()) jump(branch_location);
+            if (!profiled && parameters.jit)
+            {
+                if (!target.native && ++target.call_count == parameters.jit_threshold)
+                {
+                    target.native = compile_native(target, global_data.data(), parameters.jit_register_count);
+                }
+                if (target.native)
+                {
+                    // Native code does not use the interpreter stack frame, invoke it
+                    // in place and return from the current method right after
+                    target.native.entry()(scratch_ptr, sf.rptr);
+                    pop_stack_frame();
+                    return sf.dptr;
+                }
+            }
+
+            // Move the parameters into the current frame
+            uint8_t* const sptr = sf.sptr;
+            uint8_t* const param_ptr = sptr + stack_frame_size;
+            memmove(param_ptr, scratch_ptr, signature.parameters_size);
+            stack.size = static_cast<size_t>(sptr - stack.data) + target.frame_size;
+
+            // Update offsets
+            param_offset = param_ptr;
+            stack_offset = param_offset + signature.parameters_size;
+            stack_end = sptr + method.method_stack_size + stack_frame_size;
+
+            // Stack frame of the caller remains in place
+            sf = stack_frame_t(target.instructions.data(), sf.rptr, sptr, &method);
+            if constexpr (profiled)
+            {
+                // The callee replaces the current method in the call tree
+                const uint64_t now = host::timestamp();
+                profiler.leave(now);
+                profiler.enter(target, now);
+            }
+            return sf.dptr;
         }
-
-        inline void sw() noexcept
+        // External methods never call back into the interpreter, so their arguments can be written
+        // straight to the top of the stack and the call forwarded without pushing a stack frame
+        template<bool guarded, bool profiled> inline void call_native(const decoded_instruction& call_site)
         {
-            const uint8_t* idx_addr = read_address(false);
-
-            uint32_t idx = 0;
-            switch (addr_type[false])
+            const decoded_method& target = *call_site.call_target;
+            if constexpr (!guarded)
             {
-                case type_idx::i8: idx = (uint32_t)read<i8>(idx_addr); break;
-                case type_idx::u8: idx = (uint32_t)read<u8>(idx_addr); break;
-                case type_idx::i16: idx = (uint32_t)read<i16>(idx_addr); break;
-                case type_idx::u16: idx = (uint32_t)read<u16>(idx_addr); break;
-                case type_idx::i32: idx = (uint32_t)read<i32>(idx_addr); break;
-                case type_idx::u32: idx = (uint32_t)read<u32>(idx_addr); break;
-                case type_idx::i64: idx = (uint32_t)read<i64>(idx_addr); break;
-                case type_idx::u64: idx = (uint32_t)read<u64>(idx_addr); break;
+                const size_t new_stack_size = stack.size + target.frame_size;
+                VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
             }
 
-            const uint32_t label_count = read_bytecode<uint32_t>(sf.iptr);
+            uint8_t* const param_ptr = stack.data + stack.size;
+            write_arguments(param_ptr, call_site);
 
-            const uint32_t* labels = reinterpret_cast<const uint32_t*>(sf.iptr);
-            if (idx < label_count)
+            const external_call_info& call = get_external_call(*target.source);
+            if constexpr (profiled)
             {
-                jump(labels[idx]);
+                const uint64_t start = host::timestamp();
+                call.forward(call.handle, stack_end, param_ptr);
+                profiler.record(target, host::timestamp() - start);
             }
             else
             {
-                sf.iptr += sizeof(uint32_t) * label_count;
+                call.forward(call.handle, stack_end, param_ptr);
+            }
+        }
+        inline void write_arguments(uint8_t* param_ptr, const decoded_instruction& call_site) noexcept
+        {
+            for (uint32_t i = 0; i < call_site.copy_count; i++)
+            {
+                const decoded_copy& copy = call_site.copies[i];
+                memcpy(param_ptr + copy.dst_offset, param_offset + copy.src_offset, copy.size);
+            }
+            for (uint32_t i = 0; i < call_site.count; i++)
+            {
+                const decoded_argument& arg = call_site.args[i];
+                set(arg.sub, param_ptr + arg.offset, resolve(arg.operand, tmp_var[1]), arg.size);
             }
         }
+        const external_call_info& get_external_call(const method& method)
+        {
+            const auto& bytecode = method.bytecode;
+            ASSERT(bytecode.size() == sizeof(runtime_call_index), "Invalid external index");
+            const runtime_call_index cidx = *reinterpret_cast<const runtime_call_index*>(bytecode.data());
+
+            ASSERT(libraries.is_valid_index(cidx.library), "Invalid library index");
+            const auto& lib = libraries[cidx.library];
+            ASSERT(lib.calls.is_valid_index(cidx.index), "Invalid call index");
+            const auto& call = lib.calls[cidx.index];
+            VALIDATE_EXTERNAL_SYMBOL(call.handle != nullptr, call.name, lib.name);
+            return call;
+        }
 
-        inline void jump(uint32_t target) noexcept
+        void pop_stack_frame()
         {
-            sf.iptr = ibeg + target;
+            // Restore stackframe
+            ASSERT(callstack_depth > 0, "Stack frame pop overflow");
+            stack.size = static_cast<size_t>(sf.sptr - stack.data);
+            sf = *reinterpret_cast<stack_frame_t*>(sf.sptr);
+            if (sf.mptr != nullptr)
+            {
+                // Restore method lookup
+                const method& calling_method = *sf.mptr;
+                const signature& calling_signature = get_signature(calling_method.signature);
+                method_stackvars = calling_method.stackvars.data();
+                method_parameters = calling_signature.parameters.data();
+                method_return_type = calling_signature.return_type;
 
-            clear_return_value();
+                // Restore instruction range
+                const auto& bytecode = calling_method.bytecode;
+                ibeg = bytecode.data();
+                iend = ibeg + bytecode.size();
+
+                // Restore local offsets
+                param_offset = sf.sptr + stack_frame_size;
+                stack_offset = param_offset + calling_signature.parameters_size;
+                stack_end = sf.sptr + calling_method.method_stack_size + stack_frame_size;
+            }
+            else
+            {
+                method_return_type = type_idx::voidtype;
+                method_stackvars = nullptr;
+                method_parameters = nullptr;
+                ibeg = iend = nullptr;
+            }
+            callstack_depth--;
         }
 
-        inline void call()
+        inline uint8_t* push_return_value(type_idx type) noexcept
         {
-            const method_idx call_idx = read_bytecode<method_idx>(sf.iptr);
-            ASSERT(is_valid_method(call_idx), "Attempted to invoke an invalid method");
-            const auto& call_method = get_method(call_idx);
-            push_stack_frame(call_method, get_signature(call_method.signature));
+            return_value_addr = stack_end;
+            return_value_type = type;
+            return return_value_addr;
         }
-        inline void callv()
+        inline void clear_return_value() noexcept
         {
-            const uint8_t* method_ptr = read_address(false);
-            size_t method_handle = *reinterpret_cast<const size_t*>(method_ptr);
-            ASSERT(method_handle != 0, "Attempted to invoke a null method pointer");
-            method_handle ^= data.runtime_hash;
-            ASSERT(is_valid_method(method_handle), "Attempted to invoke an invalid method pointer");
-            const method& call_method = get_method(method_idx(method_handle));
-            push_stack_frame(call_method, get_signature(get_addr_type(false).generated.signature.index));
+            return_value_addr = nullptr;
+            return_value_type = type_idx::voidtype;
         }
-        inline void ret()
-        {
-            clear_return_value();
 
-            pop_stack_frame();
-        }
-        inline void retv()
+
+        inline stack_data_t allocate_stack(const assembly_data& asm_data, const runtime_parameters& parameters)
         {
-            const subcode sub = read_subcode();
-            const uint8_t* ret_value = read_address(true);
+            const size_t min_stack_size = parameters.min_stack_size;
+            const size_t max_stack_size = parameters.max_stack_size;
+            VALIDATE_ALLOCATOR((parameters.allocate_method == nullptr) == (parameters.free_method == nullptr));
 
-            // Set return value (of the current signature)
-            return_value_addr = sf.rptr;
-            return_value_type = method_return_type;
+#if HOST_GUARDED_INVOKE
+            if (parameters.guard_pages && parameters.predecode && !parameters.profile)
+            {
+                // Frames are pushed without checking the stack size, but every internal call writes its
+                // stack frame at the start of the new frame. The guard region has to cover the largest
+                // possible overshoot: a frame starting just before the end of the stack, followed by
+                // a tail call writing its arguments past the end of that frame.
+                size_t max_frame_size = 0;
+                for (const auto& it : asm_data.methods)
+                {
+                    max_frame_size = std::max(max_frame_size, size_t(it.total_stack_size) + stack_frame_size);
+                }
+                const size_t guard_size = max_frame_size * 2 + stack_frame_size;
 
-            set(sub, return_value_addr, ret_value);
+                const hostmem memory = host::reserve_guarded(max_stack_size, guard_size);
+                VALIDATE_STACK_ALLOCATION(memory.address != nullptr);
+                return stack_data_t(static_cast<uint8_t*>(memory.address), memory.size, guard_size);
+            }
+#endif
 
-            pop_stack_frame();
-        }
+            const runtime_allocator allocator(parameters);
+            uint8_t* memory = nullptr;
+            size_t capacity = 0;
 
-        inline void dump()
-        {
-            const uint8_t* src_addr = read_address(true);
+            // Try and find a stack that fits
+            for (size_t i = sizeof(size_t) * 8; i > 0; i--)
+            {
+                capacity = (static_cast<size_t>(1) << static_cast<size_t>(i - 1));
+                if (capacity >= min_stack_size && capacity <= max_stack_size)
+                {
+                    memory = allocator.allocate(capacity);
+                    if (memory) break;
+                }
+            }
 
-            dump_recursive(src_addr, get_addr_type(true));
+            VALIDATE_STACK_ALLOCATION(memory != nullptr);
 
-            print_output();
+            return stack_data_t(memory, capacity, 0, allocator);
         }
 
 
-        void dump_recursive(const uint8_t* addr, const type& type)
+        // Stack frame
+        stack_frame_t sf;
+
+        // Stack data
+        stack_data_t stack;
+
+        // Offset of the method parameters
+        uint8_t* param_offset = nullptr;
+        // Offset of the method stackvars
+        uint8_t* stack_offset = nullptr;
+        // End of the method stack (excluding return values)
+        uint8_t* stack_end = nullptr;
+
+        // Temporary variables
+        size_t tmp_var[2];
+        type_idx addr_type[2];
+        inline const type& get_addr_type(bool is_rhs) noexcept
         {
-            output_stream << get_name(type);
-            switch (type.index)
-            {
-                case type_idx::i8: dump_var<i8>(addr); break;
-                case type_idx::u8: dump_var<u8>(addr); break;
-                case type_idx::i16: dump_var<i16>(addr); break;
-                case type_idx::u16: dump_var<u16>(addr); break;
-                case type_idx::i32: dump_var<i32>(addr); break;
-                case type_idx::u32: dump_var<u32>(addr); break;
-                case type_idx::i64: dump_var<i64>(addr); break;
-                case type_idx::u64: dump_var<u64>(addr); break;
-                case type_idx::f32: dump_var<f32>(addr); break;
-                case type_idx::f64: dump_var<f64>(addr); break;
-                default:
-                {
-                    if (type.is_pointer() || type.is_signature())
-                    {
-                        output_stream << '(' << (void*)*reinterpret_cast<const uint8_t* const*>(addr) << ')';
-                    }
-                    else if (type.is_array())
-                    {
-                        output_stream << '{';
-                        const uint8_t* ptr = addr;
-                        const auto& underlying_type = get_type(type.generated.array.underlying_type);
-                        for (size_t i = 0; i < type.generated.array.array_size; i++)
-                        {
-                            output_stream << (i == 0 ? " " : ", ");
-                            dump_recursive(ptr + underlying_type.total_size * i, get_type(underlying_type.index));
-                        }
-                        output_stream << " }";
-                    }
-                    else if (!type.fields.empty())
-                    {
-                        output_stream << '{';
-                        for (size_t i = 0; i < type.fields.size(); i++)
-                        {
-                            auto& field = type.fields[i];
-                            output_stream << (i == 0 ? " " : ", ");
-                            output_stream << database[field.name] << " = ";
-                            dump_recursive(addr + field.offset, get_type(field.type));
-                        }
-                        output_stream << " }";
-                    }
-                    else
-                    {
-                        output_stream << "(?)";
-                    }
-                }
-                break;
-            }
+            return get_type(addr_type[is_rhs]);
         }
-        string_view get_name(const type& t) const
+
+        // Return value
+        uint8_t* return_value_addr;
+        type_idx return_value_type;
+
+        // Instruction pointer
+        const uint8_t* ibeg = nullptr;
+        const uint8_t* iend = nullptr;
+
+        // Current method lookup info
+        type_idx method_return_type = type_idx::voidtype;
+        const stackvar* method_stackvars;
+        const stackvar* method_parameters;
+
+        // Globals/constants (initial values are owned, or shared with the prototype)
+        global_image owned_initial_globals;
+        const global_image& initial_globals;
+        global_memory global_data;
+        data_table_view global_tables[2];
+
+        // Externals (resolved by the runtime)
+        const indexed_vector<name_idx, library_info>& libraries;
+        const runtime_data& rt_data;
+
+        // Strings
+        const string_table<name_idx>& database;
+        string generated_name_buffers[2];
+        size_t generated_name_index = 0;
+
+        // Pre-decoded methods (owned, or shared with the prototype)
+        indexed_vector<method_idx, decoded_method> owned_methods;
+        indexed_vector<method_idx, decoded_method>& decoded_methods;
+        // Decoding state (owned, or shared with the prototype)
+        struct decode_state
         {
-            if (t.name != name_idx::invalid)
+            // Serializes the decoding of methods on their first call
+            std::mutex mutex;
+            // Amount of callv call sites decoded so far
+            std::atomic<size_t> inline_cache_count = 0;
+            // Threaded dispatch handlers of the decoded instructions
+            const void* const* handlers = nullptr;
+        };
+        decode_state owned_decoding;
+        decode_state& decoding;
+        // Inline caches of all callv call sites (grown when call sites get decoded)
+        vector<inline_cache> inline_caches;
+
+        // Input data
+        const assembly_data& data;
+        const runtime_parameters parameters;
+        uint32_t callstack_depth = 0;
+        // Step budget of the current pre-decoded execution (see execute_decoded)
+        uint64_t step_budget = std::numeric_limits<uint64_t>::max();
+        // Execution profile (only used with runtime_parameters::profile)
+        call_profiler profiler;
+        // Callstack samples (only used with runtime_parameters::sample_interval)
+        stack_sampler sampler;
+        vector<method_idx> sample_frames;
+        static constexpr uint64_t sample_check_interval = 1 << 12;
+        // Recent calls, returns and taken branches (only used with runtime_parameters::trace_size)
+        trace_buffer trace;
+
+        print_method_handle print_method;
+        format_writer output_buffer;
+
+        // Called after every dump, batched output is separated by newlines
+        void print_output()
+        {
+            if (parameters.output_flush == output_flush_policy::every_dump)
             {
-                return database[t.name];
+                flush_output();
             }
             else
             {
-                size_t& index = const_cast<size_t&>(generated_name_index);
-                string& buffer = const_cast<string*>(generated_name_buffers)[index];
-                data.generate_name(t.index, buffer);
-                index = (index + 1) & 1;
-                return buffer;
+                output_buffer.write_newline();
+                if (parameters.output_flush == output_flush_policy::threshold && output_buffer.size() >= parameters.output_flush_threshold)
+                {
+                    flush_output();
+                }
             }
         }
-
-
-        inline const type& get_type(type_idx type) const noexcept
-        {
-            return data.types[type];
-        }
-        inline const method& get_method(method_idx method) const noexcept
-        {
-            return data.methods[method];
-        }
-        inline const signature& get_signature(signature_idx signature) const noexcept
+        static void default_print_method(const char* c_str, size_t len)
         {
-            return data.signatures[signature];
+            std::cout << std::string_view(c_str, len) << std::endl;
         }
-        inline bool is_valid_method(method_idx method) const noexcept
+
+        template<typename value_t> value_t get_value(const uint8_t* addr) { return *reinterpret_cast<const value_t*>(addr); }
+        template<typename value_t> void dump_value(const uint8_t* addr) { output_buffer << get_value<value_t>(addr); }
+        template<> inline void dump_value<int8_t>(const uint8_t* addr) { output_buffer << static_cast<int32_t>(get_value<int8_t>(addr)); }
+        template<> inline void dump_value<uint8_t>(const uint8_t* addr) { output_buffer << static_cast<uint32_t>(get_value<uint8_t>(addr)); }
+        template<> inline void dump_value<bool>(const uint8_t* addr)
         {
-            return static_cast<size_t>(method) < data.methods.size();
+            const uint8_t b = get_value<uint8_t>(addr);
+            if (b == 0) output_buffer << "false";
+            else if (b == 1) output_buffer << "true";
+            else output_buffer << static_cast<uint32_t>(b);
         }
-        inline bool is_valid_method(size_t method_handle) const noexcept
+        template<typename value_t> void dump_var(const uint8_t* addr)
         {
-            return method_handle < data.methods.size();
+            output_buffer << '(';
+            dump_value<value_t>(addr);
+            output_buffer << ')';
         }
+    };
+
+
+    static void validate_assembly(const assembly& linked_assembly, const runtime_data& rt_data)
+    {
+        VALIDATE_ASSEMBLY(linked_assembly.is_valid());
+        VALIDATE_COMPATIBILITY(linked_assembly.is_compatible());
+
+        // Setup runtime
+        const assembly_data& asm_data = linked_assembly.assembly_ref();
+        VALIDATE_RUNTIME_HASH(asm_data.runtime_hash == rt_data.hash);
+    }
+    int32_t runtime::execute(const assembly& linked_assembly, runtime_parameters parameters) const
+    {
+        const auto& rt_data = self();
+        validate_assembly(linked_assembly, rt_data);
+
+        // Find main
+        const assembly_data& asm_data = linked_assembly.assembly_ref();
+        VALIDATE_ENTRYPOINT(asm_data.methods.is_valid_index(asm_data.main));
+
+        // Execute (assembly content is already in protected memory)
+        interpreter runtime_interpreter(asm_data, rt_data, parameters);
+        return runtime_interpreter.execute_main(asm_data.methods[asm_data.main]);
+    }
+
 
-        inline subcode read_subcode() noexcept
+    static flat_map<method_idx> make_method_index(const assembly_data& asm_data)
+    {
+        flat_map<method_idx> result;
+        result.reserve(asm_data.methods.size());
+        for (const auto& it : asm_data.methods)
         {
-            return read_bytecode<subcode>(sf.iptr);
+            result.emplace(asm_data.database[it.name], it.index);
         }
-        uint8_t* read_address(bool is_rhs) noexcept
-        {
-            uint8_t* result = nullptr;
+        return result;
+    }
+    // Identifies the assembly of a context (see context_snapshot)
+    static uint64_t make_assembly_hash(const assembly& linked_assembly) noexcept
+    {
+        const span<const uint8_t> binary = linked_assembly.assembly_binary();
+        return fnv::hash64(reinterpret_cast<const char*>(binary.data()), binary.size());
+    }
 
-            const address_data_t& addr = *reinterpret_cast<const address_data_t*>(sf.iptr);
+    static runtime_parameters program_parameters(runtime_parameters parameters)
+    {
+        // Shared programs are always pre-decoded, native code is compiled against
+        // the globals of a single interpreter so it can not be shared
+        parameters.predecode = true;
+        parameters.jit = false;
+        return parameters;
+    }
 
-            const uint32_t index = addr.header.index();
-            switch (addr.header.type())
-            {
-                case address_type::stackvar:
-                {
-                    if (index == address_header_constants::index_max)
-                    {
-                        result = return_value_addr;
-                        addr_type[is_rhs] = return_value_type;
-                    }
-                    else
-                    {
-                        const auto& stack_var = method_stackvars[index];
-                        result = stack_offset + stack_var.offset;
-                        addr_type[is_rhs] = stack_var.type;
-                    }
-                }
-                break;
+    class program_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(program_data, const assembly& linked_assembly, const runtime& rt, runtime_parameters parameters) :
+            program_assembly((validate_assembly(linked_assembly, rt.self()), linked_assembly)),
+            prototype(program_assembly.assembly_ref(), rt.self(), program_parameters(parameters)),
+            method_names(make_method_index(program_assembly.assembly_ref())),
+            assembly_hash(make_assembly_hash(program_assembly)) {}
+
+        assembly program_assembly;
+        // Decoded methods and externals, never executed directly
+        interpreter prototype;
+        // Method lookup by name (shared by all contexts)
+        const flat_map<method_idx> method_names;
+        const uint64_t assembly_hash;
+    };
+    constexpr size_t program_data_handle_size = approximate_handle_size(sizeof(program_data));
 
-                case address_type::parameter:
-                {
-                    const auto& param = method_parameters[index];
-                    result = param_offset + param.offset;
-                    addr_type[is_rhs] = param.type;
-                }
-                break;
+    program::program(const assembly& linked_assembly, const runtime& rt, runtime_parameters parameters) :
+        handle(linked_assembly, rt, parameters)
+    {
 
-                case address_type::global:
-                {
-                    global_idx global = (global_idx)index;
+    }
+    program::~program()
+    {
 
-                    const data_table_view& table = global_tables[is_constant_flag_set(global)];
-                    global &= global_flags::constant_mask;
+    }
 
-                    const auto& global_info = table[global];
-                    result = table.data + global_info.offset;
-                    addr_type[is_rhs] = global_info.type;
-                }
-                break;
+    void program::prewarm(span<const method_idx> methods)
+    {
+        self().prototype.prewarm(methods);
+    }
 
-                case address_type::constant:
-                {
-                    const type_idx btype_idx = type_idx(index);
-                    sf.iptr += sizeof(address_header);
-                    uint8_t* ptr = const_cast<uint8_t*>(sf.iptr);
-                    sf.iptr += get_type(btype_idx).total_size;
-                    addr_type[is_rhs] = btype_idx;
-                    return ptr;
-                }
-                break;
+    const assembly_data& program::assembly_ref() const noexcept
+    {
+        return self().prototype.assembly_ref();
+    }
+
+
+    class program_registry_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(program_registry_data, const runtime& rt, runtime_parameters parameters) :
+            rt(rt),
+            parameters(parameters) {}
+
+        const runtime& rt;
+        const runtime_parameters parameters;
+
+        // Serializes publishing, acquiring never waits for a program to be prepared
+        std::mutex publish_mutex;
+        // Only accessed through the atomic shared pointer operations
+        std::shared_ptr<const program> current;
+        std::atomic<uint64_t> version = 0;
+    };
+    constexpr size_t program_registry_data_handle_size = approximate_handle_size(sizeof(program_registry_data));
+
+    program_registry::program_registry(const runtime& rt, runtime_parameters parameters) :
+        handle(rt, parameters)
+    {
+
+    }
+    program_registry::~program_registry()
+    {
+
+    }
+
+    uint64_t program_registry::publish(const assembly& linked_assembly)
+    {
+        program_registry_data& registry = self();
+
+        // Prepare outside of the lock, so concurrent publishers only wait for the swap
+        std::shared_ptr<const program> prepared = std::make_shared<const program>(linked_assembly, registry.rt, registry.parameters);
+
+        // The version is incremented before the swap, so an acquired program is never newer than the version
+        const std::lock_guard<std::mutex> lock(registry.publish_mutex);
+        const uint64_t published = ++registry.version;
+        std::atomic_store(&registry.current, std::move(prepared));
+        return published;
+    }
+    std::shared_ptr<const program> program_registry::acquire() const
+    {
+        return std::atomic_load(&self().current);
+    }
+    uint64_t program_registry::version() const noexcept
+    {
+        return self().version.load();
+    }
+
+
+    class execution_context_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(execution_context_data, const assembly& linked_assembly, const runtime& rt, runtime_parameters parameters) :
+            context_assembly((validate_assembly(linked_assembly, rt.self()), linked_assembly)),
+            executing_assembly(context_assembly),
+            runtime_interpreter(context_assembly.assembly_ref(), rt.self(), parameters),
+            owned_method_names(make_method_index(context_assembly.assembly_ref())),
+            method_names(owned_method_names),
+            assembly_hash(make_assembly_hash(context_assembly)) {}
+        execution_context_data(const program& shared_program, print_method_handle print_method) :
+            executing_assembly(shared_program.self().program_assembly),
+            runtime_interpreter(shared_program.self().prototype, print_method),
+            method_names(shared_program.self().method_names),
+            assembly_hash(shared_program.self().assembly_hash) {}
+
+        // Copy of the assembly (empty for contexts of a shared program)
+        assembly context_assembly;
+        // Copy of the assembly, or the assembly of the shared program
+        const assembly& executing_assembly;
+        interpreter runtime_interpreter;
+        // Method lookup by name (owned, or shared with the program)
+        flat_map<method_idx> owned_method_names;
+        const flat_map<method_idx>& method_names;
+        // Hash of the assembly binary, snapshots are only restored into contexts of the same assembly
+        const uint64_t assembly_hash;
+    };
+    constexpr size_t execution_context_data_handle_size = approximate_handle_size(sizeof(execution_context_data));
+
+    class context_snapshot_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(context_snapshot_data, const execution_context& context) :
+            globals(context.self().runtime_interpreter.globals().data(), context.self().runtime_interpreter.globals().size()),
+            global_count(context.assembly_ref().globals.info.size()),
+            assembly_hash(context.self().assembly_hash),
+            source_globals(context.self().runtime_interpreter.globals().data()),
+            source_constants(context.assembly_ref().constants.data.data())
+        {
+            const assembly_data& asm_data = context.assembly_ref();
+            vector<uint8_t> has_pointers(asm_data.types.size(), pointers_unknown);
+            for (const auto& global : asm_data.globals.info)
+            {
+                find_pointers(asm_data, global.type, global.offset, has_pointers);
             }
+        }
 
-            switch (addr.header.modifier())
+        // Pointers into the globals or constants of the source context are
+        // rebased onto the target context (other pointers are copied as-is)
+        void rebase_pointers(global_memory& target, const uint8_t* target_constants) const
+        {
+            uint8_t* const target_globals = target.data();
+            if (target_globals == source_globals && target_constants == source_constants) return;
+
+            for (const snapshot_pointer& it : pointers)
             {
-                case address_modifier::none: break;
+                const uint8_t*& value = *reinterpret_cast<const uint8_t**>(target_globals + it.offset);
+                value = it.constant ?
+                    target_constants + (value - source_constants) :
+                    target_globals + (value - source_globals);
+            }
+        }
 
-                case address_modifier::direct_field:
-                {
-                    const auto& field = data.offsets[addr.field];
-                    result += field.offset;
-                    addr_type[is_rhs] = field.type;
-                }
-                break;
+        global_image globals;
+        size_t global_count;
+        uint64_t assembly_hash;
 
-                case address_modifier::indirect_field:
+    private:
+        struct snapshot_pointer
+        {
+            size_t offset;
+            bool constant;
+        };
+
+        enum : uint8_t { pointers_unknown, pointers_none, pointers_some };
+
+        // Structs and arrays without any pointer fields are skipped
+        static bool contains_pointers(const assembly_data& asm_data, type_idx type, vector<uint8_t>& has_pointers)
+        {
+            uint8_t& state = has_pointers[size_t(type)];
+            if (state == pointers_unknown)
+            {
+                const auto& info = asm_data.types[type];
+                bool result = info.is_pointer() || type == type_idx::vptr;
+                if (info.is_array())
                 {
-                    const auto& field = data.offsets[addr.field];
-                    result = dereference(result) + field.offset;
-                    addr_type[is_rhs] = field.type;
+                    result = contains_pointers(asm_data, info.generated.array.underlying_type, has_pointers);
                 }
-                break;
-
-                case address_modifier::offset:
+                else if (info.is_struct())
                 {
-                    const auto& current_type = get_addr_type(is_rhs);
-                    if (current_type.is_pointer())
-                    {
-                        const type& underlying_type = get_type(current_type.generated.pointer.underlying_type);
-                        result = dereference(result) + underlying_type.total_size * addr.offset;
-                        addr_type[is_rhs] = underlying_type.index;
-                    }
-                    else if (current_type.is_array())
+                    for (const auto& field : info.fields)
                     {
-                        const type& underlying_type = get_type(current_type.generated.array.underlying_type);
-                        result = result + underlying_type.total_size * addr.offset;
-                        addr_type[is_rhs] = underlying_type.index;
+                        if (contains_pointers(asm_data, field.type, has_pointers)) result = true;
                     }
                 }
-                break;
+                state = result ? pointers_some : pointers_none;
             }
+            return state == pointers_some;
+        }
+        void find_pointers(const assembly_data& asm_data, type_idx type, size_t offset, vector<uint8_t>& has_pointers)
+        {
+            if (!contains_pointers(asm_data, type, has_pointers)) return;
 
-            switch (addr.header.prefix())
+            const auto& info = asm_data.types[type];
+            if (info.is_array())
             {
-                case address_prefix::none: break;
-
-                case address_prefix::indirection:
+                const type_idx underlying_type = info.generated.array.underlying_type;
+                const size_t underlying_size = asm_data.types[underlying_type].total_size;
+                for (size_t i = 0; i < info.generated.array.array_size; i++)
                 {
-                    const auto& current_type = get_addr_type(is_rhs);
-                    result = dereference(result);
-                    addr_type[is_rhs] = current_type.generated.pointer.underlying_type;
+                    find_pointers(asm_data, underlying_type, offset + i * underlying_size, has_pointers);
                 }
-                break;
-
-                case address_prefix::address_of:
+            }
+            else if (info.is_struct())
+            {
+                for (const auto& field : info.fields)
                 {
-                    tmp_var[is_rhs] = reinterpret_cast<size_t>(result);
-                    result = reinterpret_cast<uint8_t*>(&tmp_var[is_rhs]);
-
-                    const auto& current_type = get_addr_type(is_rhs);
-                    const type_idx dst_type = current_type.pointer_type;
-                    addr_type[is_rhs] = dst_type == type_idx::invalid ? type_idx::vptr : dst_type;
+                    find_pointers(asm_data, field.type, offset + field.offset, has_pointers);
                 }
-                break;
-
-                case address_prefix::size_of:
+            }
+            else
+            {
+                const uint8_t* value = *reinterpret_cast<const uint8_t* const*>(globals.data() + offset);
+                if (value >= source_globals && value < source_globals + globals.size())
                 {
-                    tmp_var[is_rhs] = get_addr_type(is_rhs).total_size;
-                    result = reinterpret_cast<uint8_t*>(&tmp_var[is_rhs]);
-
-                    addr_type[is_rhs] = derive_type_index_v<size_t>;
+                    pointers.push_back({ offset, false });
+                }
+                else if (value >= source_constants && value < source_constants + asm_data.constants.data.size())
+                {
+                    pointers.push_back({ offset, true });
                 }
-                break;
             }
+        }
 
-            sf.iptr += sizeof(address_data_t);
+        const uint8_t* source_globals;
+        const uint8_t* source_constants;
+        vector<snapshot_pointer> pointers;
+    };
+    constexpr size_t context_snapshot_data_handle_size = approximate_handle_size(sizeof(context_snapshot_data));
 
-            return result;
-        }
+    execution_context::execution_context(const assembly& linked_assembly, const runtime& rt, runtime_parameters parameters) :
+        handle(linked_assembly, rt, parameters)
+    {
 
-        void push_stack_frame(const method& method, const signature& calling_signature)
-        {
-            const signature& signature = get_signature(method.signature);
-            ASSERT(signature.index == calling_signature.index, "Call signature mismatch");
+    }
+    execution_context::execution_context(const program& shared_program, print_method_handle print_method) :
+        handle(shared_program, print_method)
+    {
 
-            const auto& bytecode = method.bytecode;
+    }
+    execution_context::~execution_context()
+    {
 
-            const size_t current_stack_size = stack.size;
-            // Next stackframe pointer (end of total stack)
-            uint8_t* const sptr = stack.data + current_stack_size;
-            // Next return address (end of effective stack)
-            uint8_t* const rptr = stack_end;
+    }
 
-            if (!method.is_external())
-            {
-                callstack_depth++;
-                VALIDATE_CALLSTACK_LIMIT(callstack_depth <= parameters.max_callstack_depth, parameters.max_callstack_depth);
+    method_idx execution_context::find_method(string_view name) const
+    {
+        const method_idx* find = self().method_names.find(name);
+        return find ? *find : method_idx::invalid;
+    }
 
-                // Push method stack size
-                const size_t new_stack_size = stack.size + method.total_stack_size + stack_frame_size;
-                VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
-                stack.size = new_stack_size;
+    int32_t execution_context::execute()
+    {
+        const assembly_data& asm_data = assembly_ref();
+        VALIDATE_ENTRYPOINT(asm_data.methods.is_valid_index(asm_data.main));
+        return self().runtime_interpreter.execute_main(asm_data.methods[asm_data.main]);
+    }
+    void execution_context::invoke(method_idx method, span<const uint8_t> arguments, span<uint8_t> return_value)
+    {
+        const assembly_data& asm_data = assembly_ref();
+        VALIDATE_INVOKE(asm_data.methods.is_valid_index(method), "Attempted to invoke an invalid method (%)", static_cast<uint32_t>(method));
+        self().runtime_interpreter.invoke(asm_data.methods[method], arguments.data(), arguments.size(), return_value.data(), return_value.size());
+    }
 
-                // Write parameters
-                uint8_t* const param_ptr = sptr + stack_frame_size;
-                const size_t parameter_count = calling_signature.parameters.size();
-                const size_t arg_count = sf.iptr ? static_cast<size_t>(read_bytecode<uint8_t>(sf.iptr)) : 0;
-                ASSERT(arg_count == parameter_count, "Invalid argument count");
-                if (parameter_count > 0)
-                {
-                    for (size_t i = 0; i < parameter_count; i++)
-                    {
-                        const stackvar& parameter = calling_signature.parameters[i];
-                        const subcode sub = read_subcode();
-                        const uint8_t* arg_addr = read_address(true);
-                        set(sub, param_ptr + parameter.offset, arg_addr);
-                    }
-                }
+    void execution_context::prewarm(span<const method_idx> methods)
+    {
+        self().runtime_interpreter.prewarm(methods);
+    }
 
-                // Update method lookup
-                method_return_type = signature.return_type;
-                method_stackvars = method.stackvars.data();
-                method_parameters = signature.parameters.data();
+    void execution_context::reset_globals()
+    {
+        self().runtime_interpreter.reset_globals();
+    }
+    void execution_context::restore(const context_snapshot& snapshot)
+    {
+        const context_snapshot_data& snapshot_data = snapshot.self();
+        const assembly_data& asm_data = assembly_ref();
+        VALIDATE_SNAPSHOT(snapshot_data.assembly_hash == self().assembly_hash &&
+            snapshot_data.global_count == asm_data.globals.info.size() && snapshot_data.globals.size() == asm_data.globals.data.size());
+        interpreter& target = self().runtime_interpreter;
+        target.restore_globals(snapshot_data.globals);
+        snapshot_data.rebase_pointers(target.globals(), asm_data.constants.data.data());
+    }
 
-                // Update offsets
-                param_offset = param_ptr;
-                stack_offset = param_offset + calling_signature.parameters_size;
-                stack_end = sptr + method.method_stack_size + stack_frame_size;
+    runtime_statistics execution_context::statistics() const
+    {
+        return self().runtime_interpreter.statistics();
+    }
+    runtime_profile execution_context::profile() const
+    {
+        return self().runtime_interpreter.profile();
+    }
+    sample_profile execution_context::samples() const
+    {
+        return self().runtime_interpreter.samples();
+    }
+    void execution_context::reset_statistics()
+    {
+        self().runtime_interpreter.reset_statistics();
+    }
+    std::string execution_context::trace() const
+    {
+        return self().runtime_interpreter.format_trace();
+    }
+    memory_statistics execution_context::memory_usage() const
+    {
+        memory_statistics result = self().runtime_interpreter.memory_usage();
+        result.assembly_bytes = self().executing_assembly.data().size();
+        return result;
+    }
 
-                // Write stack frame
-                *reinterpret_cast<stack_frame_t*>(sptr) = sf;
+    const assembly_data& execution_context::assembly_ref() const noexcept
+    {
+        return self().runtime_interpreter.assembly_ref();
+    }
+
+
+    // Native types match by name and size, pointers match any pointer of the same depth
+    // (with void pointers matching the untyped pointer type)
+    static bool match_native_type(const assembly_data& asm_data, type_idx type, const native::typedecl& native_type)
+    {
+        for (size_t depth = native_type.pointer_depth; depth > 0; depth--)
+        {
+            if (type == type_idx::vptr) return depth == 1 && native_type.name == "void";
+            const auto& pointer = asm_data.types[type];
+            if (!pointer.is_pointer()) return false;
+            type = pointer.generated.pointer.underlying_type;
+        }
+        const auto& value = asm_data.types[type];
+        return value.total_size == native_type.size && asm_data.database[value.name] == native_type.name;
+    }
 
-                // Call
-                sf = stack_frame_t(bytecode.data(), rptr, sptr, &method);
-                ibeg = sf.iptr;
-                iend = ibeg + bytecode.size();
+    method_binding::method_binding(const execution_context& context, string_view name, const native::typedecl& return_type, span<const native::parameter> parameters, size_t* offsets)
+    {
+        const assembly_data& asm_data = context.assembly_ref();
+        const method_idx index = context.find_method(name);
+        VALIDATE_INVOKE(index != method_idx::invalid, "Failed to find method '%'", name);
+        const auto& bind_method = asm_data.methods[index];
+        VALIDATE_INVOKE(!bind_method.is_external(), "Method '%' is external and can not be invoked directly", name);
+
+        const auto& bind_signature = asm_data.signatures[bind_method.signature];
+        VALIDATE_METHOD_BINDING(bind_signature.parameters.size() == parameters.size() && match_native_type(asm_data, bind_signature.return_type, return_type), name);
+        for (size_t i = 0; i < parameters.size(); i++)
+        {
+            VALIDATE_METHOD_BINDING(match_native_type(asm_data, bind_signature.parameters[i].type, parameters[i]), name);
+            offsets[i] = bind_signature.parameters[i].offset;
+        }
 
-                // Clear return value after a call
-                clear_return_value();
-            }
-            else
-            {
-                ASSERT(bytecode.size() == sizeof(runtime_call_index), "Invalid external index");
-                const runtime_call_index cidx = *reinterpret_cast<const runtime_call_index*>(bytecode.data());
+        method = index;
+        return_size = asm_data.types[bind_signature.return_type].total_size;
+    }
+    uint8_t* method_binding::begin_invoke(execution_context& context) const
+    {
+        ASSERT(method != method_idx::invalid, "Attempted to invoke an unbound method");
+        interpreter& context_interpreter = context.self().runtime_interpreter;
+        return context_interpreter.push_entry_frame(context_interpreter.assembly_ref().methods[method], return_size);
+    }
+    const uint8_t* method_binding::end_invoke(execution_context& context) const
+    {
+        interpreter& context_interpreter = context.self().runtime_interpreter;
+        context_interpreter.end_invoke(return_size);
+        return context_interpreter.return_value();
+    }
 
-                // Ensure method handle
-                ASSERT(libraries.is_valid_index(cidx.library), "Invalid library index");
-                auto& lib = libraries[cidx.library];
-                ASSERT(lib.calls.is_valid_index(cidx.index), "Invalid call index");
-                auto& call = lib.calls[cidx.index];
-                if (!call.handle)
-                {
-                    if (!lib.handle.is_open())
-                    {
-                        const bool opened = lib.handle.open();
-                        ASSERT(opened, "Failed to load library");
-                    }
-                    call.handle = lib.handle.get_proc(call.name.data());
-                    ASSERT(call.handle, "Failed to find function");
-                }
 
-                // Push method stack size (parameters only for external methods)
-                if (method.total_stack_size > 0)
-                {
-                    const size_t new_stack_size = stack.size + method.total_stack_size;
-                    VALIDATE_STACK_OVERFLOW(new_stack_size <= stack.capacity, new_stack_size, stack.capacity);
-                    stack.size = new_stack_size;
-                }
+    context_snapshot::context_snapshot(const execution_context& context) :
+        handle(context)
+    {
 
-                // Write parameters
-                const size_t parameter_count = calling_signature.parameters.size();
-                const size_t arg_count = sf.iptr ? static_cast<size_t>(read_bytecode<uint8_t>(sf.iptr)) : 0;
-                ASSERT(arg_count == parameter_count, "Invalid argument count");
-                uint8_t* const param_ptr = sptr;
-                if (parameter_count > 0)
-                {
-                    for (size_t i = 0; i < parameter_count; i++)
-                    {
-                        const stackvar& parameter = calling_signature.parameters[i];
-                        const subcode sub = read_subcode();
-                        const uint8_t* arg_addr = read_address(true);
-                        set(sub, param_ptr + parameter.offset, arg_addr);
-                    }
-                }
+    }
+    context_snapshot::~context_snapshot()
+    {
 
-                // Invoke external
-                call.forward(call.handle, rptr, param_ptr);
+    }
 
-                // Set return value here since we return immediately
-                const type_idx return_type_idx = calling_signature.return_type;
-                return_value_addr = rptr;
-                return_value_type = return_type_idx;
 
-                // Pop stackframe
-                stack.size = current_stack_size;
-            }
+    class fiber_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(fiber_data, const program& shared_program, method_idx method, span<const uint8_t> arguments, print_method_handle print_method) :
+            fiber_interpreter(shared_program.self().prototype, print_method)
+        {
+            restart(method, arguments);
         }
-        void pop_stack_frame()
+
+        void restart(method_idx method, span<const uint8_t> arguments)
         {
-            // Restore stackframe
-            ASSERT(callstack_depth > 0, "Stack frame pop overflow");
-            sf = *reinterpret_cast<stack_frame_t*>(sf.sptr);
-            if (sf.mptr != nullptr)
-            {
-                // Restore method lookup
-                const method& calling_method = *sf.mptr;
-                const signature& calling_signature = get_signature(calling_method.signature);
-                method_stackvars = calling_method.stackvars.data();
-                method_parameters = calling_signature.parameters.data();
-                method_return_type = calling_signature.return_type;
+            const assembly_data& asm_data = fiber_interpreter.assembly_ref();
+            VALIDATE_INVOKE(asm_data.methods.is_valid_index(method), "Attempted to invoke an invalid method (%)", static_cast<uint32_t>(method));
 
-                // Restore instruction range
-                const auto& bytecode = calling_method.bytecode;
-                ibeg = bytecode.data();
-                iend = ibeg + bytecode.size();
+            finished = true;
+            returned = false;
+            return_size = fiber_interpreter.begin_invoke(asm_data.methods[method], arguments.data(), arguments.size());
+            finished = false;
+        }
+        bool resume(uint64_t step_budget)
+        {
+            if (finished) return true;
 
-                // Restore local offsets
-                param_offset = sf.sptr + stack_frame_size;
-                stack_offset = param_offset + calling_signature.parameters_size;
-                stack_end = sf.sptr + calling_method.method_stack_size + stack_frame_size;
+            try
+            {
+                returned = fiber_interpreter.resume_decoded(step_budget);
             }
-            else
+            catch (const runtime_exception& e)
             {
-                method_return_type = type_idx::voidtype;
-                method_stackvars = nullptr;
-                method_parameters = nullptr;
-                ibeg = iend = nullptr;
+                // The stack is left in an undefined state, the fiber can only be restarted
+                finished = true;
+                fiber_interpreter.flush_output();
+                if (fiber_interpreter.is_traced()) fiber_interpreter.throw_traced(e);
+                throw;
             }
-            callstack_depth--;
+            catch (...)
+            {
+                finished = true;
+                fiber_interpreter.flush_output();
+                throw;
+            }
+            fiber_interpreter.flush_output();
+            finished = returned;
+            return finished;
         }
 
-        inline uint8_t* push_return_value(type_idx type) noexcept
-        {
-            return_value_addr = stack_end;
-            return_value_type = type;
-            return return_value_addr;
-        }
-        inline void clear_return_value() noexcept
+        interpreter fiber_interpreter;
+        size_t return_size = 0;
+        // Set once the method has returned or thrown
+        bool finished = true;
+        // Set once the method has returned
+        bool returned = false;
+    };
+    constexpr size_t fiber_data_handle_size = approximate_handle_size(sizeof(fiber_data));
+
+    fiber::fiber(const program& shared_program, method_idx method, span<const uint8_t> arguments, print_method_handle print_method) :
+        handle(shared_program, method, arguments, print_method)
+    {
+
+    }
+    fiber::~fiber()
+    {
+
+    }
+
+    bool fiber::resume(uint64_t step_budget)
+    {
+        return self().resume(step_budget);
+    }
+    bool fiber::resume_for(std::chrono::nanoseconds time_budget, uint64_t check_interval)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while (!self().resume(check_interval))
         {
-            return_value_addr = nullptr;
-            return_value_type = type_idx::voidtype;
+            if (std::chrono::steady_clock::now() - start >= time_budget) return false;
         }
+        return true;
+    }
 
+    void fiber::restart(method_idx method, span<const uint8_t> arguments)
+    {
+        self().restart(method, arguments);
+    }
+    void fiber::reset_globals()
+    {
+        self().fiber_interpreter.reset_globals();
+    }
 
-        inline stack_data_t allocate_stack(size_t min_stack_size, size_t max_stack_size)
-        {
-            uint8_t* memory = nullptr;
-            size_t capacity = 0;
+    bool fiber::finished() const noexcept
+    {
+        return self().finished;
+    }
+    span<const uint8_t> fiber::return_value() const noexcept
+    {
+        const auto& data = self();
+        if (!data.returned) return span<const uint8_t>();
+        return span<const uint8_t>(data.fiber_interpreter.stack_data(), data.return_size);
+    }
 
-            // Try and find a stack that fits
-            for (size_t i = sizeof(size_t) * 8; i > 0; i--)
-            {
-                capacity = (static_cast<size_t>(1) << static_cast<size_t>(i - 1));
-                if (capacity >= min_stack_size && capacity <= max_stack_size)
-                {
-                    memory = static_cast<uint8_t*>(malloc(capacity));
-                    if (memory) break;
-                }
-            }
 
-            VALIDATE_STACK_ALLOCATION(memory != nullptr);
+    class fiber_scheduler_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(fiber_scheduler_data, size_t worker_count, uint64_t step_budget) :
+            worker_count(worker_count),
+            step_budget(step_budget) {}
 
-            return stack_data_t(memory, capacity);
-        }
+        const size_t worker_count;
+        const uint64_t step_budget;
+        vector<fiber*> fibers;
+    };
+    constexpr size_t fiber_scheduler_data_handle_size = approximate_handle_size(sizeof(fiber_scheduler_data));
 
+    fiber_scheduler::fiber_scheduler(size_t worker_count, uint64_t step_budget) :
+        handle(worker_count, step_budget)
+    {
 
-        // Stack frame
-        stack_frame_t sf;
+    }
+    fiber_scheduler::~fiber_scheduler()
+    {
 
-        // Stack data
-        stack_data_t stack;
+    }
 
-        // Offset of the method parameters
-        uint8_t* param_offset = nullptr;
-        // Offset of the method stackvars
-        uint8_t* stack_offset = nullptr;
-        // End of the method stack (excluding return values)
-        uint8_t* stack_end = nullptr;
+    void fiber_scheduler::add(fiber& queued_fiber)
+    {
+        if (queued_fiber.finished()) return;
 
-        // Temporary variables
-        size_t tmp_var[2];
-        type_idx addr_type[2];
-        inline const type& get_addr_type(bool is_rhs) noexcept
+        // A fiber queued twice would be resumed by two workers at once
+        auto& fibers = self().fibers;
+        if (std::find(fibers.begin(), fibers.end(), &queued_fiber) == fibers.end()) fibers.push_back(&queued_fiber);
+    }
+    size_t fiber_scheduler::size() const noexcept
+    {
+        return self().fibers.size();
+    }
+
+    void fiber_scheduler::step()
+    {
+        auto& data = self();
+        auto& fibers = data.fibers;
+
+        // Exceptions are collected, so that a failing fiber does not hold up the others
+        std::mutex exception_mutex;
+        std::exception_ptr exception;
+        parallel_for(fibers.size(), data.worker_count, [&](size_t idx)
         {
-            return get_type(addr_type[is_rhs]);
-        }
+            try
+            {
+                fibers[idx]->resume(data.step_budget);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!exception) exception = std::current_exception();
+            }
+        });
 
-        // Return value
-        uint8_t* return_value_addr;
-        type_idx return_value_type;
+        fibers.erase(std::remove_if(fibers.begin(), fibers.end(), [](const fiber* it) { return it->finished(); }), fibers.end());
 
-        // Instruction pointer
-        const uint8_t* ibeg = nullptr;
-        const uint8_t* iend = nullptr;
+        if (exception) std::rethrow_exception(exception);
+    }
+    void fiber_scheduler::run()
+    {
+        auto& data = self();
 
-        // Current method lookup info
-        type_idx method_return_type = type_idx::voidtype;
-        const stackvar* method_stackvars;
-        const stackvar* method_parameters;
+        std::mutex queue_mutex;
+        std::deque<fiber*> queue(data.fibers.begin(), data.fibers.end());
+        data.fibers.clear();
 
-        // Globals/constants
-        block<uint8_t> global_data;
-        data_table_view global_tables[2];
+        std::exception_ptr exception;
+        auto worker = [&]()
+        {
+            while (true)
+            {
+                fiber* next;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    if (queue.empty()) return;
+                    next = queue.front();
+                    queue.pop_front();
+                }
 
-        // Externals
-        indexed_vector<name_idx, runtime_library> libraries;
+                bool finished = true;
+                try
+                {
+                    finished = next->resume(data.step_budget);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    if (!exception) exception = std::current_exception();
+                }
 
-        // Strings
-        const string_table<name_idx>& database;
-        string generated_name_buffers[2];
-        size_t generated_name_index = 0;
+                // Suspended fibers go to the back of the queue
+                if (!finished)
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    queue.push_back(next);
+                }
+            }
+        };
 
-        // Input data
-        const assembly_data& data;
-        const runtime_parameters parameters;
-        uint32_t callstack_depth = 0;
+        const size_t thread_count = resolve_thread_count(data.worker_count, queue.size());
+        vector<std::thread> threads;
+        if (thread_count > 1) threads.reserve(thread_count - 1);
+        for (size_t i = 1; i < thread_count; i++) threads.emplace_back(worker);
+        worker();
+        for (auto& it : threads) it.join();
 
-        int32_t return_code = 0;
-        print_method_handle print_method;
-        stringstream output_stream;
-        block<char> output_buffer;
+        if (exception) std::rethrow_exception(exception);
+    }
 
-        void print_output()
+
+    class batch_executor_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(batch_executor_data, const program& shared_program, batch_parameters parameters) :
+            prototype(shared_program.self().prototype),
+            parameters(parameters) {}
+
+        // Range of invocations that have not been started yet
+        struct work_queue
+        {
+            std::mutex mutex;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        void execute(method_idx method, size_t count, span<const uint8_t> arguments, span<uint8_t> return_values)
         {
-            std::streamsize stream_length = (std::streamsize)output_stream.tellp();
-            if (stream_length > 0)
+            const assembly_data& asm_data = prototype.assembly_ref();
+            VALIDATE_INVOKE(asm_data.methods.is_valid_index(method), "Attempted to invoke an invalid method (%)", static_cast<uint32_t>(method));
+            const auto& entry = asm_data.methods[method];
+            const auto& entry_signature = asm_data.signatures[entry.signature];
+            const size_t argument_stride = entry_signature.parameters_size;
+            const size_t return_stride = asm_data.types[entry_signature.return_type].total_size;
+            VALIDATE_INVOKE_ARGUMENTS(arguments.size() == argument_stride * count,
+                "Argument size mismatch (% bytes provided where % were expected)", arguments.size(), argument_stride * count);
+            VALIDATE_INVOKE_ARGUMENTS(return_values.size() >= return_stride * count,
+                "Return value buffer too small (% bytes provided where % were expected)", return_values.size(), return_stride * count);
+            if (count == 0) return;
+
+            const size_t chunk_size = std::max(parameters.chunk_size, size_t(1));
+            const size_t thread_count = resolve_thread_count(parameters.worker_count, (count + chunk_size - 1) / chunk_size);
+
+            // Contexts are created once and reused by subsequent batches
+            while (workers.size() < thread_count) workers.emplace_back(prototype, parameters.print_method);
+
+            // Distribute the invocations evenly
+            vector<work_queue> queues(thread_count);
+            for (size_t i = 0; i < thread_count; i++)
             {
-                // Add space for null terminator, stringstream appends one automatically)
-                stream_length++;
-                size_t required_size = static_cast<size_t>(stream_length);
+                queues[i].begin = (count * i) / thread_count;
+                queues[i].end = (count * (i + 1)) / thread_count;
+            }
 
-                if (output_buffer.size() < required_size)
+            std::atomic<bool> failed = false;
+            std::exception_ptr exception;
+            auto worker = [&](size_t idx)
+            {
+                interpreter& context = workers[idx];
+                work_queue& own = queues[idx];
+                try
                 {
-                    size_t new_size = std::max(output_buffer.size(), size_t(1 << 8));
-                    while (required_size > new_size)
+                    while (!failed)
                     {
-                        new_size <<= 1;
-                        ASSERT(new_size <= size_t(1 << 20), "String buffer overflow");
+                        // Take the next chunk from the front of the own queue
+                        size_t begin, end;
+                        {
+                            std::lock_guard<std::mutex> lock(own.mutex);
+                            begin = own.begin;
+                            end = std::min(begin + chunk_size, own.end);
+                            own.begin = end;
+                        }
+                        if (begin == end)
+                        {
+                            if (!steal(queues, idx)) break;
+                            continue;
+                        }
+
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            if (parameters.reset_globals) context.reset_globals();
+                            context.invoke(entry, arguments.data() + i * argument_stride, argument_stride, return_values.data() + i * return_stride, return_stride);
+                        }
                     }
-                    output_buffer = block<char>(new_size);
                 }
-                output_stream.get(output_buffer.data(), stream_length);
-                output_stream.seekp(0, std::ios::beg);
-                output_stream.seekg(0, std::ios::beg);
-                output_stream.clear();
-                print_method(output_buffer.data(), required_size - 1);
-            }
-        }
-        static void default_print_method(const char* c_str, size_t len)
-        {
-            std::cout << std::string_view(c_str, len) << std::endl;
-        }
+                catch (...)
+                {
+                    if (!failed.exchange(true)) exception = std::current_exception();
+                }
+            };
 
-        template<typename value_t> value_t get_value(const uint8_t* addr) { return *reinterpret_cast<const value_t*>(addr); }
-        template<typename value_t> void dump_value(const uint8_t* addr) { output_stream << get_value<value_t>(addr); }
-        template<> inline void dump_value<int8_t>(const uint8_t* addr) { output_stream << static_cast<int32_t>(get_value<int8_t>(addr)); }
-        template<> inline void dump_value<uint8_t>(const uint8_t* addr) { output_stream << static_cast<uint32_t>(get_value<uint8_t>(addr)); }
-        template<> inline void dump_value<bool>(const uint8_t* addr)
-        {
-            const uint8_t b = get_value<uint8_t>(addr);
-            if (b == 0) output_stream << "false";
-            else if (b == 1) output_stream << "true";
-            else output_stream << static_cast<uint32_t>(b);
+            vector<std::thread> threads;
+            threads.reserve(thread_count - 1);
+            for (size_t i = 1; i < thread_count; i++) threads.emplace_back(worker, i);
+            worker(0);
+            for (auto& it : threads) it.join();
+
+            if (exception) std::rethrow_exception(exception);
         }
-        template<typename value_t> void dump_var(const uint8_t* addr)
+        // Move the back half of the queue of another worker into the (empty) queue of this worker
+        static bool steal(vector<work_queue>& queues, size_t idx)
         {
-            output_stream << '(';
-            dump_value<value_t>(addr);
-            output_stream << ')';
+            for (size_t i = 1; i < queues.size(); i++)
+            {
+                work_queue& victim = queues[(idx + i) % queues.size()];
+                size_t begin, end;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    const size_t remaining = victim.end - victim.begin;
+                    if (remaining == 0) continue;
+
+                    begin = victim.end - (remaining + 1) / 2;
+                    end = victim.end;
+                    victim.end = begin;
+                }
+
+                work_queue& own = queues[idx];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin = begin;
+                own.end = end;
+                return true;
+            }
+            return false;
         }
+
+        const interpreter& prototype;
+        const batch_parameters parameters;
+        // Worker contexts
+        std::deque<interpreter> workers;
     };
+    constexpr size_t batch_executor_data_handle_size = approximate_handle_size(sizeof(batch_executor_data));
 
+    batch_executor::batch_executor(const program& shared_program, batch_parameters parameters) :
+        handle(shared_program, parameters)
+    {
 
-    int32_t runtime::execute(const assembly& linked_assembly, runtime_parameters parameters) const
+    }
+    batch_executor::~batch_executor()
     {
-        VALIDATE_ASSEMBLY(linked_assembly.is_valid());
-        VALIDATE_COMPATIBILITY(linked_assembly.is_compatible());
 
-        // Find main
-        const assembly_data& asm_data = linked_assembly.assembly_ref();
-        VALIDATE_ENTRYPOINT(asm_data.methods.is_valid_index(asm_data.main));
+    }
 
-        // Setup runtime
-        const auto& rt_data = self();
-        VALIDATE_RUNTIME_HASH(asm_data.runtime_hash == rt_data.hash);
+    void batch_executor::execute(method_idx method, size_t count, span<const uint8_t> arguments, span<uint8_t> return_values)
+    {
+        self().execute(method, count, arguments, return_values);
+    }
 
-        // Copy assembly binary into a protected memory area
-        const auto asm_binary = linked_assembly.assembly_binary();
-        host_memory host_mem(asm_binary.size());
-        ASSERT(host_mem, "Failed to allocate memory pages from host");
-        memcpy(host_mem.data(), asm_binary.data(), asm_binary.size());
-        const bool protect = host_mem.protect();
-        ASSERT(protect, "Failed to switch host memory pages to protected");
-
-        // Execute
-        const assembly_data& protected_data = *reinterpret_cast<assembly_data*>(host_mem.data());
-        return interpreter(protected_data, protected_data.methods[protected_data.main], rt_data, parameters);
+    void runtime::execute_batch(const assembly& linked_assembly, method_idx method, size_t count, span<const uint8_t> arguments, span<uint8_t> return_values,
+        batch_parameters batch, runtime_parameters parameters) const
+    {
+        const program shared_program(linked_assembly, *this, parameters);
+        batch_executor executor(shared_program, batch);
+        executor.execute(method, count, arguments, return_values);
     }
 }
\ No newline at end of file
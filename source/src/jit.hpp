@@ -0,0 +1,73 @@
+#ifndef _HEADER_JIT
+#define _HEADER_JIT
+
+#include "host.hpp"
+
+// Native code generation is only implemented for x86-64,
+// on other architectures every method remains interpreted
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_SUPPORTED 1
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+namespace propane
+{
+    // Native method entry point. Frame points to the parameters of the method
+    // (using the same stack frame layout as the interpreter), return value points
+    // to the return value address of the calling frame.
+    typedef void(*native_entry)(uint8_t* frame, uint8_t* return_value);
+
+    // Compiled method, owns the executable memory pages
+    class native_code final
+    {
+    public:
+        native_code() = default;
+        native_code(hostmem mem) :
+            mem(mem) {}
+        ~native_code()
+        {
+            if (mem) host::free(mem);
+        }
+
+        native_code(const native_code&) = delete;
+        native_code& operator=(const native_code&) = delete;
+
+        native_code(native_code&& other) noexcept :
+            mem(other.mem)
+        {
+            other.mem = hostmem{ nullptr, 0 };
+        }
+        native_code& operator=(native_code&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (mem) host::free(mem);
+                mem = other.mem;
+                other.mem = hostmem{ nullptr, 0 };
+            }
+            return *this;
+        }
+
+        inline native_entry entry() const noexcept
+        {
+            return reinterpret_cast<native_entry>(mem.address);
+        }
+        inline operator bool() const noexcept
+        {
+            return mem;
+        }
+
+    private:
+        hostmem mem = { nullptr, 0 };
+    };
+
+    // Compiles a pre-decoded method into native code. Only leaf methods operating on
+    // integral values in the method frame, globals and constants are supported.
+    // Returns an empty object if the method contains anything else (calls, floating point,
+    // pointer arithmetic, division, etc.), in which case the method remains interpreted.
+    // Up to register_count of the most used stack variables are kept in registers.
+    native_code compile_native(const struct decoded_method& method, uint8_t* global_data, size_t register_count);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,679 @@
+#include "jit.hpp"
+#include "decoded_bytecode.hpp"
+#include "errors.hpp"
+
+#include <algorithm>
+
+#if JIT_SUPPORTED
+
+namespace propane
+{
+    namespace
+    {
+        enum class reg : uint8_t
+        {
+            rax = 0,
+            rcx = 1,
+            rdx = 2,
+            rbx = 3,
+            rsi = 6,
+            rdi = 7,
+            r8 = 8,
+            r9 = 9,
+            r10 = 10,
+            r11 = 11,
+            r12 = 12,
+            r13 = 13,
+            r14 = 14,
+            r15 = 15,
+        };
+
+        // Argument registers of the native entry point
+#if defined(_WIN32)
+        constexpr reg arg0 = reg::rcx;
+        constexpr reg arg1 = reg::rdx;
+#else
+        constexpr reg arg0 = reg::rdi;
+        constexpr reg arg1 = reg::rsi;
+#endif
+        // Register allocation
+        // Frame and return value pointers get moved into r8/r9 because rcx is needed for shifts
+        constexpr reg frame_reg = reg::r8;
+        constexpr reg return_reg = reg::r9;
+        constexpr reg lhs_reg = reg::rax;
+        constexpr reg rhs_reg = reg::rcx;
+        constexpr reg tmp_reg = reg::rdx;
+        // Address registers for operands that are not relative to the frame
+        constexpr reg lhs_addr_reg = reg::r11;
+        constexpr reg rhs_addr_reg = reg::r10;
+        // Non-volatile registers which hold cached stack variables (saved on entry)
+        constexpr reg cache_regs[] = { reg::rbx, reg::r12, reg::r13, reg::r14, reg::r15 };
+        constexpr size_t cache_reg_count = sizeof(cache_regs) / sizeof(reg);
+
+        enum condition : uint8_t
+        {
+            cc_b = 0x2,
+            cc_ae = 0x3,
+            cc_e = 0x4,
+            cc_ne = 0x5,
+            cc_be = 0x6,
+            cc_a = 0x7,
+            cc_l = 0xC,
+            cc_ge = 0xD,
+            cc_le = 0xE,
+            cc_g = 0xF,
+        };
+
+        // Memory operand, [base + disp]
+        struct memory_ref
+        {
+            reg base;
+            int32_t disp;
+        };
+
+        class x64_emitter
+        {
+        public:
+            vector<uint8_t> code;
+
+            inline void emit(uint8_t b)
+            {
+                code.push_back(b);
+            }
+            inline void emit32(uint32_t v)
+            {
+                for (size_t i = 0; i < 4; i++) emit(uint8_t(v >> (i * 8)));
+            }
+            inline void emit64(uint64_t v)
+            {
+                for (size_t i = 0; i < 8; i++) emit(uint8_t(v >> (i * 8)));
+            }
+            inline void rex(bool w, reg r, reg b)
+            {
+                const uint8_t value = uint8_t(0x40 | (w << 3) | ((uint8_t(r) >> 3) << 2) | (uint8_t(b) >> 3));
+                if (value != 0x40) emit(value);
+            }
+            inline void modrm_reg(reg r, reg rm)
+            {
+                emit(uint8_t(0xC0 | ((uint8_t(r) & 7) << 3) | (uint8_t(rm) & 7)));
+            }
+            inline void modrm_mem(reg r, memory_ref mem)
+            {
+                // Base registers in use never require a SIB byte (rsp/r12)
+                ASSERT((uint8_t(mem.base) & 7) != 4, "Unsupported base register");
+                emit(uint8_t(0x80 | ((uint8_t(r) & 7) << 3) | (uint8_t(mem.base) & 7)));
+                emit32(uint32_t(mem.disp));
+            }
+
+            // dst = src
+            void mov(reg dst, reg src)
+            {
+                rex(true, src, dst);
+                emit(0x89);
+                modrm_reg(src, dst);
+            }
+            // dst = imm
+            void mov_imm(reg dst, uint64_t imm)
+            {
+                if (int64_t(imm) == int64_t(int32_t(imm)))
+                {
+                    // Sign-extended 32 bit immediate
+                    rex(true, reg::rax, dst);
+                    emit(0xC7);
+                    modrm_reg(reg::rax, dst);
+                    emit32(uint32_t(imm));
+                }
+                else
+                {
+                    rex(true, reg::rax, dst);
+                    emit(uint8_t(0xB8 | (uint8_t(dst) & 7)));
+                    emit64(imm);
+                }
+            }
+            // dst = extend(src) (sign or zero extend the low bits of a register)
+            void extend(reg dst, reg src, type_idx type)
+            {
+                switch (type)
+                {
+                    case type_idx::i8: rex(true, dst, src); emit(0x0F); emit(0xBE); break;
+                    case type_idx::u8: rex(false, dst, src); emit(0x0F); emit(0xB6); break;
+                    case type_idx::i16: rex(true, dst, src); emit(0x0F); emit(0xBF); break;
+                    case type_idx::u16: rex(false, dst, src); emit(0x0F); emit(0xB7); break;
+                    case type_idx::i32: rex(true, dst, src); emit(0x63); break;
+                    case type_idx::u32: rex(false, dst, src); emit(0x8B); break;
+                    default: rex(true, dst, src); emit(0x8B); break;
+                }
+                modrm_reg(dst, src);
+            }
+            // dst = extend(mem) (sign or zero extended to 64 bit depending on the type)
+            void load(reg dst, memory_ref mem, type_idx type)
+            {
+                switch (type)
+                {
+                    case type_idx::i8: rex(true, dst, mem.base); emit(0x0F); emit(0xBE); break;
+                    case type_idx::u8: rex(false, dst, mem.base); emit(0x0F); emit(0xB6); break;
+                    case type_idx::i16: rex(true, dst, mem.base); emit(0x0F); emit(0xBF); break;
+                    case type_idx::u16: rex(false, dst, mem.base); emit(0x0F); emit(0xB7); break;
+                    case type_idx::i32: rex(true, dst, mem.base); emit(0x63); break;
+                    case type_idx::u32: rex(false, dst, mem.base); emit(0x8B); break;
+                    default: rex(true, dst, mem.base); emit(0x8B); break;
+                }
+                modrm_mem(dst, mem);
+            }
+            // mem = truncate(src)
+            void store(memory_ref mem, reg src, size_t size)
+            {
+                switch (size)
+                {
+                    case 1: rex(false, src, mem.base); emit(0x88); break;
+                    case 2: emit(0x66); rex(false, src, mem.base); emit(0x89); break;
+                    case 4: rex(false, src, mem.base); emit(0x89); break;
+                    default: rex(true, src, mem.base); emit(0x89); break;
+                }
+                modrm_mem(src, mem);
+            }
+            // Two operand arithmetic (add, or, and, sub, xor, cmp)
+            void alu(uint8_t op, reg dst, reg src, bool wide = true)
+            {
+                rex(wide, src, dst);
+                emit(op);
+                modrm_reg(src, dst);
+            }
+            void imul(reg dst, reg src)
+            {
+                rex(true, dst, src);
+                emit(0x0F);
+                emit(0xAF);
+                modrm_reg(dst, src);
+            }
+            // Unary group 3 (not = 2, neg = 3)
+            void unary(uint8_t ext, reg dst)
+            {
+                rex(true, reg(ext), dst);
+                emit(0xF7);
+                modrm_reg(reg(ext), dst);
+            }
+            // Shift by cl (shl = 4, shr = 5, sar = 7)
+            void shift(uint8_t ext, reg dst, bool wide)
+            {
+                rex(wide, reg(ext), dst);
+                emit(0xD3);
+                modrm_reg(reg(ext), dst);
+            }
+            void test(reg dst)
+            {
+                rex(true, dst, dst);
+                emit(0x85);
+                modrm_reg(dst, dst);
+            }
+            // dst = zero_extend(condition)
+            void setcc(condition cc, reg dst)
+            {
+                emit(0x0F);
+                emit(uint8_t(0x90 | cc));
+                modrm_reg(reg::rax, dst);
+                emit(0x0F);
+                emit(0xB6);
+                modrm_reg(dst, dst);
+            }
+            // Jumps return the position of the relative offset
+            size_t jcc(condition cc)
+            {
+                emit(0x0F);
+                emit(uint8_t(0x80 | cc));
+                emit32(0);
+                return code.size() - 4;
+            }
+            size_t jmp()
+            {
+                emit(0xE9);
+                emit32(0);
+                return code.size() - 4;
+            }
+            void push(reg r)
+            {
+                rex(false, reg::rax, r);
+                emit(uint8_t(0x50 | (uint8_t(r) & 7)));
+            }
+            void pop(reg r)
+            {
+                rex(false, reg::rax, r);
+                emit(uint8_t(0x58 | (uint8_t(r) & 7)));
+            }
+            void ret()
+            {
+                emit(0xC3);
+            }
+        };
+
+        class method_compiler final
+        {
+        public:
+            NOCOPY_CLASS_DEFAULT(method_compiler, const decoded_method& method, uint8_t* global_data, size_t register_count) :
+                method(method),
+                global_data(global_data),
+                instructions(method.instructions),
+                register_count(register_count < cache_reg_count ? register_count : cache_reg_count) {}
+
+            bool compile()
+            {
+                select_cached_variables();
+                for (size_t i = 0; i < cached.size(); i++)
+                {
+                    as.push(cache_regs[i]);
+                }
+
+                // Move the entry arguments into the frame/return registers
+                as.mov(frame_reg, arg0);
+                as.mov(return_reg, arg1);
+
+                // Load the cached stack variables (they are never written back,
+                // the frame is discarded on return)
+                for (size_t i = 0; i < cached.size(); i++)
+                {
+                    as.load(cache_regs[i], memory_ref{ frame_reg, int32_t(cached[i].offset) }, cached[i].type);
+                }
+
+                const decoded_instruction* const ibeg = instructions.data();
+                vector<size_t> instruction_offsets(instructions.size());
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    instruction_offsets[i] = as.code.size();
+                    if (!compile_instruction(instructions[i])) return false;
+                }
+
+                // Methods always end in a return, but be safe in case they don't
+                emit_return();
+
+                for (const auto& fixup : fixups)
+                {
+                    const size_t target = instruction_offsets[static_cast<size_t>(fixup.second - ibeg)];
+                    const int64_t relative = int64_t(target) - int64_t(fixup.first + 4);
+                    const uint32_t value = uint32_t(int32_t(relative));
+                    memcpy(as.code.data() + fixup.first, &value, sizeof(value));
+                }
+
+                return true;
+            }
+
+            vector<uint8_t>& code() noexcept
+            {
+                return as.code;
+            }
+
+        private:
+            bool compile_instruction(const decoded_instruction& ins)
+            {
+                const opcode op = ins.base_op;
+                switch (op)
+                {
+                    case opcode::noop: return true;
+
+                    case opcode::set:
+                    case opcode::conv:
+                    {
+                        if (!is_integral(ins.lhs.type) || !is_integral(ins.rhs.type)) return false;
+                        memory_ref lhs;
+                        if (!address(ins.lhs, lhs_addr_reg, lhs) || !load(rhs_reg, ins.rhs, rhs_addr_reg)) return false;
+                        write(ins.lhs, lhs, rhs_reg);
+                        return true;
+                    }
+
+                    case opcode::ari_not:
+                    case opcode::ari_neg:
+                    {
+                        if (!is_integral(ins.lhs.type)) return false;
+                        memory_ref lhs;
+                        if (!address(ins.lhs, lhs_addr_reg, lhs)) return false;
+                        read(lhs_reg, ins.lhs, lhs);
+                        as.unary(op == opcode::ari_not ? 2 : 3, lhs_reg);
+                        write(ins.lhs, lhs, lhs_reg);
+                        return true;
+                    }
+
+                    case opcode::ari_mul:
+                    case opcode::ari_add:
+                    case opcode::ari_sub:
+                    case opcode::ari_lsh:
+                    case opcode::ari_rsh:
+                    case opcode::ari_and:
+                    case opcode::ari_xor:
+                    case opcode::ari_or:
+                    {
+                        if (!is_integral(ins.lhs.type) || !is_integral(ins.rhs.type)) return false;
+                        memory_ref lhs;
+                        if (!address(ins.lhs, lhs_addr_reg, lhs) || !load(rhs_reg, ins.rhs, rhs_addr_reg)) return false;
+                        read(lhs_reg, ins.lhs, lhs);
+                        // Bits that get truncated on store do not affect the result, except for shifts
+                        // which operate on the lhs promoted to at least 32 bit (the same as C++)
+                        const bool wide = type_size(ins.lhs.type) > 4;
+                        switch (op)
+                        {
+                            case opcode::ari_mul: as.imul(lhs_reg, rhs_reg); break;
+                            case opcode::ari_add: as.alu(0x01, lhs_reg, rhs_reg); break;
+                            case opcode::ari_sub: as.alu(0x29, lhs_reg, rhs_reg); break;
+                            case opcode::ari_lsh: as.shift(4, lhs_reg, wide); break;
+                            case opcode::ari_rsh: as.shift(is_unsigned(ins.lhs.type) ? 5 : 7, lhs_reg, wide); break;
+                            case opcode::ari_and: as.alu(0x21, lhs_reg, rhs_reg); break;
+                            case opcode::ari_xor: as.alu(0x31, lhs_reg, rhs_reg); break;
+                            case opcode::ari_or: as.alu(0x09, lhs_reg, rhs_reg); break;
+                            default: break;
+                        }
+                        write(ins.lhs, lhs, lhs_reg);
+                        return true;
+                    }
+
+                    case opcode::cmp:
+                    case opcode::ceq:
+                    case opcode::cne:
+                    case opcode::cgt:
+                    case opcode::cge:
+                    case opcode::clt:
+                    case opcode::cle:
+                    {
+                        if (!compare(ins)) return false;
+                        const bool is_unsigned = is_unsigned_comparison(ins);
+                        if (op == opcode::cmp)
+                        {
+                            // (lhs > rhs) - (lhs < rhs)
+                            as.setcc(is_unsigned ? cc_a : cc_g, lhs_reg);
+                            as.setcc(is_unsigned ? cc_b : cc_l, tmp_reg);
+                            as.alu(0x29, lhs_reg, tmp_reg, false);
+                        }
+                        else
+                        {
+                            as.setcc(get_condition(op - opcode::ceq + opcode::beq, is_unsigned), lhs_reg);
+                        }
+                        store_return_value(lhs_reg);
+                        return true;
+                    }
+
+                    case opcode::cze:
+                    case opcode::cnz:
+                    {
+                        if (!is_integral(ins.lhs.type) || !load(lhs_reg, ins.lhs, lhs_addr_reg)) return false;
+                        as.test(lhs_reg);
+                        as.setcc(op == opcode::cze ? cc_e : cc_ne, lhs_reg);
+                        store_return_value(lhs_reg);
+                        return true;
+                    }
+
+                    case opcode::br:
+                    {
+                        fixups.push_back({ as.jmp(), ins.target });
+                        return true;
+                    }
+
+                    case opcode::beq:
+                    case opcode::bne:
+                    case opcode::bgt:
+                    case opcode::bge:
+                    case opcode::blt:
+                    case opcode::ble:
+                    {
+                        if (!compare(ins)) return false;
+                        fixups.push_back({ as.jcc(get_condition(op, is_unsigned_comparison(ins))), ins.target });
+                        return true;
+                    }
+
+                    case opcode::bze:
+                    case opcode::bnz:
+                    {
+                        if (!is_integral(ins.lhs.type) || !load(lhs_reg, ins.lhs, lhs_addr_reg)) return false;
+                        as.test(lhs_reg);
+                        fixups.push_back({ as.jcc(op == opcode::bze ? cc_e : cc_ne), ins.target });
+                        return true;
+                    }
+
+                    case opcode::ret:
+                    {
+                        emit_return();
+                        return true;
+                    }
+
+                    case opcode::retv:
+                    {
+                        const type_idx return_type = method.method_signature->return_type;
+                        if (!is_integral(return_type) || !is_integral(ins.rhs.type) || !load(rhs_reg, ins.rhs, rhs_addr_reg)) return false;
+                        as.store(memory_ref{ return_reg, 0 }, rhs_reg, type_size(return_type));
+                        emit_return();
+                        return true;
+                    }
+
+                    // Division (division by zero), pointer arithmetic, switches,
+                    // calls and dumps are left to the interpreter
+                    default: return false;
+                }
+            }
+
+            // Loads both comparison operands and compares them
+            bool compare(const decoded_instruction& ins)
+            {
+                if (!is_integral(ins.lhs.type) || !is_integral(ins.rhs.type)) return false;
+                if (!load(lhs_reg, ins.lhs, lhs_addr_reg) || !load(rhs_reg, ins.rhs, rhs_addr_reg)) return false;
+                as.alu(0x39, lhs_reg, rhs_reg);
+                return true;
+            }
+            // Both operands are extended to 64 bit, which only requires an unsigned
+            // comparison if either side is an unsigned 64 bit integer (signed/unsigned 64 bit
+            // comparisons are not valid to begin with)
+            static bool is_unsigned_comparison(const decoded_instruction& ins) noexcept
+            {
+                return ins.lhs.type == type_idx::u64 || ins.rhs.type == type_idx::u64;
+            }
+            static condition get_condition(opcode branch, bool is_unsigned) noexcept
+            {
+                switch (branch)
+                {
+                    case opcode::beq: return cc_e;
+                    case opcode::bne: return cc_ne;
+                    case opcode::bgt: return is_unsigned ? cc_a : cc_g;
+                    case opcode::bge: return is_unsigned ? cc_ae : cc_ge;
+                    case opcode::blt: return is_unsigned ? cc_b : cc_l;
+                    case opcode::ble: return is_unsigned ? cc_be : cc_le;
+                    default: ASSERT(false, "Invalid branch opcode"); return cc_e;
+                }
+            }
+
+            // Computes the memory location of an operand
+            bool address(const decoded_operand& operand, reg address_reg, memory_ref& result)
+            {
+                if (operand.flags != operand_flags::none) return false;
+
+                switch (operand.base)
+                {
+                    case operand_base::frame:
+                    {
+                        if (operand.offset > size_t(INT32_MAX)) return false;
+                        result = memory_ref{ frame_reg, int32_t(operand.offset) };
+                        return true;
+                    }
+                    case operand_base::global:
+                    {
+                        as.mov_imm(address_reg, reinterpret_cast<size_t>(global_data + operand.offset));
+                        result = memory_ref{ address_reg, 0 };
+                        return true;
+                    }
+                    case operand_base::absolute:
+                    {
+                        as.mov_imm(address_reg, operand.offset);
+                        result = memory_ref{ address_reg, 0 };
+                        return true;
+                    }
+                    default: return false;
+                }
+            }
+            // Loads an operand value, extended to 64 bit
+            bool load(reg dst, const decoded_operand& operand, reg address_reg)
+            {
+                if (operand.base == operand_base::immediate)
+                {
+                    if (operand.flags != operand_flags::none) return false;
+                    as.mov_imm(dst, extend(operand.offset, operand.type));
+                    return true;
+                }
+
+                memory_ref mem;
+                if (!address(operand, address_reg, mem)) return false;
+                read(dst, operand, mem);
+                return true;
+            }
+            // Read/write of an operand of which the address has been computed
+            void read(reg dst, const decoded_operand& operand, memory_ref mem)
+            {
+                const reg* cached_reg = find_cached(operand);
+                if (cached_reg) as.mov(dst, *cached_reg);
+                else as.load(dst, mem, operand.type);
+            }
+            void write(const decoded_operand& operand, memory_ref mem, reg src)
+            {
+                // Cached variables are kept sign or zero extended to 64 bit
+                const reg* cached_reg = find_cached(operand);
+                if (cached_reg) as.extend(*cached_reg, src, operand.type);
+                else as.store(mem, src, type_size(operand.type));
+            }
+            void emit_return()
+            {
+                for (size_t i = cached.size(); i > 0; i--)
+                {
+                    as.pop(cache_regs[i - 1]);
+                }
+                as.ret();
+            }
+
+            // Picks the most used integral stack variables to keep in registers.
+            // Variables are only eligible if every access covers the entire variable
+            // (no field access, address-of, dereferencing or overlapping reads).
+            void select_cached_variables()
+            {
+                if (register_count == 0) return;
+
+                struct candidate
+                {
+                    cached_variable var;
+                    size_t use_count;
+                    bool eligible;
+                };
+                vector<candidate> candidates;
+                const size_t parameters_size = method.method_signature->parameters_size;
+                for (const auto& sv : method.source->stackvars)
+                {
+                    const size_t offset = parameters_size + sv.offset;
+                    candidates.push_back({ cached_variable{ offset, sv.type }, 0, is_integral(sv.type) });
+                }
+
+                const auto count_use = [&](const decoded_operand& operand, size_t operand_size)
+                {
+                    if (operand.base != operand_base::frame || operand_size == 0) return;
+                    for (auto& it : candidates)
+                    {
+                        if (!it.eligible) continue;
+
+                        const size_t var_size = type_size(it.var.type);
+                        if (operand.offset + operand_size <= it.var.offset || it.var.offset + var_size <= operand.offset) continue;
+
+                        if (operand.offset == it.var.offset && operand.type == it.var.type && operand.flags == operand_flags::none) it.use_count++;
+                        else it.eligible = false;
+                    }
+                };
+                for (const auto& ins : instructions)
+                {
+                    // Unsupported instructions abort compilation, so only plain operands need to be checked
+                    // (operands with flags are treated as accessing their full base variable)
+                    count_use(ins.lhs, ins.lhs.flags == operand_flags::none ? type_size(ins.lhs.type) : 1);
+                    count_use(ins.rhs, ins.rhs.flags == operand_flags::none ? type_size(ins.rhs.type) : 1);
+                }
+
+                std::stable_sort(candidates.begin(), candidates.end(), [](const candidate& lhs, const candidate& rhs)
+                {
+                    return lhs.use_count > rhs.use_count;
+                });
+                for (const auto& it : candidates)
+                {
+                    if (cached.size() == register_count || !it.eligible || it.use_count < 2) break;
+                    cached.push_back(it.var);
+                }
+            }
+            const reg* find_cached(const decoded_operand& operand) const noexcept
+            {
+                if (operand.base != operand_base::frame || operand.flags != operand_flags::none) return nullptr;
+                for (size_t i = 0; i < cached.size(); i++)
+                {
+                    if (cached[i].offset == operand.offset && cached[i].type == operand.type) return &cache_regs[i];
+                }
+                return nullptr;
+            }
+            // Comparison results are stored as i32 at the end of the method stack
+            void store_return_value(reg src)
+            {
+                as.store(memory_ref{ frame_reg, int32_t(method.source->method_stack_size) }, src, sizeof(int32_t));
+            }
+
+            static uint64_t extend(uint64_t value, type_idx type) noexcept
+            {
+                switch (type)
+                {
+                    case type_idx::i8: return uint64_t(int64_t(int8_t(value)));
+                    case type_idx::u8: return uint64_t(uint8_t(value));
+                    case type_idx::i16: return uint64_t(int64_t(int16_t(value)));
+                    case type_idx::u16: return uint64_t(uint16_t(value));
+                    case type_idx::i32: return uint64_t(int64_t(int32_t(value)));
+                    case type_idx::u32: return uint64_t(uint32_t(value));
+                    default: return value;
+                }
+            }
+            static size_t type_size(type_idx type) noexcept
+            {
+                return get_base_type_size(type);
+            }
+
+            const decoded_method& method;
+            uint8_t* const global_data;
+            const vector<decoded_instruction>& instructions;
+
+            // Stack variables kept in registers (in order of cache_regs)
+            struct cached_variable
+            {
+                size_t offset;
+                type_idx type;
+            };
+            const size_t register_count;
+            vector<cached_variable> cached;
+
+            x64_emitter as;
+            // Jump offset position and target instruction
+            vector<std::pair<size_t, const decoded_instruction*>> fixups;
+        };
+    }
+
+    native_code compile_native(const decoded_method& method, uint8_t* global_data, size_t register_count)
+    {
+        if (method.source->method_stack_size > size_t(INT32_MAX)) return native_code();
+
+        method_compiler compiler(method, global_data, register_count);
+        if (!compiler.compile()) return native_code();
+
+        const vector<uint8_t>& code = compiler.code();
+        const hostmem mem = host::allocate(code.size());
+        if (!mem) return native_code();
+        memcpy(mem.address, code.data(), code.size());
+        if (!host::protect(mem, true))
+        {
+            host::free(mem);
+            return native_code();
+        }
+        return native_code(mem);
+    }
+}
+
+#else
+
+namespace propane
+{
+    native_code compile_native(const decoded_method&, uint8_t*, size_t)
+    {
+        return native_code();
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "link_profile.hpp"
+
+#include <cstdio>
+
+namespace propane
+{
+    namespace
+    {
+        constexpr string_view profile_header = "propane_profile 1";
+        constexpr string_view method_prefix = "method ";
+
+        bool parse_number(string_view& str, uint64_t& value, int base = 10)
+        {
+            while (!str.empty() && str.front() == ' ') str.remove_prefix(1);
+            const auto result = std::from_chars(str.data(), str.data() + str.size(), value, base);
+            if (result.ec != std::errc() || result.ptr == str.data()) return false;
+            str.remove_prefix(size_t(result.ptr - str.data()));
+            return true;
+        }
+
+        // Sort counts by offset and combine the counts of equal offsets
+        void normalize(profile_method& method)
+        {
+            auto& instructions = method.instructions;
+            std::stable_sort(instructions.begin(), instructions.end(), [](const profile_count& lhs, const profile_count& rhs)
+            {
+                return lhs.offset < rhs.offset;
+            });
+            size_t dst = 0;
+            for (size_t i = 0; i < instructions.size(); i++)
+            {
+                if (dst > 0 && instructions[dst - 1].offset == instructions[i].offset)
+                {
+                    instructions[dst - 1].count += instructions[i].count;
+                    continue;
+                }
+                instructions[dst++] = instructions[i];
+            }
+            instructions.resize(dst);
+
+            method.total = 0;
+            for (const auto& it : instructions) method.total += it.count;
+        }
+    }
+
+    constexpr size_t link_profile_data_handle_size = approximate_handle_size(sizeof(link_profile_data));
+
+    link_profile::link_profile()
+    {
+
+    }
+    link_profile::~link_profile()
+    {
+
+    }
+
+    void link_profile::append(const assembly& profiled_assembly, const runtime_profile& profile)
+    {
+        if (!profiled_assembly.is_valid()) return;
+
+        const assembly_data& data = profiled_assembly.assembly_ref();
+        auto& methods = self().methods;
+
+        indexed_vector<method_idx, profile_method*> entries(data.methods.size(), nullptr);
+        const auto get_entry = [&](method_idx index) -> profile_method*
+        {
+            if (!entries.is_valid_index(index)) return nullptr;
+            if (!entries[index])
+            {
+                const method& m = data.methods[index];
+                if (m.is_external()) return nullptr;
+
+                const uint64_t fingerprint = make_profile_fingerprint(m.bytecode.size(), m.labels.data(), m.labels.size());
+                profile_method& entry = methods[string(data.database[m.name])];
+                if (entry.fingerprint != fingerprint)
+                {
+                    entry = profile_method();
+                    entry.fingerprint = fingerprint;
+                }
+                entries[index] = &entry;
+            }
+            return entries[index];
+        };
+
+        for (const auto& it : profile.methods)
+        {
+            if (profile_method* entry = get_entry(it.method)) entry->calls += it.calls;
+        }
+        for (const auto& it : profile.instructions)
+        {
+            if (profile_method* entry = get_entry(it.method)) entry->instructions.push_back(profile_count{ it.offset, it.count });
+        }
+        for (profile_method* entry : entries)
+        {
+            if (entry) normalize(*entry);
+        }
+    }
+    void link_profile::clear()
+    {
+        self().methods.clear();
+    }
+
+    bool link_profile::empty() const noexcept
+    {
+        return self().methods.empty();
+    }
+    size_t link_profile::method_count() const noexcept
+    {
+        return self().methods.size();
+    }
+
+    bool link_profile::load(const char* file_path)
+    {
+        auto& methods = self().methods;
+        methods.clear();
+
+        ifstream file(file_path);
+        if (!file.is_open()) return false;
+
+        string line;
+        const auto read_line = [&file, &line](string_view& str) -> bool
+        {
+            if (!std::getline(file, line)) return false;
+            str = line;
+            if (!str.empty() && str.back() == '\r') str.remove_suffix(1);
+            return true;
+        };
+
+        string_view str;
+        if (!read_line(str) || str != profile_header)
+        {
+            return false;
+        }
+
+        profile_method* current = nullptr;
+        while (read_line(str))
+        {
+            if (str.empty()) continue;
+
+            if (str.substr(0, method_prefix.size()) == method_prefix)
+            {
+                str.remove_prefix(method_prefix.size());
+                uint64_t fingerprint, calls;
+                if (!parse_number(str, fingerprint, 16) || !parse_number(str, calls) || str.size() < 2 || str.front() != ' ')
+                {
+                    methods.clear();
+                    return false;
+                }
+                current = &methods[string(str.substr(1))];
+                *current = profile_method();
+                current->fingerprint = fingerprint;
+                current->calls = calls;
+            }
+            else
+            {
+                uint64_t offset, count;
+                if (!current || !parse_number(str, offset) || !parse_number(str, count) || !str.empty() || offset > uint64_t(UINT32_MAX))
+                {
+                    methods.clear();
+                    return false;
+                }
+                current->instructions.push_back(profile_count{ uint32_t(offset), count });
+            }
+        }
+
+        for (auto& it : methods) normalize(it.second);
+        return true;
+    }
+    bool link_profile::save(const char* file_path) const
+    {
+        std::ofstream file(file_path);
+        if (!file.is_open()) return false;
+
+        file << profile_header << '\n';
+        char buffer[64];
+        for (const auto& it : self().methods)
+        {
+            snprintf(buffer, sizeof(buffer), "%016llx %llu ",
+                static_cast<unsigned long long>(it.second.fingerprint),
+                static_cast<unsigned long long>(it.second.calls));
+            file << method_prefix << buffer << it.first << '\n';
+            for (const auto& count : it.second.instructions)
+            {
+                snprintf(buffer, sizeof(buffer), "%u %llu", count.offset, static_cast<unsigned long long>(count.count));
+                file << buffer << '\n';
+            }
+        }
+        file.close();
+        return bool(file);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef _HEADER_LINK_PROFILE
+#define _HEADER_LINK_PROFILE
+
+#include "propane_assembly.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+
+namespace propane
+{
+    // Execution count of a single instruction
+    struct profile_count
+    {
+        uint32_t offset;
+        uint64_t count;
+    };
+
+    // Execution counts of a single method, keyed by bytecode offset
+    struct profile_method
+    {
+        // Fingerprint of the bytecode the counts were collected from
+        uint64_t fingerprint = 0;
+        // Amount of times the method was called
+        uint64_t calls = 0;
+        // Sum of all instruction counts
+        uint64_t total = 0;
+        // Executed instructions, sorted by offset
+        vector<profile_count> instructions;
+
+        uint64_t count(uint32_t offset) const noexcept
+        {
+            auto find = std::lower_bound(instructions.begin(), instructions.end(), offset,
+                [](const profile_count& lhs, uint32_t rhs) { return lhs.offset < rhs; });
+            return (find != instructions.end() && find->offset == offset) ? find->count : 0;
+        }
+    };
+
+    // Fingerprints are stored on disk, so the hash is 64 bit on all architectures (FNV-1a).
+    // Only the layout of the bytecode is hashed (size and label offsets), which does not
+    // change when the indices of referenced types, methods or globals change between links.
+    inline uint64_t make_profile_fingerprint(size_t bytecode_size, const uint32_t* labels, size_t label_count) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull;
+        const auto append = [&hash](uint64_t value)
+        {
+            for (size_t i = 0; i < sizeof(value); i++)
+            {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+        append(uint64_t(bytecode_size));
+        append(uint64_t(label_count));
+        for (size_t i = 0; i < label_count; i++) append(uint64_t(labels[i]));
+        return hash;
+    }
+
+    class link_profile_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(link_profile_data) = default;
+
+        inline const profile_method* find(string_view name) const
+        {
+            auto find = methods.find(name);
+            return find == methods.end() ? nullptr : &find->second;
+        }
+        // Counts apply only if the method still has the bytecode layout they were collected from
+        inline const profile_method* find(string_view name, size_t bytecode_size, const uint32_t* labels, size_t label_count) const
+        {
+            const profile_method* result = find(name);
+            if (result && result->fingerprint == make_profile_fingerprint(bytecode_size, labels, label_count)) return result;
+            return nullptr;
+        }
+
+        map<string, profile_method, std::less<>> methods;
+    };
+}
+
+#endif
\ No newline at end of file
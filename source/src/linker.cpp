@@ -5,6 +5,7 @@
 #include "utility.hpp"
 #include "name_generator.hpp"
 #include "library.hpp"
+#include "optimizer.hpp"
 
 #define VALIDATE(errc, expr, ...) ENSURE(errc, expr, propane::linker_exception, __VA_ARGS__)
 
@@ -20,6 +21,8 @@
     "Failed to find a definition for method '%'", name)
 #define VALIDATE_GLOBAL_DEFINITION(expr, name) VALIDATE(ERRC::LNK_UNDEFINED_GLOBAL, expr, \
     "Failed to find a definition for global '%'", name)
+#define VALIDATE_EXTERNAL_SYMBOL(expr, name, library) VALIDATE(ERRC::LNK_UNRESOLVED_EXTERNAL_SYMBOL, expr, \
+    "Failed to resolve symbol for external method '%' (library '%')", name, library)
 #define VALIDATE_TYPE_SIZE(expr, name, type_meta) VALIDATE(ERRC::LNK_TYPE_SIZE_ZERO, expr, \
     "Size of type '%' (%) evaluated to zero", name, type_meta)
 #define VALIDATE_METHOD_PTR_INITIALIZER(expr, name) VALIDATE(ERRC::LNK_UNINITIALIZED_METHOD_PTR, expr, \
@@ -33,7 +36,7 @@
 #define VALIDATE_TYPE_FIELD_DEFINITION(expr, field_name, type, type_meta) VALIDATE(ERRC::LNK_UNDEFINED_TYPE_FIELD, expr, \
     "Failed to find field '%' (see definition of type '%' at '%')", field_name, type, type_meta)
 
-// This only works in the assembly_linker class
+// This only works in the method_linker class
 #define VALIDATE_INSTRUCTION(errc, expr, fmt, ...) VALIDATE(ERRC::LNK_INVALID_IMPLICIT_CONVERSION, expr, \
     fmt " (See definition of method '%' at '%', instruction #%: %)", __VA_ARGS__ \
     this->database[this->current_method->name].name, this->make_meta(this->current_method->index), this->iidx, propane::opcode_str(this->current_op))
@@ -53,8 +56,18 @@
     "Invalid pointer expression between types '%' and '%'", this->get_name(lhs_type), this->get_name(rhs_type),)
 #define VALIDATE_PTR_OFFSET_EXPRESSION(expr, lhs_type, rhs_type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_PTR_OFFSET_EXPRESSION, expr, \
     "Unable to take pointer offset between types '%' and '%'", this->get_name(lhs_type), this->get_name(rhs_type),)
+#define VALIDATE_VECTOR_EXPRESSION(expr, lhs_type, rhs_type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_VECTOR_EXPRESSION, expr, \
+    "Invalid vector expression between types '%' and '%'", this->get_name(lhs_type), this->get_name(rhs_type),)
+#define VALIDATE_MEMORY_EXPRESSION(expr, lhs_type, rhs_type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_MEMORY_EXPRESSION, expr, \
+    "Invalid memory expression between types '%' and '%'", this->get_name(lhs_type), this->get_name(rhs_type),)
+#define VALIDATE_MEMORY_LENGTH_TYPE(expr, type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_MEMORY_EXPRESSION, expr, \
+    "Non-integral type '%' is not valid for memory length", this->get_name(type),)
 #define VALIDATE_SWITCH_TYPE(expr, type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_SWITCH_TYPE, expr, \
     "Non-integral type '%' is not valid for switch instruction", this->get_name(type),)
+#define VALIDATE_SWITCH_CASE_RANGE(expr, value, type) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_SWITCH_CASE, expr, \
+    "Switch case value % is out of range for type '%'", value, this->get_name(type),)
+#define VALIDATE_SWITCH_CASE_UNIQUE(expr, value) VALIDATE_INSTRUCTION(ERRC::LNK_INVALID_SWITCH_CASE, expr, \
+    "Duplicate switch case value %", value,)
 #define VALIDATE_ARGUMENT_COUNT(expr, provided, expected) VALIDATE_INSTRUCTION(ERRC::LNK_FUNCTION_ARGUMENT_COUNT_MISMATCH, expr, \
     "Provided argument count does not match signature parameter count: % provided where % was expected", provided, expected,)
 #define VALIDATE_SIGNATURE_TYPE_INVOCATION(expr, type) VALIDATE_INSTRUCTION(ERRC::LNK_NON_SIGNATURE_TYPE_INVOKE, expr, \
@@ -77,354 +90,172 @@
 
 namespace propane
 {
-    // Assembly linker takes in an intermediate that has been merged
-    // and links up the references. It recompiles the bytecode and replaces
-    // the lookup indices with the actual type/method indices
-    class assembly_linker final : public asm_assembly_data
+    // Resolved method from a previous link
+    struct link_cache_entry
     {
-    public:
-        assembly_linker(gen_intermediate_data&& im_data, const runtime& runtime) :
-            data(std::move(im_data)),
-            size_type(derive_type_index_v<size_t>),
-            offset_type(derive_type_index_v<offset_t>),
-            ptr_size(get_base_type_size(type_idx::vptr))
-        {
-            data.restore_generated_types();
-
-            // Setup runtime
-            auto& rt_data = runtime.self();
-            if (!rt_data.call_lookup.empty())
-            {
-                keybuf.reserve(32);
-
-                for (auto& it : data.methods)
-                {
-                    if (it.is_defined()) continue;
-
-                    const string_view method_name = data.database[it.name].name;
-                    auto find_external = rt_data.call_lookup.find(method_name);
-                    VALIDATE_METHOD_DEFINITION(find_external != rt_data.call_lookup.end(), method_name);
-
-                    // Create signature
-                    auto cidx = find_external->second;
-                    const external_call_info& call = rt_data.libraries[cidx.library].calls[cidx.index];
-                    const signature_idx sig_idx = resolve_native_types(call);
-
-                    // Create method
-                    gen_method method(it.name, it.index);
-                    method.signature = sig_idx;
-                    append_bytecode(method.bytecode, cidx);
-                    method.flags |= (extended_flags::is_defined | type_flags::is_external);
-                    it = std::move(method);
-                }
-            }
-
-            // Resolve any missing types
-            vector<string_view> unresolved_external_types;
-            for (auto& it : data.types)
-            {
-                if (it.is_defined()) continue;
+        vector<uint8_t> bytecode;
+        vector<uint32_t> labels;
+        vector<stackvar> stackvars;
+        size_t method_stack_size = 0;
+        size_t total_stack_size = 0;
+        vector<type_idx> generated_pointer_types;
+        // Resolved method before inlining (if small enough to be inlined)
+        vector<uint8_t> inline_bytecode;
+        vector<stackvar> inline_stackvars;
+        size_t inline_method_stack_size = 0;
+        size_t inline_total_stack_size = 0;
+        size_t generation = 0;
+    };
 
-                unresolved_external_types.push_back(data.database[it.name].name);
-            }
-            for (auto& it : unresolved_external_types)
-            {
-                auto find_external = rt_data.type_lookup.find(it);
-                VALIDATE_TYPE_DEFINITION(find_external != rt_data.type_lookup.end(), it);
+    class link_cache_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(link_cache_data) = default;
 
-                resolve_native_type(find_external->second);
-            }
+        unordered_map<vector<uint8_t>, link_cache_entry, key_hash, key_compare> entries;
+        size_t generation = 0;
+        size_t reused_count = 0;
+        size_t relinked_count = 0;
+    };
+    constexpr size_t link_cache_data_handle_size = approximate_handle_size(sizeof(link_cache_data));
 
-            // Set hash
-            runtime_hash = rt_data.hash;
+    link_cache::link_cache()
+    {
 
-            // Move over objects
-            for (auto& t : data.types) types.push_back(std::move(t));
-            for (auto& m : data.methods) methods.push_back(std::move(m));
-            for (auto& s : data.signatures) signatures.push_back(std::move(s));
-            for (auto& o : data.offsets) offsets.push_back(std::move(o));
+    }
+    link_cache::~link_cache()
+    {
 
-            // Move over data
-            globals = std::move(data.globals);
-            constants = std::move(data.constants);
-            database = std::move(data.database);
-            metatable = std::move(data.metatable);
+    }
 
-            // Resolve types, methods and signatures
-            for (auto& t : types) if (!t.is_resolved()) resolve_type_recursive(t);
-            for (auto& s : signatures) if (!s.is_resolved) resolve_signature(s);
-            // Resolve offsets
-            resolve_offsets();
-            // Resolve methods (after everything else)
-            for (auto& m : methods) if (!m.is_resolved()) resolve_method(m);
+    void link_cache::clear()
+    {
+        auto& cache = self();
+        cache.entries.clear();
+        cache.reused_count = 0;
+        cache.relinked_count = 0;
+    }
+    size_t link_cache::reused_count() const noexcept
+    {
+        return self().reused_count;
+    }
+    size_t link_cache::relinked_count() const noexcept
+    {
+        return self().relinked_count;
+    }
 
-            // Link constants
-            initialize_data_table(constants, true);
-            initialize_data_table(globals, false);
+    // Type list of an assembly that can be extended with pointer types that
+    // are generated locally while linking a method
+    class method_type_list final
+    {
+    public:
+        method_type_list(const indexed_vector<type_idx, asm_type>& types) :
+            types(types) {}
 
-            // Find main
-            find_main();
+        inline const asm_type& operator[](type_idx idx) const noexcept
+        {
+            const size_t index = static_cast<size_t>(idx);
+            return index < types.size() ? types[idx] : generated[index - types.size()];
+        }
+        inline bool is_valid_index(type_idx idx) const noexcept
+        {
+            return static_cast<size_t>(idx) < types.size() + generated.size();
         }
 
-        vector<uint8_t> keybuf;
-        vector<stackvar> params;
-
-        signature_idx resolve_native_types(const external_call_info& call)
+        type_idx generate_pointer(type_idx underlying_type, size_t ptr_size)
         {
-            const type_idx return_type = resolve_native_type(call.return_type);
-            params.resize(call.parameters.size());
-            stackvar* dst = params.data();
-            for (auto& p : call.parameters)
+            for (const auto& it : generated)
             {
-                *dst++ = stackvar(resolve_native_type(p), p.offset);
+                if (it.generated.pointer.underlying_type == underlying_type) return it.index;
             }
 
-            make_key<stackvar>(return_type, params, keybuf);
-            auto find = data.signature_lookup.find(keybuf);
-            if (find == data.signature_lookup.end())
-            {
-                // New signature
-                const signature_idx sig_idx = signature_idx(data.signatures.size());
-                gen_signature signature(sig_idx, return_type, std::move(params));
-                signature.is_resolved = true;
-                signature.parameters_size = call.parameters_size;
-                data.signature_lookup.emplace(keybuf, sig_idx);
-                data.signatures.push_back(std::move(signature));
-                return sig_idx;
-            }
-            else
-            {
-                return find->second;
-            }
+            gen_type pointer_type = gen_type(name_idx::invalid, type_idx(types.size() + generated.size()));
+            pointer_type.flags = extended_flags::is_defined | extended_flags::is_resolved;
+            pointer_type.total_size = ptr_size;
+            pointer_type.alignment = ptr_size;
+            pointer_type.make_pointer(underlying_type);
+            generated.push_back(std::move(pointer_type));
+            return generated.back().index;
         }
-        type_idx resolve_native_type(const native::typedecl& native_type)
-        {
-            type_idx result_idx;
-
-            if (auto find = data.database.find(native_type.name))
-            {
-                // Existing type
-                ASSERT(find->lookup == lookup_type::type, "Invalid type");
 
-                result_idx = find->type;
+        const indexed_vector<type_idx, asm_type>& types;
+        vector<asm_type> generated;
+    };
 
-                if (!is_base_type(find->type))
-                {
-                    auto& type = data.types[result_idx];
+    // Method linker validates and recompiles the bytecode of a single method.
+    // The assembly is only read, so multiple method linkers can run concurrently.
+    // Pointer types that need to be generated are reported back to the
+    // assembly linker, which adds them after all methods have been resolved.
+    class method_linker final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(method_linker, const asm_assembly_data& data, type_idx size_type, type_idx offset_type, size_t ptr_size) :
+            types(data.types),
+            methods(data.methods),
+            signatures(data.signatures),
+            offsets(data.offsets),
+            globals(data.globals),
+            constants(data.constants),
+            database(data.database),
+            metatable(data.metatable),
+            size_type(size_type),
+            offset_type(offset_type),
+            ptr_size(ptr_size) {}
+
+        void resolve_method(asm_method& method, vector<type_idx>& generated_pointer_types)
+        {
+            VALIDATE_METHOD_DEFINITION(method.is_defined(), get_name(method));
 
-                    ASSERT(type.total_size == 0 || type.total_size == native_type.size, "Native type size mismatch");
+            // Stack variables
+            const asm_signature& method_signature = signatures[method.signature];
+            method.layout_stack(types, method_signature.parameters_size);
 
-                    // Natives are implicitly defined
-                    type.total_size = native_type.size;
-                    type.flags |= type_flags::is_external;
-                    type.flags |= extended_flags::is_defined;
-                }
-            }
-            else
+            // Recompile
+            max_return_value_size = 0;
+            if (!method.is_external())
             {
-                // New type
-                result_idx = type_idx(data.types.size());
-                const name_idx name = data.database.emplace(native_type.name, result_idx).key;
-                gen_type type(name, result_idx);
-                type.total_size = native_type.size;
-                type.flags |= type_flags::is_external;
-                type.flags |= extended_flags::is_defined;
-                data.types.push_back(std::move(type));
-            }
+                current_method = &method;
+                current_signature = &method_signature;
+                return_value = type_idx::voidtype;
 
-            // Create field offsets
-            {
-                auto& type = data.types[result_idx];
-                for (auto& field : native_type.fields)
+                if (!method.bytecode.empty())
                 {
-                    if (auto find_field_type = data.database.find(field.type))
-                    {
-                        ASSERT(find_field_type->lookup == lookup_type::type, "NYI");
+                    labels = method.labels;
+                    label_idx = 0;
 
-                        const auto find_field_name = data.database.find(field.name);
-                        const name_idx field_name = find_field_name ? find_field_name.key : data.database.emplace(field.name, lookup_idx::make_identifier()).key;
-                        type.fields.push_back(propane::field(field_name, find_field_type->type));
-                    }
-                    else
+                    uint8_t* const ibeg = method.bytecode.data();
+                    uint8_t* const iend = ibeg + method.bytecode.size();
+                    iptr = ibeg;
+                    iidx = 0;
+                    bool has_returned = false;
+                    while (true)
                     {
-                        VALIDATE_TYPE_DEFINITION(false, field.type);
-                    }
-                }
-            }
+                        ASSERT(iptr >= ibeg && iptr <= iend, "Instruction pointer out of range");
 
-            // Resolve pointers
-            for (size_t i = 0; i < native_type.pointer_depth; i++)
-            {
-                type_idx idx = data.types[result_idx].pointer_type;
-                if (idx == type_idx::invalid)
-                {
-                    // Create a new pointer for this type
-                    idx = type_idx(data.types.size());
-                    gen_type generate_type(name_idx::invalid, idx);
-                    generate_type.make_pointer(result_idx);
-                    generate_type.flags |= extended_flags::is_defined;
-                    data.types[result_idx].pointer_type = idx;
-                    data.types.push_back(std::move(generate_type));
-                }
-                result_idx = idx;
-            }
+                        const uint32_t offset = static_cast<uint32_t>(iptr - ibeg);
+                        while (label_idx < labels.size() && offset >= labels[label_idx])
+                        {
+                            // Ensure labels are at the correct location
+                            ASSERT(offset == labels[label_idx], "Invalid label offset");
+                            label_idx++;
+                            clear_return_value();
+                        }
 
-            return result_idx;
-        }
+                        if (iptr == iend)
+                        {
+                            if (!has_returned)
+                            {
+                                // Make sure that the method returns a value if expected
+                                ASSERT(!current_signature->has_return_value(), "Function expects a return value");
 
-        void resolve_type_recursive(asm_type& type)
-        {
-            if (!type.is_resolved())
-            {
-                VALIDATE_TYPE_RECURSIVE(!(type.flags & extended_flags::is_resolving), get_name(type));
-                type.flags |= extended_flags::is_resolving;
+                                // If method bytecode ends without a return, append one
+                                append_bytecode(current_method->bytecode, opcode::ret);
+                            }
 
-                VALIDATE_TYPE_DEFINITION(type.is_defined(), get_name(type));
+                            break;
+                        }
 
-                if (is_base_type(type.index))
-                {
-                    // Base type (build-in)
-                    type.total_size = get_base_type_size(type.index);
-                    type.flags |= extended_flags::is_resolved;
-                }
-                else if (type.is_generated())
-                {
-                    if (type.is_pointer())
-                    {
-                        // Pointer
-                        type.total_size = ptr_size;
-                    }
-                    else if (type.is_array())
-                    {
-                        // Array
-                        auto& underlying_type = types[type.generated.array.underlying_type];
-                        resolve_type_recursive(underlying_type);
-                        type.total_size = underlying_type.total_size * type.generated.array.array_size;
-                    }
-                    else if (type.is_signature())
-                    {
-                        // Signature
-                        type.total_size = ptr_size;
-                    }
-                    else
-                    {
-                        ASSERT(false, "Malformed type flag");
-                    }
-
-                    type.flags |= extended_flags::is_resolved;
-                }
-                else
-                {
-                    // User-defined types
-                    if (!type.fields.empty())
-                    {
-                        const auto current_size = type.total_size;
-                        type.total_size = 0;
-                        for (auto& field : type.fields)
-                        {
-                            auto& field_type = types[field.type];
-                            resolve_type_recursive(field_type);
-                            field.offset = type.is_union() ? 0 : type.total_size;
-                            type.total_size = type.is_union() ? std::max(type.total_size, field_type.total_size) : (type.total_size + field_type.total_size);
-                        }
-                        // Ensure that size matches native declaration
-                        ASSERT(current_size == 0 || current_size == type.total_size, "Native type size mismatch");
-                    }
-                    VALIDATE_TYPE_SIZE(type.total_size > 0, get_name(type), make_meta(type.index));
-                    type.flags |= extended_flags::is_resolved;
-                }
-            }
-
-            // Pointer types underlying size needs to be resolved after the underlying type
-            // knows its own size
-            if (type.pointer_type != type_idx::invalid)
-            {
-                auto& pointer_type = types[type.pointer_type];
-                pointer_type.generated.pointer.underlying_size = type.total_size;
-            }
-        }
-
-        void resolve_method(asm_method& method)
-        {
-            VALIDATE_METHOD_DEFINITION(method.is_defined(), get_name(method));
-
-            // Translate global indices
-            for (auto& g : method.globals)
-            {
-                const name_idx name = g.name;
-                auto find = database[name];
-                if (find->lookup == lookup_type::method)
-                {
-                    // Method addresses are generated on demand, we dont have to generate one for every method
-                    g.index = resolve_method_constant(methods[find->method]);
-                }
-                else
-                {
-                    VALIDATE_GLOBAL_DEFINITION(find->lookup == lookup_type::constant || find->lookup == lookup_type::global, find.name);
-                    g.index = global_idx(find->index);
-                    if (find->lookup == lookup_type::constant) g.index |= global_flags::constant_flag;
-                }
-            }
-
-            // Stack variables
-            asm_signature& method_signature = signatures[method.signature];
-            {
-                method.method_stack_size = method_signature.parameters_size;
-                size_t variable_stack_size = 0;
-                for (auto& sv : method.stackvars)
-                {
-                    sv.offset = variable_stack_size;
-                    variable_stack_size += types[sv.type].total_size;
-                }
-                method.method_stack_size += variable_stack_size;
-            }
-
-            // Recompile
-            max_return_value_size = 0;
-            if (!method.is_external())
-            {
-                current_method = &method;
-                current_signature = &method_signature;
-                return_value = type_idx::voidtype;
-
-                if (!method.bytecode.empty())
-                {
-                    labels = method.labels;
-                    label_idx = 0;
-
-                    uint8_t* const ibeg = method.bytecode.data();
-                    uint8_t* const iend = ibeg + method.bytecode.size();
-                    iptr = ibeg;
-                    iidx = 0;
-                    bool has_returned = false;
-                    while (true)
-                    {
-                        ASSERT(iptr >= ibeg && iptr <= iend, "Instruction pointer out of range");
-
-                        const uint32_t offset = static_cast<uint32_t>(iptr - ibeg);
-                        while (label_idx < labels.size() && offset >= labels[label_idx])
-                        {
-                            // Ensure labels are at the correct location
-                            ASSERT(offset == labels[label_idx], "Invalid label offset");
-                            label_idx++;
-                            clear_return_value();
-                        }
-
-                        if (iptr == iend)
-                        {
-                            if (!has_returned)
-                            {
-                                // Make sure that the method returns a value if expected
-                                ASSERT(!current_signature->has_return_value(), "Function expects a return value");
-
-                                // If method bytecode ends without a return, append one
-                                append_bytecode(current_method->bytecode, opcode::ret);
-                            }
-
-                            break;
-                        }
-
-                        has_returned = false;
+                        has_returned = false;
 
                         iidx++;
 
@@ -575,6 +406,20 @@ namespace propane
                             }
                             break;
 
+                            case opcode::sws:
+                            {
+                                const type_idx type = resolve_operand();
+                                VALIDATE_SWITCH_TYPE(is_integral(type), type);
+                                const uint32_t case_count = read_bytecode<uint32_t>(iptr);
+                                uint64_t* values = reinterpret_cast<uint64_t*>(iptr);
+                                uint32_t* labels = reinterpret_cast<uint32_t*>(iptr + sizeof(uint64_t) * case_count);
+                                resolve_switch_cases(type, values, labels, case_count);
+                                iptr += (sizeof(uint64_t) + sizeof(uint32_t)) * case_count;
+                                // Reset return value after branch
+                                clear_return_value();
+                            }
+                            break;
+
                             case opcode::call:
                             {
                                 // Translate method index
@@ -614,253 +459,1257 @@ namespace propane
                             }
                             break;
 
-                            case opcode::ret:
-                            {
-                                ASSERT(!current_signature->has_return_value(), "Function expects a return value");
-                                has_returned = true;
-                            }
-                            break;
+                            case opcode::ret:
+                            {
+                                ASSERT(!current_signature->has_return_value(), "Function expects a return value");
+                                has_returned = true;
+                            }
+                            break;
+
+                            case opcode::retv:
+                            {
+                                ASSERT(current_signature->has_return_value(), "Function does not return a value");
+                                has_returned = true;
+
+                                subcode& sub = read_subcode();
+                                const type_idx rhs = resolve_operand(current_signature->return_type);
+                                sub = resolve_set(current_signature->return_type, rhs);
+                            }
+                            break;
+
+                            case opcode::dump:
+                                resolve_operand();
+                                break;
+
+                            case opcode::vadd:
+                            case opcode::vsub:
+                            case opcode::vmul:
+                            case opcode::vdiv:
+                            case opcode::vmin:
+                            case opcode::vmax:
+                            case opcode::vceq:
+                            case opcode::vcne:
+                            case opcode::vcgt:
+                            case opcode::vcge:
+                            case opcode::vclt:
+                            case opcode::vcle:
+                            case opcode::vshf:
+                            {
+                                subcode& sub = read_subcode();
+                                const type_idx lhs = resolve_address();
+                                const type_idx rhs = resolve_address();
+                                sub = resolve_vector(current_op, lhs, rhs);
+                            }
+                            break;
+
+                            case opcode::mcpy:
+                            case opcode::mset:
+                            case opcode::mcmp:
+                            {
+                                subcode& sub = read_subcode();
+                                const type_idx lhs = resolve_address();
+                                const type_idx rhs = resolve_operand();
+                                const type_idx length = resolve_operand();
+                                sub = resolve_memory(current_op, lhs, rhs, length);
+                                if (current_op == opcode::mcmp)
+                                {
+                                    // Comparison return value
+                                    set_return_value(type_idx::i32);
+                                }
+                            }
+                            break;
+
+                            default: ASSERT(false, "Malformed opcode");
+                        }
+                    }
+                }
+                else
+                {
+                    ASSERT(!current_signature->has_return_value(), "Function expects a return value");
+
+                    append_bytecode(current_method->bytecode, opcode::ret);
+                }
+            }
+            method.total_stack_size = method.method_stack_size + align_size(max_return_value_size, stack_alignment);
+
+            // Clear lookup
+            method.calls.clear();
+            method.offsets.clear();
+            method.globals.clear();
+
+            // Report pointer types that have to be generated
+            for (const auto& it : types.generated) generated_pointer_types.push_back(it.generated.pointer.underlying_type);
+            types.generated.clear();
+        }
+
+        subcode& read_subcode()
+        {
+            return read_bytecode_ref<subcode>(iptr);
+        }
+        // Validate sparse switch case values against the switch type and sort them by key,
+        // so that the runtime can binary search or build a jump table over the cases
+        void resolve_switch_cases(type_idx type, uint64_t* values, uint32_t* labels, uint32_t case_count)
+        {
+            const size_t bits = get_base_type_size(type) * 8;
+            switch_cases.resize(case_count);
+            for (uint32_t i = 0; i < case_count; i++)
+            {
+                const uint64_t value = values[i];
+                if (bits < 64)
+                {
+                    // Value has to survive truncation to the switch type
+                    const uint64_t truncated = value & ((uint64_t(1) << bits) - 1);
+                    const uint64_t sign_bit = uint64_t(1) << (bits - 1);
+                    const uint64_t extended = is_unsigned(type) || !(truncated & sign_bit) ? truncated : (truncated | ~((uint64_t(1) << bits) - 1));
+                    VALIDATE_SWITCH_CASE_RANGE(extended == value, static_cast<int64_t>(value), type);
+                }
+                switch_cases[i] = std::make_pair(get_switch_key(type, value), labels[i]);
+            }
+            std::sort(switch_cases.begin(), switch_cases.end());
+            for (uint32_t i = 0; i < case_count; i++)
+            {
+                // The key mapping is its own inverse
+                const uint64_t value = get_switch_key(type, switch_cases[i].first);
+                if (i > 0)
+                {
+                    VALIDATE_SWITCH_CASE_UNIQUE(switch_cases[i].first != switch_cases[i - 1].first,
+                        is_unsigned(type) ? std::to_string(value) : std::to_string(static_cast<int64_t>(value)));
+                }
+                values[i] = value;
+                labels[i] = switch_cases[i].second;
+            }
+        }
+        vector<std::pair<uint64_t, uint32_t>> switch_cases;
+        type_idx resolve_address()
+        {
+            return resolve_address_type(type_idx::invalid);
+        }
+        type_idx resolve_operand(type_idx lhs = type_idx::voidtype)
+        {
+            return resolve_address_type(lhs);
+        }
+        type_idx resolve_address_type(type_idx lhs)
+        {
+            // lhs type of invalid indicates that this address is left-hand-side
+            // lhs type of voidtype indicates that this address is right-hand-side, but no expected type
+            // lhs type of any other type indicates that special casting rules can apply
+
+            type_idx last_type = type_idx::invalid;
+
+            const auto& minf = *current_method;
+            const auto& csig = *current_signature;
+
+            address_data_t& addr = *reinterpret_cast<address_data_t*>(iptr);
+
+            const uint32_t index = addr.header.index();
+            switch (addr.header.type())
+            {
+                case address_type::stackvar:
+                {
+                    if (index == address_header_constants::index_max)
+                    {
+                        VALIDATE_RETURN_ADDRESS(return_value != type_idx::voidtype);
+
+                        last_type = return_value;
+                    }
+                    else
+                    {
+                        ASSERT(index < minf.stackvars.size(), "Stack index out of range");
+
+                        last_type = minf.stackvars[index].type;
+                    }
+                }
+                break;
+
+                case address_type::parameter:
+                {
+                    ASSERT(index < csig.parameters.size(), "Parameter index out of range");
+
+                    last_type = csig.parameters[index].type;
+                }
+                break;
+
+                case address_type::global:
+                {
+                    // Translate global index
+                    addr.header.set_index((uint32_t)minf.globals[index].index);
+
+                    global_idx global = (global_idx)addr.header.index();
+
+                    const bool is_constant = is_constant_flag_set(global);
+                    const auto& table = is_constant ? constants : globals;
+                    global &= global_flags::constant_mask;
+
+                    ASSERT(table.info.is_valid_index(global), "Parameter index out of range");
+
+                    last_type = table.info[global].type;
+                }
+                break;
+
+                case address_type::constant:
+                {
+                    const type_idx btype_idx = type_idx(index);
+
+                    // All of these cases should have been caught by the parser already
+                    ASSERT(lhs != type_idx::invalid, "Constant cannot be a left-hand side operand");
+                    ASSERT(btype_idx <= type_idx::vptr, "Malformed constant opcode");
+                    ASSERT(addr.header.modifier() == address_modifier::none, "Cannot apply address modifier on a constant");
+                    ASSERT(addr.header.prefix() == address_prefix::none, "Cannot apply address prefix on a constant");
+
+                    iptr += (types[btype_idx].total_size + sizeof(address_header));
+
+                    // Cast to destination type if assigning null pointer
+                    if (types[lhs].is_pointer() && btype_idx == type_idx::vptr)
+                    {
+                        return lhs;
+                    }
+
+                    return btype_idx;
+                }
+                break;
+
+                default: ASSERT(false, "Malformed address header");
+            }
+
+            switch (addr.header.modifier())
+            {
+                case address_modifier::none: break;
+
+                case address_modifier::direct_field:
+                {
+                    // Translate field offset
+                    addr.field = minf.offsets[static_cast<size_t>(addr.field)];
+
+                    const auto& field = offsets[addr.field];
+
+                    const auto& type = types[last_type];
+                    VALIDATE_FIELD_DEREFERENCE(!type.is_pointer(), get_name(type));
+                    VALIDATE_FIELD_PARENT_TYPE(type.index == field.name.object_type, get_name(field.name.object_type), get_name(type));
+
+                    last_type = field.type;
+                }
+                break;
+
+                case address_modifier::indirect_field:
+                {
+                    // Translate field offset
+                    addr.field = minf.offsets[static_cast<size_t>(addr.field)];
+
+                    const auto& field = offsets[addr.field];
+
+                    const auto& type = types[last_type];
+                    VALIDATE_POINTER_DEREFERENCE(type.is_pointer(), get_name(type.index));
+                    const auto& underlying_type = types[type.generated.pointer.underlying_type];
+                    VALIDATE_FIELD_PARENT_TYPE(underlying_type.index == field.name.object_type, get_name(field.name.object_type), get_name(underlying_type));
+
+                    last_type = field.type;
+                }
+                break;
+
+                case address_modifier::offset:
+                {
+                    const auto& type = types[last_type];
+                    if (type.is_pointer())
+                    {
+                        last_type = type.generated.pointer.underlying_type;
+                    }
+                    else if (type.is_array())
+                    {
+                        last_type = type.generated.array.underlying_type;
+                        VALIDATE_ARRAY_INDEX(addr.offset >= 0 && static_cast<size_t>(addr.offset) < type.generated.array.array_size, addr.offset, get_name(type));
+                    }
+                    else
+                    {
+                        VALIDATE_OFFSET_MODIFIER(false, get_name(type));
+                    }
+                }
+                break;
+
+                default: ASSERT(false, "Malformed address header");
+            }
+
+            switch (addr.header.prefix())
+            {
+                case address_prefix::none: break;
+
+                case address_prefix::indirection:
+                {
+                    const auto& type = types[last_type];
+
+                    VALIDATE_POINTER_DEREFERENCE(type.is_pointer(), get_name(type));
+                    const auto& underlying_type = types[type.generated.pointer.underlying_type];
+                    VALIDATE_VOIDPOINTER_DEREFERENCE(underlying_type.index != type_idx::voidtype, get_name(type));
+
+                    last_type = type.generated.pointer.underlying_type;
+                }
+                break;
+
+                case address_prefix::address_of:
+                {
+                    const auto& type = types[last_type];
+
+                    if (type.pointer_type == type_idx::invalid)
+                    {
+                        // Generate missing pointer type
+                        // It is possible for generators to skip pointer types that
+                        // are never declared as stack variable, parameter, global or field
+                        last_type = types.generate_pointer(type.index, ptr_size);
+                    }
+                    else
+                    {
+                        last_type = type.pointer_type;
+                    }
+                }
+                break;
+
+                case address_prefix::size_of:
+                {
+                    last_type = size_type;
+                }
+                break;
+
+                default: ASSERT(false, "Malformed address header");
+            }
+
+            iptr += sizeof(address_data_t);
+
+            return last_type;
+        }
+
+        subcode resolve_set(type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            if (lhs_type.is_pointer())
+            {
+                // Ensure that both pointer types are equal or LHS is a voidpointer
+                VALIDATE_IMPLICIT_CONVERSION(lhs_type.index == rhs_type.index || (lhs_type.index == type_idx::vptr && rhs_type.is_pointer()), lhs_type.index, rhs_type.index);
+
+                lhs = rhs = size_type;
+            }
+            else if (lhs_type.is_signature())
+            {
+                VALIDATE_IMPLICIT_CONVERSION(lhs_type.index == rhs_type.index || rhs_type.index == type_idx::vptr, lhs_type.index, rhs_type.index);
+
+                lhs = rhs = size_type;
+            }
+            else if (lhs_type.is_arithmetic())
+            {
+                // Ensure that both types are arithmetic
+                VALIDATE_IMPLICIT_CONVERSION(rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
+            }
+            else if ((lhs_type.is_struct() || lhs_type.is_array()) && lhs_type.index == rhs_type.index)
+            {
+                // Copy data
+                return subcode(45);
+            }
+            else
+            {
+                VALIDATE_IMPLICIT_CONVERSION(false, lhs_type.index, rhs_type.index);
+            }
+
+            const subcode sub = translate::set(lhs, rhs);
+            VALIDATE_IMPLICIT_CONVERSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
+            return sub;
+        }
+        subcode resolve_conv(type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            if (lhs_type.is_pointer()) lhs = size_type;
+            if (rhs_type.is_pointer()) rhs = size_type;
+
+            // Ensure arithmetic (pointers are treated as size type)
+            VALIDATE_EXPLICIT_CONVERSION(is_arithmetic(lhs) && is_arithmetic(rhs) && lhs_type.index != rhs_type.index, lhs_type.index, rhs_type.index);
+
+            const subcode sub = translate::conv(lhs, rhs);
+            VALIDATE_EXPLICIT_CONVERSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
+            return sub;
+        }
+        subcode resolve_ari(opcode op, type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            // Ensure arithmetic
+            VALIDATE_ARITHMETIC_EXPRESSION(lhs_type.is_arithmetic() && rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
+
+            const subcode sub = translate::ari(op, lhs, rhs);
+            VALIDATE_ARITHMETIC_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
+            return sub;
+        }
+        subcode resolve_cmp(opcode op, type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            if (lhs_type.is_pointer())
+            {
+                // Pointer types must be equal for valid comparison
+                VALIDATE_COMPARISON_EXPRESSION(lhs_type.index == rhs_type.index, lhs_type.index, rhs_type.index);
+
+                lhs = rhs = size_type;
+            }
+            else
+            {
+                // Ensure arithmetic
+                VALIDATE_COMPARISON_EXPRESSION(lhs_type.is_arithmetic() && rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
+            }
+
+            const subcode sub = translate::cmp(op, lhs, rhs);
+            VALIDATE_COMPARISON_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
+            return sub;
+        }
+        subcode resolve_ptr(opcode op, type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            // Lhs must be a pointer, lhs cannot be a void pointer and rhs must be integral
+            VALIDATE_POINTER_EXPRESSION(lhs_type.is_pointer() && lhs_type.index != type_idx::vptr && rhs_type.is_integral(), lhs_type.index, rhs_type.index);
+
+            const subcode sub = translate::ptr(op, lhs, rhs);
+            VALIDATE_POINTER_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
+            return sub;
+        }
+        subcode resolve_vector(opcode op, type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            // Lhs must be a vector type
+            const size_t vector_type = lhs_type.is_array() ? get_vector_type(lhs_type.generated.array.underlying_type, lhs_type.generated.array.array_size) : vector_type_count;
+            VALIDATE_VECTOR_EXPRESSION(vector_type != vector_type_count, lhs_type.index, rhs_type.index);
+
+            if (op == opcode::vshf)
+            {
+                // Shuffle indices are integers of the same size as the elements
+                const type_idx element = lhs_type.generated.array.underlying_type;
+                VALIDATE_VECTOR_EXPRESSION(rhs_type.is_array() && rhs_type.generated.array.array_size == lhs_type.generated.array.array_size &&
+                    is_integral(rhs_type.generated.array.underlying_type) &&
+                    get_base_type_size(rhs_type.generated.array.underlying_type) == get_base_type_size(element), lhs_type.index, rhs_type.index);
+            }
+            else
+            {
+                VALIDATE_VECTOR_EXPRESSION(lhs_type.index == rhs_type.index, lhs_type.index, rhs_type.index);
+            }
+
+            return subcode(vector_type);
+        }
+        subcode resolve_memory(opcode op, type_idx lhs, type_idx rhs, type_idx length) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            // Lhs must be a pointer and the length must be integral. The fill value of mset must be integral,
+            // the rhs of mcpy and mcmp must be a pointer of the same type (or either must be a void pointer)
+            const bool is_valid_rhs = op == opcode::mset ? rhs_type.is_integral() :
+                (rhs_type.is_pointer() && (lhs == rhs || lhs == type_idx::vptr || rhs == type_idx::vptr));
+            VALIDATE_MEMORY_EXPRESSION(lhs_type.is_pointer() && is_valid_rhs, lhs, rhs);
+            VALIDATE_MEMORY_LENGTH_TYPE(is_integral(length), length);
+
+            return make_memory_subcode(length, op == opcode::mset ? rhs : type_idx::i8);
+        }
+        void resolve_pdif(type_idx lhs, type_idx rhs) const
+        {
+            const auto& lhs_type = types[lhs];
+            const auto& rhs_type = types[rhs];
+
+            // Lhs must be a pointer, lhs cannot be a void pointer and rhs must be integral
+            VALIDATE_PTR_OFFSET_EXPRESSION(lhs_type.is_pointer() && lhs_type.index != type_idx::vptr && lhs_type.index == rhs_type.index, lhs_type.index, rhs_type.index);
+        }
+
+        inline file_meta make_meta(method_idx method) const noexcept
+        {
+            const auto& meta = methods[method].meta;
+            return file_meta(metatable[meta.index].name, meta.line_number);
+        }
+
+        // Name helper functions
+        inline string_view get_name(name_idx name) const
+        {
+            ASSERT(database.is_valid_index(name), "Name index out of range");
+            return database[name].name;
+        }
+        inline string_view get_name(type_idx type) const
+        {
+            size_t& index = const_cast<size_t&>(generated_name_index);
+            string& buffer = const_cast<string*>(generated_name_buffers)[index];
+            name_generator(type, buffer, types, signatures, database);
+            index = (index + 1) & 1;
+            return buffer;
+        }
+        inline string_view get_name(const asm_type& type) const
+        {
+            return get_name(type.index);
+        }
+        inline string_view get_name(method_idx method) const
+        {
+            const name_idx name = methods[method].name;
+            ASSERT(database.is_valid_index(name), "Name index out of range");
+            return database[name].name;
+        }
+        inline string_view get_name(const asm_method& method) const
+        {
+            return get_name(method.name);
+        }
+
+
+
+
+        method_type_list types;
+        const indexed_vector<method_idx, asm_method>& methods;
+        const indexed_vector<signature_idx, asm_signature>& signatures;
+        const indexed_vector<offset_idx, asm_field_offset>& offsets;
+        const asm_data_table& globals;
+        const asm_data_table& constants;
+        const asm_database& database;
+        const asm_metatable& metatable;
+
+        const type_idx size_type;
+        const type_idx offset_type;
+        const size_t ptr_size;
+
+        asm_method* current_method = nullptr;
+        const asm_signature* current_signature = nullptr;
+        inline void set_return_value(type_idx type)
+        {
+            const size_t size = types[type].total_size;
+            if (size > max_return_value_size) max_return_value_size = size;
+            return_value = type;
+        }
+        inline void clear_return_value()
+        {
+            return_value = type_idx::voidtype;
+        }
+        type_idx return_value = type_idx::invalid;
+        size_t max_return_value_size = 0;
+        uint8_t* iptr = nullptr;
+        uint32_t iidx = 0;
+        opcode current_op = opcode::noop;
+
+        vector<uint32_t> labels;
+        uint32_t label_idx = 0;
+
+
+        string generated_name_buffers[2];
+        size_t generated_name_index = 0;
+    };
+
+    // Assembly linker takes in an intermediate that has been merged
+    // and links up the references. It recompiles the bytecode and replaces
+    // the lookup indices with the actual type/method indices
+    class assembly_linker final : public asm_assembly_data
+    {
+    public:
+        assembly_linker(gen_intermediate_data&& im_data, const runtime& runtime, const link_parameters& parameters, link_cache_data* cache, const link_profile_data* profile) :
+            data(std::move(im_data)),
+            profile((profile && !profile->methods.empty()) ? profile : nullptr),
+            size_type(derive_type_index_v<size_t>),
+            offset_type(derive_type_index_v<offset_t>),
+            ptr_size(get_base_type_size(type_idx::vptr))
+        {
+            data.restore_generated_types();
+
+            // Setup runtime
+            auto& rt_data = runtime.self();
+            if (!rt_data.call_lookup.empty())
+            {
+                keybuf.reserve(32);
+
+                // Missing symbols get reported here instead of during execution
+                if (parameters.resolve_symbols) rt_data.resolve_symbols();
+
+                for (auto& it : data.methods)
+                {
+                    if (it.is_defined()) continue;
+
+                    const string_view method_name = data.database[it.name].name;
+                    auto find_external = rt_data.call_lookup.find(method_name);
+                    VALIDATE_METHOD_DEFINITION(find_external != nullptr, method_name);
+
+                    // Create signature
+                    auto cidx = *find_external;
+                    const external_call_info& call = rt_data.get_call(cidx);
+                    if (parameters.resolve_symbols) VALIDATE_EXTERNAL_SYMBOL(call.handle != nullptr, method_name, rt_data.libraries[cidx.library].name);
+                    const signature_idx sig_idx = resolve_native_types(call);
+
+                    // Create method
+                    gen_method method(it.name, it.index);
+                    method.signature = sig_idx;
+                    append_bytecode(method.bytecode, cidx);
+                    method.flags |= (extended_flags::is_defined | type_flags::is_external);
+                    it = std::move(method);
+                }
+            }
+
+            // Resolve any missing types
+            vector<string_view> unresolved_external_types;
+            for (auto& it : data.types)
+            {
+                if (it.is_defined()) continue;
+
+                unresolved_external_types.push_back(data.database[it.name].name);
+            }
+            for (auto& it : unresolved_external_types)
+            {
+                auto find_external = rt_data.type_lookup.find(it);
+                VALIDATE_TYPE_DEFINITION(find_external != nullptr, it);
+
+                resolve_native_type(*find_external);
+            }
+
+            // Set hash
+            runtime_hash = rt_data.hash;
+
+            // Move over objects
+            for (auto& t : data.types) types.push_back(std::move(t));
+            for (auto& m : data.methods) methods.push_back(std::move(m));
+            for (auto& s : data.signatures) signatures.push_back(std::move(s));
+            for (auto& o : data.offsets) offsets.push_back(std::move(o));
+
+            // Move over data
+            globals = std::move(data.globals);
+            constants = std::move(data.constants);
+            database = std::move(data.database);
+            metatable = std::move(data.metatable);
+
+            // Resolve types, methods and signatures
+            for (auto& t : types) if (!t.is_resolved()) resolve_type_recursive(t);
+            for (auto& s : signatures) if (!s.is_resolved) resolve_signature(s);
+            // Resolve offsets
+            resolve_offsets();
+            // Resolve methods (after everything else)
+            resolve_methods(parameters, cache);
+            if (this->profile) order_methods();
+
+            // Link constants
+            initialize_data_table(constants, true);
+            initialize_data_table(globals, false);
+
+            // Find main
+            find_main();
+        }
+
+        vector<uint8_t> keybuf;
+        vector<stackvar> params;
+
+        signature_idx resolve_native_types(const external_call_info& call)
+        {
+            const type_idx return_type = resolve_native_type(call.return_type);
+            params.resize(call.parameters.size());
+            stackvar* dst = params.data();
+            for (auto& p : call.parameters)
+            {
+                *dst++ = stackvar(resolve_native_type(p), p.offset);
+            }
+
+            make_key<stackvar>(return_type, params, keybuf);
+            auto find = data.signature_lookup.find(keybuf);
+            if (!find)
+            {
+                // New signature
+                const signature_idx sig_idx = signature_idx(data.signatures.size());
+                gen_signature signature(sig_idx, return_type, std::move(params));
+                signature.is_resolved = true;
+                signature.parameters_size = call.parameters_size;
+                data.signature_lookup.emplace(keybuf, sig_idx);
+                data.signatures.push_back(std::move(signature));
+                return sig_idx;
+            }
+            else
+            {
+                return *find;
+            }
+        }
+        type_idx resolve_native_type(const native::typedecl& native_type)
+        {
+            type_idx result_idx;
+
+            if (auto find = data.database.find(native_type.name))
+            {
+                // Existing type
+                ASSERT(find->lookup == lookup_type::type, "Invalid type");
 
-                            case opcode::retv:
-                            {
-                                ASSERT(current_signature->has_return_value(), "Function does not return a value");
-                                has_returned = true;
+                result_idx = find->type;
 
-                                subcode& sub = read_subcode();
-                                const type_idx rhs = resolve_operand(current_signature->return_type);
-                                sub = resolve_set(current_signature->return_type, rhs);
-                            }
-                            break;
+                if (!is_base_type(find->type))
+                {
+                    auto& type = data.types[result_idx];
 
-                            case opcode::dump:
-                                resolve_operand();
-                                break;
+                    ASSERT(type.total_size == 0 || type.total_size == native_type.size, "Native type size mismatch");
 
-                            default: ASSERT(false, "Malformed opcode");
-                        }
-                    }
+                    // Natives are implicitly defined
+                    type.total_size = native_type.size;
+                    type.flags |= type_flags::is_external;
+                    type.flags |= extended_flags::is_defined;
                 }
-                else
+            }
+            else
+            {
+                // New type
+                result_idx = type_idx(data.types.size());
+                const name_idx name = data.database.emplace(native_type.name, result_idx).key;
+                gen_type type(name, result_idx);
+                type.total_size = native_type.size;
+                type.flags |= type_flags::is_external;
+                type.flags |= extended_flags::is_defined;
+                data.types.push_back(std::move(type));
+            }
+
+            // Create field offsets
+            {
+                auto& type = data.types[result_idx];
+                for (auto& field : native_type.fields)
                 {
-                    ASSERT(!current_signature->has_return_value(), "Function expects a return value");
+                    if (auto find_field_type = data.database.find(field.type))
+                    {
+                        ASSERT(find_field_type->lookup == lookup_type::type, "NYI");
 
-                    append_bytecode(current_method->bytecode, opcode::ret);
+                        const auto find_field_name = data.database.find(field.name);
+                        const name_idx field_name = find_field_name ? find_field_name.key : data.database.emplace(field.name, lookup_idx::make_identifier()).key;
+                        type.fields.push_back(propane::field(field_name, find_field_type->type, field.offset));
+                    }
+                    else
+                    {
+                        VALIDATE_TYPE_DEFINITION(false, field.type);
+                    }
                 }
             }
-            method.total_stack_size = method.method_stack_size + max_return_value_size;
 
-            // Clear lookup
-            method.calls.clear();
-            method.offsets.clear();
-            method.globals.clear();
+            // Resolve pointers
+            for (size_t i = 0; i < native_type.pointer_depth; i++)
+            {
+                type_idx idx = data.types[result_idx].pointer_type;
+                if (idx == type_idx::invalid)
+                {
+                    // Create a new pointer for this type
+                    idx = type_idx(data.types.size());
+                    gen_type generate_type(name_idx::invalid, idx);
+                    generate_type.make_pointer(result_idx);
+                    generate_type.flags |= extended_flags::is_defined;
+                    data.types[result_idx].pointer_type = idx;
+                    data.types.push_back(std::move(generate_type));
+                }
+                result_idx = idx;
+            }
 
-            method.flags |= extended_flags::is_resolved;
+            return result_idx;
         }
 
-        subcode& read_subcode()
-        {
-            return read_bytecode_ref<subcode>(iptr);
-        }
-        type_idx resolve_address()
-        {
-            return resolve_address_type(type_idx::invalid);
-        }
-        type_idx resolve_operand(type_idx lhs = type_idx::voidtype)
-        {
-            return resolve_address_type(lhs);
-        }
-        type_idx resolve_address_type(type_idx lhs)
+        void resolve_type_recursive(asm_type& type)
         {
-            // lhs type of invalid indicates that this address is left-hand-side
-            // lhs type of voidtype indicates that this address is right-hand-side, but no expected type
-            // lhs type of any other type indicates that special casting rules can apply
-
-            type_idx last_type = type_idx::invalid;
-
-            const auto& minf = *current_method;
-            const auto& csig = *current_signature;
+            if (!type.is_resolved())
+            {
+                VALIDATE_TYPE_RECURSIVE(!(type.flags & extended_flags::is_resolving), get_name(type));
+                type.flags |= extended_flags::is_resolving;
 
-            address_data_t& addr = *reinterpret_cast<address_data_t*>(iptr);
+                VALIDATE_TYPE_DEFINITION(type.is_defined(), get_name(type));
 
-            const uint32_t index = addr.header.index();
-            switch (addr.header.type())
-            {
-                case address_type::stackvar:
+                if (is_base_type(type.index))
                 {
-                    if (index == address_header_constants::index_max)
+                    // Base type (build-in)
+                    type.total_size = get_base_type_size(type.index);
+                    type.alignment = get_base_type_alignment(type.index);
+                    type.flags |= extended_flags::is_resolved;
+                }
+                else if (type.is_generated())
+                {
+                    if (type.is_pointer())
                     {
-                        VALIDATE_RETURN_ADDRESS(return_value != type_idx::voidtype);
-
-                        last_type = return_value;
+                        // Pointer
+                        type.total_size = ptr_size;
+                        type.alignment = ptr_size;
+                    }
+                    else if (type.is_array())
+                    {
+                        // Array
+                        auto& underlying_type = types[type.generated.array.underlying_type];
+                        resolve_type_recursive(underlying_type);
+                        type.total_size = underlying_type.total_size * type.generated.array.array_size;
+                        type.alignment = underlying_type.alignment;
+                    }
+                    else if (type.is_signature())
+                    {
+                        // Signature
+                        type.total_size = ptr_size;
+                        type.alignment = ptr_size;
                     }
                     else
                     {
-                        ASSERT(index < minf.stackvars.size(), "Stack index out of range");
+                        ASSERT(false, "Malformed type flag");
+                    }
 
-                        last_type = minf.stackvars[index].type;
+                    type.flags |= extended_flags::is_resolved;
+                }
+                else
+                {
+                    // User-defined types
+                    if (!type.fields.empty())
+                    {
+                        // Fields are placed at their natural alignment, unless the type is packed
+                        const auto current_size = type.total_size;
+                        type.total_size = 0;
+                        type.alignment = 1;
+                        for (auto& field : type.fields)
+                        {
+                            auto& field_type = types[field.type];
+                            resolve_type_recursive(field_type);
+                            const size_t field_alignment = type.is_packed() ? 1 : size_t(field_type.alignment);
+                            const size_t field_offset = type.is_union() ? 0 : align_size(type.total_size, field_alignment);
+                            // Ensure that offsets match native declaration
+                            ASSERT(!type.is_external() || field.offset == field_offset, "Native field offset mismatch");
+                            field.offset = field_offset;
+                            type.total_size = std::max(size_t(type.total_size), field_offset + field_type.total_size);
+                            type.alignment = std::max(size_t(type.alignment), field_alignment);
+                        }
+                        type.total_size = align_size(type.total_size, type.alignment);
+                        // Ensure that size matches native declaration
+                        ASSERT(current_size == 0 || current_size == type.total_size, "Native type size mismatch");
                     }
+                    VALIDATE_TYPE_SIZE(type.total_size > 0, get_name(type), make_meta(type.index));
+                    type.flags |= extended_flags::is_resolved;
                 }
-                break;
+            }
 
-                case address_type::parameter:
-                {
-                    ASSERT(index < csig.parameters.size(), "Parameter index out of range");
+            // Pointer types underlying size needs to be resolved after the underlying type
+            // knows its own size
+            if (type.pointer_type != type_idx::invalid)
+            {
+                auto& pointer_type = types[type.pointer_type];
+                pointer_type.generated.pointer.underlying_size = type.total_size;
+            }
+        }
 
-                    last_type = csig.parameters[index].type;
-                }
-                break;
+        void resolve_method_globals(asm_method& method)
+        {
+            VALIDATE_METHOD_DEFINITION(method.is_defined(), get_name(method));
 
-                case address_type::global:
+            // Translate global indices
+            for (auto& g : method.globals)
+            {
+                const name_idx name = g.name;
+                auto find = database[name];
+                if (find->lookup == lookup_type::method)
                 {
-                    // Translate global index
-                    addr.header.set_index((uint32_t)minf.globals[index].index);
+                    // Method addresses are generated on demand, we dont have to generate one for every method
+                    g.index = resolve_method_constant(methods[find->method]);
+                }
+                else
+                {
+                    VALIDATE_GLOBAL_DEFINITION(find->lookup == lookup_type::constant || find->lookup == lookup_type::global, find.name);
+                    g.index = global_idx(find->index);
+                    if (find->lookup == lookup_type::constant) g.index |= global_flags::constant_flag;
+                }
+            }
+        }
+        void resolve_methods(const link_parameters& parameters, link_cache_data* cache)
+        {
+            // Method constants modify the assembly, so these are resolved up front
+            for (auto& m : methods) if (!m.is_resolved()) resolve_method_globals(m);
 
-                    global_idx global = (global_idx)addr.header.index();
+            const bool inline_methods = parameters.optimize && parameters.inline_size_limit > 0 && parameters.inline_depth_limit > 0;
 
-                    const bool is_constant = is_constant_flag_set(global);
-                    const auto& table = is_constant ? constants : globals;
-                    global &= global_flags::constant_mask;
+            // Reuse methods that are unchanged since the previous link
+            vector<vector<uint8_t>> cache_keys;
+            vector<vector<type_idx>> generated_pointer_types(methods.size());
+            vector<const link_cache_entry*> reused_entries(methods.size(), nullptr);
+            if (cache)
+            {
+                cache->generation++;
+                cache->reused_count = 0;
+                cache->relinked_count = 0;
 
-                    ASSERT(table.info.is_valid_index(global), "Parameter index out of range");
+                make_type_fingerprints();
+                cache_keys.resize(methods.size());
+                for (auto& m : methods)
+                {
+                    if (m.is_resolved()) continue;
 
-                    last_type = table.info[global].type;
+                    make_method_key(m, parameters, cache_keys[static_cast<size_t>(m.index)]);
                 }
-                break;
+                if (inline_methods) append_inline_keys(parameters, cache_keys);
 
-                case address_type::constant:
+                for (auto& m : methods)
                 {
-                    const type_idx btype_idx = type_idx(index);
+                    auto& key = cache_keys[static_cast<size_t>(m.index)];
+                    if (key.empty()) continue;
 
-                    // All of these cases should have been caught by the parser already
-                    ASSERT(lhs != type_idx::invalid, "Constant cannot be a left-hand side operand");
-                    ASSERT(btype_idx <= type_idx::vptr, "Malformed constant opcode");
-                    ASSERT(addr.header.modifier() == address_modifier::none, "Cannot apply address modifier on a constant");
-                    ASSERT(addr.header.prefix() == address_prefix::none, "Cannot apply address prefix on a constant");
+                    auto find = cache->entries.find(key);
+                    if (find != cache->entries.end())
+                    {
+                        auto& entry = find->second;
+                        ASSERT(entry.stackvars.size() >= m.stackvars.size(), "Link cache entry mismatch");
+
+                        m.bytecode = entry.bytecode;
+                        m.labels = entry.labels;
+                        m.stackvars = entry.stackvars;
+                        m.method_stack_size = entry.method_stack_size;
+                        m.total_stack_size = entry.total_stack_size;
+                        m.calls.clear();
+                        m.offsets.clear();
+                        m.globals.clear();
+                        m.flags |= extended_flags::is_resolved;
+                        generated_pointer_types[static_cast<size_t>(m.index)] = entry.generated_pointer_types;
+                        reused_entries[static_cast<size_t>(m.index)] = &entry;
+
+                        entry.generation = cache->generation;
+                        cache->reused_count++;
+                        key.clear();
+                    }
+                }
+            }
 
-                    iptr += (types[btype_idx].total_size + sizeof(address_header));
+            // Recompile methods, distributed over the available threads
+            constexpr size_t min_methods_per_thread = 64;
+            const size_t thread_count = resolve_thread_count(parameters.thread_count, std::max<size_t>(methods.size() / min_methods_per_thread, 1));
 
-                    // Cast to destination type if assigning null pointer
-                    if (types[lhs].is_pointer() && btype_idx == type_idx::vptr)
+            vector<std::exception_ptr> errors(methods.size());
+            std::atomic<size_t> first_error = methods.size();
+            vector<uint8_t> relinked(methods.size(), 0);
+            parallel_for(methods.size(), thread_count, [&](size_t idx)
+            {
+                // Methods after a failed method can be skipped, the error
+                // of the first failed method is reported (same as a serial link)
+                if (idx > first_error) return;
+
+                auto& m = methods[method_idx(idx)];
+                if (m.is_resolved()) return;
+
+                try
+                {
+                    method_linker(*this, size_type, offset_type, ptr_size).resolve_method(m, generated_pointer_types[idx]);
+                    if (parameters.optimize) optimize_method(*this, m);
+                    relinked[idx] = 1;
+                }
+                catch (...)
+                {
+                    errors[idx] = std::current_exception();
+                    size_t current = first_error;
+                    while (idx < current && !first_error.compare_exchange_weak(current, idx));
+                }
+            });
+            if (first_error < methods.size())
+            {
+                std::rethrow_exception(errors[first_error]);
+            }
+
+            // Small methods are inlined into their callers. Inlining uses the bytecode of the methods
+            // before anything was inlined into them, which is stored in the cache for reused methods.
+            vector<asm_method> inline_sources;
+            if (inline_methods)
+            {
+                for (const auto& m : methods)
+                {
+                    const size_t idx = static_cast<size_t>(m.index);
+                    if (relinked[idx])
                     {
-                        return lhs;
+                        if (m.bytecode.size() > parameters.inline_size_limit) continue;
+
+                        asm_method& source = inline_sources.emplace_back();
+                        source.index = m.index;
+                        source.flags = m.flags;
+                        source.signature = m.signature;
+                        source.bytecode = m.bytecode;
+                        source.stackvars = m.stackvars;
+                        source.method_stack_size = m.method_stack_size;
+                        source.total_stack_size = m.total_stack_size;
+                    }
+                    else if (const link_cache_entry* entry = reused_entries[idx])
+                    {
+                        if (entry->inline_bytecode.empty()) continue;
+
+                        asm_method& source = inline_sources.emplace_back();
+                        source.index = m.index;
+                        source.flags = m.flags;
+                        source.signature = m.signature;
+                        source.bytecode = entry->inline_bytecode;
+                        source.stackvars = entry->inline_stackvars;
+                        source.method_stack_size = entry->inline_method_stack_size;
+                        source.total_stack_size = entry->inline_total_stack_size;
                     }
+                }
+            }
 
-                    return btype_idx;
+            if (!inline_sources.empty() || profile)
+            {
+                const inline_table table(*this, inline_sources);
+                parallel_for(methods.size(), thread_count, [&](size_t idx)
+                {
+                    if (idx > first_error || !relinked[idx]) return;
+
+                    auto& m = methods[method_idx(idx)];
+                    try
+                    {
+                        if (!inline_sources.empty()) inline_calls(*this, m, table, parameters.inline_depth_limit);
+                        if (profile)
+                        {
+                            const profile_method* counts = profile->find(get_name(m), m.bytecode.size(), m.labels.data(), m.labels.size());
+                            if (counts) layout_method(*this, m, *counts);
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[idx] = std::current_exception();
+                        size_t current = first_error;
+                        while (idx < current && !first_error.compare_exchange_weak(current, idx));
+                    }
+                });
+                if (first_error < methods.size())
+                {
+                    std::rethrow_exception(errors[first_error]);
                 }
-                break;
-
-                default: ASSERT(false, "Malformed address header");
             }
 
-            switch (addr.header.modifier())
+            // Store relinked methods and drop methods that are no longer in use
+            if (cache)
             {
-                case address_modifier::none: break;
+                vector<asm_method*> snapshots(methods.size(), nullptr);
+                for (auto& source : inline_sources) snapshots[static_cast<size_t>(source.index)] = &source;
 
-                case address_modifier::direct_field:
+                for (auto& m : methods)
                 {
-                    // Translate field offset
-                    addr.field = minf.offsets[static_cast<size_t>(addr.field)];
-
-                    const auto& field = offsets[addr.field];
-
-                    const auto& type = types[last_type];
-                    VALIDATE_FIELD_DEREFERENCE(!type.is_pointer(), get_name(type));
-                    VALIDATE_FIELD_PARENT_TYPE(type.index == field.name.object_type, get_name(field.name.object_type), get_name(type));
+                    auto& key = cache_keys[static_cast<size_t>(m.index)];
+                    if (key.empty()) continue;
+
+                    link_cache_entry entry;
+                    entry.bytecode = m.bytecode;
+                    entry.labels = m.labels;
+                    entry.stackvars = m.stackvars;
+                    entry.method_stack_size = m.method_stack_size;
+                    entry.total_stack_size = m.total_stack_size;
+                    entry.generated_pointer_types = generated_pointer_types[static_cast<size_t>(m.index)];
+                    if (asm_method* source = snapshots[static_cast<size_t>(m.index)])
+                    {
+                        entry.inline_bytecode = std::move(source->bytecode);
+                        entry.inline_stackvars = std::move(source->stackvars);
+                        entry.inline_method_stack_size = source->method_stack_size;
+                        entry.inline_total_stack_size = source->total_stack_size;
+                    }
+                    entry.generation = cache->generation;
+                    cache->entries[std::move(key)] = std::move(entry);
+                    cache->relinked_count++;
+                }
+                for (auto it = cache->entries.begin(); it != cache->entries.end();)
+                {
+                    if (it->second.generation != cache->generation) it = cache->entries.erase(it);
+                    else ++it;
+                }
+            }
 
-                    last_type = field.type;
+            // Generate missing pointer types in method order, so the result
+            // does not depend on the amount of threads
+            for (size_t i = 0; i < methods.size(); i++)
+            {
+                for (const type_idx underlying_type : generated_pointer_types[i])
+                {
+                    auto& type = types[underlying_type];
+                    if (type.pointer_type != type_idx::invalid) continue;
+
+                    gen_type pointer_type = gen_type(name_idx::invalid, type_idx(types.size()));
+                    pointer_type.flags = extended_flags::is_defined | extended_flags::is_resolved;
+                    pointer_type.total_size = ptr_size;
+                    pointer_type.alignment = ptr_size;
+                    pointer_type.make_pointer(type.index);
+                    type.pointer_type = pointer_type.index;
+                    types.push_back(std::move(pointer_type));
                 }
-                break;
+            }
 
-                case address_modifier::indirect_field:
+            // Compaction is applied last, so the link cache and the inline
+            // sources retain the standard encoding
+            const auto bytecode_size = [this]()
+            {
+                size_t size = 0;
+                for (const auto& m : methods)
                 {
-                    // Translate field offset
-                    addr.field = minf.offsets[static_cast<size_t>(addr.field)];
+                    if (!m.is_external()) size += m.bytecode.size();
+                }
+                return size;
+            };
+            const size_t standard_bytecode_size = bytecode_size();
+            if (parameters.compact_bytecode)
+            {
+                parallel_for(methods.size(), thread_count, [&](size_t idx)
+                {
+                    compact_method(*this, methods[method_idx(idx)]);
+                });
+                encoding = bytecode_encoding::compact;
+            }
+            if (parameters.statistics)
+            {
+                parameters.statistics->standard_bytecode_size = standard_bytecode_size;
+                parameters.statistics->bytecode_size = parameters.compact_bytecode ? bytecode_size() : standard_bytecode_size;
+            }
 
-                    const auto& field = offsets[addr.field];
+            for (auto& m : methods) m.flags |= extended_flags::is_resolved;
+        }
 
-                    const auto& type = types[last_type];
-                    VALIDATE_POINTER_DEREFERENCE(type.is_pointer(), get_name(type.index));
-                    const auto& underlying_type = types[type.generated.pointer.underlying_type];
-                    VALIDATE_FIELD_PARENT_TYPE(underlying_type.index == field.name.object_type, get_name(field.name.object_type), get_name(underlying_type));
+        // Order methods from hot to cold by the amount of instructions they executed.
+        // Counts of methods that changed since the profile was collected are still used here,
+        // methods that were not executed keep their relative order.
+        void order_methods()
+        {
+            vector<uint64_t> counts(methods.size(), 0);
+            for (const auto& m : methods)
+            {
+                if (const profile_method* find = profile->find(get_name(m))) counts[static_cast<size_t>(m.index)] = find->total;
+            }
 
-                    last_type = field.type;
-                }
-                break;
+            method_order.resize(methods.size());
+            for (size_t i = 0; i < methods.size(); i++) method_order[i] = method_idx(i);
+            std::stable_sort(method_order.begin(), method_order.end(), [&counts](method_idx lhs, method_idx rhs)
+            {
+                return counts[static_cast<size_t>(lhs)] > counts[static_cast<size_t>(rhs)];
+            });
+        }
 
-                case address_modifier::offset:
+        // Link cache keys contain the bytecode of a method and everything its
+        // resolved bytecode depends on: the fingerprints of referenced types and
+        // signatures, and the resolved indices of calls, globals and offsets.
+        // Type fingerprints cover the type itself and the types that can be
+        // reached through address modifiers and prefixes.
+        void make_type_fingerprints()
+        {
+            constexpr size_t fingerprint_depth = 3;
+
+            vector<size_t> prev(types.size());
+            type_fingerprints.resize(types.size());
+            for (size_t depth = 0; depth <= fingerprint_depth; depth++)
+            {
+                std::swap(prev, type_fingerprints);
+                for (const auto& t : types)
                 {
-                    const auto& type = types[last_type];
-                    if (type.is_pointer())
+                    size_t hash = fnv::hash(t.index);
+                    hash = fnv::append(hash, t.flags);
+                    hash = fnv::append(hash, t.total_size);
+                    hash = fnv::append(hash, t.pointer_type);
+                    if (t.is_pointer())
                     {
-                        last_type = type.generated.pointer.underlying_type;
+                        hash = fnv::append(hash, t.generated.pointer.underlying_type);
+                        if (depth > 0) hash = fnv::append(hash, prev[static_cast<size_t>(t.generated.pointer.underlying_type)]);
                     }
-                    else if (type.is_array())
+                    else if (t.is_array())
                     {
-                        last_type = type.generated.array.underlying_type;
-                        VALIDATE_ARRAY_INDEX(addr.offset >= 0 && static_cast<size_t>(addr.offset) < type.generated.array.array_size, addr.offset, get_name(type));
+                        hash = fnv::append(hash, t.generated.array.underlying_type);
+                        hash = fnv::append(hash, t.generated.array.array_size);
+                        if (depth > 0) hash = fnv::append(hash, prev[static_cast<size_t>(t.generated.array.underlying_type)]);
                     }
-                    else
+                    else if (t.is_signature())
                     {
-                        VALIDATE_OFFSET_MODIFIER(false, get_name(type));
+                        hash = fnv::append(hash, t.generated.signature.index);
+                        if (depth > 0) hash = append_signature_fingerprint(hash, signatures[t.generated.signature.index], prev);
+                    }
+                    if (depth > 0 && t.pointer_type != type_idx::invalid)
+                    {
+                        hash = fnv::append(hash, prev[static_cast<size_t>(t.pointer_type)]);
                     }
+                    type_fingerprints[static_cast<size_t>(t.index)] = hash;
                 }
-                break;
-
-                default: ASSERT(false, "Malformed address header");
             }
-
-            switch (addr.header.prefix())
+        }
+        size_t append_signature_fingerprint(size_t hash, const asm_signature& signature, const vector<size_t>& fingerprints) const
+        {
+            hash = fnv::append(hash, signature.index);
+            hash = fnv::append(hash, fingerprints[static_cast<size_t>(signature.return_type)]);
+            for (const auto& p : signature.parameters)
             {
-                case address_prefix::none: break;
-
-                case address_prefix::indirection:
+                hash = fnv::append(hash, fingerprints[static_cast<size_t>(p.type)]);
+                hash = fnv::append(hash, p.offset);
+            }
+            return fnv::append(hash, signature.parameters_size);
+        }
+        void make_method_key(const asm_method& method, const link_parameters& parameters, vector<uint8_t>& key) const
+        {
+            key.clear();
+            append_bytecode(key, runtime_hash);
+            append_bytecode(key, parameters.optimize);
+            append_bytecode(key, method.index);
+            // Methods are laid out by the counts of the profile
+            if (const profile_method* counts = profile ? profile->find(get_name(method)) : nullptr)
+            {
+                append_bytecode(key, counts->fingerprint);
+                append_bytecode(key, counts->calls);
+                append_bytecode(key, counts->instructions.size());
+                for (const auto& it : counts->instructions)
                 {
-                    const auto& type = types[last_type];
+                    append_bytecode(key, it.offset);
+                    append_bytecode(key, it.count);
+                }
+            }
+            append_bytecode(key, method.flags);
+            append_bytecode(key, append_signature_fingerprint(0, signatures[method.signature], type_fingerprints));
+            for (const auto& sv : method.stackvars)
+            {
+                append_bytecode(key, type_fingerprints[static_cast<size_t>(sv.type)]);
+            }
+            for (const auto& c : method.calls)
+            {
+                const auto& call_method = methods[c];
+                append_bytecode(key, c);
+                append_bytecode(key, call_method.is_defined());
+                append_bytecode(key, append_signature_fingerprint(0, signatures[call_method.signature], type_fingerprints));
+            }
+            for (const auto& g : method.globals)
+            {
+                const bool is_constant = is_constant_flag_set(g.index);
+                const auto& table = is_constant ? constants : globals;
+                append_bytecode(key, g.index);
+                append_bytecode(key, type_fingerprints[static_cast<size_t>(table.info[g.index & global_flags::constant_mask].type)]);
+            }
+            for (const auto& o : method.offsets)
+            {
+                const auto& offset = offsets[o];
+                append_bytecode(key, o);
+                append_bytecode(key, offset.offset);
+                append_bytecode(key, type_fingerprints[static_cast<size_t>(offset.name.object_type)]);
+                append_bytecode(key, type_fingerprints[static_cast<size_t>(offset.type)]);
+            }
+            append_bytecode(key, method.stackvars.size());
+            append_bytecode(key, method.calls.size());
+            append_bytecode(key, method.globals.size());
+            append_bytecode(key, method.offsets.size());
+            append_bytecode(key, method.labels.size());
+            key.insert(key.end(), reinterpret_cast<const uint8_t*>(method.labels.data()), reinterpret_cast<const uint8_t*>(method.labels.data() + method.labels.size()));
+            key.insert(key.end(), method.bytecode.begin(), method.bytecode.end());
+        }
+        // Inlined methods are part of the resolved bytecode of their callers, so the keys
+        // of the methods that can be reached within the inline depth are part of the key
+        void append_inline_keys(const link_parameters& parameters, vector<vector<uint8_t>>& keys) const
+        {
+            vector<size_t> hashes(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) hashes[i] = key_hash()(keys[i]);
 
-                    VALIDATE_POINTER_DEREFERENCE(type.is_pointer(), get_name(type));
-                    const auto& underlying_type = types[type.generated.pointer.underlying_type];
-                    VALIDATE_VOIDPOINTER_DEREFERENCE(underlying_type.index != type_idx::voidtype, get_name(type));
+            vector<method_idx> reachable;
+            for (const auto& m : methods)
+            {
+                auto& key = keys[static_cast<size_t>(m.index)];
+                if (key.empty()) continue;
 
-                    last_type = type.generated.pointer.underlying_type;
-                }
-                break;
+                append_bytecode(key, parameters.inline_size_limit);
+                append_bytecode(key, parameters.inline_depth_limit);
 
-                case address_prefix::address_of:
+                reachable.clear();
+                reachable.push_back(m.index);
+                size_t begin = 0;
+                for (size_t depth = 0; depth < parameters.inline_depth_limit && begin < reachable.size(); depth++)
                 {
-                    auto& type = types[last_type];
-
-                    if (type.pointer_type == type_idx::invalid)
-                    {
-                        // Generate missing pointer type
-                        // It is possible for generators to skip pointer types that
-                        // are never declared as stack variable, parameter, global or field
-                        gen_type pointer_type = gen_type(name_idx::invalid, type_idx(types.size()));
-                        pointer_type.flags = extended_flags::is_defined | extended_flags::is_resolved;
-                        pointer_type.total_size = ptr_size;
-                        pointer_type.make_pointer(type.index);
-                        type.pointer_type = pointer_type.index;
-                        last_type = pointer_type.index;
-                        types.push_back(std::move(pointer_type));
-                    }
-                    else
+                    const size_t end = reachable.size();
+                    for (size_t i = begin; i < end; i++)
                     {
-                        last_type = type.pointer_type;
+                        for (const auto& c : methods[reachable[i]].calls)
+                        {
+                            if (std::find(reachable.begin(), reachable.end(), c) != reachable.end()) continue;
+                            reachable.push_back(c);
+                            append_bytecode(key, c);
+                            append_bytecode(key, hashes[static_cast<size_t>(c)]);
+                        }
                     }
+                    begin = end;
                 }
-                break;
-
-                case address_prefix::size_of:
-                {
-                    last_type = size_type;
-                }
-                break;
-
-                default: ASSERT(false, "Malformed address header");
             }
-
-            iptr += sizeof(address_data_t);
-
-            return last_type;
         }
 
         void resolve_signature(asm_signature& signature)
@@ -928,113 +1777,6 @@ namespace propane
         }
 
 
-        subcode resolve_set(type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            if (lhs_type.is_pointer())
-            {
-                // Ensure that both pointer types are equal or LHS is a voidpointer
-                VALIDATE_IMPLICIT_CONVERSION(lhs_type.index == rhs_type.index || (lhs_type.index == type_idx::vptr && rhs_type.is_pointer()), lhs_type.index, rhs_type.index);
-
-                lhs = rhs = size_type;
-            }
-            else if (lhs_type.is_signature())
-            {
-                VALIDATE_IMPLICIT_CONVERSION(lhs_type.index == rhs_type.index || rhs_type.index == type_idx::vptr, lhs_type.index, rhs_type.index);
-
-                lhs = rhs = size_type;
-            }
-            else if (lhs_type.is_arithmetic())
-            {
-                // Ensure that both types are arithmetic
-                VALIDATE_IMPLICIT_CONVERSION(rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
-            }
-            else if ((lhs_type.is_struct() || lhs_type.is_array()) && lhs_type.index == rhs_type.index)
-            {
-                // Copy data
-                return subcode(45);
-            }
-            else
-            {
-                VALIDATE_IMPLICIT_CONVERSION(false, lhs_type.index, rhs_type.index);
-            }
-
-            const subcode sub = translate::set(lhs, rhs);
-            VALIDATE_IMPLICIT_CONVERSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
-            return sub;
-        }
-        subcode resolve_conv(type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            if (lhs_type.is_pointer()) lhs = size_type;
-            if (rhs_type.is_pointer()) rhs = size_type;
-
-            // Ensure arithmetic (pointers are treated as size type)
-            VALIDATE_EXPLICIT_CONVERSION(is_arithmetic(lhs) && is_arithmetic(rhs) && lhs_type.index != rhs_type.index, lhs_type.index, rhs_type.index);
-
-            const subcode sub = translate::conv(lhs, rhs);
-            VALIDATE_EXPLICIT_CONVERSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
-            return sub;
-        }
-        subcode resolve_ari(opcode op, type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            // Ensure arithmetic
-            VALIDATE_ARITHMETIC_EXPRESSION(lhs_type.is_arithmetic() && rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
-
-            const subcode sub = translate::ari(op, lhs, rhs);
-            VALIDATE_ARITHMETIC_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
-            return sub;
-        }
-        subcode resolve_cmp(opcode op, type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            if (lhs_type.is_pointer())
-            {
-                // Pointer types must be equal for valid comparison
-                VALIDATE_COMPARISON_EXPRESSION(lhs_type.index == rhs_type.index, lhs_type.index, rhs_type.index);
-
-                lhs = rhs = size_type;
-            }
-            else
-            {
-                // Ensure arithmetic
-                VALIDATE_COMPARISON_EXPRESSION(lhs_type.is_arithmetic() && rhs_type.is_arithmetic(), lhs_type.index, rhs_type.index);
-            }
-
-            const subcode sub = translate::cmp(op, lhs, rhs);
-            VALIDATE_COMPARISON_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
-            return sub;
-        }
-        subcode resolve_ptr(opcode op, type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            // Lhs must be a pointer, lhs cannot be a void pointer and rhs must be integral
-            VALIDATE_POINTER_EXPRESSION(lhs_type.is_pointer() && lhs_type.index != type_idx::vptr && rhs_type.is_integral(), lhs_type.index, rhs_type.index);
-
-            const subcode sub = translate::ptr(op, lhs, rhs);
-            VALIDATE_POINTER_EXPRESSION(sub != subcode::invalid, lhs_type.index, rhs_type.index);
-            return sub;
-        }
-        void resolve_pdif(type_idx lhs, type_idx rhs) const
-        {
-            const auto& lhs_type = types[lhs];
-            const auto& rhs_type = types[rhs];
-
-            // Lhs must be a pointer, lhs cannot be a void pointer and rhs must be integral
-            VALIDATE_PTR_OFFSET_EXPRESSION(lhs_type.is_pointer() && lhs_type.index != type_idx::vptr && lhs_type.index == rhs_type.index, lhs_type.index, rhs_type.index);
-        }
-
         global_idx resolve_method_constant(asm_method& method)
         {
             auto find = method_ptr_lookup.find(method.name);
@@ -1049,6 +1791,7 @@ namespace propane
                     gen_type signature_type = gen_type(name_idx::invalid, type_idx(types.size()));
                     signature_type.flags = extended_flags::is_defined | extended_flags::is_resolved;
                     signature_type.total_size = ptr_size;
+                    signature_type.alignment = ptr_size;
                     signature_type.make_signature(signature.index);
                     signature.signature_type = signature_type.index;
                     signature_type_idx = signature_type.index;
@@ -1085,7 +1828,8 @@ namespace propane
             {
                 const asm_type& global_type = types[global.type];
 
-                const size_t current_size = new_data.size();
+                // Globals are placed at their natural alignment
+                const size_t current_size = align_size(new_data.size(), global_type.alignment);
                 new_data.resize(current_size + global_type.total_size);
 
                 uint8_t* lhs_addr = new_data.data() + current_size;
@@ -1185,11 +1929,14 @@ namespace propane
             }
             else
             {
-                // Initialize fields
-                for (size_t i = 0; i < t.fields.size(); i++)
+                // Initialize fields (padding bytes remain zero)
+                uint8_t* const base_addr = lhs_addr;
+                for (const auto& field : t.fields)
                 {
-                    initialize_data_recursive(name, lhs_addr, t.fields[i].type, rhs_addr, init_count, is_constant);
+                    lhs_addr = base_addr + field.offset;
+                    initialize_data_recursive(name, lhs_addr, field.type, rhs_addr, init_count, is_constant);
                 }
+                lhs_addr = base_addr + t.total_size;
             }
         }
 
@@ -1224,36 +1971,18 @@ namespace propane
 
 
         gen_intermediate_data data;
+        const link_profile_data* const profile;
 
         const type_idx size_type;
         const type_idx offset_type;
         const size_t ptr_size;
 
-        asm_method* current_method = nullptr;
-        asm_signature* current_signature = nullptr;
-        inline void set_return_value(type_idx type)
-        {
-            const size_t size = data.types[type].total_size;
-            if (size > max_return_value_size) max_return_value_size = size;
-            return_value = type;
-        }
-        inline void clear_return_value()
-        {
-            return_value = type_idx::voidtype;
-        }
-        type_idx return_value = type_idx::invalid;
-        size_t max_return_value_size = 0;
-        uint8_t* iptr = nullptr;
-        uint32_t iidx = 0;
-        opcode current_op = opcode::noop;
-
-        vector<uint32_t> labels;
-        uint32_t label_idx = 0;
-
         string generated_name_buffers[2];
         size_t generated_name_index = 0;
 
         unordered_map<name_idx, global_idx> method_ptr_lookup;
+
+        vector<size_t> type_fingerprints;
     };
 
     void asm_assembly_data::serialize(assembly& dst, const asm_assembly_data& data)
@@ -1262,22 +1991,32 @@ namespace propane
         writer.write_direct(constants::assembly_header);
         writer.write_direct(toolchain_version::current());
         writer.write(data);
-        vector<uint8_t> serialized = writer.finalize();
+        vector<uint8_t> serialized = writer.finalize(constants::footer.size());
         append_bytecode(serialized, constants::footer);
 
-        dst.content = block<uint8_t>(serialized.data(), serialized.size());
+        const bool loaded = dst.load(span<const uint8_t>(serialized.data(), serialized.size()));
+        ASSERT(loaded, "Failed to load serialized assembly");
     }
 
-    assembly::assembly(const intermediate& im, const runtime& runtime)
+    assembly::assembly(const intermediate& im, const runtime& runtime, link_parameters parameters)
+    {
+        VALIDATE_INTERMEDIATE(im.is_valid());
+        VALIDATE_COMPATIBILITY(im.is_compatible());
+
+        gen_intermediate_data data = gen_intermediate_data::deserialize(im);
+
+        asm_assembly_data::serialize(*this, assembly_linker(std::move(data), runtime, parameters, nullptr, parameters.profile ? &parameters.profile->self() : nullptr));
+    }
+    assembly::assembly(const intermediate& im, const runtime& runtime, link_cache& cache, link_parameters parameters)
     {
         VALIDATE_INTERMEDIATE(im.is_valid());
         VALIDATE_COMPATIBILITY(im.is_compatible());
 
         gen_intermediate_data data = gen_intermediate_data::deserialize(im);
 
-        asm_assembly_data::serialize(*this, assembly_linker(std::move(data), runtime));
+        asm_assembly_data::serialize(*this, assembly_linker(std::move(data), runtime, parameters, &cache.self(), parameters.profile ? &parameters.profile->self() : nullptr));
     }
-    assembly::assembly(const intermediate& im) : assembly(im, runtime())
+    assembly::assembly(const intermediate& im, link_parameters parameters) : assembly(im, runtime(), parameters)
     {
 
     }
@@ -34,43 +34,93 @@ namespace propane
         return false;
     }
 
-    // Intermediate merger takes in two intermediates and produces
-    // the merged result
+    // Intermediate merger takes in a destination intermediate and appends
+    // other intermediates to it. Lookup tables of the destination are restored
+    // once, after which any number of intermediates can be appended. Every
+    // appended intermediate has its names translated against the database of
+    // the destination exactly once. Names of intermediates that were generated with
+    // the same identifier interner are translated by their interned index instead.
     class merger final : public gen_intermediate_data
     {
     public:
         NOCOPY_CLASS_DEFAULT(merger) = delete;
 
-        merger(gen_intermediate_data&& lhs, gen_intermediate_data&& rhs) :
-            gen_intermediate_data(std::move(lhs)), merge(rhs)
+        merger(gen_intermediate_data&& dst) :
+            gen_intermediate_data(std::move(dst))
         {
             restore_lookup_tables();
             restore_generated_types();
+            restore_name_keys();
 
             keybuf.reserve(32);
+        }
+
+        // Reserves the lookups for the worst case of appending the provided intermediates
+        // (no shared names, signatures or offsets), so that they do not grow while merging
+        void reserve(const gen_intermediate_data* sources, size_t count)
+        {
+            size_t name_count = database.size();
+            size_t signature_count = signature_lookup.size();
+            size_t offset_count = offset_lookup.size();
+            for (size_t i = 0; i < count; i++)
+            {
+                name_count += sources[i].database.size();
+                signature_count += sources[i].signatures.size();
+                offset_count += sources[i].offsets.size();
+            }
+            database.reserve(name_count);
+            signature_lookup.reserve(signature_count);
+            offset_lookup.reserve(offset_count);
+        }
 
-            initialize_translations(type_translations, merge.types.size());
-            initialize_translations(method_translations, merge.methods.size());
-            initialize_translations(signature_translations, merge.signatures.size());
-            initialize_translations(offset_translations, merge.offsets.size());
-            if (!merge.database.empty())
+        void append(gen_intermediate_data& src)
+        {
+            merge = &src;
+
+            initialize_translations(type_translations, merge->types.size());
+            initialize_translations(method_translations, merge->methods.size());
+            initialize_translations(signature_translations, merge->signatures.size());
+            initialize_translations(offset_translations, merge->offsets.size());
+            name_translations = indexed_block<name_idx, name_idx>();
+            meta_translations = indexed_block<meta_idx, meta_idx>();
+            if (name_table != 0 && name_table == merge->name_table && merge->name_keys.size() == merge->database.size())
+            {
+                // Names of the same interner are translated by their interner index
+                name_translations = indexed_block<name_idx, name_idx>(merge->database.size());
+                for (size_t i = 0; i < name_translations.size(); i++)
+                {
+                    const name_idx key = merge->name_keys[name_idx(i)];
+                    if (static_cast<size_t>(key) >= key_names.size()) key_names.resize(static_cast<size_t>(key) + 1, name_idx::invalid);
+                    name_idx& dst = key_names[key];
+                    if (dst == name_idx::invalid)
+                    {
+                        dst = database.emplace(merge->database[name_idx(i)].name, lookup_idx::make_identifier()).key;
+                        name_keys.push_back(key);
+                    }
+                    name_translations[name_idx(i)] = dst;
+                }
+            }
+            else if (!merge->database.empty())
             {
-                name_translations = indexed_block<name_idx, name_idx>(merge.database.size());
+                // Names of the result no longer belong to a single interner
+                clear_name_keys();
+
+                name_translations = indexed_block<name_idx, name_idx>(merge->database.size());
                 for (size_t i = 0; i < name_translations.size(); i++)
                 {
                     const name_idx index = name_idx(i);
-                    const string_view identifier = merge.database[index].name;
+                    const string_view identifier = merge->database[index].name;
                     auto find = database.find(identifier);
                     name_translations[index] = find ? find.key : database.emplace(identifier, lookup_idx::make_identifier()).key;
                 }
             }
-            if (!merge.metatable.empty())
+            if (!merge->metatable.empty())
             {
-                meta_translations = indexed_block<meta_idx, meta_idx>(merge.metatable.size());
+                meta_translations = indexed_block<meta_idx, meta_idx>(merge->metatable.size());
                 for (size_t i = 0; i < meta_translations.size(); i++)
                 {
                     const meta_idx index = meta_idx(i);
-                    const string_view metastr = merge.metatable[index].name;
+                    const string_view metastr = merge->metatable[index].name;
                     auto find = metatable.find(metastr);
                     meta_translations[index] = find != meta_idx::invalid ? find : metatable.emplace(metastr);
                 }
@@ -79,7 +129,7 @@ namespace propane
             // Merge defined and declared types
             vector<type_idx> untranslated_types;
             size_t next_index = types.size();
-            for (auto& src : merge.types)
+            for (auto& src : merge->types)
             {
                 if (is_base_type(src.index)) continue;
 
@@ -94,7 +144,7 @@ namespace propane
                 {
                     auto& dst = types[find->type];
 
-                    VALIDATE_TYPE_DEF(!dst.is_defined() || !src.is_defined(), database[dst.name].name, make_meta(dst.index), merge.make_meta(src.index));
+                    VALIDATE_TYPE_DEF(!dst.is_defined() || !src.is_defined(), database[dst.name].name, make_meta(dst.index), merge->make_meta(src.index));
 
                     src.index = dst.index;
                     src.name = dst.name;
@@ -107,7 +157,7 @@ namespace propane
                 }
                 type_translations[src_type] = src.index;
             }
-            for (auto& src : merge.types)
+            for (auto& src : merge->types)
             {
                 if (is_base_type(src.index)) continue;
                 if (src.is_generated()) continue;
@@ -137,7 +187,7 @@ namespace propane
             }
 
             // Merge generated types
-            for (auto& src : merge.types)
+            for (auto& src : merge->types)
             {
                 if (is_base_type(src.index)) continue;
                 if (!src.is_generated()) continue;
@@ -190,7 +240,7 @@ namespace propane
                     // Merge the signature first if needed
                     signature_idx dst_idx = src.generated.signature.index;
                     const signature_idx src_idx = src.generated.signature.index;
-                    src.generated.signature.index = dst_idx = merge_signature(std::move(merge.signatures[src_idx]));
+                    src.generated.signature.index = dst_idx = merge_signature(std::move(merge->signatures[src_idx]));
                     signature_translations[src_idx] = dst_idx;
 
                     auto& signature = signatures[dst_idx];
@@ -229,7 +279,7 @@ namespace propane
             }
 
             // Merge remaining signatures
-            for (auto& signature : merge.signatures)
+            for (auto& signature : merge->signatures)
             {
                 if (signature.index != signature_idx::invalid)
                 {
@@ -240,17 +290,17 @@ namespace propane
             }
 
             // Merge offsets
-            for (size_t i = 0; i < merge.offsets.size(); i++)
+            for (size_t i = 0; i < merge->offsets.size(); i++)
             {
                 const offset_idx src_idx = offset_idx(i);
-                auto& offset = merge.offsets[src_idx];
+                auto& offset = merge->offsets[src_idx];
 
                 translate(offset.name.object_type);
                 for (auto& fn : offset.name.field_names) rename(fn);
 
                 offset.name.make_key(keybuf);
                 auto find = offset_lookup.find(keybuf);
-                if (find == offset_lookup.end())
+                if (!find)
                 {
                     const offset_idx dst_idx = offset_idx(offsets.size());
                     offset_lookup.emplace(keybuf, dst_idx);
@@ -259,25 +309,25 @@ namespace propane
                 }
                 else
                 {
-                    offset_translations[src_idx] = find->second;
+                    offset_translations[src_idx] = *find;
                 }
             }
 
             // Fold globals
-            merge_data_table(globals, merge.globals, lookup_type::global);
-            merge_data_table(constants, merge.constants, lookup_type::constant);
+            merge_data_table(globals, merge->globals, lookup_type::global);
+            merge_data_table(constants, merge->constants, lookup_type::constant);
 
             // Merge methods
             vector<method_idx> untranslated_methods;
             next_index = methods.size();
-            for (auto& src : merge.methods)
+            for (auto& src : merge->methods)
             {
                 const method_idx src_type = src.index;
                 if (auto find = lookup(src.name, lookup_type::method, src_type))
                 {
                     auto& dst = methods[find->method];
 
-                    VALIDATE_METHOD_DEF(!dst.is_defined() || !src.is_defined(), database[dst.name].name, make_meta(dst.index), merge.make_meta(src.index));
+                    VALIDATE_METHOD_DEF(!dst.is_defined() || !src.is_defined(), database[dst.name].name, make_meta(dst.index), merge->make_meta(src.index));
 
                     src.index = dst.index;
                     src.name = dst.name;
@@ -290,7 +340,7 @@ namespace propane
                 }
                 method_translations[src_type] = src.index;
             }
-            for (auto& src : merge.methods)
+            for (auto& src : merge->methods)
             {
                 if (static_cast<size_t>(src.index) == methods.size())
                 {
@@ -324,9 +374,12 @@ namespace propane
                 translate(m.signature);
                 translate(m.meta.index);
             }
+
+            merge = nullptr;
         }
 
-        gen_intermediate_data& merge;
+    private:
+        gen_intermediate_data* merge = nullptr;
 
         indexed_block<type_idx, type_idx> type_translations;
         indexed_block<method_idx, method_idx> method_translations;
@@ -335,8 +388,32 @@ namespace propane
         indexed_block<name_idx, name_idx> name_translations;
         indexed_block<meta_idx, meta_idx> meta_translations;
 
+        // Destination name per interner index (see name_table)
+        indexed_vector<name_idx, name_idx> key_names;
+
         vector<uint8_t> keybuf;
 
+        void restore_name_keys()
+        {
+            if (name_table == 0 || name_keys.size() != database.size())
+            {
+                clear_name_keys();
+                return;
+            }
+            for (size_t i = 0; i < name_keys.size(); i++)
+            {
+                const name_idx key = name_keys[name_idx(i)];
+                if (static_cast<size_t>(key) >= key_names.size()) key_names.resize(static_cast<size_t>(key) + 1, name_idx::invalid);
+                key_names[key] = name_idx(i);
+            }
+        }
+        void clear_name_keys()
+        {
+            name_table = 0;
+            name_keys.clear();
+            key_names.clear();
+        }
+
         template<typename value_t> inline void initialize_translations(indexed_block<value_t, value_t>& block, size_t num)
         {
             if (num > 0)
@@ -347,6 +424,10 @@ namespace propane
                     block[value_t(i)] = value_t(i);
                 }
             }
+            else
+            {
+                block = indexed_block<value_t, value_t>();
+            }
         }
 
         template<typename value_t> inline find_result<name_idx, lookup_idx> lookup(name_idx src_name, lookup_type type, value_t index)
@@ -361,11 +442,11 @@ namespace propane
             {
                 if (type == lookup_type::type && find->lookup == lookup_type::method)
                 {
-                    VALIDATE_IDENTIFIER_TYPE_WITH_META(type, merge.make_meta(type_idx(index)), find->lookup, make_meta(find->method));
+                    VALIDATE_IDENTIFIER_TYPE_WITH_META(type, merge->make_meta(type_idx(index)), find->lookup, make_meta(find->method));
                 }
                 else if (type == lookup_type::method && find->lookup == lookup_type::type)
                 {
-                    VALIDATE_IDENTIFIER_TYPE_WITH_META(type, merge.make_meta(method_idx(index)), find->lookup, make_meta(find->type));
+                    VALIDATE_IDENTIFIER_TYPE_WITH_META(type, merge->make_meta(method_idx(index)), find->lookup, make_meta(find->type));
                 }
                 else
                 {
@@ -388,7 +469,7 @@ namespace propane
 
             signature.make_key(keybuf);
             auto find = signature_lookup.find(keybuf);
-            if (find == signature_lookup.end())
+            if (!find)
             {
                 const signature_idx dst_idx = signature_idx(signatures.size());
                 signature.index = dst_idx;
@@ -398,7 +479,7 @@ namespace propane
                 return dst_idx;
             }
             signature.index = signature_idx::invalid;
-            return find->second;
+            return *find;
         }
 
         void merge_data_table(gen_data_table& dst, gen_data_table& src, lookup_type type)
@@ -407,7 +488,7 @@ namespace propane
             for (auto& global : src.info)
             {
                 auto find = lookup(global.name, type);
-                VALIDATE_GLOBAL_DEF(!find, merge.database[global.name].name);
+                VALIDATE_GLOBAL_DEF(!find, merge->database[global.name].name);
 
                 const uint32_t global_idx = uint32_t(dst.info.size());
 
@@ -470,7 +551,23 @@ namespace propane
     {
         ASSERT(lhs_data.types.size() >= base_type_count, "Merge destination does not have base types set up");
 
-        return merger(std::move(lhs_data), std::move(rhs_data));
+        merger result(std::move(lhs_data));
+        result.reserve(&rhs_data, 1);
+        result.append(rhs_data);
+        return std::move(result);
+    }
+    gen_intermediate_data gen_intermediate_data::merge(span<gen_intermediate_data> sources)
+    {
+        ASSERT(!sources.empty(), "Merge requires at least one intermediate");
+        ASSERT(sources[0].types.size() >= base_type_count, "Merge destination does not have base types set up");
+
+        merger result(std::move(sources[0]));
+        result.reserve(sources.data() + 1, sources.size() - 1);
+        for (size_t i = 1; i < sources.size(); i++)
+        {
+            result.append(sources[i]);
+        }
+        return std::move(result);
     }
     gen_intermediate_data gen_intermediate_data::merge(const intermediate& lhs, const intermediate& rhs)
     {
@@ -484,4 +581,161 @@ namespace propane
 
         return merge(std::move(lhs_data), std::move(rhs_data));
     }
+
+    class intermediate_builder_data final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(intermediate_builder_data) = default;
+
+        void append(const intermediate& im)
+        {
+            // Empty intermediates are skipped, similar to operator+=
+            if (im.data().empty()) return;
+            VALIDATE_INTERMEDIATE(im.is_valid());
+            VALIDATE_COMPATIBILITY(im.is_compatible());
+
+            if (count == 0)
+            {
+                // Keep the first intermediate serialized, in case nothing else gets appended
+                first = im;
+            }
+            else
+            {
+                if (!result)
+                {
+                    result = std::make_unique<merger>(gen_intermediate_data::deserialize(first));
+                    first = intermediate();
+                }
+                gen_intermediate_data src = gen_intermediate_data::deserialize(im);
+                result->append(src);
+            }
+            count++;
+        }
+
+        intermediate finalize()
+        {
+            intermediate im;
+            if (result)
+            {
+                gen_intermediate_data::serialize(im, *result);
+                result.reset();
+            }
+            else
+            {
+                im = std::move(first);
+            }
+            first = intermediate();
+            count = 0;
+            return im;
+        }
+
+        std::unique_ptr<merger> result;
+        intermediate first;
+        size_t count = 0;
+    };
+    constexpr size_t intermediate_builder_data_handle_size = approximate_handle_size(sizeof(intermediate_builder_data));
+
+    intermediate_builder::intermediate_builder()
+    {
+
+    }
+    intermediate_builder::~intermediate_builder()
+    {
+
+    }
+
+    intermediate_builder& intermediate_builder::operator+=(const intermediate& im)
+    {
+        self().append(im);
+        return *this;
+    }
+    void intermediate_builder::append(const intermediate& im)
+    {
+        self().append(im);
+    }
+
+    size_t intermediate_builder::size() const noexcept
+    {
+        return self().count;
+    }
+    bool intermediate_builder::empty() const noexcept
+    {
+        return self().count == 0;
+    }
+
+    intermediate intermediate_builder::finalize()
+    {
+        return self().finalize();
+    }
+
+    intermediate merge_all(span<const intermediate> intermediates, size_t thread_count)
+    {
+        // Empty intermediates are skipped, similar to operator+=
+        vector<const intermediate*> sources;
+        sources.reserve(intermediates.size());
+        for (const auto& it : intermediates)
+        {
+            if (it.data().empty()) continue;
+            VALIDATE_INTERMEDIATE(it.is_valid());
+            VALIDATE_COMPATIBILITY(it.is_compatible());
+            sources.push_back(&it);
+        }
+
+        if (sources.empty()) return intermediate();
+        if (sources.size() == 1) return *sources[0];
+
+        vector<gen_intermediate_data> level;
+        try
+        {
+            vector<gen_intermediate_data> inputs(sources.size());
+            parallel_for(inputs.size(), thread_count, [&](size_t idx)
+            {
+                inputs[idx] = gen_intermediate_data::deserialize(*sources[idx]);
+            });
+
+            // Divide the inputs into one contiguous range per thread, which are merged
+            // in a single pass each (names of every input are translated only once)
+            const size_t chunk_count = resolve_thread_count(thread_count, inputs.size());
+            level.resize(chunk_count);
+            parallel_for(chunk_count, chunk_count, [&](size_t idx)
+            {
+                const size_t begin = inputs.size() * idx / chunk_count;
+                const size_t end = inputs.size() * (idx + 1) / chunk_count;
+                level[idx] = gen_intermediate_data::merge(span<gen_intermediate_data>(inputs.data() + begin, end - begin));
+            });
+
+            // Merge neighbouring pairs until one remains (this preserves the order
+            // of the intermediates, so the merged result matches a serial merge)
+            while (level.size() > 1)
+            {
+                const size_t pair_count = level.size() / 2;
+                vector<gen_intermediate_data> next(pair_count + (level.size() & 1));
+                parallel_for(pair_count, thread_count, [&](size_t idx)
+                {
+                    next[idx] = gen_intermediate_data::merge(std::move(level[idx * 2]), std::move(level[idx * 2 + 1]));
+                });
+                if (level.size() & 1)
+                {
+                    next.back() = std::move(level.back());
+                }
+                level = std::move(next);
+            }
+        }
+        catch (const merger_exception&)
+        {
+            // Which error is reported first depends on how the inputs were divided,
+            // redo the merge serially so the error matches that of a serial merge
+            vector<gen_intermediate_data> serial(sources.size());
+            for (size_t i = 0; i < sources.size(); i++)
+            {
+                serial[i] = gen_intermediate_data::deserialize(*sources[i]);
+            }
+            gen_intermediate_data::merge(span<gen_intermediate_data>(serial.data(), serial.size()));
+            throw;
+        }
+
+        intermediate result;
+        gen_intermediate_data::serialize(result, level.front());
+        return result;
+    }
 }
\ No newline at end of file
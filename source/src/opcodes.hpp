@@ -51,6 +51,7 @@ namespace propane
         bnz,
 
         sw,
+        sws,
 
         call,
         callv,
@@ -58,10 +59,56 @@ namespace propane
         retv,
 
         dump,
+
+        // Vector instructions (element-wise, see vector_types)
+        vadd,
+        vsub,
+        vmul,
+        vdiv,
+        vmin,
+        vmax,
+        vceq,
+        vcne,
+        vcgt,
+        vcge,
+        vclt,
+        vcle,
+        vshf,
+
+        // Bulk memory instructions (pointer, pointer/value, length)
+        mcpy,
+        mset,
+        mcmp,
     };
+    // Amount of opcodes in the bytecode format
+    constexpr size_t opcode_count = size_t(opcode::mcmp) + 1;
+
+    inline constexpr bool is_vector_op(opcode op) noexcept
+    {
+        return op >= opcode::vadd && op <= opcode::vshf;
+    }
+    inline constexpr bool is_memory_op(opcode op) noexcept
+    {
+        return op >= opcode::mcpy && op <= opcode::mcmp;
+    }
 
     enum class subcode : uint8_t { invalid = 0xFF };
 
+    // Subcode of the bulk memory instructions, contains the integral type of the
+    // length operand and the integral type of the fill value (mset only)
+    inline constexpr subcode make_memory_subcode(type_idx length, type_idx value = type_idx::i8) noexcept
+    {
+        return subcode((static_cast<uint32_t>(value) << 3) | static_cast<uint32_t>(length));
+    }
+    inline constexpr type_idx memory_length_type(subcode sub) noexcept
+    {
+        return type_idx(static_cast<uint32_t>(sub) & 7);
+    }
+    inline constexpr type_idx memory_value_type(subcode sub) noexcept
+    {
+        return type_idx(static_cast<uint32_t>(sub) >> 3);
+    }
+
     inline constexpr opcode operator+(opcode lhs, opcode rhs) noexcept
     {
         return opcode(static_cast<uint32_t>(lhs) + static_cast<uint32_t>(rhs));
@@ -0,0 +1,1674 @@
+#include "optimizer.hpp"
+#include "operations.hpp"
+#include "errors.hpp"
+
+namespace propane
+{
+    namespace
+    {
+        constexpr uint32_t return_value_index = address_header_constants::index_max;
+        constexpr size_t invalid_instruction = size_t(-1);
+
+        // Passes are repeated until nothing changes (or the limit is reached),
+        // since every pass can expose new opportunities for the other passes
+        constexpr size_t max_optimization_passes = 8;
+
+        // Decoded address operand
+        struct opt_address
+        {
+            address_header header;
+            // Field/offset for regular addresses, value for constants
+            alignas(size_t) uint8_t payload[sizeof(size_t)];
+
+            inline bool is_constant() const noexcept
+            {
+                return header.type() == address_type::constant;
+            }
+            inline type_idx constant_type() const noexcept
+            {
+                return type_idx(header.index());
+            }
+            inline bool is_plain_stackvar() const noexcept
+            {
+                return header.type() == address_type::stackvar &&
+                    header.prefix() == address_prefix::none &&
+                    header.modifier() == address_modifier::none;
+            }
+            inline bool is_return_value() const noexcept
+            {
+                return is_plain_stackvar() && header.index() == return_value_index;
+            }
+
+            static opt_address make_constant(type_idx type, const uint8_t* value) noexcept
+            {
+                opt_address result;
+                result.header = address_header(type);
+                memset(result.payload, 0, sizeof(result.payload));
+                memcpy(result.payload, value, get_base_type_size(type));
+                return result;
+            }
+        };
+
+        // Decoded instruction, branch targets are instruction indices
+        struct opt_instruction
+        {
+            opcode op = opcode::noop;
+            subcode sub = subcode::invalid;
+            uint32_t method = 0;
+            vector<opt_address> operands;
+            vector<subcode> argument_subcodes;
+            vector<size_t> targets;
+            // Case values of a sparse switch (one per target)
+            vector<uint64_t> case_values;
+            // Bytecode offset before optimization
+            uint32_t offset = 0;
+            bool removed = false;
+        };
+
+        // Known value of a stack variable (or the return value)
+        enum class value_kind : uint8_t
+        {
+            unknown,
+            constant,
+            stackvar_copy,
+            return_value_copy,
+        };
+
+        struct value_state
+        {
+            value_kind kind = value_kind::unknown;
+            uint32_t source = 0;
+            size_t generation = 0;
+            alignas(size_t) uint8_t value[sizeof(size_t)];
+        };
+
+
+        inline bool is_branch(opcode op) noexcept
+        {
+            return op >= opcode::br && op <= opcode::sws;
+        }
+        inline bool is_terminator(opcode op) noexcept
+        {
+            return op == opcode::br || op == opcode::ret || op == opcode::retv;
+        }
+        inline bool is_binary_arithmetic(opcode op) noexcept
+        {
+            return op >= opcode::ari_mul && op <= opcode::ari_or;
+        }
+        inline bool is_unary_arithmetic(opcode op) noexcept
+        {
+            return op == opcode::ari_not || op == opcode::ari_neg;
+        }
+        inline bool sets_return_value(opcode op) noexcept
+        {
+            return (op >= opcode::pdif && op <= opcode::cnz) || op == opcode::call || op == opcode::callv || op == opcode::mcmp;
+        }
+
+        // Instructions that write to their first operand
+        inline bool writes_lhs(opcode op) noexcept
+        {
+            return op >= opcode::set && op <= opcode::psub;
+        }
+        // Index of the first operand that is read as a value and can
+        // be replaced by a constant of the same type
+        inline size_t first_value_operand(opcode op) noexcept
+        {
+            switch (op)
+            {
+                case opcode::set:
+                case opcode::conv:
+                case opcode::padd:
+                case opcode::psub:
+                case opcode::pdif:
+                case opcode::mcpy:
+                case opcode::mset:
+                case opcode::mcmp:
+                    return 1;
+
+                case opcode::cze:
+                case opcode::cnz:
+                case opcode::bze:
+                case opcode::bnz:
+                case opcode::sw:
+                case opcode::sws:
+                case opcode::call:
+                case opcode::callv:
+                case opcode::retv:
+                    return 0;
+
+                default:
+                {
+                    if (is_binary_arithmetic(op)) return 1;
+                    if (op >= opcode::cmp && op <= opcode::cle) return 1;
+                    if (op >= opcode::beq && op <= opcode::ble) return 1;
+                }
+                break;
+            }
+            return size_t(-1);
+        }
+
+
+        // Constant evaluation (matches the interpreter operations)
+        template<typename value_t> bool fold_arithmetic(opcode op, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            value_t& lhs = write<value_t>(lhs_addr);
+            const value_t rhs = read<value_t>(rhs_addr);
+
+            if constexpr (std::is_integral_v<value_t>)
+            {
+                // Evaluate unsigned to get well-defined overflow
+                using unsigned_t = std::make_unsigned_t<value_t>;
+                const uint64_t ulhs = uint64_t(unsigned_t(lhs));
+                const uint64_t urhs = uint64_t(unsigned_t(rhs));
+
+                switch (op)
+                {
+                    case opcode::ari_not: lhs = value_t(unsigned_t(~ulhs)); return true;
+                    case opcode::ari_neg: lhs = value_t(unsigned_t(0 - ulhs)); return true;
+                    case opcode::ari_mul: lhs = value_t(unsigned_t(ulhs * urhs)); return true;
+                    case opcode::ari_add: lhs = value_t(unsigned_t(ulhs + urhs)); return true;
+                    case opcode::ari_sub: lhs = value_t(unsigned_t(ulhs - urhs)); return true;
+                    case opcode::ari_and: lhs = value_t(unsigned_t(ulhs & urhs)); return true;
+                    case opcode::ari_xor: lhs = value_t(unsigned_t(ulhs ^ urhs)); return true;
+                    case opcode::ari_or: lhs = value_t(unsigned_t(ulhs | urhs)); return true;
+
+                    case opcode::ari_div:
+                    case opcode::ari_mod:
+                    {
+                        // Division by zero and overflow are left to the runtime
+                        if (rhs == 0) return false;
+                        if constexpr (std::is_signed_v<value_t>)
+                        {
+                            if (rhs == value_t(-1) && lhs == std::numeric_limits<value_t>::min()) return false;
+                        }
+                        lhs = op == opcode::ari_div ? value_t(lhs / rhs) : value_t(lhs % rhs);
+                        return true;
+                    }
+
+                    // Shifts are left to the runtime
+                    default: break;
+                }
+            }
+            else
+            {
+                switch (op)
+                {
+                    case opcode::ari_neg: lhs = -lhs; return true;
+                    case opcode::ari_mul: lhs *= rhs; return true;
+                    case opcode::ari_div: lhs /= rhs; return true;
+                    case opcode::ari_add: lhs += rhs; return true;
+                    case opcode::ari_sub: lhs -= rhs; return true;
+                    default: break;
+                }
+            }
+
+            return false;
+        }
+        bool fold_arithmetic(opcode op, type_idx type, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return fold_arithmetic<int8_t>(op, lhs_addr, rhs_addr);
+                case type_idx::u8: return fold_arithmetic<uint8_t>(op, lhs_addr, rhs_addr);
+                case type_idx::i16: return fold_arithmetic<int16_t>(op, lhs_addr, rhs_addr);
+                case type_idx::u16: return fold_arithmetic<uint16_t>(op, lhs_addr, rhs_addr);
+                case type_idx::i32: return fold_arithmetic<int32_t>(op, lhs_addr, rhs_addr);
+                case type_idx::u32: return fold_arithmetic<uint32_t>(op, lhs_addr, rhs_addr);
+                case type_idx::i64: return fold_arithmetic<int64_t>(op, lhs_addr, rhs_addr);
+                case type_idx::u64: return fold_arithmetic<uint64_t>(op, lhs_addr, rhs_addr);
+                case type_idx::f32: return fold_arithmetic<float>(op, lhs_addr, rhs_addr);
+                case type_idx::f64: return fold_arithmetic<double>(op, lhs_addr, rhs_addr);
+                default: break;
+            }
+            return false;
+        }
+
+        // Compare opcode relative to opcode::cmp (ceq to cle, cze/cnz are evaluated separately)
+        template<typename value_t> bool fold_comparison(opcode op, const uint8_t* lhs_addr, const uint8_t* rhs_addr, int32_t& result) noexcept
+        {
+            const value_t lhs = read<value_t>(lhs_addr);
+            const value_t rhs = read<value_t>(rhs_addr);
+            switch (op)
+            {
+                case opcode::ceq: result = lhs == rhs; return true;
+                case opcode::cne: result = lhs != rhs; return true;
+                case opcode::cgt: result = lhs > rhs; return true;
+                case opcode::cge: result = lhs >= rhs; return true;
+                case opcode::clt: result = lhs < rhs; return true;
+                case opcode::cle: result = lhs <= rhs; return true;
+                default: break;
+            }
+            return false;
+        }
+        bool fold_comparison(opcode op, type_idx type, const uint8_t* lhs_addr, const uint8_t* rhs_addr, int32_t& result) noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return fold_comparison<int8_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::u8: return fold_comparison<uint8_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::i16: return fold_comparison<int16_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::u16: return fold_comparison<uint16_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::i32: return fold_comparison<int32_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::u32: return fold_comparison<uint32_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::i64: return fold_comparison<int64_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::u64: return fold_comparison<uint64_t>(op, lhs_addr, rhs_addr, result);
+                case type_idx::f32: return fold_comparison<float>(op, lhs_addr, rhs_addr, result);
+                case type_idx::f64: return fold_comparison<double>(op, lhs_addr, rhs_addr, result);
+                default: break;
+            }
+            return false;
+        }
+
+        bool is_zero(type_idx type, const uint8_t* addr) noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: return read<int8_t>(addr) == 0;
+                case type_idx::u8: return read<uint8_t>(addr) == 0;
+                case type_idx::i16: return read<int16_t>(addr) == 0;
+                case type_idx::u16: return read<uint16_t>(addr) == 0;
+                case type_idx::i32: return read<int32_t>(addr) == 0;
+                case type_idx::u32: return read<uint32_t>(addr) == 0;
+                case type_idx::i64: return read<int64_t>(addr) == 0;
+                case type_idx::u64: return read<uint64_t>(addr) == 0;
+                case type_idx::f32: return read<float>(addr) == 0;
+                case type_idx::f64: return read<double>(addr) == 0;
+                case type_idx::vptr: return read<size_t>(addr) == 0;
+                default: break;
+            }
+            return false;
+        }
+
+        bool read_switch_index(type_idx type, const uint8_t* addr, uint32_t& result) noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: result = (uint32_t)read<int8_t>(addr); return true;
+                case type_idx::u8: result = (uint32_t)read<uint8_t>(addr); return true;
+                case type_idx::i16: result = (uint32_t)read<int16_t>(addr); return true;
+                case type_idx::u16: result = (uint32_t)read<uint16_t>(addr); return true;
+                case type_idx::i32: result = (uint32_t)read<int32_t>(addr); return true;
+                case type_idx::u32: result = (uint32_t)read<uint32_t>(addr); return true;
+                case type_idx::i64: result = (uint32_t)read<int64_t>(addr); return true;
+                case type_idx::u64: result = (uint32_t)read<uint64_t>(addr); return true;
+                default: break;
+            }
+            return false;
+        }
+        bool read_switch_value(type_idx type, const uint8_t* addr, uint64_t& result) noexcept
+        {
+            switch (type)
+            {
+                case type_idx::i8: result = (uint64_t)read<int8_t>(addr); return true;
+                case type_idx::u8: result = (uint64_t)read<uint8_t>(addr); return true;
+                case type_idx::i16: result = (uint64_t)read<int16_t>(addr); return true;
+                case type_idx::u16: result = (uint64_t)read<uint16_t>(addr); return true;
+                case type_idx::i32: result = (uint64_t)read<int32_t>(addr); return true;
+                case type_idx::u32: result = (uint64_t)read<uint32_t>(addr); return true;
+                case type_idx::i64: result = (uint64_t)read<int64_t>(addr); return true;
+                case type_idx::u64: result = (uint64_t)read<uint64_t>(addr); return true;
+                default: break;
+            }
+            return false;
+        }
+
+
+        // Callers can grow by this factor of their size through inlining (or by the minimum budget)
+        constexpr size_t max_inline_growth = 2;
+        constexpr size_t min_inline_budget = 512;
+    }
+
+    // Decoded bytecode of a method that can be inlined
+    struct inline_candidate
+    {
+        vector<opt_instruction> instructions;
+        vector<stackvar> parameters;
+        vector<stackvar> stackvars;
+        type_idx return_type = type_idx::voidtype;
+        // Size of the return value of the calls made by the method
+        size_t return_value_size = 0;
+        size_t bytecode_size = 0;
+    };
+
+    namespace
+    {
+        class method_optimizer final
+        {
+        public:
+            method_optimizer(const asm_assembly_data& data, asm_method& method) :
+                data(data),
+                method(method) {}
+
+            void optimize()
+            {
+                decode();
+                find_tracked_variables();
+                optimization_passes();
+                encode();
+            }
+
+            // Inlining
+            // Calls to inline candidates are replaced by a copy of the candidate bytecode. Parameters and
+            // stack variables of the candidate become stack variables of the caller, arguments are set to the
+            // parameters and returns jump to the end of the copy. Returned values are set to a stack variable,
+            // which replaces the reads of the return value that follow the call.
+            // Calls made by inlined bytecode are inlined as well, up to the provided depth.
+            void inline_calls(const inline_table& table, size_t depth_limit)
+            {
+                decode();
+
+                const size_t stackvar_count = method.stackvars.size();
+                const size_t size_limit = method.bytecode.size() + std::max(method.bytecode.size() * max_inline_growth, min_inline_budget);
+                size_t size = method.bytecode.size();
+                size_t return_value_size = method.total_stack_size - method.method_stack_size;
+                bool inlined = false;
+                for (size_t depth = 0; depth < depth_limit; depth++)
+                {
+                    if (!inline_pass(table, size, size_limit, return_value_size)) break;
+                    inlined = true;
+                }
+                if (!inlined) return;
+
+                find_tracked_variables();
+                optimization_passes();
+                remove_unused_stackvars(stackvar_count);
+
+                // Stack variables are laid out the same way the linker does
+                method.layout_stack(data.types, data.signatures[method.signature].parameters_size);
+                method.total_stack_size = method.method_stack_size + return_value_size;
+
+                encode();
+            }
+
+            // Compact encoding
+            // Re-encodes the method with variable-length addresses (see append_compact_address).
+            // Branch targets and labels are remapped to the new offsets by the encoder.
+            void compact()
+            {
+                decode();
+                compact_encoding = true;
+                encode();
+            }
+
+            // Profile guided block layout
+            // Blocks are chained starting from the method entry, continuing every chain with the most
+            // executed successor that has not been placed yet (the fallthrough wins ties). When a chain
+            // ends, the most executed remaining block starts the next one, so cold blocks end up last.
+            // Conditional branches are inverted when their target is placed next, and jumps are added
+            // where a block no longer falls through to its original successor.
+            bool layout(const profile_method& profile)
+            {
+                decode();
+                if (instructions.empty()) return false;
+
+                struct block
+                {
+                    size_t begin;
+                    size_t end;
+                    uint64_t count;
+                };
+                // Fused instructions are only counted once, the highest count of a block is used
+                const vector<bool> block_start = find_block_starts();
+                vector<block> blocks;
+                vector<size_t> block_index(instructions.size());
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    if (block_start[i]) blocks.push_back(block{ i, i, 0 });
+                    block& current = blocks.back();
+                    current.end = i + 1;
+                    current.count = std::max(current.count, profile.count(instructions[i].offset));
+                    block_index[i] = blocks.size() - 1;
+                }
+                if (blocks.size() < 2) return false;
+
+                // Linked methods always end in a return
+                const auto is_return = [](opcode op) { return op == opcode::ret || op == opcode::retv; };
+                if (!is_return(instructions.back().op)) return false;
+
+                const size_t block_count = blocks.size();
+                constexpr size_t invalid_block = size_t(-1);
+                vector<bool> placed(block_count, false);
+                vector<size_t> order;
+                order.reserve(block_count);
+                for (size_t current = 0;;)
+                {
+                    placed[current] = true;
+                    order.push_back(current);
+                    if (order.size() == block_count) break;
+
+                    size_t next = invalid_block;
+                    const auto consider = [&](size_t candidate)
+                    {
+                        if (candidate >= block_count || placed[candidate]) return;
+                        if (next == invalid_block || blocks[candidate].count > blocks[next].count) next = candidate;
+                    };
+                    const opt_instruction& last = instructions[blocks[current].end - 1];
+                    opcode inverted_op;
+                    subcode inverted_sub;
+                    if (!is_terminator(last.op)) consider(current + 1);
+                    if (last.op == opcode::br || invert_branch(last, inverted_op, inverted_sub)) consider(block_index[last.targets[0]]);
+
+                    // Cold successors are placed after the remaining hot blocks
+                    if (next == invalid_block || blocks[next].count == 0)
+                    {
+                        size_t hottest = invalid_block;
+                        for (size_t i = 0; i < block_count; i++)
+                        {
+                            if (placed[i]) continue;
+                            if (hottest == invalid_block || blocks[i].count > blocks[hottest].count) hottest = i;
+                        }
+                        if (next == invalid_block || blocks[hottest].count > 0) next = hottest;
+                    }
+                    current = next;
+                }
+
+                // The method has to end in a return after layout as well,
+                // the last block that returns is moved to the end
+                for (size_t i = block_count; i-- > 0;)
+                {
+                    if (!is_return(instructions[blocks[order[i]].end - 1].op)) continue;
+                    std::rotate(order.begin() + i, order.begin() + i + 1, order.end());
+                    break;
+                }
+
+                bool reordered = false;
+                for (size_t i = 0; i < block_count && !reordered; i++) reordered = order[i] != i;
+                if (!reordered) return false;
+
+                // Targets refer to the original instruction indices until all blocks are placed
+                vector<opt_instruction> laid_out;
+                laid_out.reserve(instructions.size() + block_count);
+                vector<size_t> remap(instructions.size());
+                for (size_t i = 0; i < block_count; i++)
+                {
+                    const block& b = blocks[order[i]];
+                    const size_t next_begin = i + 1 < block_count ? blocks[order[i + 1]].begin : invalid_instruction;
+                    for (size_t j = b.begin; j < b.end; j++)
+                    {
+                        remap[j] = laid_out.size();
+                        laid_out.push_back(std::move(instructions[j]));
+                    }
+
+                    opt_instruction& last = laid_out.back();
+                    if (is_terminator(last.op))
+                    {
+                        // Jumps to the next block are removed afterwards (jumps to the jump continue at the next block)
+                        if (last.op == opcode::br && last.targets[0] == next_begin) last.removed = true;
+                        continue;
+                    }
+
+                    const size_t fallthrough = b.end;
+                    if (fallthrough == next_begin) continue;
+
+                    opcode inverted_op;
+                    subcode inverted_sub;
+                    if (!last.targets.empty() && last.targets[0] == next_begin && invert_branch(last, inverted_op, inverted_sub))
+                    {
+                        last.op = inverted_op;
+                        last.sub = inverted_sub;
+                        last.targets[0] = fallthrough;
+                        continue;
+                    }
+
+                    opt_instruction jump;
+                    jump.op = opcode::br;
+                    jump.targets.push_back(fallthrough);
+                    laid_out.push_back(std::move(jump));
+                }
+                for (auto& ins : laid_out)
+                {
+                    for (auto& target : ins.targets) target = remap[target];
+                }
+                instructions = std::move(laid_out);
+                apply_removal();
+
+                encode();
+                return true;
+            }
+
+        private:
+            friend class propane::inline_table;
+
+            const asm_assembly_data& data;
+            asm_method& method;
+
+            void optimization_passes()
+            {
+                for (size_t pass = 0; pass < max_optimization_passes; pass++)
+                {
+                    bool changed = propagate_values();
+                    changed |= remove_unreachable_code();
+                    changed |= remove_dead_stores();
+                    changed |= remove_unused_comparisons();
+                    changed |= remove_redundant_branches();
+                    if (!changed) break;
+                }
+            }
+
+            vector<opt_instruction> instructions;
+            bool compact_encoding = false;
+
+            // Stack variables of arithmetic type of which the address is never taken.
+            // These cannot be modified other than through the instructions in this method.
+            vector<bool> tracked;
+            vector<value_state> values;
+            value_state return_value;
+            type_idx return_type = type_idx::voidtype;
+            size_t return_generation = 0;
+
+
+            // Bytecode
+            static opt_address read_address(const uint8_t*& iptr)
+            {
+                opt_address addr;
+                addr.header = read_bytecode<address_header>(iptr);
+                memset(addr.payload, 0, sizeof(addr.payload));
+                const size_t payload_size = addr.is_constant() ? get_base_type_size(addr.constant_type()) : sizeof(addr.payload);
+                memcpy(addr.payload, iptr, payload_size);
+                iptr += payload_size;
+                return addr;
+            }
+            void write_address(vector<uint8_t>& bytecode, const opt_address& addr)
+            {
+                if (compact_encoding)
+                {
+                    append_compact_address(bytecode, addr.header, addr.payload);
+                    return;
+                }
+                append_bytecode(bytecode, addr.header);
+                const size_t payload_size = addr.is_constant() ? get_base_type_size(addr.constant_type()) : sizeof(addr.payload);
+                bytecode.insert(bytecode.end(), addr.payload, addr.payload + payload_size);
+            }
+
+            void decode()
+            {
+                decode(method.bytecode, instructions);
+            }
+            static void decode(const vector<uint8_t>& bytecode, vector<opt_instruction>& instructions)
+            {
+                const uint8_t* const ibeg = bytecode.data();
+                const uint8_t* const iend = ibeg + bytecode.size();
+                const uint8_t* iptr = ibeg;
+
+                // Branch targets are decoded as offsets and translated afterwards
+                vector<size_t> instruction_index(bytecode.size() + 1, invalid_instruction);
+                while (iptr < iend)
+                {
+                    instruction_index[static_cast<size_t>(iptr - ibeg)] = instructions.size();
+
+                    opt_instruction ins;
+                    ins.offset = static_cast<uint32_t>(iptr - ibeg);
+                    ins.op = read_bytecode<opcode>(iptr);
+                    switch (ins.op)
+                    {
+                        case opcode::noop:
+                        case opcode::ret:
+                            break;
+
+                        case opcode::pdif:
+                            ins.operands.push_back(read_address(iptr));
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        case opcode::ari_not:
+                        case opcode::ari_neg:
+                        case opcode::cze:
+                        case opcode::cnz:
+                        case opcode::retv:
+                            ins.sub = read_bytecode<subcode>(iptr);
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        case opcode::br:
+                            ins.targets.push_back(read_bytecode<uint32_t>(iptr));
+                            break;
+
+                        case opcode::beq:
+                        case opcode::bne:
+                        case opcode::bgt:
+                        case opcode::bge:
+                        case opcode::blt:
+                        case opcode::ble:
+                            ins.targets.push_back(read_bytecode<uint32_t>(iptr));
+                            ins.sub = read_bytecode<subcode>(iptr);
+                            ins.operands.push_back(read_address(iptr));
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        case opcode::bze:
+                        case opcode::bnz:
+                            ins.targets.push_back(read_bytecode<uint32_t>(iptr));
+                            ins.sub = read_bytecode<subcode>(iptr);
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        case opcode::sw:
+                        {
+                            ins.operands.push_back(read_address(iptr));
+                            const uint32_t label_count = read_bytecode<uint32_t>(iptr);
+                            for (uint32_t i = 0; i < label_count; i++) ins.targets.push_back(read_bytecode<uint32_t>(iptr));
+                        }
+                        break;
+
+                        case opcode::sws:
+                        {
+                            ins.operands.push_back(read_address(iptr));
+                            const uint32_t case_count = read_bytecode<uint32_t>(iptr);
+                            for (uint32_t i = 0; i < case_count; i++) ins.case_values.push_back(read_bytecode<uint64_t>(iptr));
+                            for (uint32_t i = 0; i < case_count; i++) ins.targets.push_back(read_bytecode<uint32_t>(iptr));
+                        }
+                        break;
+
+                        case opcode::call:
+                        case opcode::callv:
+                        {
+                            if (ins.op == opcode::call) ins.method = read_bytecode<uint32_t>(iptr);
+                            else ins.operands.push_back(read_address(iptr));
+                            const uint8_t arg_count = read_bytecode<uint8_t>(iptr);
+                            for (uint8_t i = 0; i < arg_count; i++)
+                            {
+                                ins.argument_subcodes.push_back(read_bytecode<subcode>(iptr));
+                                ins.operands.push_back(read_address(iptr));
+                            }
+                        }
+                        break;
+
+                        case opcode::dump:
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        case opcode::mcpy:
+                        case opcode::mset:
+                        case opcode::mcmp:
+                            ins.sub = read_bytecode<subcode>(iptr);
+                            ins.operands.push_back(read_address(iptr));
+                            ins.operands.push_back(read_address(iptr));
+                            ins.operands.push_back(read_address(iptr));
+                            break;
+
+                        default:
+                        {
+                            // Set, conversion, arithmetic, pointer arithmetic, comparison and vector operations
+                            ASSERT((ins.op >= opcode::set && ins.op <= opcode::cle) || is_vector_op(ins.op), "Malformed opcode");
+                            ins.sub = read_bytecode<subcode>(iptr);
+                            ins.operands.push_back(read_address(iptr));
+                            ins.operands.push_back(read_address(iptr));
+                        }
+                        break;
+                    }
+                    instructions.push_back(std::move(ins));
+                }
+                ASSERT(iptr == iend, "Instruction pointer out of range");
+
+                for (auto& ins : instructions)
+                {
+                    for (auto& target : ins.targets)
+                    {
+                        ASSERT(target < instruction_index.size() && instruction_index[target] != invalid_instruction, "Invalid label offset");
+                        target = instruction_index[target];
+                    }
+                }
+            }
+
+            void encode()
+            {
+                vector<uint8_t> bytecode;
+                bytecode.reserve(method.bytecode.size());
+
+                // Labels are only retained for instructions that are still being jumped to
+                vector<bool> is_label(instructions.size(), false);
+                for (const auto& ins : instructions)
+                {
+                    for (const size_t target : ins.targets) is_label[target] = true;
+                }
+
+                vector<uint32_t> offsets(instructions.size());
+                vector<size_t> target_positions;
+                method.labels.clear();
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    const auto& ins = instructions[i];
+                    offsets[i] = static_cast<uint32_t>(bytecode.size());
+                    if (is_label[i]) method.labels.push_back(offsets[i]);
+
+                    append_bytecode(bytecode, ins.op);
+                    switch (ins.op)
+                    {
+                        case opcode::noop:
+                        case opcode::ret:
+                            break;
+
+                        case opcode::br:
+                        case opcode::beq:
+                        case opcode::bne:
+                        case opcode::bgt:
+                        case opcode::bge:
+                        case opcode::blt:
+                        case opcode::ble:
+                        case opcode::bze:
+                        case opcode::bnz:
+                        {
+                            target_positions.push_back(bytecode.size());
+                            append_bytecode(bytecode, uint32_t(ins.targets[0]));
+                            if (ins.op != opcode::br) append_bytecode(bytecode, ins.sub);
+                            for (const auto& addr : ins.operands) write_address(bytecode, addr);
+                        }
+                        break;
+
+                        case opcode::sw:
+                        {
+                            write_address(bytecode, ins.operands[0]);
+                            append_bytecode(bytecode, static_cast<uint32_t>(ins.targets.size()));
+                            for (const size_t target : ins.targets)
+                            {
+                                target_positions.push_back(bytecode.size());
+                                append_bytecode(bytecode, uint32_t(target));
+                            }
+                        }
+                        break;
+
+                        case opcode::sws:
+                        {
+                            write_address(bytecode, ins.operands[0]);
+                            append_bytecode(bytecode, static_cast<uint32_t>(ins.targets.size()));
+                            for (const uint64_t value : ins.case_values) append_bytecode(bytecode, value);
+                            for (const size_t target : ins.targets)
+                            {
+                                target_positions.push_back(bytecode.size());
+                                append_bytecode(bytecode, uint32_t(target));
+                            }
+                        }
+                        break;
+
+                        case opcode::call:
+                        case opcode::callv:
+                        {
+                            size_t arg_idx = 0;
+                            if (ins.op == opcode::call) append_bytecode(bytecode, ins.method);
+                            else write_address(bytecode, ins.operands[arg_idx++]);
+                            append_bytecode(bytecode, static_cast<uint8_t>(ins.argument_subcodes.size()));
+                            for (const subcode sub : ins.argument_subcodes)
+                            {
+                                append_bytecode(bytecode, sub);
+                                write_address(bytecode, ins.operands[arg_idx++]);
+                            }
+                        }
+                        break;
+
+                        case opcode::pdif:
+                        case opcode::dump:
+                            for (const auto& addr : ins.operands) write_address(bytecode, addr);
+                            break;
+
+                        default:
+                        {
+                            append_bytecode(bytecode, ins.sub);
+                            for (const auto& addr : ins.operands) write_address(bytecode, addr);
+                        }
+                        break;
+                    }
+                }
+
+                // Patch jumps now that all offsets are known
+                for (const size_t position : target_positions)
+                {
+                    uint32_t& target = *reinterpret_cast<uint32_t*>(bytecode.data() + position);
+                    target = offsets[target];
+                }
+
+                method.bytecode = std::move(bytecode);
+            }
+
+
+            // Helpers
+            inline type_idx stackvar_type(uint32_t index) const noexcept
+            {
+                return method.stackvars[index].type;
+            }
+            inline bool is_tracked(const opt_address& addr) const noexcept
+            {
+                return addr.is_plain_stackvar() && addr.header.index() != return_value_index && tracked[addr.header.index()];
+            }
+            inline bool is_stackvar_reference(const opt_address& addr) const noexcept
+            {
+                return addr.header.type() == address_type::stackvar && addr.header.index() != return_value_index;
+            }
+
+            void find_tracked_variables()
+            {
+                tracked.resize(method.stackvars.size());
+                for (size_t i = 0; i < method.stackvars.size(); i++)
+                {
+                    tracked[i] = is_arithmetic(method.stackvars[i].type);
+                }
+
+                // Variables of which the address is taken can be modified indirectly
+                for (const auto& ins : instructions)
+                {
+                    for (const auto& addr : ins.operands)
+                    {
+                        if (is_stackvar_reference(addr) && addr.header.prefix() == address_prefix::address_of)
+                        {
+                            tracked[addr.header.index()] = false;
+                        }
+                    }
+                }
+            }
+
+            // Instructions that directly follow a branch or are jumped to
+            // start a new block, on which known values are reset
+            vector<bool> find_block_starts() const
+            {
+                vector<bool> block_start(instructions.size(), false);
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    const auto& ins = instructions[i];
+                    for (const size_t target : ins.targets) block_start[target] = true;
+                    if ((is_branch(ins.op) || is_terminator(ins.op)) && i + 1 < instructions.size()) block_start[i + 1] = true;
+                }
+                if (!block_start.empty()) block_start[0] = true;
+                return block_start;
+            }
+
+            void get_successors(size_t idx, vector<size_t>& successors) const
+            {
+                successors.clear();
+                const auto& ins = instructions[idx];
+                successors.insert(successors.end(), ins.targets.begin(), ins.targets.end());
+                if (!is_terminator(ins.op) && idx + 1 < instructions.size()) successors.push_back(idx + 1);
+            }
+
+            // Removes all instructions that have been flagged,
+            // jumps to removed instructions continue at the next instruction
+            bool apply_removal()
+            {
+                const size_t count = instructions.size();
+                size_t remaining = 0;
+                for (const auto& ins : instructions) if (!ins.removed) remaining++;
+                if (remaining == count) return false;
+
+                vector<size_t> remap(count);
+                size_t next = remaining;
+                for (size_t i = count; i-- > 0;)
+                {
+                    if (!instructions[i].removed) next--;
+                    remap[i] = next;
+                }
+
+                size_t dst = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (instructions[i].removed) continue;
+
+                    auto& ins = instructions[i];
+                    for (auto& target : ins.targets)
+                    {
+                        target = remap[target];
+                        ASSERT(target < remaining, "Branch target out of range");
+                    }
+                    if (dst != i) instructions[dst] = std::move(ins);
+                    dst++;
+                }
+                instructions.resize(remaining);
+
+                return true;
+            }
+
+
+            // Known values
+            void reset_values()
+            {
+                values.clear();
+                values.resize(method.stackvars.size());
+                reset_return_value(type_idx::voidtype);
+            }
+            void reset_return_value(type_idx type)
+            {
+                return_value = value_state();
+                return_type = type;
+                return_generation++;
+            }
+            void set_unknown(uint32_t index)
+            {
+                values[index] = value_state();
+
+                // Copies of this variable are no longer valid
+                for (auto& it : values)
+                {
+                    if (it.kind == value_kind::stackvar_copy && it.source == index) it = value_state();
+                }
+            }
+            void set_constant(uint32_t index, const uint8_t* value)
+            {
+                set_unknown(index);
+                auto& state = values[index];
+                state.kind = value_kind::constant;
+                memset(state.value, 0, sizeof(state.value));
+                memcpy(state.value, value, get_base_type_size(stackvar_type(index)));
+            }
+
+            // Returns the constant value of an operand, if known
+            const uint8_t* get_constant(const opt_address& addr, type_idx& type) const
+            {
+                if (addr.is_constant())
+                {
+                    type = addr.constant_type();
+                    return addr.payload;
+                }
+                if (addr.is_return_value())
+                {
+                    if (return_value.kind != value_kind::constant) return nullptr;
+                    type = return_type;
+                    return return_value.value;
+                }
+                if (is_tracked(addr))
+                {
+                    const auto& state = values[addr.header.index()];
+                    if (state.kind != value_kind::constant) return nullptr;
+                    type = stackvar_type(addr.header.index());
+                    return state.value;
+                }
+                return nullptr;
+            }
+
+            // Replaces a read of a variable with a known value or an equivalent variable.
+            // The type of the operand does not change, so the subcode remains valid.
+            bool substitute(opt_address& addr)
+            {
+                if (addr.is_return_value())
+                {
+                    if (return_value.kind != value_kind::constant) return false;
+                    addr = opt_address::make_constant(return_type, return_value.value);
+                    return true;
+                }
+                if (!is_tracked(addr)) return false;
+
+                const uint32_t index = addr.header.index();
+                const auto& state = values[index];
+                switch (state.kind)
+                {
+                    case value_kind::constant:
+                    {
+                        addr = opt_address::make_constant(stackvar_type(index), state.value);
+                        return true;
+                    }
+
+                    case value_kind::stackvar_copy:
+                    {
+                        addr.header.set_index(state.source);
+                        return true;
+                    }
+
+                    case value_kind::return_value_copy:
+                    {
+                        if (state.generation != return_generation) return false;
+                        addr.header.set_index(return_value_index);
+                        return true;
+                    }
+
+                    default: break;
+                }
+                return false;
+            }
+
+            // Replaces an instruction with a set of a constant to a variable
+            void make_constant_set(opt_instruction& ins, uint32_t index, const uint8_t* value)
+            {
+                const type_idx type = stackvar_type(index);
+                ins.op = opcode::set;
+                ins.sub = translate::set(type, type);
+                ins.operands.resize(2);
+                ins.operands[1] = opt_address::make_constant(type, value);
+                ASSERT(ins.sub != subcode::invalid, "Invalid set subcode");
+            }
+
+            // Constant folding, constant/copy propagation and branch folding within blocks
+            bool propagate_values()
+            {
+                bool changed = false;
+
+                const vector<bool> block_start = find_block_starts();
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    if (block_start[i]) reset_values();
+
+                    auto& ins = instructions[i];
+                    const opcode op = ins.op;
+
+                    const size_t first_value = first_value_operand(op);
+                    for (size_t k = first_value; k < ins.operands.size(); k++)
+                    {
+                        // The signature of a virtual call cannot be constant
+                        if (op == opcode::callv && k == 0) continue;
+
+                        changed |= substitute(ins.operands[k]);
+                    }
+
+                    if (writes_lhs(op) && is_tracked(ins.operands[0]))
+                    {
+                        const uint32_t index = ins.operands[0].header.index();
+                        const type_idx type = stackvar_type(index);
+
+                        alignas(size_t) uint8_t result[sizeof(size_t)] = {};
+                        type_idx lhs_type = type_idx::invalid, rhs_type = type_idx::invalid;
+                        const uint8_t* lhs_value = get_constant(ins.operands[0], lhs_type);
+                        const uint8_t* rhs_value = ins.operands.size() > 1 ? get_constant(ins.operands[1], rhs_type) : nullptr;
+
+                        if ((op == opcode::set || op == opcode::conv) && rhs_value)
+                        {
+                            operations::conv(result, type, rhs_value, rhs_type);
+                            const bool is_canonical = op == opcode::set && ins.operands[1].is_constant() && ins.operands[1].constant_type() == type &&
+                                memcmp(ins.operands[1].payload, result, get_base_type_size(type)) == 0;
+                            if (!is_canonical)
+                            {
+                                make_constant_set(ins, index, result);
+                                changed = true;
+                            }
+                            set_constant(index, result);
+                        }
+                        else if ((is_binary_arithmetic(op) && rhs_value && lhs_value) || (is_unary_arithmetic(op) && lhs_value))
+                        {
+                            memcpy(result, lhs_value, get_base_type_size(type));
+                            alignas(size_t) uint8_t rhs[sizeof(size_t)] = {};
+                            if (rhs_value) operations::conv(rhs, type, rhs_value, rhs_type);
+                            if (fold_arithmetic(op, type, result, rhs))
+                            {
+                                make_constant_set(ins, index, result);
+                                set_constant(index, result);
+                                changed = true;
+                            }
+                            else
+                            {
+                                set_unknown(index);
+                            }
+                        }
+                        else if (op == opcode::set && is_tracked(ins.operands[1]) && stackvar_type(ins.operands[1].header.index()) == type)
+                        {
+                            const uint32_t source = ins.operands[1].header.index();
+                            set_unknown(index);
+                            if (source != index)
+                            {
+                                values[index].kind = value_kind::stackvar_copy;
+                                values[index].source = source;
+                            }
+                        }
+                        else if (op == opcode::set && ins.operands[1].is_return_value() && return_type == type)
+                        {
+                            set_unknown(index);
+                            values[index].kind = value_kind::return_value_copy;
+                            values[index].generation = return_generation;
+                        }
+                        else
+                        {
+                            set_unknown(index);
+                        }
+                        continue;
+                    }
+
+                    switch (op)
+                    {
+                        case opcode::ceq:
+                        case opcode::cne:
+                        case opcode::cgt:
+                        case opcode::cge:
+                        case opcode::clt:
+                        case opcode::cle:
+                        case opcode::cze:
+                        case opcode::cnz:
+                        {
+                            int32_t result;
+                            if (evaluate_comparison(op, ins, result))
+                            {
+                                reset_return_value(type_idx::i32);
+                                return_value.kind = value_kind::constant;
+                                memset(return_value.value, 0, sizeof(return_value.value));
+                                memcpy(return_value.value, &result, sizeof(result));
+                            }
+                            else
+                            {
+                                reset_return_value(type_idx::i32);
+                            }
+                        }
+                        break;
+
+                        case opcode::cmp:
+                            reset_return_value(type_idx::i32);
+                            break;
+
+                        case opcode::pdif:
+                            reset_return_value(derive_type_index_v<offset_t>);
+                            break;
+
+                        case opcode::mcmp:
+                            reset_return_value(type_idx::i32);
+                            break;
+
+                        case opcode::call:
+                            reset_return_value(data.signatures[data.methods[method_idx(ins.method)].signature].return_type);
+                            break;
+
+                        case opcode::callv:
+                            // Return type is not tracked for virtual calls
+                            reset_return_value(type_idx::invalid);
+                            break;
+
+                        case opcode::beq:
+                        case opcode::bne:
+                        case opcode::bgt:
+                        case opcode::bge:
+                        case opcode::blt:
+                        case opcode::ble:
+                        case opcode::bze:
+                        case opcode::bnz:
+                        {
+                            int32_t result;
+                            if (evaluate_comparison(op - (opcode::br - opcode::cmp), ins, result))
+                            {
+                                fold_branch(ins, result != 0);
+                                changed = true;
+                            }
+                        }
+                        break;
+
+                        case opcode::sw:
+                        {
+                            type_idx type;
+                            uint32_t idx;
+                            const uint8_t* value = get_constant(ins.operands[0], type);
+                            if (value && read_switch_index(type, value, idx))
+                            {
+                                if (idx < ins.targets.size())
+                                {
+                                    const size_t target = ins.targets[idx];
+                                    ins.targets.assign(1, target);
+                                    fold_branch(ins, true);
+                                }
+                                else
+                                {
+                                    fold_branch(ins, false);
+                                }
+                                changed = true;
+                            }
+                        }
+                        break;
+
+                        case opcode::sws:
+                        {
+                            type_idx type;
+                            uint64_t switch_value;
+                            const uint8_t* value = get_constant(ins.operands[0], type);
+                            if (value && read_switch_value(type, value, switch_value))
+                            {
+                                const auto find = std::find(ins.case_values.begin(), ins.case_values.end(), switch_value);
+                                if (find != ins.case_values.end())
+                                {
+                                    const size_t target = ins.targets[static_cast<size_t>(find - ins.case_values.begin())];
+                                    ins.targets.assign(1, target);
+                                    fold_branch(ins, true);
+                                }
+                                else
+                                {
+                                    fold_branch(ins, false);
+                                }
+                                changed = true;
+                            }
+                        }
+                        break;
+
+                        default: break;
+                    }
+                }
+
+                return apply_removal() || changed;
+            }
+
+            // Evaluates a comparison (ceq to cnz) of which all operands are known
+            bool evaluate_comparison(opcode op, const opt_instruction& ins, int32_t& result) const
+            {
+                type_idx lhs_type, rhs_type;
+                const uint8_t* lhs = get_constant(ins.operands[0], lhs_type);
+                if (!lhs) return false;
+
+                if (op == opcode::cze || op == opcode::cnz)
+                {
+                    const bool zero = is_zero(lhs_type, lhs);
+                    result = op == opcode::cze ? zero : !zero;
+                    return true;
+                }
+
+                // Only same-type comparisons are evaluated, mixed types are
+                // promoted differently depending on the combination
+                const uint8_t* rhs = get_constant(ins.operands[1], rhs_type);
+                if (!rhs || lhs_type != rhs_type) return false;
+                return fold_comparison(op, lhs_type, lhs, rhs, result);
+            }
+
+            bool inline_pass(const inline_table& table, size_t& size, size_t size_limit, size_t& return_value_size)
+            {
+                const vector<bool> block_start = find_block_starts();
+
+                // Targets of the caller instructions are remapped afterwards, inlined targets are final
+                vector<opt_instruction> result;
+                vector<bool> is_inlined;
+                result.reserve(instructions.size());
+                is_inlined.reserve(instructions.size());
+                vector<size_t> remap(instructions.size());
+                vector<size_t> positions;
+                bool changed = false;
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    opt_instruction& ins = instructions[i];
+                    remap[i] = result.size();
+
+                    const inline_candidate* callee = ins.op == opcode::call ? table.find(method_idx(ins.method)) : nullptr;
+                    if (!callee || method_idx(ins.method) == method.index || size + callee->bytecode_size > size_limit ||
+                        method.stackvars.size() + callee->parameters.size() + callee->stackvars.size() + 1 >= return_value_index)
+                    {
+                        result.push_back(std::move(ins));
+                        is_inlined.push_back(false);
+                        continue;
+                    }
+                    size += callee->bytecode_size;
+                    return_value_size = std::max(return_value_size, callee->return_value_size);
+                    changed = true;
+
+                    // Parameters and stack variables of the callee are appended to the stack variables of the caller
+                    const uint32_t parameter_base = static_cast<uint32_t>(method.stackvars.size());
+                    for (const auto& p : callee->parameters) method.stackvars.push_back(stackvar(p.type));
+                    const uint32_t stackvar_base = static_cast<uint32_t>(method.stackvars.size());
+                    for (const auto& sv : callee->stackvars) method.stackvars.push_back(stackvar(sv.type));
+                    uint32_t return_index = return_value_index;
+                    if (callee->return_type != type_idx::voidtype)
+                    {
+                        return_index = static_cast<uint32_t>(method.stackvars.size());
+                        method.stackvars.push_back(stackvar(callee->return_type));
+                    }
+
+                    // Arguments (the subcodes are the same as the subcodes of setting the parameters)
+                    for (size_t k = 0; k < ins.argument_subcodes.size(); k++)
+                    {
+                        opt_instruction& set = result.emplace_back();
+                        set.op = opcode::set;
+                        set.sub = ins.argument_subcodes[k];
+                        set.operands.push_back(make_stackvar(parameter_base + static_cast<uint32_t>(k)));
+                        set.operands.push_back(ins.operands[k]);
+                        is_inlined.push_back(true);
+                    }
+
+                    // Position of every callee instruction, returns are replaced by a set and a jump
+                    // (the jump is left out for the last instruction)
+                    const size_t count = callee->instructions.size();
+                    positions.resize(count);
+                    size_t position = result.size();
+                    for (size_t k = 0; k < count; k++)
+                    {
+                        positions[k] = position;
+                        const opcode op = callee->instructions[k].op;
+                        const bool is_last = k + 1 == count;
+                        if (op == opcode::ret) position += is_last ? 0 : 1;
+                        else if (op == opcode::retv) position += is_last ? 1 : 2;
+                        else position++;
+                    }
+                    const size_t end = position;
+
+                    for (size_t k = 0; k < count; k++)
+                    {
+                        const opt_instruction& src = callee->instructions[k];
+                        const bool is_last = k + 1 == count;
+                        if (src.op == opcode::ret || src.op == opcode::retv)
+                        {
+                            if (src.op == opcode::retv)
+                            {
+                                opt_instruction& set = result.emplace_back();
+                                set.op = opcode::set;
+                                set.sub = src.sub;
+                                set.operands.push_back(make_stackvar(return_index));
+                                set.operands.push_back(relocate(src.operands[0], parameter_base, stackvar_base));
+                                is_inlined.push_back(true);
+                            }
+                            if (!is_last)
+                            {
+                                opt_instruction& jump = result.emplace_back();
+                                jump.op = opcode::br;
+                                jump.targets.push_back(end);
+                                is_inlined.push_back(true);
+                            }
+                            continue;
+                        }
+
+                        opt_instruction& copy = result.emplace_back(src);
+                        for (auto& addr : copy.operands) addr = relocate(addr, parameter_base, stackvar_base);
+                        for (auto& target : copy.targets) target = positions[target];
+                        is_inlined.push_back(true);
+                    }
+                    ASSERT(result.size() == end, "Inlined instruction count mismatch");
+
+                    // Reads of the return value that follow the call read the returned value instead
+                    if (return_index != return_value_index)
+                    {
+                        for (size_t j = i + 1; j < instructions.size() && !block_start[j]; j++)
+                        {
+                            auto& next = instructions[j];
+                            for (auto& addr : next.operands)
+                            {
+                                if (addr.header.type() == address_type::stackvar && addr.header.index() == return_value_index) addr.header.set_index(return_index);
+                            }
+                            if (sets_return_value(next.op) || is_branch(next.op) || is_terminator(next.op)) break;
+                        }
+                    }
+                }
+                if (changed)
+                {
+                    for (size_t i = 0; i < result.size(); i++)
+                    {
+                        if (is_inlined[i]) continue;
+                        for (auto& target : result[i].targets) target = remap[target];
+                    }
+                }
+                instructions = std::move(result);
+                return changed;
+            }
+            // Stack variables added by inlining that are no longer referenced after optimizing are removed
+            void remove_unused_stackvars(size_t first)
+            {
+                constexpr uint32_t unused = return_value_index;
+                vector<uint32_t> remap(method.stackvars.size(), unused);
+                for (size_t i = 0; i < first; i++) remap[i] = static_cast<uint32_t>(i);
+                for (const auto& ins : instructions)
+                {
+                    for (const auto& addr : ins.operands)
+                    {
+                        if (is_stackvar_reference(addr) && addr.header.index() >= first) remap[addr.header.index()] = 0;
+                    }
+                }
+
+                uint32_t count = static_cast<uint32_t>(first);
+                for (size_t i = first; i < method.stackvars.size(); i++)
+                {
+                    if (remap[i] == unused) continue;
+                    remap[i] = count;
+                    method.stackvars[count++] = method.stackvars[i];
+                }
+                if (count == method.stackvars.size()) return;
+                method.stackvars.resize(count);
+
+                for (auto& ins : instructions)
+                {
+                    for (auto& addr : ins.operands)
+                    {
+                        if (is_stackvar_reference(addr)) addr.header.set_index(remap[addr.header.index()]);
+                    }
+                }
+            }
+            static opt_address make_stackvar(uint32_t index) noexcept
+            {
+                opt_address result;
+                result.header = address_header(address_type::stackvar, address_prefix::none, address_modifier::none, index);
+                memset(result.payload, 0, sizeof(result.payload));
+                return result;
+            }
+            // Parameters and stack variables of inlined bytecode refer to stack variables of the caller
+            static opt_address relocate(opt_address addr, uint32_t parameter_base, uint32_t stackvar_base) noexcept
+            {
+                if (addr.header.type() == address_type::parameter)
+                {
+                    addr.header.set_type(address_type::stackvar);
+                    addr.header.set_index(parameter_base + addr.header.index());
+                }
+                else if (addr.header.type() == address_type::stackvar && addr.header.index() != return_value_index)
+                {
+                    addr.header.set_index(stackvar_base + addr.header.index());
+                }
+                return addr;
+            }
+
+            // Opposite condition of a conditional branch, for branches of which the inverted condition
+            // is exactly equivalent (ordered comparisons of floating point values are false on NaN)
+            static bool invert_branch(const opt_instruction& ins, opcode& op, subcode& sub)
+            {
+                switch (ins.op)
+                {
+                    case opcode::beq: op = opcode::bne; break;
+                    case opcode::bne: op = opcode::beq; break;
+                    case opcode::bgt: op = opcode::ble; break;
+                    case opcode::bge: op = opcode::blt; break;
+                    case opcode::blt: op = opcode::bge; break;
+                    case opcode::ble: op = opcode::bgt; break;
+                    case opcode::bze: op = opcode::bnz; break;
+                    case opcode::bnz: op = opcode::bze; break;
+                    default: return false;
+                }
+
+                // Find the operand types the subcode was resolved from
+                const opcode cmp_op = ins.op - (opcode::br - opcode::cmp);
+                const bool is_ordered = ins.op >= opcode::bgt && ins.op <= opcode::ble;
+                for (type_idx lhs = type_idx::i8; lhs <= type_idx::f64; lhs = type_idx(size_t(lhs) + 1))
+                {
+                    for (type_idx rhs = type_idx::i8; rhs <= type_idx::f64; rhs = type_idx(size_t(rhs) + 1))
+                    {
+                        if (translate::cmp(cmp_op, lhs, rhs) != ins.sub) continue;
+                        if (is_ordered && (is_floating_point(lhs) || is_floating_point(rhs))) return false;
+
+                        sub = translate::cmp(op - (opcode::br - opcode::cmp), lhs, rhs);
+                        return sub != subcode::invalid;
+                    }
+                }
+                return false;
+            }
+
+            // Replaces a branch with a jump (if taken) or removes it
+            void fold_branch(opt_instruction& ins, bool taken)
+            {
+                if (taken)
+                {
+                    ins.op = opcode::br;
+                    ins.sub = subcode::invalid;
+                    ins.operands.clear();
+                    ins.targets.resize(1);
+                }
+                else
+                {
+                    ins.removed = true;
+                }
+            }
+
+            // Removes instructions that cannot be reached from the method entry
+            bool remove_unreachable_code()
+            {
+                if (instructions.empty()) return false;
+
+                vector<bool> reachable(instructions.size(), false);
+                vector<size_t> queue(1, 0);
+                vector<size_t> successors;
+                reachable[0] = true;
+                while (!queue.empty())
+                {
+                    const size_t idx = queue.back();
+                    queue.pop_back();
+
+                    get_successors(idx, successors);
+                    for (const size_t next : successors)
+                    {
+                        if (reachable[next]) continue;
+                        reachable[next] = true;
+                        queue.push_back(next);
+                    }
+                }
+
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    if (!reachable[i]) instructions[i].removed = true;
+                }
+                return apply_removal();
+            }
+
+            // Removes writes to variables that are never read afterwards
+            bool remove_dead_stores()
+            {
+                const size_t count = instructions.size();
+                const size_t words = (method.stackvars.size() + 63) / 64;
+                if (words == 0) return false;
+
+                // Per-instruction used and defined variables
+                vector<uint64_t> use(count * words, 0), def(count * words, 0);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto& ins = instructions[i];
+                    for (size_t k = 0; k < ins.operands.size(); k++)
+                    {
+                        const auto& addr = ins.operands[k];
+                        if (!is_tracked(addr)) continue;
+
+                        const uint32_t index = addr.header.index();
+                        const uint64_t bit = uint64_t(1) << (index % 64);
+                        const bool is_lhs = k == 0 && writes_lhs(ins.op);
+                        if (is_lhs) def[i * words + index / 64] |= bit;
+                        if (!is_lhs || (ins.op != opcode::set && ins.op != opcode::conv)) use[i * words + index / 64] |= bit;
+                    }
+                }
+
+                // Backwards liveness analysis, iterated until stable
+                vector<uint64_t> live_in(count * words, 0), live_out(count * words, 0);
+                vector<size_t> successors;
+                for (bool updated = true; updated;)
+                {
+                    updated = false;
+                    for (size_t i = count; i-- > 0;)
+                    {
+                        get_successors(i, successors);
+                        for (size_t w = 0; w < words; w++)
+                        {
+                            uint64_t out = 0;
+                            for (const size_t next : successors) out |= live_in[next * words + w];
+                            live_out[i * words + w] = out;
+
+                            const uint64_t in = use[i * words + w] | (out & ~def[i * words + w]);
+                            if (in != live_in[i * words + w])
+                            {
+                                live_in[i * words + w] = in;
+                                updated = true;
+                            }
+                        }
+                    }
+                }
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    auto& ins = instructions[i];
+
+                    // Division can raise an exception at runtime, which is retained
+                    if (!writes_lhs(ins.op) || ins.op == opcode::ari_div || ins.op == opcode::ari_mod) continue;
+                    if (!is_tracked(ins.operands[0])) continue;
+
+                    const uint32_t index = ins.operands[0].header.index();
+                    const uint64_t bit = uint64_t(1) << (index % 64);
+                    if ((live_out[i * words + index / 64] & bit) == 0) ins.removed = true;
+                }
+                return apply_removal();
+            }
+
+            // Removes comparisons of which the return value is never read
+            bool remove_unused_comparisons()
+            {
+                const vector<bool> block_start = find_block_starts();
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    auto& ins = instructions[i];
+                    if (!sets_return_value(ins.op) || ins.op == opcode::call || ins.op == opcode::callv) continue;
+
+                    bool is_read = false;
+                    for (size_t j = i + 1; j < instructions.size() && !is_read && !block_start[j]; j++)
+                    {
+                        const auto& next = instructions[j];
+                        for (const auto& addr : next.operands)
+                        {
+                            if (addr.header.type() == address_type::stackvar && addr.header.index() == return_value_index) is_read = true;
+                        }
+
+                        if (sets_return_value(next.op) || is_branch(next.op) || is_terminator(next.op)) break;
+                    }
+                    if (!is_read) ins.removed = true;
+                }
+                return apply_removal();
+            }
+
+            // Removes no-ops and jumps to the next instruction
+            bool remove_redundant_branches()
+            {
+                for (size_t i = 0; i < instructions.size(); i++)
+                {
+                    auto& ins = instructions[i];
+                    if (ins.op == opcode::noop)
+                    {
+                        // Keep the last instruction, jumps can still target it
+                        if (i + 1 < instructions.size()) ins.removed = true;
+                    }
+                    else if (ins.op >= opcode::br && ins.op <= opcode::bnz)
+                    {
+                        // Conditional branches have no side effects other than the jump
+                        // (the return value is reset in either case)
+                        if (ins.targets[0] == i + 1) ins.removed = true;
+                    }
+                }
+                return apply_removal();
+            }
+        };
+    }
+
+    void optimize_method(const asm_assembly_data& data, asm_method& method)
+    {
+        if (method.is_external() || method.bytecode.empty()) return;
+
+        method_optimizer(data, method).optimize();
+    }
+    inline_table::inline_table(const asm_assembly_data& data, const vector<asm_method>& sources)
+    {
+        candidates.resize(data.methods.size());
+        for (const auto& m : sources)
+        {
+            if (m.is_external() || m.bytecode.empty() || !candidates.is_valid_index(m.index)) continue;
+
+            std::unique_ptr<inline_candidate> candidate(new inline_candidate());
+            method_optimizer::decode(m.bytecode, candidate->instructions);
+
+            // Recursive methods would inline themselves
+            bool is_recursive = false;
+            for (const auto& ins : candidate->instructions)
+            {
+                if (ins.op == opcode::call && method_idx(ins.method) == m.index) is_recursive = true;
+            }
+            if (is_recursive) continue;
+
+            const asm_signature& signature = data.signatures[m.signature];
+            candidate->parameters = signature.parameters;
+            candidate->stackvars = m.stackvars;
+            candidate->return_type = signature.return_type;
+            candidate->return_value_size = m.total_stack_size - m.method_stack_size;
+            candidate->bytecode_size = m.bytecode.size();
+            candidates[m.index] = std::move(candidate);
+        }
+    }
+    inline_table::~inline_table()
+    {
+
+    }
+
+    void inline_calls(const asm_assembly_data& data, asm_method& method, const inline_table& table, size_t depth_limit)
+    {
+        if (method.is_external() || method.bytecode.empty() || depth_limit == 0) return;
+
+        method_optimizer(data, method).inline_calls(table, depth_limit);
+    }
+    void compact_method(const asm_assembly_data& data, asm_method& method)
+    {
+        if (method.is_external() || method.bytecode.empty()) return;
+
+        method_optimizer(data, method).compact();
+    }
+    void layout_method(const asm_assembly_data& data, asm_method& method, const profile_method& profile)
+    {
+        if (method.is_external() || method.bytecode.empty() || profile.total == 0) return;
+
+        method_optimizer(data, method).layout(profile);
+    }
+}
\ No newline at end of file
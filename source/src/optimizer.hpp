@@ -0,0 +1,50 @@
+#ifndef _HEADER_OPTIMIZER
+#define _HEADER_OPTIMIZER
+
+#include "assembly_data.hpp"
+#include "link_profile.hpp"
+
+#include <memory>
+
+namespace propane
+{
+    // Link-time optimizer, operates on the resolved bytecode of a single method.
+    // Performs constant folding and propagation, copy propagation, dead store
+    // elimination, branch folding and unreachable code/label elimination.
+    // The assembly data is only read, which allows methods to be optimized
+    // concurrently (as long as the method itself is not used elsewhere).
+    void optimize_method(const asm_assembly_data& data, asm_method& method);
+    // Methods that can be inlined into their callers, decoded up front (the table does not refer
+    // to the sources, so callers can be rewritten concurrently with the methods they call)
+    class inline_table final
+    {
+    public:
+        inline_table(const asm_assembly_data& data, const vector<asm_method>& sources);
+        ~inline_table();
+
+        inline_table(const inline_table&) = delete;
+        inline_table& operator=(const inline_table&) = delete;
+
+        inline const struct inline_candidate* find(method_idx method) const noexcept
+        {
+            return candidates.is_valid_index(method) ? candidates[method].get() : nullptr;
+        }
+
+    private:
+        indexed_vector<method_idx, std::unique_ptr<struct inline_candidate>> candidates;
+    };
+    // Inlines calls to the methods of the table into a resolved method, and optimizes the result.
+    // Calls made by the inlined methods are inlined as well, up to the depth limit.
+    void inline_calls(const asm_assembly_data& data, asm_method& method, const inline_table& table, size_t depth_limit);
+
+    // Profile guided block layout of a resolved method, places the most executed paths of
+    // the method such that they fall through. The profile should match the resolved bytecode.
+    void layout_method(const asm_assembly_data& data, asm_method& method, const profile_method& profile);
+
+    // Re-encodes the standard bytecode of a resolved method in the compact encoding
+    // (see bytecode_encoding::compact). This should be the last pass applied to a method,
+    // as the other passes only operate on the standard encoding.
+    void compact_method(const asm_assembly_data& data, asm_method& method);
+}
+
+#endif
\ No newline at end of file
@@ -5,13 +5,22 @@
 #include "errors.hpp"
 #include "propane_literals.hpp"
 #include "parser_tokens.hpp"
+#include "host.hpp"
 
+#include <array>
 #include <charconv>
 #include <system_error>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARSER_SSE2 1
+#include <emmintrin.h>
+#else
+#define PARSER_SSE2 0
+#endif
+
 #define VALIDATE(errc, expr, ...) ENSURE_WITH_META(errc, this->get_meta(), expr, propane::generator_exception, __VA_ARGS__)
 
-#define VALIDATE_FILE_OPEN(expr, file_path) VALIDATE(ERRC::PRS_FILE_EXCEPTION, expr, \
+#define VALIDATE_FILE_OPEN(expr, file_path) ENSURE_WITH_META(ERRC::PRS_FILE_EXCEPTION, propane::file_meta(strip_filepath(file_path), 0), expr, propane::generator_exception, \
     "Failed to open file: \"%\"", file_path)
 #define UNEXPECTED_EXPRESSION(expr, expression) VALIDATE(ERRC::PRS_UNEXPECTED_EXPRESSION, expr, \
     "Unexpected expression: '%'", expression)
@@ -78,164 +87,190 @@ namespace propane
         multi,
     };
 
+    // Character classes of the tokenizer
+    enum : uint8_t
+    {
+        char_whitespace = 1 << 0,
+        char_identifier_first = 1 << 1,
+        char_identifier = 1 << 2,
+        char_literal = 1 << 3,
+    };
+    constexpr std::array<uint8_t, 256> make_char_class_table() noexcept
+    {
+        std::array<uint8_t, 256> table = {};
+        table[uint8_t(' ')] = table[uint8_t('\r')] = table[uint8_t('\t')] = table[uint8_t('\v')] = char_whitespace;
+        for (size_t c = 0; c < 256; c++)
+        {
+            const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            const bool digit = c >= '0' && c <= '9';
+            if (alpha || c == '_' || c == '$') table[c] |= char_identifier_first | char_identifier;
+            if (digit) table[c] |= char_identifier;
+            if (alpha || digit || c == '.' || c == '-') table[c] |= char_literal;
+        }
+        return table;
+    }
+    constexpr std::array<uint8_t, 256> char_class = make_char_class_table();
+
+#if PARSER_SSE2
+    inline uint32_t count_trailing_zeroes(uint32_t mask) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return uint32_t(index);
+#else
+        return uint32_t(__builtin_ctz(mask));
+#endif
+    }
+#endif
+
+    // Find the next '*' or newline (the only characters that can end a comment)
+    inline const char* find_comment_end(const char* ptr, const char* end) noexcept
+    {
+#if PARSER_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i asterisk = _mm_set1_epi8('*');
+        for (; end - ptr >= 16; ptr += 16)
+        {
+            const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            const uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, newline), _mm_cmpeq_epi8(chars, asterisk))));
+            if (mask != 0) return ptr + count_trailing_zeroes(mask);
+        }
+#endif
+        for (; ptr < end; ptr++)
+        {
+            if (*ptr == '\n' || *ptr == '*') break;
+        }
+        return ptr;
+    }
+
     // Experimental implementation of propane generator
     class parser_impl final : public generator
     {
     public:
         NOCOPY_CLASS_DEFAULT(parser_impl) = delete;
 
-        parser_impl(const char* file_path) :
+        // Source text is expected to end with a newline (see source_text)
+        parser_impl(const char* file_path, string_view file_text) :
             generator(strip_filepath(file_path))
         {
-            block<char> file_text;
-
-            // Read file (and close thereafter)
-            {
-                ifstream file(file_path, std::ios::binary);
-                VALIDATE_FILE_OPEN(file.is_open(), file_path);
-                file.seekg(0, file.end);
-                const size_t file_size = static_cast<size_t>(file.tellg());
-                file.seekg(0, file.beg);
-                // Add one extra newline
-                file_text = block<char>(static_cast<size_t>(file_size) + 1);
-                file_text[file_size] = '\n';
-                file.read((char*)file_text.data(), file_size);
-            }
+            parse_text(file_text);
+        }
+        parser_impl(const char* file_path, string_view file_text, identifier_interner& interner) :
+            generator(strip_filepath(file_path), interner)
+        {
+            parse_text(file_text);
+        }
 
-            const char* beg = file_text.data();
-            const char* end = beg + file_text.size();
-            const char* ptr = beg;
+    private:
+        void parse_text(string_view file_text)
+        {
+            const char* ptr = file_text.data();
+            const char* const end = ptr + file_text.size();
+            tokens.reserve(file_text.size() / 4);
             line_num = 1;
-            set_line_number(line_num);
             comment_type comment = comment_type::none;
             while (ptr < end)
             {
-                const char c = *ptr++;
-                if (c == '\n')
+                if (comment != comment_type::none)
                 {
-                    set_line_number(++line_num);
-                    beg = ptr;
-                    if (comment == comment_type::single)
+                    // Skip to the next character that can end the comment
+                    ptr = find_comment_end(ptr, end);
+                    if (ptr == end) break;
+                    if (*ptr++ == '\n')
+                    {
+                        line_num++;
+                        if (comment == comment_type::single)
+                        {
+                            comment = comment_type::none;
+                        }
+                    }
+                    else if (*ptr == '/')
                     {
+                        ptr++;
                         comment = comment_type::none;
                     }
                     continue;
                 }
 
-                if (comment != comment_type::none)
+                const char* const beg = ptr;
+                const char c = *ptr++;
+                const uint8_t flags = char_class[uint8_t(c)];
+                if (flags & char_whitespace)
                 {
-                    if (c == '*' && *ptr == '/')
-                    {
-                        ptr++;
-                        comment = comment_type::none;
-                    }
+                    continue;
+                }
+                if (c == '\n')
+                {
+                    line_num++;
                     continue;
                 }
 
-                switch (c)
+                if (flags & char_identifier_first)
                 {
-                    case ' ':
-                    case '\r':
-                    case '\t':
-                    case '\v':
-                        break;
+                    while (char_class[uint8_t(*ptr)] & char_identifier) ptr++;
 
-                    case '/':
+                    const string_view str = string_view(beg, ptr - beg);
+                    auto lookup_result = token_string_lookup_table.try_find_token(str);
+                    if (lookup_result.type != token_type::invalid)
                     {
-                        const char n = *ptr++;
-                        switch (n)
-                        {
-                            case '/': comment = comment_type::single; break;
-                            case '*': comment = comment_type::multi; break;
-                            default: UNEXPECTED_CHARACTER(false, c); break;
-                        }
-                        break;
+                        // Treat as keyword
+                        add_token(lookup_result.type, lookup_result.str);
                     }
-                    break;
+                    else
+                    {
+                        // Treat as identifier
+                        add_token(token_type::identifier, str);
+                    }
+                }
+                else if (is_literal(c) && *ptr != '>')
+                {
+                    while (char_class[uint8_t(*ptr)] & char_literal) ptr++;
 
-                    default:
+                    // Literal
+                    add_token(token_type::literal, string_view(beg, ptr - beg));
+                }
+                else
+                {
+                    switch (c)
                     {
-                        if (is_identifier(c, true))
+                        case '/':
                         {
-                            for (; ptr < end;)
+                            const char n = *ptr++;
+                            switch (n)
                             {
-                                const char n = *ptr;
-                                if (!is_identifier(n, false))
-                                {
-                                    const auto len = ptr - beg;
-                                    if (len > 0)
-                                    {
-                                        const string_view str = string_view(beg, len);
-                                        auto lookup_result = token_string_lookup_table.try_find_token(str);
-                                        if (lookup_result.type != token_type::invalid)
-                                        {
-                                            // Treat as keyword
-                                            add_token(lookup_result.type, lookup_result.str);
-                                        }
-                                        else
-                                        {
-                                            // Treat as identifier
-                                            add_token(token_type::identifier, str);
-                                        }
-                                    }
-                                    break;
-                                }
-                                ptr++;
+                                case '/': comment = comment_type::single; break;
+                                case '*': comment = comment_type::multi; break;
+                                default: validate_character(false, c); break;
                             }
                         }
-                        else if (is_literal(c) && *ptr != '>')
-                        {
-                            for (; ptr < end;)
-                            {
-                                const char n = *ptr;
-                                if (!((n >= '0' && n <= '9') || (n >= 'a' && n <= 'z') || (n >= 'A' && n <= 'Z') || n == '.' || n == '-'))
-                                {
-                                    const auto len = ptr - beg;
-                                    if (len > 0)
-                                    {
-                                        // Literal
-                                        const string_view str = string_view(beg, len);
-                                        add_token(token_type::literal, str);
-                                        break;
-                                    }
-                                }
-                                ptr++;
-                            }
-                        }
-                        else
+                        break;
+                        case '{': add_token(token_type::lbrace, ptr, 1); break;
+                        case '}': add_token(token_type::rbrace, ptr, 1); break;
+                        case '[': add_token(token_type::lbracket, ptr, 1); break;
+                        case ']': add_token(token_type::rbracket, ptr, 1); break;
+                        case '(': add_token(token_type::lparen, ptr, 1); break;
+                        case ')': add_token(token_type::rparen, ptr, 1); break;
+                        case '-':
                         {
-                            switch (c)
-                            {
-                                case '{': add_token(token_type::lbrace, ptr, 1); break;
-                                case '}': add_token(token_type::rbrace, ptr, 1); break;
-                                case '[': add_token(token_type::lbracket, ptr, 1); break;
-                                case ']': add_token(token_type::rbracket, ptr, 1); break;
-                                case '(': add_token(token_type::lparen, ptr, 1); break;
-                                case ')': add_token(token_type::rparen, ptr, 1); break;
-                                case '-':
-                                {
-                                    const char n = *ptr++;
-                                    UNEXPECTED_CHARACTER(n == '>', c);
-                                    add_token(token_type::deref, ptr, 2);
-                                    break;
-                                }
-                                break;
-                                case '*': add_token(token_type::asterisk, ptr, 1); break;
-                                case '&': add_token(token_type::ampersand, ptr, 1); break;
-                                case '!': add_token(token_type::exclamation, ptr, 1); break;
-                                case '^': add_token(token_type::circumflex, ptr, 1); break;
-                                case ':': add_token(token_type::colon, ptr, 1); break;
-                                case ',': add_token(token_type::comma, ptr, 1); break;
-                                case '.': add_token(token_type::period, ptr, 1); break;
-                                default: UNEXPECTED_CHARACTER(false, c); break;
-                            }
+                            const char n = *ptr++;
+                            validate_character(n == '>', c);
+                            add_token(token_type::deref, ptr, 2);
                         }
+                        break;
+                        case '*': add_token(token_type::asterisk, ptr, 1); break;
+                        case '&': add_token(token_type::ampersand, ptr, 1); break;
+                        case '!': add_token(token_type::exclamation, ptr, 1); break;
+                        case '^': add_token(token_type::circumflex, ptr, 1); break;
+                        case ':': add_token(token_type::colon, ptr, 1); break;
+                        case ',': add_token(token_type::comma, ptr, 1); break;
+                        case '.': add_token(token_type::period, ptr, 1); break;
+                        default: validate_character(false, c); break;
                     }
-                    break;
                 }
-                beg = ptr;
             }
 
+            set_line_number(line_num);
             UNEXPECTED_EOF(current_scope == definition_type::none);
             UNTERMINATED_COMMENT(comment != comment_type::multi);
 
@@ -244,7 +279,16 @@ namespace propane
             if (tokens.size() > 0) evaluate();
         }
 
-    private:
+        // The line number is only updated on error during tokenization
+        void validate_character(bool expr, char c)
+        {
+            if (!expr)
+            {
+                set_line_number(line_num);
+                UNEXPECTED_CHARACTER(false, c);
+            }
+        }
+
         void add_token(token_type type, const char* c, size_t len)
         {
             tokens.push_back(token(type, string_view(c - len, len), line_num));
@@ -336,11 +380,29 @@ namespace propane
                             case token_type::op_bze: write_bze(ptr); continue;
                             case token_type::op_bnz: write_bnz(ptr); continue;
                             case token_type::op_sw: write_sw(ptr); continue;
+                            case token_type::op_sws: write_sws(ptr); continue;
                             case token_type::op_call: write_call(ptr); continue;
                             case token_type::op_callv: write_callv(ptr); continue;
                             case token_type::op_ret: write_ret(); continue;
                             case token_type::op_retv: write_retv(ptr); continue;
                             case token_type::op_dump: write_dump(ptr); continue;
+                            case token_type::op_vadd: write_vadd(ptr); continue;
+                            case token_type::op_vsub: write_vsub(ptr); continue;
+                            case token_type::op_vmul: write_vmul(ptr); continue;
+                            case token_type::op_vdiv: write_vdiv(ptr); continue;
+                            case token_type::op_vmin: write_vmin(ptr); continue;
+                            case token_type::op_vmax: write_vmax(ptr); continue;
+                            case token_type::op_vceq: write_vceq(ptr); continue;
+                            case token_type::op_vcne: write_vcne(ptr); continue;
+                            case token_type::op_vcgt: write_vcgt(ptr); continue;
+                            case token_type::op_vcge: write_vcge(ptr); continue;
+                            case token_type::op_vclt: write_vclt(ptr); continue;
+                            case token_type::op_vcle: write_vcle(ptr); continue;
+                            case token_type::op_vshf: write_vshf(ptr); continue;
+
+                            case token_type::op_mcpy: write_mcpy(ptr); continue;
+                            case token_type::op_mset: write_mset(ptr); continue;
+                            case token_type::op_mcmp: write_mcmp(ptr); continue;
 
                             case token_type::kw_end: end_method(); continue;
 
@@ -372,6 +434,7 @@ namespace propane
 
             set_line_number(ptr->line_num);
             current_type = &define_type((ptr++)->str, false);
+            parse_packed(ptr);
         }
         void begin_union(const token*& ptr)
         {
@@ -381,6 +444,15 @@ namespace propane
 
             set_line_number(ptr->line_num);
             current_type = &define_type((ptr++)->str, true);
+            parse_packed(ptr);
+        }
+        void parse_packed(const token*& ptr)
+        {
+            if (ptr->type == token_type::kw_packed)
+            {
+                ptr++;
+                current_type->set_packed();
+            }
         }
         void parse_field(const token*& ptr)
         {
@@ -744,6 +816,22 @@ namespace propane
 
             current_method->write_sw(addr, label_buffer);
         }
+        vector<switch_case> case_buffer;
+        void write_sws(const token*& ptr)
+        {
+            const address addr = parse_address(ptr);
+
+            case_buffer.clear();
+            while (ptr->type == token_type::literal)
+            {
+                const int64_t value = parse_offset_num<int64_t>(ptr);
+                UNEXPECTED_EXPRESSION(ptr->type == token_type::identifier, ptr->str);
+                case_buffer.push_back(switch_case{ value, current_method->declare_label(ptr->str) });
+                ptr++;
+            }
+
+            current_method->write_sws(addr, case_buffer);
+        }
 
         vector<address> arg_buffer;
         void write_call(const token*& ptr)
@@ -759,7 +847,7 @@ namespace propane
                 case token_type::literal: arg_buffer.push_back(parse_constant(ptr)); goto parse_next_arg;
                 default:
                 {
-                    if (ptr->type <= token_type::op_dump) break;
+                    if (ptr->type <= token_type::op_mcmp) break;
                     arg_buffer.push_back(parse_address(ptr));
                     goto parse_next_arg;
                 }
@@ -779,7 +867,7 @@ namespace propane
                 case token_type::literal: arg_buffer.push_back(parse_constant(ptr)); goto parse_next_arg;
                 default:
                 {
-                    if (ptr->type <= token_type::op_dump) break;
+                    if (ptr->type <= token_type::op_mcmp) break;
                     arg_buffer.push_back(parse_address(ptr));
                     goto parse_next_arg;
                 }
@@ -803,6 +891,107 @@ namespace propane
             current_method->write_dump(addr);
         }
 
+        void write_vadd(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vadd(lhs, rhs);
+        }
+        void write_vsub(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vsub(lhs, rhs);
+        }
+        void write_vmul(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vmul(lhs, rhs);
+        }
+        void write_vdiv(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vdiv(lhs, rhs);
+        }
+        void write_vmin(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vmin(lhs, rhs);
+        }
+        void write_vmax(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vmax(lhs, rhs);
+        }
+        void write_vceq(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vceq(lhs, rhs);
+        }
+        void write_vcne(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vcne(lhs, rhs);
+        }
+        void write_vcgt(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vcgt(lhs, rhs);
+        }
+        void write_vcge(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vcge(lhs, rhs);
+        }
+        void write_vclt(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vclt(lhs, rhs);
+        }
+        void write_vcle(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vcle(lhs, rhs);
+        }
+        void write_vshf(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            current_method->write_vshf(lhs, rhs);
+        }
+
+        void write_mcpy(const token*& ptr)
+        {
+            const address dst = parse_address(ptr);
+            const address src = parse_address(ptr);
+            const address length = parse_address(ptr);
+            current_method->write_mcpy(dst, src, length);
+        }
+        void write_mset(const token*& ptr)
+        {
+            const address dst = parse_address(ptr);
+            const address value = parse_address(ptr);
+            const address length = parse_address(ptr);
+            current_method->write_mset(dst, value, length);
+        }
+        void write_mcmp(const token*& ptr)
+        {
+            const address lhs = parse_address(ptr);
+            const address rhs = parse_address(ptr);
+            const address length = parse_address(ptr);
+            current_method->write_mcmp(lhs, rhs, length);
+        }
+
 
         void write_label(string_view label_name)
         {
@@ -1116,8 +1305,95 @@ namespace propane
         vector<type_idx> parameters;
     };
 
+    // Read file (with one extra newline appended)
+    static block<char> read_file(const char* file_path)
+    {
+        ifstream file(file_path, std::ios::binary);
+        VALIDATE_FILE_OPEN(file.is_open(), file_path);
+        file.seekg(0, file.end);
+        const size_t file_size = static_cast<size_t>(file.tellg());
+        file.seekg(0, file.beg);
+        block<char> file_text(file_size + 1);
+        file_text[file_size] = '\n';
+        file.read((char*)file_text.data(), file_size);
+        return file_text;
+    }
+
+    // Source text of a file
+    // Files that already end with a newline are mapped and tokenized in place,
+    // other files are read into a copy with the newline appended.
+    class source_text final
+    {
+    public:
+        NOCOPY_CLASS_DEFAULT(source_text, const char* file_path)
+        {
+            const hostmem mem = host::map_file(file_path);
+            if (mem)
+            {
+                const char* const address = static_cast<const char*>(mem.address);
+                if (address[mem.size - 1] == '\n')
+                {
+                    mapped = mem;
+                    text = string_view(address, mem.size);
+                    return;
+                }
+                host::unmap_file(mem);
+            }
+            copy = read_file(file_path);
+            text = string_view(copy.data(), copy.size());
+        }
+        ~source_text()
+        {
+            if (mapped) host::unmap_file(mapped);
+        }
+
+        string_view text;
+
+    private:
+        hostmem mapped = { nullptr, 0 };
+        block<char> copy;
+    };
+
     intermediate parser_propane::parse(const char* file_path)
     {
-        return parser_impl(file_path).finalize();
+        const source_text source(file_path);
+        return parser_impl(file_path, source.text).finalize();
+    }
+    intermediate parser_propane::parse(const char* file_path, const intermediate_cache& cache)
+    {
+        const source_text source(file_path);
+
+        // The stripped file name ends up in the meta data, so it is part of the key
+        const uint64_t key = intermediate_cache::make_key(source.text,
+            intermediate_cache::make_key(string_view(strip_filepath(file_path))));
+        intermediate cached = cache.find(key);
+        if (cached) return cached;
+
+        intermediate result = parser_impl(file_path, source.text).finalize();
+        cache.store(key, result);
+        return result;
+    }
+    intermediate parser_propane::parse(const char* file_path, identifier_interner& interner)
+    {
+        const source_text source(file_path);
+        return parser_impl(file_path, source.text, interner).finalize();
+    }
+    std::vector<intermediate> parser_propane::parse_all(span<const char* const> file_paths, size_t thread_count)
+    {
+        std::vector<intermediate> result(file_paths.size());
+        parallel_for(file_paths.size(), thread_count, [&](size_t idx)
+        {
+            result[idx] = parse(file_paths[idx]);
+        });
+        return result;
+    }
+    std::vector<intermediate> parser_propane::parse_all(span<const char* const> file_paths, identifier_interner& interner, size_t thread_count)
+    {
+        std::vector<intermediate> result(file_paths.size());
+        parallel_for(file_paths.size(), thread_count, [&](size_t idx)
+        {
+            result[idx] = parse(file_paths[idx], interner);
+        });
+        return result;
     }
 }
\ No newline at end of file
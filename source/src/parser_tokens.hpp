@@ -13,6 +13,7 @@ namespace propane
         kw_method,
         kw_struct,
         kw_union,
+        kw_packed,
         kw_stack,
         kw_returns,
         kw_parameters,
@@ -64,6 +65,7 @@ namespace propane
         op_bnz,
 
         op_sw,
+        op_sws,
 
         op_call,
         op_callv,
@@ -72,6 +74,23 @@ namespace propane
 
         op_dump,
 
+        op_vadd,
+        op_vsub,
+        op_vmul,
+        op_vdiv,
+        op_vmin,
+        op_vmax,
+        op_vceq,
+        op_vcne,
+        op_vcgt,
+        op_vcge,
+        op_vclt,
+        op_vcle,
+        op_vshf,
+        op_mcpy,
+        op_mset,
+        op_mcmp,
+
         // Special characters
         lbrace,
         rbrace,
@@ -111,6 +130,7 @@ namespace propane
         { "method", token_type::kw_method },
         { "struct", token_type::kw_struct },
         { "union", token_type::kw_union },
+        { "packed", token_type::kw_packed },
         { "stack", token_type::kw_stack },
         { "returns", token_type::kw_returns },
         { "parameters", token_type::kw_parameters },
@@ -155,11 +175,28 @@ namespace propane
         { "bze", token_type::op_bze },
         { "bnz", token_type::op_bnz },
         { "sw", token_type::op_sw },
+        { "sws", token_type::op_sws },
         { "call", token_type::op_call },
         { "callv", token_type::op_callv },
         { "ret", token_type::op_ret },
         { "retv", token_type::op_retv },
         { "dump", token_type::op_dump },
+        { "vadd", token_type::op_vadd },
+        { "vsub", token_type::op_vsub },
+        { "vmul", token_type::op_vmul },
+        { "vdiv", token_type::op_vdiv },
+        { "vmin", token_type::op_vmin },
+        { "vmax", token_type::op_vmax },
+        { "vceq", token_type::op_vceq },
+        { "vcne", token_type::op_vcne },
+        { "vcgt", token_type::op_vcgt },
+        { "vcge", token_type::op_vcge },
+        { "vclt", token_type::op_vclt },
+        { "vcle", token_type::op_vcle },
+        { "vshf", token_type::op_vshf },
+        { "mcpy", token_type::op_mcpy },
+        { "mset", token_type::op_mset },
+        { "mcmp", token_type::op_mcmp },
     };
     constexpr size_t token_string_count = sizeof(token_strings) / sizeof(token_string);
 
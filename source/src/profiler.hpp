@@ -0,0 +1,287 @@
+#ifndef _HEADER_PROFILER
+#define _HEADER_PROFILER
+
+#include "decoded_bytecode.hpp"
+#include "host.hpp"
+
+namespace propane
+{
+    // Call tree node, one per unique call path
+    // (the root node represents the host that invokes the entry method)
+    struct profile_node
+    {
+        static constexpr uint32_t invalid = uint32_t(-1);
+
+        profile_node(method_idx method, uint32_t parent) :
+            method(method),
+            parent(parent) {}
+
+        method_idx method;
+        uint32_t parent;
+        uint32_t first_child = invalid;
+        uint32_t next_sibling = invalid;
+
+        uint64_t calls = 0;
+        uint64_t inclusive_ticks = 0;
+        uint64_t exclusive_ticks = 0;
+    };
+    // Sampled call tree node
+    struct sample_node
+    {
+        static constexpr uint32_t invalid = uint32_t(-1);
+
+        sample_node(method_idx method, uint32_t parent) :
+            method(method),
+            parent(parent) {}
+
+        method_idx method;
+        uint32_t parent;
+        uint32_t first_child = invalid;
+        uint32_t next_sibling = invalid;
+
+        // Samples taken while this call path was the innermost
+        uint64_t samples = 0;
+    };
+
+    // Find (or add) the child node of a call tree that calls the provided method
+    template<typename node_t> uint32_t find_child(vector<node_t>& nodes, uint32_t parent, method_idx method)
+    {
+        uint32_t* link = &nodes[parent].first_child;
+        while (*link != node_t::invalid)
+        {
+            if (nodes[*link].method == method) return *link;
+            link = &nodes[*link].next_sibling;
+        }
+        const uint32_t index = static_cast<uint32_t>(nodes.size());
+        *link = index;
+        nodes.emplace_back(method, parent);
+        return index;
+    }
+
+    // Execution profiler of the pre-decoded interpreter
+    // Counts every dispatched instruction, and keeps a call tree with the timestamp ticks spent
+    // per call path. External calls are leaf nodes of the tree, timed around the forwarded call.
+    // Only used by the profiling instantiation of the interpreter, which runs without jit or guard pages.
+    class call_profiler final
+    {
+    public:
+        // Instruction counts of a method are allocated when it is first entered
+        // (methods might not have been decoded yet)
+        void initialize(const indexed_vector<method_idx, decoded_method>& methods)
+        {
+            instruction_counts.resize(methods.size());
+            reset();
+        }
+        void reset()
+        {
+            for (auto& counts : instruction_counts)
+            {
+                std::fill(counts.begin(), counts.end(), uint64_t(0));
+            }
+            nodes.clear();
+            nodes.emplace_back(method_idx::invalid, profile_node::invalid);
+            interrupt();
+        }
+        // Discard the open frames of an interrupted invocation
+        // (ticks of unfinished calls are not accumulated)
+        void interrupt() noexcept
+        {
+            frames.clear();
+            current_node = 0;
+            current_counts = nullptr;
+            current_instructions = nullptr;
+        }
+
+        inline void enter(const decoded_method& target, uint64_t timestamp)
+        {
+            frames.push_back(frame{ current_node, timestamp, 0, current_counts, current_instructions });
+            current_node = find_child(nodes, current_node, target.source->index);
+            vector<uint64_t>& counts = instruction_counts[target.source->index];
+            if (counts.size() != target.instructions.size()) counts.resize(target.instructions.size());
+            current_counts = counts.data();
+            current_instructions = target.instructions.data();
+        }
+        inline void leave(uint64_t timestamp)
+        {
+            ASSERT(!frames.empty(), "Profiler frame pop overflow");
+            const frame& top = frames.back();
+            const uint64_t elapsed = timestamp - top.start;
+
+            profile_node& node = nodes[current_node];
+            node.calls++;
+            node.inclusive_ticks += elapsed;
+            node.exclusive_ticks += elapsed - top.child_ticks;
+
+            current_node = top.node;
+            current_counts = top.counts;
+            current_instructions = top.instructions;
+            frames.pop_back();
+            if (!frames.empty()) frames.back().child_ticks += elapsed;
+        }
+        // Calls that do not push a frame (externals)
+        inline void record(const decoded_method& target, uint64_t elapsed)
+        {
+            profile_node& node = nodes[find_child(nodes, current_node, target.source->index)];
+            node.calls++;
+            node.inclusive_ticks += elapsed;
+            node.exclusive_ticks += elapsed;
+            if (!frames.empty()) frames.back().child_ticks += elapsed;
+        }
+
+        inline void count(const decoded_instruction* ins) noexcept
+        {
+            current_counts[ins - current_instructions]++;
+        }
+        // Suspended instructions get dispatched (and counted) again when execution resumes
+        inline void uncount(const decoded_instruction* ins) noexcept
+        {
+            current_counts[ins - current_instructions]--;
+        }
+
+        inline const vector<profile_node>& call_tree() const noexcept
+        {
+            return nodes;
+        }
+        inline const vector<uint64_t>& counts(method_idx method) const noexcept
+        {
+            return instruction_counts[method];
+        }
+
+    private:
+        struct frame
+        {
+            uint32_t node;
+            uint64_t start;
+            uint64_t child_ticks;
+            uint64_t* counts;
+            const decoded_instruction* instructions;
+        };
+
+        vector<profile_node> nodes;
+        vector<frame> frames;
+        indexed_vector<method_idx, vector<uint64_t>> instruction_counts;
+
+        uint32_t current_node = 0;
+        uint64_t* current_counts = nullptr;
+        const decoded_instruction* current_instructions = nullptr;
+    };
+
+    // Statistical sampler of the pre-decoded interpreter
+    // Samples are taken at the safe points of the step budget (branches and calls), so execution
+    // does not need to be instrumented. Every sample adds the callstack at the time of sampling to
+    // a call tree, along with the instruction (method and bytecode offset) that was about to execute.
+    class stack_sampler final
+    {
+    public:
+        stack_sampler()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            nodes.clear();
+            nodes.emplace_back(method_idx::invalid, sample_node::invalid);
+            instruction_samples.clear();
+            sample_count = 0;
+        }
+
+        // Callstack is ordered from the innermost method outwards
+        void record(span<const method_idx> callstack, uint32_t offset)
+        {
+            ASSERT(!callstack.empty(), "Empty sample callstack");
+
+            uint32_t node = 0;
+            for (size_t i = callstack.size(); i > 0; i--)
+            {
+                node = find_child(nodes, node, callstack[i - 1]);
+            }
+            nodes[node].samples++;
+            instruction_samples[(uint64_t(callstack[0]) << 32) | offset]++;
+            sample_count++;
+        }
+
+        inline const vector<sample_node>& call_tree() const noexcept
+        {
+            return nodes;
+        }
+        // Samples per instruction, keyed by method index (upper 32 bits) and bytecode offset (lower 32 bits)
+        inline const unordered_map<uint64_t, uint64_t>& instructions() const noexcept
+        {
+            return instruction_samples;
+        }
+        inline uint64_t samples() const noexcept
+        {
+            return sample_count;
+        }
+
+    private:
+        vector<sample_node> nodes;
+        unordered_map<uint64_t, uint64_t> instruction_samples;
+        uint64_t sample_count = 0;
+    };
+
+    enum class trace_event : uint32_t
+    {
+        // Call into a method (value is the callee, the entry call of an invocation has no calling method)
+        call,
+        // Call in the stack frame of the current method (value is the callee)
+        tail_call,
+        // Return from the method
+        ret,
+        // Taken branch (value is the bytecode offset of the destination)
+        branch,
+    };
+    struct trace_entry
+    {
+        method_idx method;
+        // Byte offset of the instruction in the method bytecode
+        uint32_t offset;
+        uint32_t value;
+        trace_event event;
+    };
+
+    // Fixed size ring buffer of the most recent calls, returns and taken branches.
+    // Execution contexts are single threaded, so entries are written without synchronization
+    // (one store of the entry and an increment of the position, older entries get overwritten).
+    class trace_buffer final
+    {
+    public:
+        // Capacity is rounded up to a power of two (zero disables tracing)
+        void initialize(size_t capacity)
+        {
+            size_t size = capacity > 0 ? 1 : 0;
+            while (size < capacity) size <<= 1;
+            entries.resize(size);
+            mask = size > 0 ? size - 1 : 0;
+            position = 0;
+        }
+
+        inline bool enabled() const noexcept
+        {
+            return !entries.empty();
+        }
+        inline void record(trace_event event, method_idx method, uint32_t offset, uint32_t value) noexcept
+        {
+            entries[position++ & mask] = trace_entry{ method, offset, value, event };
+        }
+
+        // Amount of entries currently in the buffer
+        inline size_t size() const noexcept
+        {
+            return position < entries.size() ? size_t(position) : entries.size();
+        }
+        // Entries ordered from oldest to newest
+        inline const trace_entry& operator[](size_t idx) const noexcept
+        {
+            return entries[(position - size() + idx) & mask];
+        }
+
+    private:
+        vector<trace_entry> entries;
+        uint64_t mask = 0;
+        uint64_t position = 0;
+    };
+}
+
+#endif
\ No newline at end of file
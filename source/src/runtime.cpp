@@ -58,6 +58,15 @@ namespace propane
         auto& self_data = self();
         auto& env_data = env.self();
 
+        size_t call_count = 0, type_count = 0;
+        for (auto& pair : env_data.libraries)
+        {
+            call_count += pair.second->calls.size();
+            type_count += pair.second->types.size();
+        }
+        self_data.call_lookup.reserve(call_count);
+        self_data.type_lookup.reserve(type_count);
+
         uint32_t lib_idx = 0;
         for (auto& pair : env_data.libraries)
         {
@@ -77,16 +86,19 @@ namespace propane
             for (auto& type : lib_data.types)
             {
                 auto find_type = self_data.type_lookup.find(type.name);
-                if (find_type == self_data.type_lookup.end())
+                if (!find_type)
                 {
                     self_data.type_lookup.emplace(type.name, type);
                 }
                 else
                 {
-                    ASSERT(find_type->second.size == type.size, "Native type size mismatch");
+                    ASSERT(find_type->size == type.size, "Native type size mismatch");
                 }
             }
 
+            // Preloaded libraries get resolved right away, any missing symbols are reported when linking
+            if (add_lib.preload_symbols) add_lib.resolve_symbols();
+
             self_data.libraries.push_back(std::move(add_lib));
         }
     }
@@ -94,4 +106,46 @@ namespace propane
     {
 
     }
+
+    memory_statistics runtime::memory_usage() const
+    {
+        memory_statistics result;
+        result.library_bytes = self().memory_usage();
+        return result;
+    }
+
+    bool library_info::resolve_symbols()
+    {
+        bool resolved = true;
+        for (auto& call : calls)
+        {
+            if (call.handle) continue;
+
+            if (!host.is_open() && !host.open()) return false;
+
+            call.handle = host.get_proc(call.name.data());
+            if (!call.handle) resolved = false;
+        }
+        return resolved;
+    }
+    size_t runtime_data::memory_usage() const noexcept
+    {
+        size_t result = libraries.capacity() * sizeof(library_info);
+        for (const auto& lib : libraries)
+        {
+            result += lib.name.capacity() + lib.calls.size() * sizeof(external_call_info);
+        }
+        return result + call_lookup.memory_usage() + type_lookup.memory_usage();
+    }
+    void runtime_data::resolve_symbols() const
+    {
+        std::call_once(symbols_resolved, [this]()
+        {
+            // Only writes to the call handles, which are not read before resolution has finished
+            for (auto& lib : const_cast<runtime_data*>(this)->libraries)
+            {
+                if (!lib.preload_symbols) lib.resolve_symbols();
+            }
+        });
+    }
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include "host.hpp"
 #include "library.hpp"
 
+#include <mutex>
+
 namespace propane
 {
     // Global indices
@@ -87,6 +89,84 @@ namespace propane
         return 0;
     }
 
+    // Base types are aligned to their own size, structs to the largest alignment of their fields
+    // and arrays to the alignment of their elements. Packed structs have an alignment of 1.
+    inline constexpr size_t get_base_type_alignment(type_idx btype) noexcept
+    {
+        return std::max(get_base_type_size(btype), size_t(1));
+    }
+    inline constexpr size_t align_size(size_t size, size_t alignment) noexcept
+    {
+        return (size + (alignment - 1)) & ~(alignment - 1);
+    }
+    // Stack frames are aligned to the largest base type alignment
+    inline constexpr size_t stack_alignment = get_base_type_alignment(type_idx::u64);
+
+    // Vector types are arrays of an arithmetic type that are 16 or 32 bytes in size.
+    // The built-in vector type names are aliases for these arrays (f32x4 is float[4]).
+    // Vector instructions use the index in this table as subcode.
+    struct vector_type_info
+    {
+        constexpr vector_type_info(string_view name, type_idx element, size_t lanes) :
+            name(name),
+            element(element),
+            lanes(lanes) {}
+
+        string_view name;
+        type_idx element;
+        size_t lanes;
+    };
+
+    inline constexpr vector_type_info vector_types[] =
+    {
+        vector_type_info("i8x16", type_idx::i8, 16),
+        vector_type_info("u8x16", type_idx::u8, 16),
+        vector_type_info("i16x8", type_idx::i16, 8),
+        vector_type_info("u16x8", type_idx::u16, 8),
+        vector_type_info("i32x4", type_idx::i32, 4),
+        vector_type_info("u32x4", type_idx::u32, 4),
+        vector_type_info("i64x2", type_idx::i64, 2),
+        vector_type_info("u64x2", type_idx::u64, 2),
+        vector_type_info("f32x4", type_idx::f32, 4),
+        vector_type_info("f64x2", type_idx::f64, 2),
+        vector_type_info("i8x32", type_idx::i8, 32),
+        vector_type_info("u8x32", type_idx::u8, 32),
+        vector_type_info("i16x16", type_idx::i16, 16),
+        vector_type_info("u16x16", type_idx::u16, 16),
+        vector_type_info("i32x8", type_idx::i32, 8),
+        vector_type_info("u32x8", type_idx::u32, 8),
+        vector_type_info("i64x4", type_idx::i64, 4),
+        vector_type_info("u64x4", type_idx::u64, 4),
+        vector_type_info("f32x8", type_idx::f32, 8),
+        vector_type_info("f64x4", type_idx::f64, 4),
+    };
+    inline constexpr size_t vector_type_count = sizeof(vector_types) / sizeof(vector_type_info);
+
+    // Returns vector_type_count if the array is not a vector type
+    inline constexpr size_t get_vector_type(type_idx element, size_t lanes) noexcept
+    {
+        if (!is_arithmetic(element)) return vector_type_count;
+        const size_t size = get_base_type_size(element) * lanes;
+        if (size == 16) return static_cast<size_t>(element);
+        if (size == 32) return static_cast<size_t>(element) + vector_type_count / 2;
+        return vector_type_count;
+    }
+    inline const vector_type_info* find_vector_type(string_view name) noexcept
+    {
+        for (const auto& it : vector_types)
+        {
+            if (it.name == name) return &it;
+        }
+        return nullptr;
+    }
+
+    // Sparse switch case values are stored as 64-bit integers (sign extended for signed types).
+    // Cases are sorted by key, which maps the value range of the switch type onto an unsigned range.
+    inline constexpr uint64_t get_switch_key(type_idx type, uint64_t value) noexcept
+    {
+        return is_unsigned(type) ? value : (value ^ (uint64_t(1) << 63));
+    }
+
 
     // Lookups/translations
     enum class lookup_type : uint32_t
@@ -220,6 +300,207 @@ namespace propane
         buf.insert(buf.end(), ptr, ptr + str.size());
     }
 
+    // Compact address encoding (see link_parameters::compact_bytecode)
+    // Every address starts with a tag byte:
+    //   0tiiiiii   Stack variable (t = 0) or parameter (t = 1) below index 63 without modifier and prefix
+    //              (stack variable index 63 is the return value)
+    //   10cccccc   Constant of base type c, followed by the value (variable-length for integral types and pointers)
+    //   11ttppmm   Address of type t with prefix p and modifier m, followed by the variable-length index
+    //              and, if the address has a modifier, the variable-length field index or array offset
+    // Variable-length values are stored 7 bits per byte (LEB128), signed values are zigzag encoded.
+    // Global indices are rotated so that the constant flag does not inflate the encoded size.
+    namespace compact_address_constants
+    {
+        static constexpr uint8_t extended_flag = 0x80;
+        static constexpr uint8_t constant_flag = 0x40;
+        static constexpr uint8_t parameter_flag = 0x40;
+        static constexpr uint8_t index_mask = 0x3F;
+        static constexpr uint32_t return_value_index = index_mask;
+    }
+
+    inline void append_varint(vector<uint8_t>& buf, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buf.push_back(static_cast<uint8_t>(value) | uint8_t(0x80));
+            value >>= 7;
+        }
+        buf.push_back(static_cast<uint8_t>(value));
+    }
+    inline uint64_t read_varint(const uint8_t*& iptr) noexcept
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0;; shift += 7)
+        {
+            const uint8_t byte = *iptr++;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+    inline constexpr uint64_t zigzag_encode(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    inline constexpr int64_t zigzag_decode(uint64_t value) noexcept
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    inline constexpr uint64_t rotate_global_index(uint32_t index) noexcept
+    {
+        return (uint64_t(index & uint32_t(global_flags::constant_mask)) << 1) | uint64_t(is_constant_flag_set(global_idx(index)));
+    }
+    inline constexpr uint32_t restore_global_index(uint64_t value) noexcept
+    {
+        return static_cast<uint32_t>(value >> 1) | ((value & 1) ? uint32_t(global_flags::constant_flag) : 0);
+    }
+
+    // Writes an address in the compact encoding. The payload is the field index or
+    // array offset for regular addresses and the value (at full type width) for constants.
+    inline void append_compact_address(vector<uint8_t>& buf, address_header header, const uint8_t* payload)
+    {
+        using namespace compact_address_constants;
+
+        const address_type type = header.type();
+        const uint32_t index = header.index();
+        if (type == address_type::constant)
+        {
+            const type_idx constant_type = type_idx(index);
+            buf.push_back(extended_flag | static_cast<uint8_t>(index));
+            const size_t size = get_base_type_size(constant_type);
+            if (is_floating_point(constant_type))
+            {
+                buf.insert(buf.end(), payload, payload + size);
+            }
+            else
+            {
+                uint64_t value = 0;
+                memcpy(&value, payload, size);
+                if (is_integral(constant_type) && !is_unsigned(constant_type))
+                {
+                    // Sign extend
+                    const uint32_t shift = uint32_t(64 - size * 8);
+                    value = zigzag_encode(static_cast<int64_t>(value << shift) >> shift);
+                }
+                append_varint(buf, value);
+            }
+            return;
+        }
+
+        const bool is_plain = header.prefix() == address_prefix::none && header.modifier() == address_modifier::none;
+        if (is_plain && type == address_type::stackvar && index == address_header_constants::index_max)
+        {
+            buf.push_back(static_cast<uint8_t>(return_value_index));
+            return;
+        }
+        if (is_plain && (type == address_type::stackvar || type == address_type::parameter) && index < return_value_index)
+        {
+            buf.push_back(static_cast<uint8_t>(index) | (type == address_type::parameter ? parameter_flag : uint8_t(0)));
+            return;
+        }
+
+        const uint32_t flags = (uint32_t(type) << 4) | (uint32_t(header.prefix()) << 2) | uint32_t(header.modifier());
+        buf.push_back(extended_flag | constant_flag | static_cast<uint8_t>(flags));
+        append_varint(buf, type == address_type::global ? rotate_global_index(index) : uint64_t(index));
+        switch (header.modifier())
+        {
+            case address_modifier::none: break;
+
+            case address_modifier::direct_field:
+            case address_modifier::indirect_field:
+            {
+                uint32_t field = 0;
+                memcpy(&field, payload, sizeof(field));
+                append_varint(buf, field);
+            }
+            break;
+
+            case address_modifier::offset:
+            {
+                offset_t offset = 0;
+                memcpy(&offset, payload, sizeof(offset));
+                append_varint(buf, zigzag_encode(static_cast<int64_t>(offset)));
+            }
+            break;
+        }
+    }
+    // Reads an address in the compact encoding. Constant values are written
+    // at full type width to the provided buffer (at least 8 bytes).
+    inline address_data_t read_compact_address(const uint8_t*& iptr, void* constant) noexcept
+    {
+        using namespace compact_address_constants;
+
+        address_data_t result(0);
+        const uint8_t tag = *iptr++;
+        if (!(tag & extended_flag))
+        {
+            const uint32_t index = tag & index_mask;
+            if (tag & parameter_flag) result.header = address_header(address_type::parameter, address_prefix::none, address_modifier::none, index);
+            else result.header = address_header(address_type::stackvar, address_prefix::none, address_modifier::none, index == return_value_index ? address_header_constants::index_max : index);
+        }
+        else if (!(tag & constant_flag))
+        {
+            const type_idx constant_type = type_idx(tag & index_mask);
+            result.header = address_header(constant_type);
+            const size_t size = get_base_type_size(constant_type);
+            if (is_floating_point(constant_type))
+            {
+                memcpy(constant, iptr, size);
+                iptr += size;
+            }
+            else
+            {
+                uint64_t value = read_varint(iptr);
+                if (is_integral(constant_type) && !is_unsigned(constant_type)) value = static_cast<uint64_t>(zigzag_decode(value));
+                memcpy(constant, &value, size);
+            }
+        }
+        else
+        {
+            const address_type type = address_type((tag >> 4) & address_header_constants::flag_mask);
+            const uint64_t index = read_varint(iptr);
+            result.header = address_header(type, address_prefix((tag >> 2) & address_header_constants::flag_mask), address_modifier(tag & address_header_constants::flag_mask),
+                type == address_type::global ? restore_global_index(index) : static_cast<uint32_t>(index));
+            switch (result.header.modifier())
+            {
+                case address_modifier::none: break;
+                case address_modifier::direct_field:
+                case address_modifier::indirect_field: result.field = offset_idx(read_varint(iptr)); break;
+                case address_modifier::offset: result.offset = static_cast<offset_t>(zigzag_decode(read_varint(iptr))); break;
+            }
+        }
+        return result;
+    }
+    // Size of an address in the standard encoding
+    inline size_t standard_address_size(address_header header) noexcept
+    {
+        if (header.type() == address_type::constant) return sizeof(address_header) + get_base_type_size(type_idx(header.index()));
+        return sizeof(address_data_t);
+    }
+    // Reads an address in either encoding. Constant values point into the bytecode
+    // for the standard encoding, or into the provided buffer for the compact encoding.
+    inline address_data_t read_address_data(const uint8_t*& iptr, bytecode_encoding encoding, uint64_t& constant_buffer, const uint8_t*& constant) noexcept
+    {
+        if (encoding == bytecode_encoding::compact)
+        {
+            constant = reinterpret_cast<const uint8_t*>(&constant_buffer);
+            return read_compact_address(iptr, &constant_buffer);
+        }
+
+        address_data_t result(0);
+        result.header = read_bytecode<address_header>(iptr);
+        if (result.header.type() == address_type::constant)
+        {
+            constant = iptr;
+            iptr += get_base_type_size(type_idx(result.header.index()));
+        }
+        else
+        {
+            memcpy(&result.offset, iptr, sizeof(result.offset));
+            iptr += sizeof(result.offset);
+        }
+        return result;
+    }
+
     // Serialization of generic types
     template<typename value_t> struct propane::serialization::is_packed<aligned_t<value_t, alignof(uint32_t)>> { static constexpr bool value = true; };
     template<> struct propane::serialization::is_packed<translate_idx> { static constexpr bool value = true; };
@@ -243,11 +524,17 @@ namespace propane
         library_info(string_view name, bool preload_symbols, const block<external_call_info>& calls) :
             name(name),
             preload_symbols(preload_symbols),
-            calls(calls) {}
+            calls(calls),
+            host(name) {}
+
+        // Load the library dynamically and resolve all calls without a handle.
+        // Returns false if any of the symbols could not be resolved.
+        bool resolve_symbols();
 
         string name;
         bool preload_symbols;
         indexed_block<uint32_t, external_call_info> calls;
+        host_library host;
     };
 
     struct runtime_call_index
@@ -276,10 +563,24 @@ namespace propane
     public:
         NOCOPY_CLASS_DEFAULT(runtime_data) = default;
 
+        // Resolve the symbols of all libraries that were not preloaded. Symbols are resolved only once per
+        // runtime (on first link or execution), after which the call handles are immutable and can be
+        // shared by all executions on any thread. Calls that could not be resolved keep a null handle.
+        void resolve_symbols() const;
+        // Allocated size of the library tables and lookups in bytes
+        size_t memory_usage() const noexcept;
+        inline const external_call_info& get_call(runtime_call_index cidx) const noexcept
+        {
+            return libraries[cidx.library].calls[cidx.index];
+        }
+
         indexed_vector<name_idx, library_info> libraries;
-        unordered_map<string_view, runtime_call_index> call_lookup;
-        unordered_map<string_view, native::typedecl> type_lookup;
+        flat_map<runtime_call_index> call_lookup;
+        flat_map<native::typedecl> type_lookup;
         size_t hash = 0;
+
+    private:
+        mutable std::once_flag symbols_resolved;
     };
     constexpr size_t runtime_data_handle_size = approximate_handle_size(sizeof(runtime_data));
 }
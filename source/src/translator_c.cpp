@@ -2,7 +2,10 @@
 #include "generation.hpp"
 #include "assembly_data.hpp"
 #include "errors.hpp"
+#include "utility.hpp"
+#include "link_profile.hpp"
 
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 using std::ofstream;
@@ -37,8 +40,16 @@ namespace propane
         bool fwd_declared = false;
         bool is_declared = false;
         bool is_defined = false;
+        bool is_generated = false;
+        bool is_inline = false;
+        bool uses_vectors = false;
+        bool uses_memory = false;
         unordered_set<method_idx> calls_made;
         unordered_set<global_idx> referenced_globals;
+
+        // Generated definition, and the types it uses in order of use
+        string definition;
+        vector<type_idx> used_types;
     };
 
     class global_meta
@@ -47,6 +58,9 @@ namespace propane
         bool is_defined = false;
     };
 
+    // Execution counts per bytecode offset
+    using instruction_counts = unordered_map<uint32_t, uint64_t>;
+
     struct string_address_t
     {
         string_address_t() = default;
@@ -89,6 +103,22 @@ namespace propane
         " == 0",
         " != 0",
     };
+    constexpr string_view vector_operator_str[] =
+    {
+        "+",
+        "-",
+        "*",
+        "/",
+        "",
+        "",
+        "==",
+        "!=",
+        ">",
+        ">=",
+        "<",
+        "<=",
+    };
+
     constexpr bool is_cmpzero(opcode op) noexcept
     {
         return op >= opcode::cze && op <= opcode::cnz;
@@ -118,313 +148,328 @@ namespace propane
     }
 
 
-    class translator_c_impl final : ofstream
+    // Assembly data and formatting shared by the translator and the method translators
+    class translator_c_base
     {
-    public:
-        translator_c_impl(const char* out_file, const assembly_data& asm_data) :
+    protected:
+        translator_c_base(const assembly_data& asm_data, indexed_vector<type_idx, type_meta>& type_metas) :
             data(asm_data),
             database(asm_data.database),
+            type_metas(type_metas),
             int_type(data.types[type_idx::i32]),
             offset_type(data.types[derive_type_index_v<offset_t>]),
             size_type(data.types[derive_type_index_v<size_t>]),
             vptr_type(data.types[type_idx::vptr])
         {
-            this->open(out_file);
-            VALIDATE_FILE_OPEN(this->operator bool(), out_file);
-
             // Reserve
             get_number_str(31);
             get_indent_str(7);
+        }
 
-            type_metas.resize(data.types.size());
-            method_metas.resize(data.methods.size());
-            globals_meta.resize(data.globals.info.size());
-            constants_meta.resize(data.constants.info.size());
+        // Assembly data
+        const assembly_data& data;
+        const string_table<name_idx>& database;
 
-            resolve_method(data.methods[data.main]);
+        inline const type& get_type(type_idx type) const
+        {
+            return data.types[type];
+        }
+        inline const method& get_method(method_idx method) const
+        {
+            return data.methods[method];
+        }
+        inline const signature& get_signature(signature_idx signature) const
+        {
+            return data.signatures[signature];
+        }
 
-            file_writer.write("#include \"propane.h\"");
+        // Type names are resolved by the translator before any method is generated
+        indexed_vector<type_idx, type_meta>& type_metas;
 
-            if (!type_definitions.empty())
-            {
-                file_writer.write(type_definitions);
-            }
-            if (!method_declarations.empty())
+        // String buffers
+        static constexpr string_view stack_postfix = "s";
+        static constexpr string_view param_postfix = "p";
+        static constexpr string_view retval_postfix = "r";
+        static constexpr string_view label_postfix = "l";
+
+        number_converter num_conv;
+
+        indexed_vector<size_t, string> number_str;
+        inline string_view get_number_str(size_t idx)
+        {
+            if (idx >= number_str.size())
             {
-                file_writer.write("\n");
-                file_writer.write(method_declarations);
+                const size_t begin = number_str.size();
+                number_str.resize(idx + 1);
+                for (size_t i = begin; i < number_str.size(); i++)
+                {
+                    number_str[i] = num_conv.convert(i);
+                }
             }
-            if (!constants.empty())
+            return number_str[idx];
+        }
+        indexed_vector<size_t, string> indent_str;
+        inline string_view get_indent_str(size_t idx)
+        {
+            if (idx >= indent_str.size())
             {
-                file_writer.write("\n");
-                file_writer.write(constants);
+                const size_t begin = indent_str.empty() ? 1 : indent_str.size();
+                indent_str.resize(idx + 1);
+                for (size_t i = begin; i < indent_str.size(); i++)
+                {
+                    indent_str[i] = indent_str[i - 1];
+                    indent_str[i].push_back('\t');
+                }
             }
-            if (!globals.empty())
+            return indent_str[idx];
+        }
+
+        void write_literal(string_writer& buf, const uint8_t* ptr, type_idx type)
+        {
+            switch (type)
             {
-                file_writer.write("\n");
-                file_writer.write(globals);
+                case type_idx::i8: buf.write(num_conv.convert(static_cast<int32_t>(*reinterpret_cast<const i8*>(ptr)))); break;
+                case type_idx::u8: buf.write(num_conv.convert(static_cast<uint32_t>(*reinterpret_cast<const u8*>(ptr)))); break;
+                case type_idx::i16: buf.write(num_conv.convert(*reinterpret_cast<const i16*>(ptr))); break;
+                case type_idx::u16: buf.write(num_conv.convert(*reinterpret_cast<const u16*>(ptr))); break;
+                case type_idx::i32: buf.write(num_conv.convert(*reinterpret_cast<const i32*>(ptr))); break;
+                case type_idx::u32: buf.write(num_conv.convert(*reinterpret_cast<const u32*>(ptr))); break;
+                case type_idx::i64: buf.write(num_conv.convert(*reinterpret_cast<const i64*>(ptr))); break;
+                case type_idx::u64: buf.write(num_conv.convert(*reinterpret_cast<const u64*>(ptr))); break;
+                case type_idx::f32: 
+                {
+                    const string& f32str = num_conv.convert(*reinterpret_cast<const f32*>(ptr));
+                    bool contains_exp = false;
+                    bool contains_period = false;
+                    for (size_t i = 0; i < f32str.size(); i++)
+                    {
+                        const char c = f32str[i];
+                        switch (c)
+                        {
+                            case 'e':
+                                contains_exp = true;
+                                break;
+                            case '.':
+                                contains_period = true;
+                                break;
+                        }
+                    }
+                    if (contains_exp || contains_period)
+                        buf.write(f32str, "f");
+                    else
+                        buf.write(f32str, ".0f");
+                }
+                break;
+                case type_idx::f64: buf.write(num_conv.convert(*reinterpret_cast<const f64*>(ptr))); break;
+                case type_idx::vptr: write_hex(buf, *reinterpret_cast<const size_t*>(ptr)); break;
+                default: ASSERT(false, "Unknown constant type");
             }
-            if (!method_definitions.empty())
+        }
+        void write_hex(string_writer& buf, size_t value)
+        {
+            buf.write("0x");
+            constexpr size_t nibble_count = sizeof(size_t) * 2;
+            for (size_t i = 0; i < nibble_count; i++)
             {
-                file_writer.write(method_definitions);
+                const size_t nibble = (value >> ((nibble_count - 1) * 4)) & static_cast<size_t>(0xF);
+                if (nibble < 10)
+                {
+                    buf.write('0' + char(nibble));
+                }
+                else
+                {
+                    buf.write('A' + char(nibble - 10));
+                }
+                value <<= 4;
             }
-
-            write(file_writer.data(), std::streamsize(file_writer.size()));
         }
 
-
-        type_meta& resolve_type(const type& type)
+        void generate_method_declaration(string_writer& dst, const method& method, const signature& signature)
         {
-            auto& meta = type_metas[type.index];
-            if (meta.is_resolved) return meta;
-            meta.is_resolved = true;
+            const auto& return_meta = type_metas[signature.return_type];
+            if (return_meta.ptr_offset != 0)
+            {
+                dst.write(string_view(return_meta.declaration).substr(0, return_meta.ptr_offset));
+            }
+            else
+            {
+                dst.write(return_meta.declaration, " ");
+            }
 
-            const auto& underlying_type = type.is_array() ? resolve_type(type.generated.array.underlying_type) : type.is_pointer() ? resolve_type(type.generated.pointer.underlying_type) : meta;
+            dst.write("$", database[method.name], "(");
+            for (size_t i = 0; i < signature.parameters.size(); i++)
+            {
+                if (i > 0) dst.write(", ");
+                const type_idx param_type = signature.parameters[i].type;
+                declare_stackvar(dst, param_postfix, i, param_type);
+            }
+            dst.write(')');
 
-            if (meta.declaration.empty())
+            if (return_meta.ptr_offset != 0)
             {
-                resolve_name_recursive(type.index);
+                dst.write(string_view(return_meta.declaration).substr(return_meta.ptr_offset));
             }
+        }
 
-            if (!is_base_type(type.index))
+        void declare_stackvar(string_writer& dst, string_view postfix, size_t idx, type_idx type)
+        {
+            const auto& meta = type_metas[type];
+            if (meta.ptr_offset != 0)
             {
-                for (auto& field : type.fields)
-                {
-                    resolve_type(field.type);
-                }
+                dst.write(string_view(meta.declaration).substr(0, meta.ptr_offset));
+                dst.write("$", get_number_str(idx), postfix);
+                dst.write(string_view(meta.declaration).substr(meta.ptr_offset));
+            }
+            else
+            {
+                dst.write(meta.declaration, " $", get_number_str(idx), postfix);
+            }
+        }
 
-                if (!type.is_external())
-                {
-                    if (type.is_array() || !type.is_generated())
-                    {
-                        type_fields.clear();
-                        type_fields.write("\n\n");
+        // Type constant
+        const type& int_type;
+        const type& offset_type;
+        const type& size_type;
+        const type& vptr_type;
+    };
 
-                        type_fields.write(meta.declaration);
-                        type_fields.write("\n{\n");
-                        if (type.is_array())
-                        {
-                            declare_array_field(type_fields, type.generated.array.underlying_type, type.generated.array.array_size);
-                        }
-                        else
-                        {
-                            for (size_t i = 0; i < type.fields.size(); i++)
-                            {
-                                if (i != 0) type_fields.write("\n");
-                                const auto& f = type.fields[i];
-                                declare_field(type_fields, database[f.name], f.type);
-                            }
-                        }
-                        type_fields.write("\n};");
 
-                        type_definitions.write(type_fields);
-                    }
-                }
-            }
+    // Generates method definitions
+    // Method translators only read the (fully resolved) type names, so multiple translators
+    // can generate definitions in parallel. The types that a definition depends on are
+    // recorded in order of use, and get defined by the translator when the method is emitted.
+    class method_translator final : public translator_c_base
+    {
+    public:
+        method_translator(const assembly_data& asm_data, indexed_vector<type_idx, type_meta>& type_metas,
+            const translator_c_parameters& parameters, const indexed_vector<method_idx, instruction_counts>& profile_counts) :
+            translator_c_base(asm_data, type_metas),
+            parameters(parameters),
+            profile_counts(profile_counts) {}
 
-            return meta;
-        }
-        inline type_meta& resolve_type(type_idx type)
+        void generate(const method& m, method_meta& meta)
         {
-            return resolve_type(data.types[type]);
-        }
+            const auto& signature = get_signature(m.signature);
+
+            current_meta = &meta;
+            meta.calls_made.clear();
+            meta.referenced_globals.clear();
+            meta.used_types.clear();
+            meta.uses_vectors = false;
+            meta.uses_memory = false;
+
+            method_body.clear();
+            method_frame.clear();
+
+            stack_vars_used.clear();
+            stack_vars_used.resize(m.stackvars.size());
+            stack_vars_escaping.clear();
+            stack_vars_escaping.resize(m.stackvars.size());
+            return_vars.clear();
+            calls_indirect = false;
+
+            current_counts = nullptr;
+            if (profile_counts.is_valid_index(m.index) && !profile_counts[m.index].empty())
+            {
+                current_counts = &profile_counts[m.index];
+            }
 
-        method_meta& resolve_method(const method& m)
-        {
-            auto& meta = method_metas[m.index];
-            if (meta.is_declared) return meta;
-            meta.is_declared = true;
+            // Definition
+            method_frame.write("\n\n");
+            generate_method_declaration(method_frame, m, signature);
+            method_frame.write("\n{\n");
 
-            if (!meta.is_defined && !m.is_external())
+            if (!m.bytecode.empty())
             {
-                const auto& signature = get_signature(m.signature);
-                resolve_signature(signature);
-
-                method_body.clear();
-                method_frame.clear();
+                current_method = &m;
+                current_signature = &signature;
 
-                stack_vars_used.clear();
-                stack_vars_used.resize(m.stackvars.size());
-                return_vars.clear();
+                ret_idx = 0;
+                return_type = type_idx::invalid;
 
-                // Definition
-                method_frame.write("\n\n");
-                generate_method_declaration(method_frame, m, signature);
-                method_frame.write("\n{\n");
+                const auto& bytecode = m.bytecode;
+                ibeg = iptr = bytecode.data();
+                iend = ibeg + bytecode.size();
+                standard_size = bytecode.size();
 
-                if (!m.bytecode.empty())
+                label_idx = static_cast<uint32_t>(m.labels.size());
+                label_queue.resize(label_idx);
+                label_indices.clear();
+                for (auto& label : m.labels)
                 {
-                    current_method = &m;
-                    current_signature = &signature;
+                    label_queue[--label_idx] = label;
+                    label_indices.emplace(label, uint32_t(label_indices.size()));
+                }
 
-                    ret_idx = 0;
-                    return_type = type_idx::invalid;
+                evaluate();
+            }
 
-                    const auto& bytecode = m.bytecode;
-                    ibeg = iptr = bytecode.data();
-                    iend = ibeg + bytecode.size();
+            method_frame.write(method_body);
+            method_frame.write("}");
 
-                    label_idx = static_cast<uint32_t>(m.labels.size());
-                    label_queue.resize(label_idx);
-                    label_indices.clear();
-                    for (auto& label : m.labels)
-                    {
-                        label_queue[--label_idx] = label;
-                        label_indices.emplace(label, uint32_t(label_indices.size()));
-                    }
+            if (parameters.optimize)
+            {
+                meta.is_inline = !calls_indirect && meta.calls_made.empty() &&
+                    m.index != data.main && standard_size <= inline_bytecode_size;
+                finalize_optimized(meta);
+            }
+            else
+            {
+                meta.definition = method_frame;
+            }
+            meta.is_generated = true;
+        }
+
+    private:
+        // Leaf methods up to this bytecode size are declared static inline in optimized output
+        static constexpr size_t inline_bytecode_size = 128;
+        // Branches are hinted when executed at least this many times, and taken (or not taken) at least 90% of the time
+        static constexpr uint64_t branch_hint_min_count = 16;
+        // Declarations of locals that qualify for register are marked while generating, whether they
+        // escape is only known once the whole method has been generated
+        static constexpr char register_marker = '\x01';
 
-                    evaluate();
+        void finalize_optimized(method_meta& meta)
+        {
+            string& dst = meta.definition;
+            dst.clear();
+            dst.reserve(method_frame.size() + 16);
+            dst.append("\n\n");
+            if (meta.is_inline) dst.append("static inline ");
+
+            const char* ptr = method_frame.data() + 2;
+            const char* const end = method_frame.data() + method_frame.size();
+            while (ptr < end)
+            {
+                const char* marker = static_cast<const char*>(memchr(ptr, register_marker, size_t(end - ptr)));
+                if (!marker)
+                {
+                    dst.append(ptr, end);
+                    break;
                 }
+                dst.append(ptr, marker);
 
-                method_frame.write(method_body);
-                method_frame.write("}");
+                size_t index = 0;
+                for (ptr = marker + 1; *ptr != register_marker; ptr++) index = index * 10 + size_t(*ptr - '0');
+                ptr++;
+                if (!stack_vars_escaping[index]) dst.append("register ");
+            }
+        }
 
-                if (!meta.calls_made.empty() || !meta.referenced_globals.empty())
+        void evaluate()
+        {
+            bool has_returned = false;
+            while (true)
+            {
+                const uint32_t offset = static_cast<uint32_t>(iptr - ibeg);
+                previous_offset = instruction_offset;
+                instruction_offset = offset;
+                while (!label_queue.empty() && offset >= label_queue.back())
                 {
-                    string tmp = method_frame;
-
-                    // Declare called methods
-                    for (auto c : meta.calls_made)
-                    {
-                        const auto& call_method = get_method(c);
-                        auto& call_meta = resolve_method(call_method);
-                        if (!call_meta.is_defined && call_method.index != m.index)
-                        {
-                            declare_method(call_method);
-                        }
-                    }
-
-                    // Declare referenced constants
-                    for (auto g : meta.referenced_globals)
-                    {
-                        if (is_constant_flag_set(g))
-                        {
-                            const global_idx global_idx = g & global_flags::constant_mask;
-                            const auto& global_info = data.constants.info[global_idx];
-                            const auto& global_type = get_type(global_info.type);
-                            if (global_type.is_signature())
-                            {
-                                // Resolve method if signature
-                                const size_t method_handle = *reinterpret_cast<const size_t*>(data.constants.data.data() + global_info.offset);
-                                if (method_handle != 0)
-                                {
-                                    const method_idx call_method_idx = method_idx(method_handle ^ data.runtime_hash);
-                                    ASSERT(data.methods.is_valid_index(call_method_idx), "Attempted to call an invalid method");
-                                    auto& const_meta = resolve_method(call_method_idx);
-                                    auto& const_call = get_method(call_method_idx);
-                                    if (!const_meta.is_defined && call_method_idx != m.index)
-                                    {
-                                        declare_method(const_call);
-                                    }
-                                    if (global_info.name == const_call.name)
-                                    {
-                                        // Build-in method constant
-                                        continue;
-                                    }
-                                }
-                            }
-                        }
-                        resolve_global(g);
-                    }
-
-                    method_definitions.write(tmp);
-                }
-                else
-                {
-                    method_definitions.write(method_frame);
-                }
-            }
-
-            meta.is_defined = true;
-            return meta;
-        }
-        inline method_meta& resolve_method(method_idx method)
-        {
-            return resolve_method(get_method(method));
-        }
-
-        global_meta& resolve_global(global_idx global)
-        {
-            const bool is_constant = is_constant_flag_set(global);
-            auto& metas = is_constant ? constants_meta : globals_meta;
-            global &= global_flags::constant_mask;
-
-            ASSERT(metas.is_valid_index(global), "Global index out of range");
-            auto& meta = metas[global];
-            if (meta.is_defined) return meta;
-            meta.is_defined = true;
-
-            const auto& table = is_constant ? data.constants : data.globals;
-
-            const auto& global_info = table.info[global];
-            const auto& global_type = data.types[global_info.type];
-
-            auto& dst_buf = is_constant ? constants : globals;
-
-            const auto name_info = database[global_info.name];
-
-            dst_buf.write_newline();
-            const auto& global_type_meta = resolve_type(global_type);
-            if (global_type.is_signature())
-            {
-                const size_t method_handle = *reinterpret_cast<const size_t*>(table.data.data() + global_info.offset);
-                method_idx call_method_idx = method_idx(method_handle - 1);
-
-                dst_buf.write(string_view(global_type_meta.declaration).substr(0, global_type_meta.ptr_offset));
-                if (is_constant) dst_buf.write("const ");
-                dst_buf.write("$", name_info);
-                dst_buf.write(string_view(global_type_meta.declaration).substr(global_type_meta.ptr_offset));
-            }
-            else if (global_type.is_pointer())
-            {
-                dst_buf.write(global_type_meta.declaration);
-                if (is_constant) dst_buf.write(" const");
-                dst_buf.write(" $", name_info);
-            }
-            else
-            {
-                if (is_constant) dst_buf.write("const ");
-                dst_buf.write(global_type_meta.declaration, " $", name_info);
-            }
-
-            dst_buf.write(" = ");
-            if (global_type.is_pointer())
-            {
-                // If its a pointer type, we need to cast to dst to silence 'levels of indirection' warning
-                dst_buf.write("(");
-                dst_buf.write(global_type_meta.declaration);
-                if (is_constant) dst_buf.write(" const");
-                dst_buf.write(")");
-            }
-            const uint8_t* addr = table.data.data() + global_info.offset;
-            write_constant(dst_buf, addr, global_type.index, true);
-            dst_buf.write(";");
-
-            return meta;
-        }
-
-        void resolve_signature(const signature& signature)
-        {
-            for (auto& p : signature.parameters)
-            {
-                resolve_type(p.type);
-            }
-            resolve_type(signature.return_type);
-        }
-
-
-        void evaluate()
-        {
-            bool has_returned = false;
-            while (true)
-            {
-                const uint32_t offset = static_cast<uint32_t>(iptr - ibeg);
-                while (!label_queue.empty() && offset >= label_queue.back())
-                {
-                    method_body.write("$", get_number_str(label_idx), label_postfix, ":;\n");
-                    label_idx++;
-                    label_queue.pop_back();
-                }
+                    method_body.write("$", get_number_str(label_idx), label_postfix, ":;\n");
+                    label_idx++;
+                    label_queue.pop_back();
+                }
 
                 if (iptr == iend)
                 {
@@ -485,6 +530,7 @@ namespace propane
                     case opcode::bnz: br(op); break;
 
                     case opcode::sw: sw(); break;
+                    case opcode::sws: sws(); break;
 
                     case opcode::call: call(); break;
                     case opcode::callv: callv(); break;
@@ -493,6 +539,24 @@ namespace propane
 
                     case opcode::dump: dump(); break;
 
+                    case opcode::vadd:
+                    case opcode::vsub:
+                    case opcode::vmul:
+                    case opcode::vdiv:
+                    case opcode::vmin:
+                    case opcode::vmax:
+                    case opcode::vceq:
+                    case opcode::vcne:
+                    case opcode::vcgt:
+                    case opcode::vcge:
+                    case opcode::vclt:
+                    case opcode::vcle:
+                    case opcode::vshf: vec(op); break;
+
+                    case opcode::mcpy:
+                    case opcode::mset:
+                    case opcode::mcmp: mem(op); break;
+
                     default: ASSERT(false, "Malformed opcode: %", static_cast<uint32_t>(op));
                 }
 
@@ -652,10 +716,45 @@ namespace propane
             auto label_index = label_indices.find(branch_location);
 
             instruction.write("if (");
+            const size_t condition = instruction.size();
             do_cmp(op - (opcode::br - opcode::cmp));
+            const string_view hint = get_branch_hint(static_cast<uint32_t>(iptr - ibeg));
+            if (!hint.empty())
+            {
+                instruction.insert(condition, hint);
+                instruction.write(")");
+            }
             instruction.write(") goto $", get_number_str(static_cast<size_t>(label_index->second)), label_postfix);
         }
 
+        string_view get_branch_hint(uint32_t next_offset) const
+        {
+            if (!current_counts) return string_view();
+
+            // Fallthrough can only be counted when the next instruction is not a branch target
+            if (label_indices.find(next_offset) != label_indices.end()) return string_view();
+
+            // The interpreter can fuse a branch with the preceding instruction, which
+            // is then counted at the offset of the preceding instruction
+            uint64_t executed = get_count(instruction_offset);
+            if (executed == 0 && label_indices.find(instruction_offset) == label_indices.end())
+            {
+                executed = get_count(previous_offset);
+            }
+            if (executed < branch_hint_min_count) return string_view();
+
+            const uint64_t not_taken = std::min(get_count(next_offset), executed);
+            const uint64_t taken = executed - not_taken;
+            if (taken * 10 >= executed * 9) return "$likely(";
+            if (not_taken * 10 >= executed * 9) return "$unlikely(";
+            return string_view();
+        }
+        inline uint64_t get_count(uint32_t offset) const
+        {
+            auto find = current_counts->find(offset);
+            return find == current_counts->end() ? 0 : find->second;
+        }
+
         void sw()
         {
             string_address_t idx_addr = read_address(true);
@@ -673,11 +772,38 @@ namespace propane
             }
             instruction.write("\t}");
         }
+        void sws()
+        {
+            string_address_t value_addr = read_address(true);
+            const bool is_unsigned_switch = is_unsigned(value_addr.type_ptr->index);
+
+            const uint32_t case_count = read_bytecode<uint32_t>(iptr);
+
+            const uint64_t* values = reinterpret_cast<const uint64_t*>(iptr);
+            iptr += sizeof(uint64_t) * case_count;
+            const uint32_t* labels = reinterpret_cast<const uint32_t*>(iptr);
+            iptr += sizeof(uint32_t) * case_count;
+
+            // The C compiler picks its own lowering (jump table or binary search) for sparse cases
+            instruction.write("switch (", value_addr.addr, ")\n\t{\n");
+            for (uint32_t i = 0; i < case_count; i++)
+            {
+                auto label_index = label_indices.find(labels[i]);
+                instruction.write(get_indent_str(2), "case ");
+                if (is_unsigned_switch) instruction.write(num_conv.convert(values[i]), "u");
+                else instruction.write(num_conv.convert(static_cast<int64_t>(values[i])));
+                instruction.write(": goto $", get_number_str(static_cast<size_t>(label_index->second)), label_postfix, ";\n");
+            }
+            instruction.write("\t}");
+        }
 
         void call()
         {
-            const method_idx call_idx = read_bytecode<method_idx>(iptr);
-            method_metas[current_method->index].calls_made.emplace(call_idx);
+            write_call(read_bytecode<method_idx>(iptr));
+        }
+        void write_call(method_idx call_idx)
+        {
+            current_meta->calls_made.emplace(call_idx);
 
             const auto& method = get_method(call_idx);
             const auto& signature = get_signature(method.signature);
@@ -692,6 +818,24 @@ namespace propane
         }
         void callv()
         {
+            // Calls through constant method pointers are made directly in optimized output
+            if (parameters.optimize)
+            {
+                const uint8_t* const addr_ptr = iptr;
+                const size_t addr_standard_size = standard_size;
+                uint64_t constant_buffer;
+                const uint8_t* constant = nullptr;
+                const method_idx call_idx = get_constant_method(read_address_data(constant_buffer, constant));
+                if (call_idx != method_idx::invalid)
+                {
+                    write_call(call_idx);
+                    return;
+                }
+                iptr = addr_ptr;
+                standard_size = addr_standard_size;
+            }
+            calls_indirect = true;
+
             auto method_ptr = read_address(true);
 
             const auto& signature = get_signature(method_ptr.type_ptr->generated.signature.index);
@@ -711,6 +855,25 @@ namespace propane
 
             return_type = ret_type;
         }
+        method_idx get_constant_method(const address_data_t& addr) const
+        {
+            if (addr.header.type() != address_type::global ||
+                addr.header.prefix() != address_prefix::none ||
+                addr.header.modifier() != address_modifier::none) return method_idx::invalid;
+
+            const global_idx global = global_idx(addr.header.index());
+            if (!is_constant_flag_set(global)) return method_idx::invalid;
+
+            const auto& global_info = data.constants.info[global & global_flags::constant_mask];
+            if (!get_type(global_info.type).is_signature()) return method_idx::invalid;
+
+            const size_t method_handle = *reinterpret_cast<const size_t*>(data.constants.data.data() + global_info.offset);
+            if (method_handle == 0) return method_idx::invalid;
+
+            const method_idx call_idx = method_idx(method_handle ^ data.runtime_hash);
+            ASSERT(data.methods.is_valid_index(call_idx), "Attempted to call an invalid method");
+            return call_idx;
+        }
         void write_param(const signature& signature)
         {
             const size_t arg_count = static_cast<size_t>(read_bytecode<uint8_t>(iptr));
@@ -742,6 +905,72 @@ namespace propane
             instruction.write(ret_value.addr);
         }
 
+        // Vector instructions expand to the macros in the prelude, which use compiler
+        // vector extensions where available
+        void vec(opcode op)
+        {
+            auto sub = read_subcode();
+            auto lhs_addr = read_address(true);
+            auto rhs_addr = read_address(true);
+
+            current_meta->uses_vectors = true;
+
+            const auto& array = lhs_addr.type_ptr->generated.array;
+            const string_view element = type_metas[array.underlying_type].declaration;
+            const string_view lanes = get_number_str(array.array_size);
+
+            // Unsigned integer of the element size, used for comparison masks and shuffle indices
+            type_idx mask_type;
+            switch (get_type(array.underlying_type).total_size)
+            {
+                case 1: mask_type = type_idx::u8; break;
+                case 2: mask_type = type_idx::u16; break;
+                case 4: mask_type = type_idx::u32; break;
+                default: mask_type = type_idx::u64; break;
+            }
+            const string_view mask = type_metas[mask_type].declaration;
+
+            switch (op)
+            {
+                case opcode::vmin: instruction.write("$vmin(", lanes); break;
+                case opcode::vmax: instruction.write("$vmax(", lanes); break;
+                case opcode::vshf: instruction.write("$vshf(", element, ", ", mask, ", ", lanes); break;
+                case opcode::vadd:
+                case opcode::vsub:
+                case opcode::vmul:
+                case opcode::vdiv: instruction.write("$vop(", element, ", ", lanes, ", ", vector_operator_str[size_t(op - opcode::vadd)]); break;
+                default: instruction.write("$vcmp(", element, ", ", mask, ", ", lanes, ", ", vector_operator_str[size_t(op - opcode::vadd)]); break;
+            }
+            instruction.write(", (", lhs_addr.addr, ").$val, (", rhs_addr.addr, ").$val)");
+        }
+
+        // Bulk memory instructions map onto the string.h functions, lengths are
+        // scaled by the size of the destination element type (except for void pointers)
+        void mem(opcode op)
+        {
+            auto sub = read_subcode();
+            auto lhs_addr = read_address(true);
+            auto rhs_addr = read_address(true);
+            auto length_addr = read_address(true);
+
+            current_meta->uses_memory = true;
+
+            switch (op)
+            {
+                case opcode::mcpy: instruction.write("memmove(", lhs_addr.addr, ", ", rhs_addr.addr, ", "); break;
+                case opcode::mset: instruction.write("memset(", lhs_addr.addr, ", (unsigned char)(", rhs_addr.addr, "), "); break;
+                default:
+                {
+                    return_type = write_return_value(type_idx::i32);
+                    instruction.write("$mcmp(", lhs_addr.addr, ", ", rhs_addr.addr, ", ");
+                }
+                break;
+            }
+            instruction.write("(size_t)(", length_addr.addr, ")");
+            if (lhs_addr.type_ptr->index != type_idx::vptr) instruction.write(" * sizeof(*(", lhs_addr.addr, "))");
+            instruction.write(")");
+        }
+
         void dump()
         {
             auto src_addr = read_address(true);
@@ -850,576 +1079,1022 @@ namespace propane
         }
 
 
-        type_meta& resolve_name_recursive(type_idx t)
+        inline subcode read_subcode() noexcept
         {
-            const auto& type = get_type(t);
-            auto& meta = type_metas[type.index];
-            if (meta.declaration.empty())
+            return read_bytecode<subcode>(iptr);
+        }
+        address_data_t read_address_data(uint64_t& constant_buffer, const uint8_t*& constant)
+        {
+            // Sizes are tracked in the standard encoding, so that optimized
+            // output does not depend on the encoding of the assembly
+            const uint8_t* const addr_ptr = iptr;
+            const address_data_t addr = propane::read_address_data(iptr, data.encoding, constant_buffer, constant);
+            standard_size += standard_address_size(addr.header);
+            standard_size -= static_cast<size_t>(iptr - addr_ptr);
+            return addr;
+        }
+        string_address_t read_address(bool is_rhs)
+        {
+            string_writer& buf = get_next_buffer();
+
+            string_address_t result;
+
+            uint64_t constant_buffer;
+            const uint8_t* constant = nullptr;
+            const address_data_t addr = read_address_data(constant_buffer, constant);
+
+            const auto& minf = *current_method;
+            const auto& csig = *current_signature;
+
+            bool is_constant = false;
+
+            switch (addr.header.prefix())
             {
-                if (!type.is_generated())
+                case address_prefix::indirection: buf.write("*"); break;
+                case address_prefix::address_of: buf.write("&"); break;
+                case address_prefix::size_of: buf.write("sizeof("); break;
+            }
+
+            const uint32_t index = addr.header.index();
+            type_idx sv_type = type_idx::invalid;
+            switch (addr.header.type())
+            {
+                case address_type::stackvar:
                 {
-                    if (!is_base_type(type.index))
+                    if (index == address_header_constants::index_max)
                     {
-                        meta.generated = "$";
-                        meta.generated.append(database[type.name]);
-                        meta.declaration = type.is_union() ? "union " : "struct ";
-                        meta.declaration.append(meta.generated);
+                        ASSERT(has_return_value(), "Return value address has not been set");
+
+                        ASSERT(return_type != type_idx::voidtype, "Return value address has not been set");
+
+                        buf.write("$", get_number_str(ret_idx), retval_postfix);
+
+                        result.type_ptr = &get_type(return_type);
                     }
                     else
                     {
-                        switch (type.index)
-                        {
-                            case type_idx::i8: meta.declaration = "int8_t"; break;
-                            case type_idx::u8: meta.declaration = "uint8_t"; break;
-                            case type_idx::i16: meta.declaration = "int16_t"; break;
-                            case type_idx::u16: meta.declaration = "uint16_t"; break;
-                            case type_idx::i32: meta.declaration = "int32_t"; break;
-                            case type_idx::u32: meta.declaration = "uint32_t"; break;
-                            case type_idx::i64: meta.declaration = "int64_t"; break;
-                            case type_idx::u64: meta.declaration = "uint64_t"; break;
-                            case type_idx::f32: meta.declaration = "float"; break;
-                            case type_idx::f64: meta.declaration = "double"; break;
-                            case type_idx::vptr: meta.declaration = "void"; break;
-                            case type_idx::voidtype: meta.declaration = "void"; break;
-                        }
-                        meta.generated = "$" + meta.declaration;
-                        if (type.index == type_idx::vptr)
-                        {
-                            meta.declaration.push_back('*');
-                            meta.generated.append("$P1");
-                        }
+                        ASSERT(index < minf.stackvars.size(), "Stack index out of range");
+
+                        const auto& stack_var = minf.stackvars[index];
+                        if (addr.header.prefix() == address_prefix::address_of) stack_vars_escaping[index] = true;
+
+                        buf.write("$", get_number_str(static_cast<size_t>(index)), stack_postfix);
+
+                        result.type_ptr = &get_type(stack_var.type);
+                        sv_type = stack_var.type;
                     }
                 }
-                else
+                break;
+
+                case address_type::parameter:
                 {
-                    if (type.is_pointer())
+                    ASSERT(index < csig.parameters.size(), "Parameter index out of range");
+
+                    buf.write("$", get_number_str(static_cast<size_t>(index)), param_postfix);
+
+                    const auto& param = csig.parameters[index];
+                    result.type_ptr = &get_type(param.type);
+                }
+                break;
+
+                case address_type::global:
+                {
+                    global_idx global = (global_idx)index;
+
+                    current_meta->referenced_globals.emplace(global);
+
+                    is_constant = is_constant_flag_set(global);
+                    const auto& table = is_constant ? data.constants : data.globals;
+                    global &= global_flags::constant_mask;
+
+                    buf.write("$", database[table.info[global].name]);
+
+                    const auto& global_info = table.info[global];
+                    result.type_ptr = &get_type(global_info.type);
+                }
+                break;
+
+                case address_type::constant:
+                {
+                    ASSERT(is_rhs, "Constant cannot be a left-hand side operand");
+                    const type_idx btype_idx = type_idx(index);
+                    ASSERT(btype_idx <= type_idx::vptr, "Malformed constant opcode");
+                    const auto& type = get_type(btype_idx);
+                    string_writer& next_buf = get_next_buffer();
+                    write_literal(next_buf, constant, type.index);
+                    return string_address_t(&type, next_buf);
+                }
+                break;
+            }
+
+            switch (addr.header.modifier())
+            {
+                case address_modifier::none: break;
+
+                case address_modifier::direct_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+
+                    const auto& type = *result.type_ptr;
+                    ASSERT(!type.is_pointer(), "Attempted to deref a field on a non-pointer type");
+                    ASSERT(type.index == field.name.object_type, "Field type mismatch");
+
+                    for (auto& it : field.name.field_names)
                     {
-                        const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
-                        const auto& underlying_meta = resolve_name_recursive(underlying_type.index);
+                        buf.write(".");
+                        buf.write("$", database[it]);
+                    }
 
-                        if (underlying_meta.ptr_offset != 0)
-                        {
-                            meta.declaration.append(string_view(underlying_meta.declaration).substr(0, underlying_meta.ptr_offset));
-                            meta.declaration.append("*");
-                            meta.declaration.append(string_view(underlying_meta.declaration).substr(underlying_meta.ptr_offset));
-                            meta.ptr_offset = underlying_meta.ptr_offset + 1;
-                        }
-                        else
-                        {
-                            meta.declaration.append(underlying_meta.declaration);
-                            meta.declaration.append("*");
-                        }
+                    result.type_ptr = &get_type(field.type);
+                }
+                break;
 
-                        if (underlying_type.is_pointer())
-                        {
-                            meta.ptr_level = underlying_meta.ptr_level + 1;
-                            meta.generated.append(string_view(underlying_meta.generated).substr(0, underlying_meta.generated.find_last_of('$')));
-                            meta.generated.append("$P");
-                            meta.generated.append(get_number_str(meta.ptr_level));
-                        }
-                        else
-                        {
-                            meta.ptr_level = 1;
-                            meta.generated.append(underlying_meta.generated);
-                            meta.generated.append("$P1");
-                        }
+                case address_modifier::indirect_field:
+                {
+                    const auto& field = data.offsets[addr.field];
+
+                    const auto& type = *result.type_ptr;
+                    ASSERT(type.is_pointer(), "Attempted to dereference a non-pointer type");
+                    const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
+                    ASSERT(underlying_type.index == field.name.object_type, "Field type mismatch");
+
+                    bool first = true;
+                    for (auto& it : field.name.field_names)
+                    {
+                        buf.write(first ? "->" : ".");
+                        buf.write("$", database[it]);
+                        first = false;
+                    }
+
+                    result.type_ptr = &data.types[field.type];
+                }
+                break;
+
+                case address_modifier::offset:
+                {
+                    const offset_t offset = addr.offset;
+
+                    const auto& type = *result.type_ptr;
+                    if (type.is_pointer())
+                    {
+                        result.type_ptr = &get_type(type.generated.pointer.underlying_type);
                     }
                     else if (type.is_array())
                     {
-                        const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
-                        const auto& underlying_meta = resolve_name_recursive(underlying_type.index);
+                        buf.write(".$val");
+                        result.type_ptr = &get_type(type.generated.array.underlying_type);
+                    }
+                    else
+                    {
+                        ASSERT(false, "Offset is not valid here");
+                    }
+                    buf.write('[', num_conv.convert(offset), ']');
+                }
+                break;
+            }
+
+            switch (addr.header.prefix())
+            {
+                case address_prefix::none: break;
+
+                case address_prefix::indirection:
+                {
+                    const auto& type = *result.type_ptr;
+                    ASSERT(type.is_pointer(), "Attempted to dereference a non-pointer type");
+                    ASSERT(type.index != type_idx::vptr, "Attempted to dereference an abstract pointer type");
+
+                    result.type_ptr = &get_type(type.generated.pointer.underlying_type);
+                }
+                break;
+
+                case address_prefix::address_of:
+                {
+                    const type_idx dst_type = result.type_ptr->pointer_type;
+                    result.type_ptr = dst_type == type_idx::invalid ? &vptr_type : &get_type(dst_type);
+
+                    // Cast away constness
+                    if (is_constant)
+                    {
+                        string tmp = buf;
+                        buf.clear();
+                        write_cast(buf, dst_type);
+                        buf.write(tmp);
+                    }
+                }
+                break;
+
+                case address_prefix::size_of:
+                {
+                    result.type_ptr = &size_type;
+
+                    buf.write(')');
+                }
+                break;
+            }
+
+            if (addr.header.type() == address_type::stackvar)
+            {
+                if (static_cast<size_t>(index) < stack_vars_used.size() && !stack_vars_used[static_cast<size_t>(index)])
+                {
+                    if (addr.header.prefix() == address_prefix::none && addr.header.modifier() == address_modifier::none && !is_rhs)
+                    {
+                        buf.clear();
+                        declare_stackvar(buf, stack_postfix, static_cast<size_t>(index), sv_type);
+                    }
+                    else
+                    {
+                        declare_stackvar(method_body, stack_postfix, static_cast<size_t>(index), sv_type);
+                        method_body.write(";\n", get_indent_str(1));
+                    }
+
+                    stack_vars_used[static_cast<size_t>(index)] = true;
+                }
+            }
+
+            result.addr = buf;
+            return result;
+        }
+
+        type_idx write_return_value(type_idx type)
+        {
+            if (type == type_idx::voidtype)
+            {
+                ret_idx = 0;
+                return type;
+            }
+
+            for (size_t i = 0; i < return_vars.size(); i++)
+            {
+                if (return_vars[i] == type)
+                {
+                    ret_idx = i;
+                    instruction.write("$", get_number_str(ret_idx), retval_postfix, " = ");
+                    return type;
+                }
+            }
+
+            ret_idx = return_vars.size();
+            declare_stackvar(instruction, retval_postfix, ret_idx, type);
+            instruction.write(" = ");
+            return_vars.push_back(type);
+
+            return type;
+        }
+        bool has_return_value()
+        {
+            return return_type != type_idx::voidtype;
+        }
+
+        void write_cast(string_writer& dst, type_idx dst_type)
+        {
+            dst.write("(", type_metas[dst_type].declaration, ")");
+        }
+        void write_cast(type_idx dst_type)
+        {
+            write_cast(instruction, dst_type);
+        }
+
+        void declare_stackvar(string_writer& dst, string_view postfix, size_t idx, type_idx type)
+        {
+            current_meta->used_types.push_back(type);
+
+            if (parameters.optimize && postfix == stack_postfix)
+            {
+                // Aggregates are excluded, as indexing an array requires its address
+                const auto& t = get_type(type);
+                if (t.is_arithmetic() || t.is_pointer() || t.is_signature())
+                {
+                    dst.write(register_marker, get_number_str(idx), register_marker);
+                }
+            }
+
+            translator_c_base::declare_stackvar(dst, postfix, idx, type);
+        }
+
+        const translator_c_parameters& parameters;
+        const indexed_vector<method_idx, instruction_counts>& profile_counts;
+        const instruction_counts* current_counts = nullptr;
+
+        // Stack frame
+        method_meta* current_meta = nullptr;
+        const method* current_method = nullptr;
+        const signature* current_signature = nullptr;
+        vector<uint32_t> label_queue;
+        unordered_map<uint32_t, uint32_t> label_indices;
+        uint32_t label_idx = 0;
+        size_t ret_idx = 0;
+        type_idx return_type = type_idx::voidtype;
+        const uint8_t* iptr = nullptr;
+        const uint8_t* ibeg = nullptr;
+        const uint8_t* iend = nullptr;
+        size_t standard_size = 0;
+
+        vector<bool> stack_vars_used;
+        vector<bool> stack_vars_escaping;
+        vector<type_idx> return_vars;
+        bool calls_indirect = false;
+        uint32_t instruction_offset = 0;
+        uint32_t previous_offset = 0;
+        string_writer method_frame;
+        string_writer method_body;
+        string_writer instruction;
+
+        // Rotating buffers for formatting operands, these need to hold every operand
+        // of an instruction (up to three, constants take up two buffers)
+        static constexpr size_t string_buffer_count = 8;
+        string_writer string_buffers[string_buffer_count];
+        size_t buffer_index = 0;
+        string_writer& get_next_buffer()
+        {
+            string_writer& buf = string_buffers[buffer_index];
+            buf.clear();
+            buffer_index = (buffer_index + 1) % string_buffer_count;
+            return buf;
+        }
+    };
+
+
+    class translator_c_impl final : public translator_c_base
+    {
+    public:
+        translator_c_impl(const char* out_file, const assembly_data& asm_data, const translator_c_parameters& parameters, const link_profile_data* profile) :
+            translator_c_base(asm_data, type_table),
+            parameters(parameters),
+            translator(asm_data, type_table, this->parameters, profile_counts)
+        {
+            ofstream file(out_file);
+            VALIDATE_FILE_OPEN(file.is_open(), out_file);
+
+            type_table.resize(data.types.size());
+            method_metas.resize(data.methods.size());
+            globals_meta.resize(data.globals.info.size());
+            constants_meta.resize(data.constants.info.size());
+
+            if (parameters.optimize && profile)
+            {
+                profile_counts.resize(data.methods.size());
+                for (const auto& m : data.methods)
+                {
+                    const profile_method* counts = profile->find(database[m.name], m.bytecode.size(), m.labels.data(), m.labels.size());
+                    if (!counts) continue;
+
+                    auto& dst = profile_counts[m.index];
+                    for (const auto& it : counts->instructions) dst[it.offset] = it.count;
+                }
+            }
+
+            // Method translators expect every type name to be resolved
+            for (size_t i = 0; i < type_table.size(); i++)
+            {
+                resolve_name_recursive(type_idx(i));
+            }
+
+            generate_methods();
+
+            resolve_method(data.methods[data.main]);
+
+            if (parameters.translation_units == 0)
+            {
+                write_combined(file);
+            }
+            else
+            {
+                write_split(file, out_file);
+            }
+        }
+
+
+        // Generate the definitions of all methods in advance on multiple threads
+        // (a single thread generates definitions on demand, which skips unused methods)
+        void generate_methods()
+        {
+            vector<method_idx> pending;
+            for (const auto& m : data.methods)
+            {
+                if (!m.is_external()) pending.push_back(m.index);
+            }
+
+            const size_t thread_count = resolve_thread_count(parameters.thread_count, pending.size());
+            if (thread_count <= 1) return;
+
+            // Batches of methods per translator, so threads that finish early can pick up more work
+            const size_t batch_count = std::min(pending.size(), thread_count * 8);
+            parallel_for(batch_count, thread_count, [&](size_t idx)
+            {
+                method_translator batch_translator(data, type_table, parameters, profile_counts);
+                const size_t begin = pending.size() * idx / batch_count;
+                const size_t end = pending.size() * (idx + 1) / batch_count;
+                for (size_t i = begin; i < end; i++)
+                {
+                    auto& meta = method_metas[pending[i]];
+                    try
+                    {
+                        batch_translator.generate(get_method(pending[i]), meta);
+                    }
+                    catch (...)
+                    {
+                        // Generated again when emitted, so errors are reported in emit order
+                        meta.is_generated = false;
+                    }
+                }
+            });
+        }
+
+        void write_prelude()
+        {
+            bool uses_vectors = false, uses_memory = false;
+            for (auto m : definition_order)
+            {
+                uses_vectors |= method_metas[m].uses_vectors;
+                uses_memory |= method_metas[m].uses_memory;
+            }
+
+            file_writer.write("#include \"propane.h\"");
+            if (uses_vectors || uses_memory)
+            {
+                file_writer.write("\n#include <string.h>");
+            }
+            if (parameters.optimize && parameters.profile)
+            {
+                file_writer.write(branch_hint_macros);
+            }
+            if (uses_vectors)
+            {
+                file_writer.write(vector_macros);
+            }
+            if (uses_memory)
+            {
+                file_writer.write(memory_functions);
+            }
+        }
+        static constexpr string_view branch_hint_macros =
+            "\n\n#if defined(__GNUC__) || defined(__clang__)"
+            "\n#define $likely(x) __builtin_expect(!!(x), 1)"
+            "\n#define $unlikely(x) __builtin_expect(!!(x), 0)"
+            "\n#else"
+            "\n#define $likely(x) (x)"
+            "\n#define $unlikely(x) (x)"
+            "\n#endif";
+        // Element-wise vector operations on array operands (comparisons yield all-ones lane masks)
+        static constexpr string_view vector_macros =
+            "\n\n#if defined(__GNUC__) || defined(__clang__)"
+            "\n#define $vop(et, n, op, l, r) do { typedef et $vt __attribute__((vector_size(sizeof(et) * (n)))); $vt $l, $r;"
+            " memcpy(&$l, (l), sizeof($l)); memcpy(&$r, (r), sizeof($r)); $l = $l op $r; memcpy((l), &$l, sizeof($l)); } while (0)"
+            "\n#define $vcmp(et, mt, n, op, l, r) do { typedef et $vt __attribute__((vector_size(sizeof(et) * (n)))); $vt $l, $r;"
+            " memcpy(&$l, (l), sizeof($l)); memcpy(&$r, (r), sizeof($r)); __typeof__($l op $r) $m = $l op $r; memcpy((l), &$m, sizeof($m)); } while (0)"
+            "\n#else"
+            "\n#define $vop(et, n, op, l, r) do { for (size_t $i = 0; $i < (n); $i++) (l)[$i] = (et)((l)[$i] op (r)[$i]); } while (0)"
+            "\n#define $vcmp(et, mt, n, op, l, r) do { for (size_t $i = 0; $i < (n); $i++) { mt $m = ((l)[$i] op (r)[$i]) ? (mt)~(mt)0 : (mt)0;"
+            " memcpy(&(l)[$i], &$m, sizeof($m)); } } while (0)"
+            "\n#endif"
+            "\n#define $vmin(n, l, r) do { for (size_t $i = 0; $i < (n); $i++) if ((r)[$i] < (l)[$i]) (l)[$i] = (r)[$i]; } while (0)"
+            "\n#define $vmax(n, l, r) do { for (size_t $i = 0; $i < (n); $i++) if ((r)[$i] > (l)[$i]) (l)[$i] = (r)[$i]; } while (0)"
+            "\n#define $vshf(et, ut, n, l, r) do { et $t[n]; memcpy($t, (l), sizeof($t));"
+            " for (size_t $i = 0; $i < (n); $i++) (l)[$i] = $t[(ut)(r)[$i] % (n)]; } while (0)";
+        // Memory comparison yields -1, 0 or 1 (like cmp)
+        static constexpr string_view memory_functions =
+            "\n\nstatic inline int32_t $mcmp(const void* l, const void* r, size_t n) { const int c = memcmp(l, r, n); return (c > 0) - (c < 0); }";
+
+        void write_combined(ofstream& file)
+        {
+            write_prelude();
+
+            if (!type_definitions.empty())
+            {
+                file_writer.write(type_definitions);
+            }
+            if (!method_declarations.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(method_declarations);
+            }
+            if (!constants.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(constants);
+            }
+            if (!globals.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(globals);
+            }
+            file_writer.reserve(file_writer.size() + definitions_size());
+            for (auto m : definition_order)
+            {
+                file_writer.write(method_metas[m].definition);
+            }
+
+            file.write(file_writer.data(), std::streamsize(file_writer.size()));
+        }
+        // The output file contains the globals and constants, the header ("<output>.h") contains all
+        // type definitions and declarations and the method definitions are divided over the
+        // translation units ("<output>_<index>.c") by size, in order of definition.
+        void write_split(ofstream& file, const char* out_file)
+        {
+            const std::filesystem::path path(out_file);
+            const string base_path = (path.parent_path() / path.stem()).string();
+            const string header_name = path.stem().string() + ".h";
+
+            // Every method is declared up front, as translation units can call each other
+            for (auto m : definition_order)
+            {
+                declare_method(get_method(m));
+            }
+
+            string include_guard = "_PROPANE_GENERATED_";
+            for (char c : path.stem().string())
+            {
+                include_guard.push_back(isalnum(static_cast<unsigned char>(c)) ? char(toupper(static_cast<unsigned char>(c))) : '_');
+            }
+
+            file_writer.write("#ifndef ", include_guard, "\n#define ", include_guard, "\n\n");
+            write_prelude();
+            if (!type_definitions.empty())
+            {
+                file_writer.write(type_definitions);
+            }
+            if (!method_declarations.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(method_declarations);
+            }
+            if (!constant_declarations.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(constant_declarations);
+            }
+            if (!global_declarations.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(global_declarations);
+            }
+            // Inline methods are defined in every translation unit
+            for (auto m : definition_order)
+            {
+                if (method_metas[m].is_inline) file_writer.write(method_metas[m].definition);
+            }
+            file_writer.write("\n\n#endif");
+            write_file(base_path + ".h", file_writer);
+
+            file_writer.clear();
+            file_writer.write("#include \"", header_name, "\"");
+            if (!constants.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(constants);
+            }
+            if (!globals.empty())
+            {
+                file_writer.write("\n");
+                file_writer.write(globals);
+            }
+            file.write(file_writer.data(), std::streamsize(file_writer.size()));
+
+            const size_t total_size = definitions_size(true);
+            const size_t unit_count = parameters.translation_units;
+            size_t written = 0;
+            size_t index = 0;
+            for (size_t unit = 0; unit < unit_count; unit++)
+            {
+                const size_t unit_end = unit + 1 == unit_count ? total_size : total_size * (unit + 1) / unit_count;
+
+                file_writer.clear();
+                file_writer.write("#include \"", header_name, "\"");
+                while (index < definition_order.size() && written < unit_end)
+                {
+                    const auto& meta = method_metas[definition_order[index++]];
+                    if (meta.is_inline) continue;
+                    file_writer.write(meta.definition);
+                    written += meta.definition.size();
+                }
+                write_file(base_path + "_" + num_conv.convert(unit) + ".c", file_writer);
+            }
+        }
+        static void write_file(const string& file_path, string_view text)
+        {
+            ofstream file(file_path);
+            VALIDATE_FILE_OPEN(file.is_open(), file_path);
+            file.write(text.data(), std::streamsize(text.size()));
+        }
+        size_t definitions_size(bool skip_inline = false) const
+        {
+            size_t size = 0;
+            for (auto m : definition_order)
+            {
+                if (skip_inline && method_metas[m].is_inline) continue;
+                size += method_metas[m].definition.size();
+            }
+            return size;
+        }
+        type_meta& resolve_type(const type& type)
+        {
+            auto& meta = type_metas[type.index];
+            if (meta.is_resolved) return meta;
+            meta.is_resolved = true;
+
+            const auto& underlying_type = type.is_array() ? resolve_type(type.generated.array.underlying_type) : type.is_pointer() ? resolve_type(type.generated.pointer.underlying_type) : meta;
+
+            if (meta.declaration.empty())
+            {
+                resolve_name_recursive(type.index);
+            }
 
-                        meta.generated = underlying_meta.generated;
-                        meta.generated.append("$A");
-                        meta.generated.append(num_conv.convert(type.generated.array.array_size));
+            if (!is_base_type(type.index))
+            {
+                for (auto& field : type.fields)
+                {
+                    resolve_type(field.type);
+                }
 
-                        meta.declaration = "struct ";
-                        meta.declaration.append(meta.generated);
-                    }
-                    else if (type.is_signature())
+                if (!type.is_external())
+                {
+                    if (type.is_array() || !type.is_generated())
                     {
-                        meta.generated = "$";
+                        type_fields.clear();
+                        type_fields.write("\n\n");
 
-                        const auto& signature = get_signature(type.generated.signature.index);
-                        const auto& ret_type = get_type(signature.return_type);
-                        const auto& return_type_meta = resolve_name_recursive(ret_type.index);
-                        if (return_type_meta.ptr_offset != 0)
+                        // Packed types have no padding in the runtime either
+                        if (type.is_packed()) type_fields.write("#pragma pack(push, 1)\n");
+                        type_fields.write(meta.declaration);
+                        type_fields.write("\n{\n");
+                        if (type.is_array())
                         {
-                            meta.declaration.append(string_view(return_type_meta.declaration).substr(0, return_type_meta.ptr_offset));
+                            declare_array_field(type_fields, type.generated.array.underlying_type, type.generated.array.array_size);
                         }
                         else
                         {
-                            meta.declaration.append(return_type_meta.declaration);
-                        }
-
-                        meta.generated.append(return_type_meta.generated);
-
-                        meta.ptr_offset = meta.declaration.size() + 2;
-                        meta.declaration.append("(*)(");
-                        for (size_t i = 0; i < signature.parameters.size(); i++)
-                        {
-                            if (i > 0) meta.declaration.append(", ");
-                            const auto& param_type = get_type(signature.parameters[i].type);
-                            const auto& param_type_meta = resolve_name_recursive(param_type.index);
-                            meta.declaration.append(param_type_meta.declaration);
-
-                            meta.generated.append(param_type_meta.generated);
+                            for (size_t i = 0; i < type.fields.size(); i++)
+                            {
+                                if (i != 0) type_fields.write("\n");
+                                const auto& f = type.fields[i];
+                                declare_field(type_fields, database[f.name], f.type);
+                            }
                         }
-                        meta.declaration.append(")");
+                        type_fields.write("\n};");
+                        if (type.is_packed()) type_fields.write("\n#pragma pack(pop)");
 
-                        if (return_type_meta.ptr_offset != 0)
-                        {
-                            meta.declaration.append(string_view(return_type_meta.declaration).substr(return_type_meta.ptr_offset));
-                        }
-                    }
-                    else
-                    {
-                        meta.generated = meta.declaration = "<???>";
+                        type_definitions.write(type_fields);
                     }
                 }
             }
-            return meta;
-        }
 
-
-        // Assembly data
-        const assembly_data& data;
-        const string_table<name_idx>& database;
-
-        inline const type& get_type(type_idx type) const
-        {
-            return data.types[type];
-        }
-        inline const method& get_method(method_idx method) const
-        {
-            return data.methods[method];
+            return meta;
         }
-        inline const signature& get_signature(signature_idx signature) const
+        inline type_meta& resolve_type(type_idx type)
         {
-            return data.signatures[signature];
+            return resolve_type(data.types[type]);
         }
 
-        // Stack frame
-        const method* current_method = nullptr;
-        const signature* current_signature = nullptr;
-        vector<uint32_t> label_queue;
-        unordered_map<uint32_t, uint32_t> label_indices;
-        uint32_t label_idx = 0;
-        size_t ret_idx = 0;
-        type_idx return_type = type_idx::voidtype;
-        const uint8_t* iptr = nullptr;
-        const uint8_t* ibeg = nullptr;
-        const uint8_t* iend = nullptr;
-
-        // String buffers
-        static constexpr string_view stack_postfix = "s";
-        static constexpr string_view param_postfix = "p";
-        static constexpr string_view retval_postfix = "r";
-        static constexpr string_view label_postfix = "l";
-
-        vector<bool> stack_vars_used;
-        vector<type_idx> return_vars;
-        string_writer type_fields;
-        string_writer type_definitions;
-        string_writer constants;
-        string_writer globals;
-        string_writer method_frame;
-        string_writer method_body;
-        string_writer instruction;
-        string_writer method_declarations;
-        string_writer method_definitions;
-        string_writer file_writer;
-
-        number_converter num_conv;
-
-        string_writer string_buffers[4];
-        size_t buffer_index = 0;
-        string_writer& get_next_buffer()
+        method_meta& resolve_method(const method& m)
         {
-            string_writer& buf = string_buffers[buffer_index];
-            buf.clear();
-            buffer_index = (buffer_index + 1) & 3;
-            return buf;
-        }
+            auto& meta = method_metas[m.index];
+            if (meta.is_declared) return meta;
+            meta.is_declared = true;
 
-        string generate_name;
+            if (!meta.is_defined && !m.is_external())
+            {
+                const auto& signature = get_signature(m.signature);
+                resolve_signature(signature);
 
-        // Meta
-        indexed_vector<type_idx, type_meta> type_metas;
-        indexed_vector<method_idx, method_meta> method_metas;
-        indexed_vector<global_idx, global_meta> globals_meta;
-        indexed_vector<global_idx, global_meta> constants_meta;
+                generate_method(m);
 
-        indexed_vector<size_t, string> number_str;
-        inline string_view get_number_str(size_t idx)
-        {
-            if (idx >= number_str.size())
-            {
-                const size_t begin = number_str.size();
-                number_str.resize(idx + 1);
-                for (size_t i = begin; i < number_str.size(); i++)
-                {
-                    number_str[i] = num_conv.convert(i);
-                }
-            }
-            return number_str[idx];
-        }
-        indexed_vector<size_t, string> indent_str;
-        inline string_view get_indent_str(size_t idx)
-        {
-            if (idx >= indent_str.size())
-            {
-                const size_t begin = indent_str.empty() ? 1 : indent_str.size();
-                indent_str.resize(idx + 1);
-                for (size_t i = begin; i < indent_str.size(); i++)
+                // Define the types in the same order as they are used by the definition
+                for (auto t : meta.used_types)
                 {
-                    indent_str[i] = indent_str[i - 1];
-                    indent_str[i].push_back('\t');
+                    resolve_type(t);
                 }
-            }
-            return indent_str[idx];
-        }
 
-        void write_literal(string_writer& buf, const uint8_t* ptr, type_idx type)
-        {
-            switch (type)
-            {
-                case type_idx::i8: buf.write(num_conv.convert(static_cast<int32_t>(*reinterpret_cast<const i8*>(ptr)))); break;
-                case type_idx::u8: buf.write(num_conv.convert(static_cast<uint32_t>(*reinterpret_cast<const u8*>(ptr)))); break;
-                case type_idx::i16: buf.write(num_conv.convert(*reinterpret_cast<const i16*>(ptr))); break;
-                case type_idx::u16: buf.write(num_conv.convert(*reinterpret_cast<const u16*>(ptr))); break;
-                case type_idx::i32: buf.write(num_conv.convert(*reinterpret_cast<const i32*>(ptr))); break;
-                case type_idx::u32: buf.write(num_conv.convert(*reinterpret_cast<const u32*>(ptr))); break;
-                case type_idx::i64: buf.write(num_conv.convert(*reinterpret_cast<const i64*>(ptr))); break;
-                case type_idx::u64: buf.write(num_conv.convert(*reinterpret_cast<const u64*>(ptr))); break;
-                case type_idx::f32: 
+                if (!meta.calls_made.empty() || !meta.referenced_globals.empty())
                 {
-                    const string& f32str = num_conv.convert(*reinterpret_cast<const f32*>(ptr));
-                    bool contains_exp = false;
-                    bool contains_period = false;
-                    for (size_t i = 0; i < f32str.size(); i++)
+                    // Declare called methods
+                    for (auto c : meta.calls_made)
                     {
-                        const char c = f32str[i];
-                        switch (c)
+                        const auto& call_method = get_method(c);
+                        auto& call_meta = resolve_method(call_method);
+                        if (!call_meta.is_defined && call_method.index != m.index)
                         {
-                            case 'e':
-                                contains_exp = true;
-                                break;
-                            case '.':
-                                contains_period = true;
-                                break;
+                            declare_method(call_method);
                         }
                     }
-                    if (contains_exp || contains_period)
-                        buf.write(f32str, "f");
-                    else
-                        buf.write(f32str, ".0f");
+
+                    // Declare referenced constants
+                    for (auto g : meta.referenced_globals)
+                    {
+                        if (is_constant_flag_set(g))
+                        {
+                            const global_idx global_idx = g & global_flags::constant_mask;
+                            const auto& global_info = data.constants.info[global_idx];
+                            const auto& global_type = get_type(global_info.type);
+                            if (global_type.is_signature())
+                            {
+                                // Resolve method if signature
+                                const size_t method_handle = *reinterpret_cast<const size_t*>(data.constants.data.data() + global_info.offset);
+                                if (method_handle != 0)
+                                {
+                                    const method_idx call_method_idx = method_idx(method_handle ^ data.runtime_hash);
+                                    ASSERT(data.methods.is_valid_index(call_method_idx), "Attempted to call an invalid method");
+                                    auto& const_meta = resolve_method(call_method_idx);
+                                    auto& const_call = get_method(call_method_idx);
+                                    if (!const_meta.is_defined && call_method_idx != m.index)
+                                    {
+                                        declare_method(const_call);
+                                    }
+                                    if (global_info.name == const_call.name)
+                                    {
+                                        // Build-in method constant
+                                        continue;
+                                    }
+                                }
+                            }
+                        }
+                        resolve_global(g);
+                    }
+
                 }
-                break;
-                case type_idx::f64: buf.write(num_conv.convert(*reinterpret_cast<const f64*>(ptr))); break;
-                case type_idx::vptr: write_hex(buf, *reinterpret_cast<const size_t*>(ptr)); break;
-                default: ASSERT(false, "Unknown constant type");
+
+                definition_order.push_back(m.index);
             }
+
+            meta.is_defined = true;
+            return meta;
         }
-        void write_hex(string_writer& buf, size_t value)
+        inline method_meta& resolve_method(method_idx method)
         {
-            buf.write("0x");
-            constexpr size_t nibble_count = sizeof(size_t) * 2;
-            for (size_t i = 0; i < nibble_count; i++)
-            {
-                const size_t nibble = (value >> ((nibble_count - 1) * 4)) & static_cast<size_t>(0xF);
-                if (nibble < 10)
-                {
-                    buf.write('0' + char(nibble));
-                }
-                else
-                {
-                    buf.write('A' + char(nibble - 10));
-                }
-                value <<= 4;
-            }
+            return resolve_method(get_method(method));
+        }
+        method_meta& generate_method(const method& m)
+        {
+            auto& meta = method_metas[m.index];
+            if (!meta.is_generated) translator.generate(m, meta);
+            return meta;
         }
-        void write_constant(string_writer& buf, const uint8_t*& ptr, type_idx type, bool top_level)
+
+
+        global_meta& resolve_global(global_idx global)
         {
-            const auto& t = data.types[type];
+            const bool is_constant = is_constant_flag_set(global);
+            auto& metas = is_constant ? constants_meta : globals_meta;
+            global &= global_flags::constant_mask;
 
-            if (t.is_pointer())
+            ASSERT(metas.is_valid_index(global), "Global index out of range");
+            auto& meta = metas[global];
+            if (meta.is_defined) return meta;
+            meta.is_defined = true;
+
+            const auto& table = is_constant ? data.constants : data.globals;
+
+            const auto& global_info = table.info[global];
+            const auto& global_type = data.types[global_info.type];
+
+            auto& dst_buf = is_constant ? constants : globals;
+
+            const auto name_info = database[global_info.name];
+
+            dst_buf.write_newline();
+            const size_t declaration_offset = dst_buf.size();
+            const auto& global_type_meta = resolve_type(global_type);
+            if (global_type.is_signature())
             {
-                write_hex(buf, *reinterpret_cast<const size_t*>(ptr));
-                ptr += get_base_type_size(type_idx::vptr);
+                const size_t method_handle = *reinterpret_cast<const size_t*>(table.data.data() + global_info.offset);
+                method_idx call_method_idx = method_idx(method_handle - 1);
+
+                dst_buf.write(string_view(global_type_meta.declaration).substr(0, global_type_meta.ptr_offset));
+                if (is_constant) dst_buf.write("const ");
+                dst_buf.write("$", name_info);
+                dst_buf.write(string_view(global_type_meta.declaration).substr(global_type_meta.ptr_offset));
             }
-            else if (t.is_arithmetic())
+            else if (global_type.is_pointer())
             {
-                write_literal(buf, ptr, type);
-                ptr += get_base_type_size(type);
+                dst_buf.write(global_type_meta.declaration);
+                if (is_constant) dst_buf.write(" const");
+                dst_buf.write(" $", name_info);
             }
-            else if (t.is_signature())
+            else
             {
-                size_t method_handle = *reinterpret_cast<const size_t*&>(ptr)++;
-                if (method_handle == 0)
-                {
-                    buf.write("0");
-                }
-                else
-                {
-                    const method_idx call_idx = method_idx(method_handle ^ data.runtime_hash);
-                    ASSERT(data.methods.is_valid_index(call_idx), "Invalid method index");
-
-                    const auto& call_method = get_method(call_idx);
-                    declare_method(call_method);
-                    resolve_method(call_method);
-
-                    buf.write("$", database[call_method.name]);
-                }
+                if (is_constant) dst_buf.write("const ");
+                dst_buf.write(global_type_meta.declaration, " $", name_info);
             }
-            else if (t.is_array())
+
+            if (parameters.translation_units != 0)
             {
-                if (top_level) buf.write("{ ");
-                for (size_t i = 0; i < t.generated.array.array_size; i++)
-                {
-                    if (i != 0) buf.write(", ");
-                    write_constant(buf, ptr, t.generated.array.underlying_type, false);
-                }
-                if (top_level) buf.write(" }");
+                // Split output declares globals in the header
+                auto& declarations = is_constant ? constant_declarations : global_declarations;
+                declarations.write_newline();
+                declarations.write("extern ", string_view(dst_buf).substr(declaration_offset), ";");
             }
-            else
+
+            dst_buf.write(" = ");
+            if (global_type.is_pointer())
             {
-                if (top_level) buf.write("{ ");
-                for (size_t i = 0; i < t.fields.size(); i++)
-                {
-                    if (i != 0) buf.write(", ");
-                    write_constant(buf, ptr, t.fields[i].type, false);
-                }
-                if (top_level) buf.write(" }");
+                // If its a pointer type, we need to cast to dst to silence 'levels of indirection' warning
+                dst_buf.write("(");
+                dst_buf.write(global_type_meta.declaration);
+                if (is_constant) dst_buf.write(" const");
+                dst_buf.write(")");
             }
-        }
+            const uint8_t* addr = table.data.data() + global_info.offset;
+            write_constant(dst_buf, addr, global_type.index, true);
+            dst_buf.write(";");
 
-        inline subcode read_subcode() noexcept
-        {
-            return read_bytecode<subcode>(iptr);
+            return meta;
         }
-        string_address_t read_address(bool is_rhs)
-        {
-            string_writer& buf = get_next_buffer();
-
-            string_address_t result;
-
-            const address_data_t& addr = *reinterpret_cast<const address_data_t*>(iptr);
-
-            const auto& minf = *current_method;
-            const auto& csig = *current_signature;
-
-            bool is_constant = false;
 
-            switch (addr.header.prefix())
+        void resolve_signature(const signature& signature)
+        {
+            for (auto& p : signature.parameters)
             {
-                case address_prefix::indirection: buf.write("*"); break;
-                case address_prefix::address_of: buf.write("&"); break;
-                case address_prefix::size_of: buf.write("sizeof("); break;
+                resolve_type(p.type);
             }
+            resolve_type(signature.return_type);
+        }
 
-            const uint32_t index = addr.header.index();
-            type_idx sv_type = type_idx::invalid;
-            switch (addr.header.type())
+        type_meta& resolve_name_recursive(type_idx t)
+        {
+            const auto& type = get_type(t);
+            auto& meta = type_metas[type.index];
+            if (meta.declaration.empty())
             {
-                case address_type::stackvar:
+                if (!type.is_generated())
                 {
-                    if (index == address_header_constants::index_max)
+                    if (!is_base_type(type.index))
                     {
-                        ASSERT(has_return_value(), "Return value address has not been set");
-
-                        ASSERT(return_type != type_idx::voidtype, "Return value address has not been set");
-
-                        buf.write("$", get_number_str(ret_idx), retval_postfix);
-
-                        result.type_ptr = &get_type(return_type);
+                        meta.generated = "$";
+                        meta.generated.append(database[type.name]);
+                        meta.declaration = type.is_union() ? "union " : "struct ";
+                        meta.declaration.append(meta.generated);
                     }
                     else
                     {
-                        ASSERT(index < minf.stackvars.size(), "Stack index out of range");
-
-                        const auto& stack_var = minf.stackvars[index];
-
-                        buf.write("$", get_number_str(static_cast<size_t>(index)), stack_postfix);
-
-                        result.type_ptr = &get_type(stack_var.type);
-                        sv_type = stack_var.type;
+                        switch (type.index)
+                        {
+                            case type_idx::i8: meta.declaration = "int8_t"; break;
+                            case type_idx::u8: meta.declaration = "uint8_t"; break;
+                            case type_idx::i16: meta.declaration = "int16_t"; break;
+                            case type_idx::u16: meta.declaration = "uint16_t"; break;
+                            case type_idx::i32: meta.declaration = "int32_t"; break;
+                            case type_idx::u32: meta.declaration = "uint32_t"; break;
+                            case type_idx::i64: meta.declaration = "int64_t"; break;
+                            case type_idx::u64: meta.declaration = "uint64_t"; break;
+                            case type_idx::f32: meta.declaration = "float"; break;
+                            case type_idx::f64: meta.declaration = "double"; break;
+                            case type_idx::vptr: meta.declaration = "void"; break;
+                            case type_idx::voidtype: meta.declaration = "void"; break;
+                        }
+                        meta.generated = "$" + meta.declaration;
+                        if (type.index == type_idx::vptr)
+                        {
+                            meta.declaration.push_back('*');
+                            meta.generated.append("$P1");
+                        }
                     }
                 }
-                break;
-
-                case address_type::parameter:
-                {
-                    ASSERT(index < csig.parameters.size(), "Parameter index out of range");
-
-                    buf.write("$", get_number_str(static_cast<size_t>(index)), param_postfix);
-
-                    const auto& param = csig.parameters[index];
-                    result.type_ptr = &get_type(param.type);
-                }
-                break;
-
-                case address_type::global:
-                {
-                    global_idx global = (global_idx)index;
-
-                    method_metas[current_method->index].referenced_globals.emplace(global);
-
-                    is_constant = is_constant_flag_set(global);
-                    const auto& table = is_constant ? data.constants : data.globals;
-                    global &= global_flags::constant_mask;
-
-                    buf.write("$", database[table.info[global].name]);
-
-                    const auto& global_info = table.info[global];
-                    result.type_ptr = &get_type(global_info.type);
-                }
-                break;
-
-                case address_type::constant:
-                {
-                    ASSERT(is_rhs, "Constant cannot be a left-hand side operand");
-                    const type_idx btype_idx = type_idx(index);
-                    ASSERT(btype_idx <= type_idx::vptr, "Malformed constant opcode");
-                    iptr += sizeof(address_header);
-                    uint8_t* ptr = const_cast<uint8_t*>(iptr);
-                    const auto& type = get_type(btype_idx);
-                    string_writer& next_buf = get_next_buffer();
-                    write_literal(next_buf, ptr, type.index);
-                    iptr += type.total_size;
-                    return string_address_t(&type, next_buf);
-                }
-                break;
-            }
-
-            switch (addr.header.modifier())
-            {
-                case address_modifier::none: break;
-
-                case address_modifier::direct_field:
+                else
                 {
-                    const auto& field = data.offsets[addr.field];
+                    if (type.is_pointer())
+                    {
+                        const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
+                        const auto& underlying_meta = resolve_name_recursive(underlying_type.index);
 
-                    const auto& type = *result.type_ptr;
-                    ASSERT(!type.is_pointer(), "Attempted to deref a field on a non-pointer type");
-                    ASSERT(type.index == field.name.object_type, "Field type mismatch");
+                        if (underlying_meta.ptr_offset != 0)
+                        {
+                            meta.declaration.append(string_view(underlying_meta.declaration).substr(0, underlying_meta.ptr_offset));
+                            meta.declaration.append("*");
+                            meta.declaration.append(string_view(underlying_meta.declaration).substr(underlying_meta.ptr_offset));
+                            meta.ptr_offset = underlying_meta.ptr_offset + 1;
+                        }
+                        else
+                        {
+                            meta.declaration.append(underlying_meta.declaration);
+                            meta.declaration.append("*");
+                        }
 
-                    for (auto& it : field.name.field_names)
-                    {
-                        buf.write(".");
-                        buf.write("$", database[it]);
+                        if (underlying_type.is_pointer())
+                        {
+                            meta.ptr_level = underlying_meta.ptr_level + 1;
+                            meta.generated.append(string_view(underlying_meta.generated).substr(0, underlying_meta.generated.find_last_of('$')));
+                            meta.generated.append("$P");
+                            meta.generated.append(get_number_str(meta.ptr_level));
+                        }
+                        else
+                        {
+                            meta.ptr_level = 1;
+                            meta.generated.append(underlying_meta.generated);
+                            meta.generated.append("$P1");
+                        }
                     }
+                    else if (type.is_array())
+                    {
+                        const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
+                        const auto& underlying_meta = resolve_name_recursive(underlying_type.index);
 
-                    result.type_ptr = &get_type(field.type);
-                }
-                break;
+                        meta.generated = underlying_meta.generated;
+                        meta.generated.append("$A");
+                        meta.generated.append(num_conv.convert(type.generated.array.array_size));
 
-                case address_modifier::indirect_field:
-                {
-                    const auto& field = data.offsets[addr.field];
+                        meta.declaration = "struct ";
+                        meta.declaration.append(meta.generated);
+                    }
+                    else if (type.is_signature())
+                    {
+                        meta.generated = "$";
 
-                    const auto& type = *result.type_ptr;
-                    ASSERT(type.is_pointer(), "Attempted to dereference a non-pointer type");
-                    const auto& underlying_type = get_type(type.generated.pointer.underlying_type);
-                    ASSERT(underlying_type.index == field.name.object_type, "Field type mismatch");
+                        const auto& signature = get_signature(type.generated.signature.index);
+                        const auto& ret_type = get_type(signature.return_type);
+                        const auto& return_type_meta = resolve_name_recursive(ret_type.index);
+                        if (return_type_meta.ptr_offset != 0)
+                        {
+                            meta.declaration.append(string_view(return_type_meta.declaration).substr(0, return_type_meta.ptr_offset));
+                        }
+                        else
+                        {
+                            meta.declaration.append(return_type_meta.declaration);
+                        }
 
-                    bool first = true;
-                    for (auto& it : field.name.field_names)
-                    {
-                        buf.write(first ? "->" : ".");
-                        buf.write("$", database[it]);
-                        first = false;
-                    }
+                        meta.generated.append(return_type_meta.generated);
 
-                    result.type_ptr = &data.types[field.type];
-                }
-                break;
+                        meta.ptr_offset = meta.declaration.size() + 2;
+                        meta.declaration.append("(*)(");
+                        for (size_t i = 0; i < signature.parameters.size(); i++)
+                        {
+                            if (i > 0) meta.declaration.append(", ");
+                            const auto& param_type = get_type(signature.parameters[i].type);
+                            const auto& param_type_meta = resolve_name_recursive(param_type.index);
+                            meta.declaration.append(param_type_meta.declaration);
 
-                case address_modifier::offset:
-                {
-                    const offset_t offset = addr.offset;
+                            meta.generated.append(param_type_meta.generated);
+                        }
+                        meta.declaration.append(")");
 
-                    const auto& type = *result.type_ptr;
-                    if (type.is_pointer())
-                    {
-                        result.type_ptr = &get_type(type.generated.pointer.underlying_type);
-                    }
-                    else if (type.is_array())
-                    {
-                        buf.write(".$val");
-                        result.type_ptr = &get_type(type.generated.array.underlying_type);
+                        if (return_type_meta.ptr_offset != 0)
+                        {
+                            meta.declaration.append(string_view(return_type_meta.declaration).substr(return_type_meta.ptr_offset));
+                        }
                     }
                     else
                     {
-                        ASSERT(false, "Offset is not valid here");
+                        meta.generated = meta.declaration = "<???>";
                     }
-                    buf.write('[', num_conv.convert(offset), ']');
                 }
-                break;
             }
+            return meta;
+        }
 
-            switch (addr.header.prefix())
-            {
-                case address_prefix::none: break;
+        void write_constant(string_writer& buf, const uint8_t*& ptr, type_idx type, bool top_level)
+        {
+            const auto& t = data.types[type];
 
-                case address_prefix::indirection:
+            if (t.is_pointer())
+            {
+                write_hex(buf, *reinterpret_cast<const size_t*>(ptr));
+                ptr += get_base_type_size(type_idx::vptr);
+            }
+            else if (t.is_arithmetic())
+            {
+                write_literal(buf, ptr, type);
+                ptr += get_base_type_size(type);
+            }
+            else if (t.is_signature())
+            {
+                size_t method_handle = *reinterpret_cast<const size_t*&>(ptr)++;
+                if (method_handle == 0)
                 {
-                    const auto& type = *result.type_ptr;
-                    ASSERT(type.is_pointer(), "Attempted to dereference a non-pointer type");
-                    ASSERT(type.index != type_idx::vptr, "Attempted to dereference an abstract pointer type");
-
-                    result.type_ptr = &get_type(type.generated.pointer.underlying_type);
+                    buf.write("0");
                 }
-                break;
-
-                case address_prefix::address_of:
+                else
                 {
-                    const type_idx dst_type = result.type_ptr->pointer_type;
-                    result.type_ptr = dst_type == type_idx::invalid ? &vptr_type : &get_type(dst_type);
+                    const method_idx call_idx = method_idx(method_handle ^ data.runtime_hash);
+                    ASSERT(data.methods.is_valid_index(call_idx), "Invalid method index");
 
-                    // Cast away constness
-                    if (is_constant)
-                    {
-                        string tmp = buf;
-                        buf.clear();
-                        write_cast(buf, dst_type);
-                        buf.write(tmp);
-                    }
-                }
-                break;
+                    const auto& call_method = get_method(call_idx);
+                    declare_method(call_method);
+                    resolve_method(call_method);
 
-                case address_prefix::size_of:
+                    buf.write("$", database[call_method.name]);
+                }
+            }
+            else if (t.is_array())
+            {
+                if (top_level) buf.write("{ ");
+                for (size_t i = 0; i < t.generated.array.array_size; i++)
                 {
-                    result.type_ptr = &size_type;
-
-                    buf.write(')');
+                    if (i != 0) buf.write(", ");
+                    write_constant(buf, ptr, t.generated.array.underlying_type, false);
                 }
-                break;
+                if (top_level) buf.write(" }");
             }
-
-            if (addr.header.type() == address_type::stackvar)
+            else
             {
-                if (static_cast<size_t>(index) < stack_vars_used.size() && !stack_vars_used[static_cast<size_t>(index)])
+                if (top_level) buf.write("{ ");
+                const uint8_t* const base_ptr = ptr;
+                for (size_t i = 0; i < t.fields.size(); i++)
                 {
-                    if (addr.header.prefix() == address_prefix::none && addr.header.modifier() == address_modifier::none && !is_rhs)
-                    {
-                        buf.clear();
-                        declare_stackvar(buf, stack_postfix, static_cast<size_t>(index), sv_type);
-                    }
-                    else
-                    {
-                        declare_stackvar(method_body, stack_postfix, static_cast<size_t>(index), sv_type);
-                        method_body.write(";\n", get_indent_str(1));
-                    }
-
-                    stack_vars_used[static_cast<size_t>(index)] = true;
+                    if (i != 0) buf.write(", ");
+                    ptr = base_ptr + t.fields[i].offset;
+                    write_constant(buf, ptr, t.fields[i].type, false);
                 }
+                ptr = base_ptr + t.total_size;
+                if (top_level) buf.write(" }");
             }
-
-            iptr += sizeof(address_data_t);
-
-            result.addr = buf;
-            return result;
         }
 
         void declare_method(const method& method)
@@ -1429,52 +2104,16 @@ namespace propane
                 method_declarations.write_newline();
                 const auto& signature = get_signature(method.signature);
                 resolve_signature(signature);
+                // Optimized output needs to know if the method is inline before it can be declared
+                if (parameters.optimize && !method.is_external() && generate_method(method).is_inline)
+                {
+                    method_declarations.write("static inline ");
+                }
                 generate_method_declaration(method_declarations, method, signature);
                 method_declarations.write(";");
                 method_metas[method.index].fwd_declared = true;
             }
         }
-        void generate_method_declaration(string_writer& dst, const method& method, const signature& signature)
-        {
-            const auto& return_meta = type_metas[signature.return_type];
-            if (return_meta.ptr_offset != 0)
-            {
-                dst.write(string_view(return_meta.declaration).substr(0, return_meta.ptr_offset));
-            }
-            else
-            {
-                dst.write(return_meta.declaration, " ");
-            }
-
-            dst.write("$", database[method.name], "(");
-            for (size_t i = 0; i < signature.parameters.size(); i++)
-            {
-                if (i > 0) dst.write(", ");
-                const type_idx param_type = signature.parameters[i].type;
-                declare_stackvar(dst, param_postfix, i, param_type);
-            }
-            dst.write(')');
-
-            if (return_meta.ptr_offset != 0)
-            {
-                dst.write(string_view(return_meta.declaration).substr(return_meta.ptr_offset));
-            }
-        }
-
-        void declare_stackvar(string_writer& dst, string_view postfix, size_t idx, type_idx type)
-        {
-            const auto& meta = resolve_type(type);
-            if (meta.ptr_offset != 0)
-            {
-                dst.write(string_view(meta.declaration).substr(0, meta.ptr_offset));
-                dst.write("$", get_number_str(idx), postfix);
-                dst.write(string_view(meta.declaration).substr(meta.ptr_offset));
-            }
-            else
-            {
-                dst.write(meta.declaration, " $", get_number_str(idx), postfix);
-            }
-        }
         void declare_field(string_writer& dst, string_view name, type_idx type)
         {
             dst.write(get_indent_str(1));
@@ -1508,53 +2147,31 @@ namespace propane
             dst.write(";");
         }
 
-        type_idx write_return_value(type_idx type)
-        {
-            if (type == type_idx::voidtype)
-            {
-                ret_idx = 0;
-                return type;
-            }
-
-            for (size_t i = 0; i < return_vars.size(); i++)
-            {
-                if (return_vars[i] == type)
-                {
-                    ret_idx = i;
-                    instruction.write("$", get_number_str(ret_idx), retval_postfix, " = ");
-                    return type;
-                }
-            }
+        const translator_c_parameters parameters;
 
-            ret_idx = return_vars.size();
-            declare_stackvar(instruction, retval_postfix, ret_idx, type);
-            instruction.write(" = ");
-            return_vars.push_back(type);
+        // Meta
+        indexed_vector<type_idx, type_meta> type_table;
+        indexed_vector<method_idx, method_meta> method_metas;
+        indexed_vector<global_idx, global_meta> globals_meta;
+        indexed_vector<global_idx, global_meta> constants_meta;
 
-            return type;
-        }
-        bool has_return_value()
-        {
-            return return_type != type_idx::voidtype;
-        }
+        indexed_vector<method_idx, instruction_counts> profile_counts;
 
-        void write_cast(string_writer& dst, type_idx dst_type)
-        {
-            dst.write("(", resolve_name_recursive(dst_type).declaration, ")");
-        }
-        void write_cast(type_idx dst_type)
-        {
-            write_cast(instruction, dst_type);
-        }
+        // Generates the definitions that were not generated in advance
+        method_translator translator;
+        vector<method_idx> definition_order;
 
-        // Type constant
-        const type& int_type;
-        const type& offset_type;
-        const type& size_type;
-        const type& vptr_type;
+        string_writer type_fields;
+        string_writer type_definitions;
+        string_writer constants;
+        string_writer constant_declarations;
+        string_writer globals;
+        string_writer global_declarations;
+        string_writer method_declarations;
+        string_writer file_writer;
     };
 
-    void translator_c::generate(const char* out_file, const assembly& linked_assembly)
+    void translator_c::generate(const char* out_file, const assembly& linked_assembly, translator_c_parameters parameters)
     {
         VALIDATE_ASSEMBLY(linked_assembly.is_valid());
         VALIDATE_COMPATIBILITY(linked_assembly.is_compatible());
@@ -1562,6 +2179,6 @@ namespace propane
         const assembly_data& data = linked_assembly.assembly_ref();
         VALIDATE_ENTRYPOINT(data.methods.is_valid_index(data.main));
 
-        translator_c_impl generator(out_file, data);
+        translator_c_impl generator(out_file, data, parameters, parameters.profile ? &parameters.profile->self() : nullptr);
     }
 }
\ No newline at end of file
@@ -59,6 +59,7 @@ namespace propane
                 if (t.is_external()) continue;
 
                 file_writer.write(t.is_union() ? "union " : "struct ", resolve_type_name(t));
+                if (t.is_packed()) file_writer.write(" packed");
                 file_writer.write_newline();
                 for (auto& f : t.fields)
                 {
@@ -207,6 +208,19 @@ namespace propane
                     case opcode::cge:
                     case opcode::clt:
                     case opcode::cle:
+                    case opcode::vadd:
+                    case opcode::vsub:
+                    case opcode::vmul:
+                    case opcode::vdiv:
+                    case opcode::vmin:
+                    case opcode::vmax:
+                    case opcode::vceq:
+                    case opcode::vcne:
+                    case opcode::vcgt:
+                    case opcode::vcge:
+                    case opcode::vclt:
+                    case opcode::vcle:
+                    case opcode::vshf:
                     {
                         read_subcode();
                         read_address();
@@ -214,6 +228,17 @@ namespace propane
                     }
                     break;
 
+                    case opcode::mcpy:
+                    case opcode::mset:
+                    case opcode::mcmp:
+                    {
+                        read_subcode();
+                        read_address();
+                        read_address();
+                        read_address();
+                    }
+                    break;
+
                     case opcode::br:
                     {
                         read_label();
@@ -255,6 +280,22 @@ namespace propane
                     }
                     break;
 
+                    case opcode::sws:
+                    {
+                        read_address();
+                        const uint32_t case_count = read_bytecode<uint32_t>(iptr);
+
+                        // Values are written as signed integers, which the parser converts back
+                        const uint64_t* values = reinterpret_cast<const uint64_t*>(iptr);
+                        iptr += sizeof(uint64_t) * case_count;
+                        for (uint32_t i = 0; i < case_count; i++)
+                        {
+                            file_writer.write(" ", num_conv.convert(static_cast<int64_t>(values[i])));
+                            read_label();
+                        }
+                    }
+                    break;
+
                     case opcode::call:
                     {
                         const method_idx idx = read_bytecode<method_idx>(iptr);
@@ -302,7 +343,9 @@ namespace propane
         }
         void read_address()
         {
-            const address_data_t& addr = *reinterpret_cast<const address_data_t*>(iptr);
+            uint64_t constant_buffer;
+            const uint8_t* constant = nullptr;
+            const address_data_t addr = read_address_data(iptr, data.encoding, constant_buffer, constant);
 
             file_writer.write_space();
 
@@ -350,11 +393,8 @@ namespace propane
                 case address_type::constant:
                 {
                     const type_idx btype_idx = type_idx(index);
-                    iptr += sizeof(address_header);
-                    uint8_t* ptr = const_cast<uint8_t*>(iptr);
                     const auto& type = data.types[btype_idx];
-                    write_literal(ptr, type.index);
-                    iptr += type.total_size;
+                    write_literal(constant, type.index);
                     return;
                 }
                 break;
@@ -382,8 +422,6 @@ namespace propane
                 }
                 break;
             }
-
-            iptr += sizeof(address_data_t);
         }
         void read_label()
         {
@@ -470,11 +508,14 @@ namespace propane
             }
             else
             {
+                const uint8_t* const base_ptr = ptr;
                 for (size_t i = 0; i < t.fields.size(); i++)
                 {
                     if (i != 0) file_writer.write_space();
+                    ptr = base_ptr + t.fields[i].offset;
                     write_constant(ptr, t.fields[i].type);
                 }
+                ptr = base_ptr + t.total_size;
             }
 
             if (top_level) file_writer.write(" end");
@@ -53,6 +53,7 @@ namespace propane
             OPCODE_STR(bnz);
 
             OPCODE_STR(sw);
+            OPCODE_STR(sws);
 
             OPCODE_STR(call);
             OPCODE_STR(callv);
@@ -61,6 +62,23 @@ namespace propane
 
             OPCODE_STR(dump);
 
+            OPCODE_STR(vadd);
+            OPCODE_STR(vsub);
+            OPCODE_STR(vmul);
+            OPCODE_STR(vdiv);
+            OPCODE_STR(vmin);
+            OPCODE_STR(vmax);
+            OPCODE_STR(vceq);
+            OPCODE_STR(vcne);
+            OPCODE_STR(vcgt);
+            OPCODE_STR(vcge);
+            OPCODE_STR(vclt);
+            OPCODE_STR(vcle);
+            OPCODE_STR(vshf);
+            OPCODE_STR(mcpy);
+            OPCODE_STR(mset);
+            OPCODE_STR(mcmp);
+
             default: ASSERT(false, "Unknown opcode"); return string_view();
         }
     }
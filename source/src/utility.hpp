@@ -5,8 +5,63 @@
 #include "propane_literals.hpp"
 #include "runtime.hpp"
 
+#include <thread>
+#include <atomic>
+
 namespace propane
 {
+    // Threading
+    inline size_t resolve_thread_count(size_t thread_count, size_t job_count) noexcept
+    {
+        if (thread_count == 0)
+        {
+            thread_count = static_cast<size_t>(std::thread::hardware_concurrency());
+            if (thread_count == 0) thread_count = 1;
+        }
+        return std::min(thread_count, job_count);
+    }
+    // Invokes func(index) for every index in [0, count), distributed over
+    // the specified amount of threads (zero uses the hardware concurrency).
+    // The calling thread participates. If any invocation throws, the
+    // remaining jobs are abandoned and the first exception is rethrown.
+    template<typename func_t> void parallel_for(size_t count, size_t thread_count, func_t func)
+    {
+        thread_count = resolve_thread_count(thread_count, count);
+        if (thread_count <= 1)
+        {
+            for (size_t i = 0; i < count; i++) func(i);
+            return;
+        }
+
+        std::atomic<size_t> next_job = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr exception;
+        auto worker = [&]()
+        {
+            try
+            {
+                while (!failed)
+                {
+                    const size_t idx = next_job++;
+                    if (idx >= count) break;
+                    func(idx);
+                }
+            }
+            catch (...)
+            {
+                if (!failed.exchange(true)) exception = std::current_exception();
+            }
+        };
+
+        vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+        for (size_t i = 1; i < thread_count; i++) threads.emplace_back(worker);
+        worker();
+        for (auto& it : threads) it.join();
+
+        if (exception) std::rethrow_exception(exception);
+    }
+
     // Parsing
     inline bool is_literal(char c) noexcept
     {
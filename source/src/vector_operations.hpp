@@ -0,0 +1,353 @@
+#ifndef _HEADER_VECTOR_OPERATIONS
+#define _HEADER_VECTOR_OPERATIONS
+
+#include "runtime.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECTOR_OPERATIONS_SSE2 1
+#include <emmintrin.h>
+#else
+#define VECTOR_OPERATIONS_SSE2 0
+#endif
+
+#if defined(__AVX__)
+#define VECTOR_OPERATIONS_AVX 1
+#include <immintrin.h>
+#else
+#define VECTOR_OPERATIONS_AVX 0
+#endif
+
+// Division requires AArch64
+#if (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define VECTOR_OPERATIONS_NEON 1
+#include <arm_neon.h>
+#else
+#define VECTOR_OPERATIONS_NEON 0
+#endif
+
+// The subcode dispatch is forced inline, so that it resolves at compile time for constant subcodes
+#if defined(_MSC_VER)
+#define VECTOR_OPERATIONS_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define VECTOR_OPERATIONS_INLINE inline __attribute__((always_inline))
+#else
+#define VECTOR_OPERATIONS_INLINE inline
+#endif
+
+namespace propane
+{
+    // Element-wise vector operations (matches the translated C vector extensions)
+    // Operands are not required to be aligned. Integer arithmetic wraps around, comparisons
+    // set every lane to all bits one if true and all bits zero if false, and shuffles select
+    // the lanes of the left-hand operand by the (unsigned) index modulo the lane count.
+    // The generic implementation is element-wise, shapes that map onto a native register
+    // (SSE2, AVX or NEON) use intrinsics instead.
+    namespace vector_operations
+    {
+        enum class vector_op
+        {
+            add,
+            sub,
+            mul,
+            div,
+            min,
+            max,
+            ceq,
+            cne,
+            cgt,
+            cge,
+            clt,
+            cle,
+        };
+        inline constexpr bool is_comparison(vector_op op) noexcept
+        {
+            return op >= vector_op::ceq;
+        }
+
+        template<size_t size> struct lane_bits;
+        template<> struct lane_bits<1> { typedef uint8_t type; };
+        template<> struct lane_bits<2> { typedef uint16_t type; };
+        template<> struct lane_bits<4> { typedef uint32_t type; };
+        template<> struct lane_bits<8> { typedef uint64_t type; };
+        template<typename value_t> using lane_bits_t = typename lane_bits<sizeof(value_t)>::type;
+
+        template<vector_op op, typename value_t> inline value_t evaluate_lane(value_t lhs, value_t rhs) noexcept
+        {
+            if constexpr (is_comparison(op))
+            {
+                bool result;
+                if constexpr (op == vector_op::ceq) result = lhs == rhs;
+                else if constexpr (op == vector_op::cne) result = lhs != rhs;
+                else if constexpr (op == vector_op::cgt) result = lhs > rhs;
+                else if constexpr (op == vector_op::cge) result = lhs >= rhs;
+                else if constexpr (op == vector_op::clt) result = lhs < rhs;
+                else result = lhs <= rhs;
+
+                const lane_bits_t<value_t> mask = result ? lane_bits_t<value_t>(~lane_bits_t<value_t>(0)) : lane_bits_t<value_t>(0);
+                value_t lane;
+                memcpy(&lane, &mask, sizeof(lane));
+                return lane;
+            }
+            else if constexpr (op == vector_op::min)
+            {
+                return rhs < lhs ? rhs : lhs;
+            }
+            else if constexpr (op == vector_op::max)
+            {
+                return rhs > lhs ? rhs : lhs;
+            }
+            else if constexpr (op == vector_op::div)
+            {
+                return value_t(lhs / rhs);
+            }
+            else if constexpr (std::is_integral_v<value_t>)
+            {
+                // Integer arithmetic is evaluated unsigned, so that signed overflow wraps around
+                typedef std::make_unsigned_t<value_t> unsigned_t;
+                unsigned_t result;
+                if constexpr (op == vector_op::add) result = unsigned_t(unsigned_t(lhs) + unsigned_t(rhs));
+                else if constexpr (op == vector_op::sub) result = unsigned_t(unsigned_t(lhs) - unsigned_t(rhs));
+                else result = unsigned_t(unsigned_t(lhs) * unsigned_t(rhs));
+                return value_t(result);
+            }
+            else
+            {
+                if constexpr (op == vector_op::add) return lhs + rhs;
+                else if constexpr (op == vector_op::sub) return lhs - rhs;
+                else return lhs * rhs;
+            }
+        }
+
+#if VECTOR_OPERATIONS_SSE2
+        template<vector_op op> inline __m128 evaluate_native(__m128 lhs, __m128 rhs) noexcept
+        {
+            if constexpr (op == vector_op::add) return _mm_add_ps(lhs, rhs);
+            else if constexpr (op == vector_op::sub) return _mm_sub_ps(lhs, rhs);
+            else if constexpr (op == vector_op::mul) return _mm_mul_ps(lhs, rhs);
+            else if constexpr (op == vector_op::div) return _mm_div_ps(lhs, rhs);
+            else if constexpr (op == vector_op::min) return _mm_min_ps(rhs, lhs);
+            else if constexpr (op == vector_op::max) return _mm_max_ps(rhs, lhs);
+            else if constexpr (op == vector_op::ceq) return _mm_cmpeq_ps(lhs, rhs);
+            else if constexpr (op == vector_op::cne) return _mm_cmpneq_ps(lhs, rhs);
+            else if constexpr (op == vector_op::cgt) return _mm_cmpgt_ps(lhs, rhs);
+            else if constexpr (op == vector_op::cge) return _mm_cmpge_ps(lhs, rhs);
+            else if constexpr (op == vector_op::clt) return _mm_cmplt_ps(lhs, rhs);
+            else return _mm_cmple_ps(lhs, rhs);
+        }
+        template<vector_op op> inline __m128d evaluate_native(__m128d lhs, __m128d rhs) noexcept
+        {
+            if constexpr (op == vector_op::add) return _mm_add_pd(lhs, rhs);
+            else if constexpr (op == vector_op::sub) return _mm_sub_pd(lhs, rhs);
+            else if constexpr (op == vector_op::mul) return _mm_mul_pd(lhs, rhs);
+            else if constexpr (op == vector_op::div) return _mm_div_pd(lhs, rhs);
+            else if constexpr (op == vector_op::min) return _mm_min_pd(rhs, lhs);
+            else if constexpr (op == vector_op::max) return _mm_max_pd(rhs, lhs);
+            else if constexpr (op == vector_op::ceq) return _mm_cmpeq_pd(lhs, rhs);
+            else if constexpr (op == vector_op::cne) return _mm_cmpneq_pd(lhs, rhs);
+            else if constexpr (op == vector_op::cgt) return _mm_cmpgt_pd(lhs, rhs);
+            else if constexpr (op == vector_op::cge) return _mm_cmpge_pd(lhs, rhs);
+            else if constexpr (op == vector_op::clt) return _mm_cmplt_pd(lhs, rhs);
+            else return _mm_cmple_pd(lhs, rhs);
+        }
+        // Integer addition and subtraction (other integer operations are element-wise)
+        template<vector_op op, size_t element_size> inline __m128i evaluate_native(__m128i lhs, __m128i rhs) noexcept
+        {
+            if constexpr (op == vector_op::add)
+            {
+                if constexpr (element_size == 1) return _mm_add_epi8(lhs, rhs);
+                else if constexpr (element_size == 2) return _mm_add_epi16(lhs, rhs);
+                else if constexpr (element_size == 4) return _mm_add_epi32(lhs, rhs);
+                else return _mm_add_epi64(lhs, rhs);
+            }
+            else
+            {
+                if constexpr (element_size == 1) return _mm_sub_epi8(lhs, rhs);
+                else if constexpr (element_size == 2) return _mm_sub_epi16(lhs, rhs);
+                else if constexpr (element_size == 4) return _mm_sub_epi32(lhs, rhs);
+                else return _mm_sub_epi64(lhs, rhs);
+            }
+        }
+#endif
+
+#if VECTOR_OPERATIONS_AVX
+        template<vector_op op> inline __m256 evaluate_native(__m256 lhs, __m256 rhs) noexcept
+        {
+            if constexpr (op == vector_op::add) return _mm256_add_ps(lhs, rhs);
+            else if constexpr (op == vector_op::sub) return _mm256_sub_ps(lhs, rhs);
+            else if constexpr (op == vector_op::mul) return _mm256_mul_ps(lhs, rhs);
+            else if constexpr (op == vector_op::div) return _mm256_div_ps(lhs, rhs);
+            else if constexpr (op == vector_op::min) return _mm256_min_ps(rhs, lhs);
+            else if constexpr (op == vector_op::max) return _mm256_max_ps(rhs, lhs);
+            else if constexpr (op == vector_op::ceq) return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ);
+            else if constexpr (op == vector_op::cne) return _mm256_cmp_ps(lhs, rhs, _CMP_NEQ_UQ);
+            else if constexpr (op == vector_op::cgt) return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ);
+            else if constexpr (op == vector_op::cge) return _mm256_cmp_ps(lhs, rhs, _CMP_GE_OQ);
+            else if constexpr (op == vector_op::clt) return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ);
+            else return _mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ);
+        }
+        template<vector_op op> inline __m256d evaluate_native(__m256d lhs, __m256d rhs) noexcept
+        {
+            if constexpr (op == vector_op::add) return _mm256_add_pd(lhs, rhs);
+            else if constexpr (op == vector_op::sub) return _mm256_sub_pd(lhs, rhs);
+            else if constexpr (op == vector_op::mul) return _mm256_mul_pd(lhs, rhs);
+            else if constexpr (op == vector_op::div) return _mm256_div_pd(lhs, rhs);
+            else if constexpr (op == vector_op::min) return _mm256_min_pd(rhs, lhs);
+            else if constexpr (op == vector_op::max) return _mm256_max_pd(rhs, lhs);
+            else if constexpr (op == vector_op::ceq) return _mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ);
+            else if constexpr (op == vector_op::cne) return _mm256_cmp_pd(lhs, rhs, _CMP_NEQ_UQ);
+            else if constexpr (op == vector_op::cgt) return _mm256_cmp_pd(lhs, rhs, _CMP_GT_OQ);
+            else if constexpr (op == vector_op::cge) return _mm256_cmp_pd(lhs, rhs, _CMP_GE_OQ);
+            else if constexpr (op == vector_op::clt) return _mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ);
+            else return _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ);
+        }
+#endif
+
+#if VECTOR_OPERATIONS_NEON
+        template<vector_op op> inline float32x4_t evaluate_native(float32x4_t lhs, float32x4_t rhs) noexcept
+        {
+            if constexpr (op == vector_op::add) return vaddq_f32(lhs, rhs);
+            else if constexpr (op == vector_op::sub) return vsubq_f32(lhs, rhs);
+            else if constexpr (op == vector_op::mul) return vmulq_f32(lhs, rhs);
+            else if constexpr (op == vector_op::div) return vdivq_f32(lhs, rhs);
+            // NEON min and max propagate NaN, select instead to match the generic implementation
+            else if constexpr (op == vector_op::min) return vbslq_f32(vcltq_f32(rhs, lhs), rhs, lhs);
+            else if constexpr (op == vector_op::max) return vbslq_f32(vcgtq_f32(rhs, lhs), rhs, lhs);
+            else if constexpr (op == vector_op::ceq) return vreinterpretq_f32_u32(vceqq_f32(lhs, rhs));
+            else if constexpr (op == vector_op::cne) return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(lhs, rhs)));
+            else if constexpr (op == vector_op::cgt) return vreinterpretq_f32_u32(vcgtq_f32(lhs, rhs));
+            else if constexpr (op == vector_op::cge) return vreinterpretq_f32_u32(vcgeq_f32(lhs, rhs));
+            else if constexpr (op == vector_op::clt) return vreinterpretq_f32_u32(vcltq_f32(lhs, rhs));
+            else return vreinterpretq_f32_u32(vcleq_f32(lhs, rhs));
+        }
+#endif
+
+        template<vector_op op, typename value_t, size_t lanes> inline void evaluate_vector(uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            constexpr size_t size = sizeof(value_t) * lanes;
+
+#if VECTOR_OPERATIONS_SSE2
+            if constexpr (size == 16 && std::is_same_v<value_t, float>)
+            {
+                const __m128 lhs = _mm_loadu_ps(reinterpret_cast<const float*>(lhs_addr));
+                const __m128 rhs = _mm_loadu_ps(reinterpret_cast<const float*>(rhs_addr));
+                _mm_storeu_ps(reinterpret_cast<float*>(lhs_addr), evaluate_native<op>(lhs, rhs));
+                return;
+            }
+            else if constexpr (size == 16 && std::is_same_v<value_t, double>)
+            {
+                const __m128d lhs = _mm_loadu_pd(reinterpret_cast<const double*>(lhs_addr));
+                const __m128d rhs = _mm_loadu_pd(reinterpret_cast<const double*>(rhs_addr));
+                _mm_storeu_pd(reinterpret_cast<double*>(lhs_addr), evaluate_native<op>(lhs, rhs));
+                return;
+            }
+            else if constexpr (size == 16 && std::is_integral_v<value_t> && (op == vector_op::add || op == vector_op::sub))
+            {
+                const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs_addr));
+                const __m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_addr));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lhs_addr), evaluate_native<op, sizeof(value_t)>(lhs, rhs));
+                return;
+            }
+#endif
+#if VECTOR_OPERATIONS_AVX
+            if constexpr (size == 32 && std::is_same_v<value_t, float>)
+            {
+                const __m256 lhs = _mm256_loadu_ps(reinterpret_cast<const float*>(lhs_addr));
+                const __m256 rhs = _mm256_loadu_ps(reinterpret_cast<const float*>(rhs_addr));
+                _mm256_storeu_ps(reinterpret_cast<float*>(lhs_addr), evaluate_native<op>(lhs, rhs));
+                return;
+            }
+            else if constexpr (size == 32 && std::is_same_v<value_t, double>)
+            {
+                const __m256d lhs = _mm256_loadu_pd(reinterpret_cast<const double*>(lhs_addr));
+                const __m256d rhs = _mm256_loadu_pd(reinterpret_cast<const double*>(rhs_addr));
+                _mm256_storeu_pd(reinterpret_cast<double*>(lhs_addr), evaluate_native<op>(lhs, rhs));
+                return;
+            }
+#endif
+#if VECTOR_OPERATIONS_NEON
+            if constexpr (size == 16 && std::is_same_v<value_t, float>)
+            {
+                const float32x4_t lhs = vld1q_f32(reinterpret_cast<const float*>(lhs_addr));
+                const float32x4_t rhs = vld1q_f32(reinterpret_cast<const float*>(rhs_addr));
+                vst1q_f32(reinterpret_cast<float*>(lhs_addr), evaluate_native<op>(lhs, rhs));
+                return;
+            }
+#endif
+
+            value_t lhs[lanes], rhs[lanes];
+            memcpy(lhs, lhs_addr, size);
+            memcpy(rhs, rhs_addr, size);
+            for (size_t i = 0; i < lanes; i++) lhs[i] = evaluate_lane<op>(lhs[i], rhs[i]);
+            memcpy(lhs_addr, lhs, size);
+        }
+
+        template<typename value_t, size_t lanes> inline void shuffle_vector(uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            constexpr size_t size = sizeof(value_t) * lanes;
+
+            lane_bits_t<value_t> src[lanes], dst[lanes], indices[lanes];
+            memcpy(src, lhs_addr, size);
+            memcpy(indices, rhs_addr, size);
+            for (size_t i = 0; i < lanes; i++) dst[i] = src[indices[i] % lanes];
+            memcpy(lhs_addr, dst, size);
+        }
+
+        // Vector type (subcode) dispatch, see vector_types
+        template<typename handler_t> VECTOR_OPERATIONS_INLINE void dispatch(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            switch (sub)
+            {
+                case subcode(0): handler_t::template invoke<int8_t, 16>(lhs_addr, rhs_addr); return;
+                case subcode(1): handler_t::template invoke<uint8_t, 16>(lhs_addr, rhs_addr); return;
+                case subcode(2): handler_t::template invoke<int16_t, 8>(lhs_addr, rhs_addr); return;
+                case subcode(3): handler_t::template invoke<uint16_t, 8>(lhs_addr, rhs_addr); return;
+                case subcode(4): handler_t::template invoke<int32_t, 4>(lhs_addr, rhs_addr); return;
+                case subcode(5): handler_t::template invoke<uint32_t, 4>(lhs_addr, rhs_addr); return;
+                case subcode(6): handler_t::template invoke<int64_t, 2>(lhs_addr, rhs_addr); return;
+                case subcode(7): handler_t::template invoke<uint64_t, 2>(lhs_addr, rhs_addr); return;
+                case subcode(8): handler_t::template invoke<float, 4>(lhs_addr, rhs_addr); return;
+                case subcode(9): handler_t::template invoke<double, 2>(lhs_addr, rhs_addr); return;
+                case subcode(10): handler_t::template invoke<int8_t, 32>(lhs_addr, rhs_addr); return;
+                case subcode(11): handler_t::template invoke<uint8_t, 32>(lhs_addr, rhs_addr); return;
+                case subcode(12): handler_t::template invoke<int16_t, 16>(lhs_addr, rhs_addr); return;
+                case subcode(13): handler_t::template invoke<uint16_t, 16>(lhs_addr, rhs_addr); return;
+                case subcode(14): handler_t::template invoke<int32_t, 8>(lhs_addr, rhs_addr); return;
+                case subcode(15): handler_t::template invoke<uint32_t, 8>(lhs_addr, rhs_addr); return;
+                case subcode(16): handler_t::template invoke<int64_t, 4>(lhs_addr, rhs_addr); return;
+                case subcode(17): handler_t::template invoke<uint64_t, 4>(lhs_addr, rhs_addr); return;
+                case subcode(18): handler_t::template invoke<float, 8>(lhs_addr, rhs_addr); return;
+                case subcode(19): handler_t::template invoke<double, 4>(lhs_addr, rhs_addr); return;
+            }
+        }
+        static_assert(vector_type_count == 20, "Vector type dispatch mismatch");
+
+        template<vector_op op> struct operation_handler
+        {
+            template<typename value_t, size_t lanes> static void invoke(uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+            {
+                evaluate_vector<op, value_t, lanes>(lhs_addr, rhs_addr);
+            }
+        };
+        struct shuffle_handler
+        {
+            template<typename value_t, size_t lanes> static void invoke(uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+            {
+                shuffle_vector<value_t, lanes>(lhs_addr, rhs_addr);
+            }
+        };
+
+        template<vector_op op> VECTOR_OPERATIONS_INLINE void evaluate(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            dispatch<operation_handler<op>>(sub, lhs_addr, rhs_addr);
+        }
+        VECTOR_OPERATIONS_INLINE void shuffle(subcode sub, uint8_t* lhs_addr, const uint8_t* rhs_addr) noexcept
+        {
+            dispatch<shuffle_handler>(sub, lhs_addr, rhs_addr);
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -3,9 +3,9 @@
 
 #define PROPANE_VERSION_MAJOR 1
 #define PROPANE_VERSION_MINOR 1
-#define PROPANE_VERSION_CHANGELIST 2327
+#define PROPANE_VERSION_CHANGELIST 2334
 
 // Minimum supported changelist
-#define PROPANE_VERSION_CHANGELIST_MIN 2313
+#define PROPANE_VERSION_CHANGELIST_MIN 2334
 
 #endif
\ No newline at end of file
@@ -0,0 +1,506 @@
+// Toolchain benchmark
+// Generates a corpus of workloads and times every stage of the toolchain on them:
+// generator finalize, parsing, pairwise, builder and batch merging, linking, execution and C translation.
+// Results are written as JSON, which can be compared across commits.
+//
+// Usage: benchmark [-iterations <count>] [-scale <factor>] [-filter <workload>] [-dir <directory>] [-out <file>]
+// The generated workload sources (.ptf) and translations (.c) are written to the directory
+// (benchmark_workloads by default), results are written to stdout unless an output file is provided.
+//
+// Requires the public include path (source/include) and all toolchain sources.
+
+#include "propane_generator.hpp"
+#include "propane_parser.hpp"
+#include "propane_assembly.hpp"
+#include "propane_library.hpp"
+#include "propane_translator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace propane;
+
+    struct benchmark_options
+    {
+        size_t iterations = 5;
+        double scale = 1.0;
+        std::string filter;
+        std::string directory = "benchmark_workloads";
+        std::string output;
+    };
+
+    struct benchmark_result
+    {
+        std::string workload;
+        std::string stage;
+        std::vector<double> samples;
+    };
+
+    size_t scaled(const benchmark_options& options, size_t count)
+    {
+        return std::max(size_t(1), static_cast<size_t>(static_cast<double>(count) * options.scale));
+    }
+
+    // External call used by the native workload
+    int64_t bench_native(int32_t value, int64_t accumulator)
+    {
+        return (accumulator ^ value) + 1;
+    }
+
+    void discard_output(const char*, size_t)
+    {
+
+    }
+
+
+    // Workload sources
+    std::string arithmetic_source(size_t iterations)
+    {
+        std::stringstream src;
+        src << "method main returns int\n"
+            "\tstack\n\t\tlong acc\n\t\tlong tmp\n\t\tint i\n\tend\n"
+            "\tset acc 1l\n"
+            "\tset i 0\n"
+            "loop:\n"
+            "\tset tmp acc\n"
+            "\tmul tmp 3l\n"
+            "\txor tmp i\n"
+            "\tadd acc tmp\n"
+            "\trsh acc 1\n"
+            "\tadd i 1\n"
+            "\tblt loop i " << iterations << "\n"
+            "\tretv 0\n"
+            "end\n";
+        return src.str();
+    }
+    std::string recursion_source(size_t depth)
+    {
+        std::stringstream src;
+        src << "method Fib returns int parameters\n\t\tint n\n\tend\n"
+            "\tstack\n\t\tint a\n\t\tint b\n\tend\n"
+            "\tbge rec n 2\n"
+            "\tretv n\n"
+            "rec:\n"
+            "\tset a n\n"
+            "\tsub a 1\n"
+            "\tcall Fib a\n"
+            "\tset b {^}\n"
+            "\tsub a 1\n"
+            "\tcall Fib a\n"
+            "\tadd b {^}\n"
+            "\tretv b\n"
+            "end\n"
+            "method main returns int\n"
+            "\tcall Fib " << depth << "\n"
+            "\tretv 0\n"
+            "end\n";
+        return src.str();
+    }
+    std::string struct_source(size_t iterations)
+    {
+        std::stringstream src;
+        src << "struct Vec3\n\tfloat x\n\tfloat y\n\tfloat z\nend\n"
+            "struct Particle\n\tVec3 position\n\tVec3 velocity\n\tint id\nend\n"
+            "method Step parameters\n\t\tParticle* p\n\tend\n"
+            "\tadd p->Particle:position.x p->Particle:velocity.x\n"
+            "\tadd p->Particle:position.y p->Particle:velocity.y\n"
+            "\tadd p->Particle:position.z p->Particle:velocity.z\n"
+            "\tmul p->Particle:velocity.y 0.99f\n"
+            "end\n"
+            "method main returns int\n"
+            "\tstack\n\t\tParticle particle\n\t\tint i\n\tend\n"
+            "\tset particle.Particle:position.x 0.0f\n"
+            "\tset particle.Particle:position.y 0.0f\n"
+            "\tset particle.Particle:position.z 0.0f\n"
+            "\tset particle.Particle:velocity.x 1.0f\n"
+            "\tset particle.Particle:velocity.y 2.0f\n"
+            "\tset particle.Particle:velocity.z 3.0f\n"
+            "\tset particle.Particle:id 1\n"
+            "\tset i 0\n"
+            "loop:\n"
+            "\tcall Step &particle\n"
+            "\tadd i 1\n"
+            "\tblt loop i " << iterations << "\n"
+            "\tretv 0\n"
+            "end\n";
+        return src.str();
+    }
+    std::string vtable_source(size_t iterations)
+    {
+        std::stringstream src;
+        src << "struct VTable\n\tint(Shape*) area\nend\n"
+            "struct Shape\n\tVTable* vt\n\tint width\n\tint height\nend\n"
+            "method RectArea returns int parameters\n\t\tShape* s\n\tend\n"
+            "\tstack\n\t\tint r\n\tend\n"
+            "\tset r s->Shape:width\n"
+            "\tmul r s->Shape:height\n"
+            "\tretv r\n"
+            "end\n"
+            "method TriangleArea returns int parameters\n\t\tShape* s\n\tend\n"
+            "\tstack\n\t\tint r\n\tend\n"
+            "\tset r s->Shape:width\n"
+            "\tmul r s->Shape:height\n"
+            "\trsh r 1\n"
+            "\tretv r\n"
+            "end\n"
+            "method main returns int\n"
+            "\tstack\n\t\tVTable rect_vt\n\t\tVTable triangle_vt\n\t\tShape rect\n\t\tShape triangle\n\t\tShape* s\n\t\tVTable* vt\n\t\tlong total\n\t\tint i\n\t\tint odd\n\tend\n"
+            "\tset rect_vt.VTable:area RectArea\n"
+            "\tset triangle_vt.VTable:area TriangleArea\n"
+            "\tset rect.Shape:vt &rect_vt\n"
+            "\tset rect.Shape:width 3\n"
+            "\tset rect.Shape:height 4\n"
+            "\tset triangle.Shape:vt &triangle_vt\n"
+            "\tset triangle.Shape:width 5\n"
+            "\tset triangle.Shape:height 6\n"
+            "\tset total 0l\n"
+            "\tset i 0\n"
+            "loop:\n"
+            "\tset s &rect\n"
+            "\tset odd i\n"
+            "\tand odd 1\n"
+            "\tbze dispatch odd\n"
+            "\tset s &triangle\n"
+            "dispatch:\n"
+            "\tset vt s->Shape:vt\n"
+            "\tcallv vt->VTable:area s\n"
+            "\tadd total {^}\n"
+            "\tadd i 1\n"
+            "\tblt loop i " << iterations << "\n"
+            "\tretv 0\n"
+            "end\n";
+        return src.str();
+    }
+    std::string native_source(size_t iterations)
+    {
+        std::stringstream src;
+        src << "method main returns int\n"
+            "\tstack\n\t\tlong acc\n\t\tint i\n\tend\n"
+            "\tset acc 0l\n"
+            "\tset i 0\n"
+            "loop:\n"
+            "\tcall bench_native i acc\n"
+            "\tset acc {^}\n"
+            "\tadd i 1\n"
+            "\tblt loop i " << iterations << "\n"
+            "\tretv 0\n"
+            "end\n";
+        return src.str();
+    }
+    // Large assembly, split into parts (for merging). Methods are grouped in chains
+    // of chain_length where every method calls the previous method in the chain.
+    constexpr size_t chain_length = 8;
+    std::string large_source(size_t method_count, size_t part, size_t part_count)
+    {
+        std::stringstream src;
+        const size_t begin = method_count * part / part_count;
+        const size_t end = method_count * (part + 1) / part_count;
+        for (size_t i = begin; i < end; i++)
+        {
+            src << "method Method" << i << " returns int parameters\n\t\tint value\n\tend\n"
+                "\tstack\n\t\tint r\n\tend\n"
+                "\tset r value\n"
+                "\tmul r 3\n"
+                "\tadd r " << i << "\n";
+            if (i % chain_length != 0)
+            {
+                src << "\tcall Method" << (i - 1) << " r\n"
+                    "\tset r {^}\n";
+            }
+            src << "\tretv r\n"
+                "end\n";
+        }
+        if (part == 0)
+        {
+            src << "method main returns int\n"
+                "\tstack\n\t\tint total\n\tend\n"
+                "\tset total 0\n";
+            for (size_t i = chain_length - 1; i < method_count; i += chain_length)
+            {
+                src << "\tcall Method" << i << " total\n"
+                    "\tset total {^}\n";
+            }
+            src << "\tretv 0\n"
+                "end\n";
+        }
+        return src.str();
+    }
+
+    // Same layout as the large source, written through the generator
+    void generate_large(generator& gen, size_t method_count)
+    {
+        const signature_idx method_signature = gen.make_signature(type_idx::i32, { type_idx::i32 });
+        std::vector<method_idx> methods(method_count);
+        for (size_t i = 0; i < method_count; i++)
+        {
+            methods[i] = gen.declare_method("Method" + std::to_string(i));
+        }
+        for (size_t i = 0; i < method_count; i++)
+        {
+            generator::method_writer& writer = gen.define_method(methods[i], method_signature);
+            writer.push(type_idx::i32);
+            writer.write_set(stack(0), param(0));
+            writer.write_mul(stack(0), constant(int32_t(3)));
+            writer.write_add(stack(0), constant(int32_t(i)));
+            if (i % chain_length != 0)
+            {
+                writer.write_call(methods[i - 1], { stack(0) });
+                writer.write_set(stack(0), retval());
+            }
+            writer.write_retv(stack(0));
+            writer.finalize();
+        }
+
+        generator::method_writer& main = gen.define_method("main", gen.make_signature(type_idx::i32));
+        main.push(type_idx::i32);
+        main.write_set(stack(0), constant(int32_t(0)));
+        for (size_t i = chain_length - 1; i < method_count; i += chain_length)
+        {
+            main.write_call(methods[i], { stack(0) });
+            main.write_set(stack(0), retval());
+        }
+        main.write_retv(constant(int32_t(0)));
+        main.finalize();
+    }
+
+
+    class benchmark_suite
+    {
+    public:
+        benchmark_suite(const benchmark_options& options) :
+            options(options),
+            native_library("bench", false, { external_call::bind<int64_t(int32_t, int64_t)>("bench_native", bench_native) }),
+            env(native_library),
+            rt(env)
+        {
+            parameters.print_method = discard_output;
+        }
+
+        void run()
+        {
+            namespace fs = std::filesystem;
+            fs::create_directories(options.directory);
+
+            run_workload("arithmetic", { arithmetic_source(scaled(options, 2000000)) });
+            run_workload("recursion", { recursion_source(std::min(size_t(30), scaled(options, 24))) });
+            run_workload("struct", { struct_source(scaled(options, 1000000)) });
+            run_workload("vtable", { vtable_source(scaled(options, 1000000)) });
+            run_workload("native", { native_source(scaled(options, 1000000)) });
+
+            const size_t method_count = scaled(options, 12000);
+            constexpr size_t part_count = 16;
+            std::vector<std::string> parts;
+            for (size_t i = 0; i < part_count; i++)
+            {
+                parts.push_back(large_source(method_count, i, part_count));
+            }
+            run_workload("large", parts);
+
+            if (enabled("large"))
+            {
+                measure("large", "generator_finalize", [&]()
+                {
+                    generator gen("large");
+                    generate_large(gen, method_count);
+                    return time([&]() { gen.finalize(); });
+                });
+            }
+        }
+
+        void write(std::ostream& stream) const
+        {
+            const toolchain_version version = toolchain_version::current();
+            stream << "{\n";
+            stream << "  \"version\": \"" << version.major() << '.' << version.minor() << '.' << version.changelist() << "\",\n";
+            stream << "  \"iterations\": " << options.iterations << ",\n";
+            stream << "  \"scale\": " << options.scale << ",\n";
+            stream << "  \"results\": [\n";
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                std::vector<double> samples = results[i].samples;
+                std::sort(samples.begin(), samples.end());
+                double total = 0;
+                for (double sample : samples) total += sample;
+
+                stream << "    { \"workload\": \"" << results[i].workload << "\", \"stage\": \"" << results[i].stage << "\""
+                    << ", \"min_ns\": " << static_cast<uint64_t>(samples.front())
+                    << ", \"median_ns\": " << static_cast<uint64_t>(samples[samples.size() / 2])
+                    << ", \"mean_ns\": " << static_cast<uint64_t>(total / static_cast<double>(samples.size())) << " }"
+                    << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+            stream << "  ]\n";
+            stream << "}\n";
+        }
+
+    private:
+        bool enabled(const std::string& workload) const
+        {
+            return options.filter.empty() || options.filter == workload;
+        }
+
+        static double time(const std::function<void()>& func)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const auto end = std::chrono::steady_clock::now();
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+        // The function returns the duration of the measured part of one iteration
+        void measure(const std::string& workload, const std::string& stage, const std::function<double()>& iteration)
+        {
+            benchmark_result result{ workload, stage };
+            for (size_t i = 0; i < options.iterations; i++)
+            {
+                result.samples.push_back(iteration());
+            }
+            std::cerr << workload << ' ' << stage << ": " << static_cast<uint64_t>(*std::min_element(result.samples.begin(), result.samples.end())) << "ns" << std::endl;
+            results.push_back(std::move(result));
+        }
+
+        void run_workload(const std::string& workload, const std::vector<std::string>& sources)
+        {
+            if (!enabled(workload)) return;
+
+            // Write sources
+            std::vector<std::string> paths;
+            for (size_t i = 0; i < sources.size(); i++)
+            {
+                std::string path = options.directory + "/" + workload;
+                if (sources.size() > 1) path += "_" + std::to_string(i);
+                path += ".ptf";
+                std::ofstream(path) << sources[i];
+                paths.push_back(std::move(path));
+            }
+
+            // Parse
+            std::vector<intermediate> parsed(paths.size());
+            measure(workload, "parse", [&]()
+            {
+                return time([&]()
+                {
+                    for (size_t i = 0; i < paths.size(); i++) parsed[i] = parser<language_propane>::parse(paths[i].c_str());
+                });
+            });
+
+            // Merge
+            intermediate merged = parsed[0];
+            if (parsed.size() > 1)
+            {
+                measure(workload, "merge_pairwise", [&]()
+                {
+                    return time([&]()
+                    {
+                        merged = parsed[0];
+                        for (size_t i = 1; i < parsed.size(); i++) merged += parsed[i];
+                    });
+                });
+                measure(workload, "merge_builder", [&]()
+                {
+                    return time([&]()
+                    {
+                        intermediate_builder builder;
+                        for (const auto& im : parsed) builder += im;
+                        merged = builder.finalize();
+                    });
+                });
+                measure(workload, "merge_batch", [&]()
+                {
+                    return time([&]() { merged = merge_all(span<const intermediate>(parsed.data(), parsed.size())); });
+                });
+            }
+
+            // Link
+            assembly linked;
+            measure(workload, "link", [&]()
+            {
+                return time([&]() { linked = assembly(merged, rt); });
+            });
+
+            // Execute
+            measure(workload, "execute", [&]()
+            {
+                return time([&]() { rt.execute(linked, parameters); });
+            });
+
+            // Translate
+            const std::string translated = options.directory + "/" + workload + ".c";
+            measure(workload, "translate_c", [&]()
+            {
+                return time([&]() { translator<language_c>::generate(translated.c_str(), linked); });
+            });
+        }
+
+        const benchmark_options& options;
+        library native_library;
+        environment env;
+        runtime rt;
+        runtime_parameters parameters;
+        std::vector<benchmark_result> results;
+    };
+}
+
+int32_t main(int32_t argc, char** argv)
+{
+    benchmark_options options;
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "-iterations") == 0)
+        {
+            options.iterations = std::max(size_t(1), static_cast<size_t>(strtoull(argv[++i], nullptr, 10)));
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-scale") == 0)
+        {
+            options.scale = strtod(argv[++i], nullptr);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-filter") == 0)
+        {
+            options.filter = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-dir") == 0)
+        {
+            options.directory = argv[++i];
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-out") == 0)
+        {
+            options.output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [-iterations <count>] [-scale <factor>] [-filter <workload>] [-dir <directory>] [-out <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        benchmark_suite suite(options);
+        suite.run();
+
+        if (options.output.empty())
+        {
+            suite.write(std::cout);
+        }
+        else
+        {
+            std::ofstream file(options.output);
+            suite.write(file);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+// Opcode pair frequency miner
+// Counts consecutive opcode pairs in the resolved bytecode of a corpus of assemblies,
+// which can be used to tune the set of superinstructions fused by the interpreter.
+//
+// Usage: opcode_pairs [-top <count>] <file>...
+// Files with a .ptf extension are parsed and linked, anything else is loaded as a binary assembly.
+//
+// Requires both the public (source/include) and internal (source/src) include paths.
+
+#include "propane_parser.hpp"
+#include "propane_assembly.hpp"
+#include "assembly_data.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    using namespace propane;
+
+    struct pair_counter
+    {
+        size_t pairs[opcode_count][opcode_count] = {};
+        size_t singles[opcode_count] = {};
+        size_t pair_total = 0;
+        size_t single_total = 0;
+
+        void count_method(const assembly_data& data, const method& m)
+        {
+            const uint8_t* iptr = m.bytecode.data();
+            const uint8_t* const iend = iptr + m.bytecode.size();
+
+            size_t prev = opcode_count;
+            while (iptr < iend)
+            {
+                const size_t op = static_cast<size_t>(*iptr);
+                if (op >= opcode_count) return;
+
+                singles[op]++;
+                single_total++;
+                if (prev != opcode_count)
+                {
+                    pairs[prev][op]++;
+                    pair_total++;
+                }
+                prev = op;
+
+                skip_instruction(data, iptr);
+            }
+        }
+
+        static void skip_address(const assembly_data& data, const uint8_t*& iptr)
+        {
+            uint64_t constant_buffer;
+            const uint8_t* constant = nullptr;
+            read_address_data(iptr, data.encoding, constant_buffer, constant);
+        }
+        static void skip_arguments(const assembly_data& data, const uint8_t*& iptr)
+        {
+            const size_t arg_count = read_bytecode<uint8_t>(iptr);
+            for (size_t i = 0; i < arg_count; i++)
+            {
+                read_bytecode<subcode>(iptr);
+                skip_address(data, iptr);
+            }
+        }
+        static void skip_instruction(const assembly_data& data, const uint8_t*& iptr)
+        {
+            const opcode op = read_bytecode<opcode>(iptr);
+            switch (op)
+            {
+                case opcode::noop:
+                case opcode::ret:
+                    break;
+
+                case opcode::dump:
+                    skip_address(data, iptr);
+                    break;
+
+                case opcode::pdif:
+                    skip_address(data, iptr);
+                    skip_address(data, iptr);
+                    break;
+
+                case opcode::ari_not:
+                case opcode::ari_neg:
+                case opcode::cze:
+                case opcode::cnz:
+                case opcode::retv:
+                    read_bytecode<subcode>(iptr);
+                    skip_address(data, iptr);
+                    break;
+
+                case opcode::br:
+                    read_bytecode<uint32_t>(iptr);
+                    break;
+
+                case opcode::bze:
+                case opcode::bnz:
+                    read_bytecode<uint32_t>(iptr);
+                    read_bytecode<subcode>(iptr);
+                    skip_address(data, iptr);
+                    break;
+
+                case opcode::beq:
+                case opcode::bne:
+                case opcode::bgt:
+                case opcode::bge:
+                case opcode::blt:
+                case opcode::ble:
+                    read_bytecode<uint32_t>(iptr);
+                    read_bytecode<subcode>(iptr);
+                    skip_address(data, iptr);
+                    skip_address(data, iptr);
+                    break;
+
+                case opcode::sw:
+                    skip_address(data, iptr);
+                    iptr += sizeof(uint32_t) * read_bytecode<uint32_t>(iptr);
+                    break;
+
+                case opcode::sws:
+                    skip_address(data, iptr);
+                    iptr += (sizeof(uint64_t) + sizeof(uint32_t)) * read_bytecode<uint32_t>(iptr);
+                    break;
+
+                case opcode::call:
+                    read_bytecode<method_idx>(iptr);
+                    skip_arguments(data, iptr);
+                    break;
+
+                case opcode::callv:
+                    skip_address(data, iptr);
+                    skip_arguments(data, iptr);
+                    break;
+
+                case opcode::mcpy:
+                case opcode::mset:
+                case opcode::mcmp:
+                    read_bytecode<subcode>(iptr);
+                    skip_address(data, iptr);
+                    skip_address(data, iptr);
+                    skip_address(data, iptr);
+                    break;
+
+                // Binary operations (set, conversion, arithmetic, pointer, comparison and vector)
+                default:
+                    read_bytecode<subcode>(iptr);
+                    skip_address(data, iptr);
+                    skip_address(data, iptr);
+                    break;
+            }
+        }
+    };
+
+    bool ends_with(const char* str, const char* suffix)
+    {
+        const size_t len = strlen(str), suffix_len = strlen(suffix);
+        return len >= suffix_len && strcmp(str + len - suffix_len, suffix) == 0;
+    }
+
+    double percentage(size_t count, size_t total)
+    {
+        return total == 0 ? 0.0 : (static_cast<double>(count) * 100.0) / static_cast<double>(total);
+    }
+}
+
+int32_t main(int32_t argc, char** argv)
+{
+    size_t top = 32;
+    std::vector<const char*> files;
+    for (int32_t i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-top") == 0 && i + 1 < argc)
+        {
+            top = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [-top <count>] <file>..." << std::endl;
+        return 1;
+    }
+
+    pair_counter* const counter = new pair_counter();
+    size_t method_count = 0;
+    for (const char* file : files)
+    {
+        try
+        {
+            propane::assembly linked;
+            if (ends_with(file, ".ptf"))
+            {
+                const propane::intermediate im = propane::parser<propane::language_propane>::parse(file);
+                linked = propane::assembly(im);
+            }
+            else if (!linked.load_mapped(file))
+            {
+                std::cerr << "Failed to load assembly: " << file << std::endl;
+                continue;
+            }
+
+            const assembly_data& data = linked.assembly_ref();
+            for (const auto& m : data.methods)
+            {
+                if (m.is_external()) continue;
+
+                counter->count_method(data, m);
+                method_count++;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << file << ": " << e.what() << std::endl;
+        }
+    }
+
+    struct pair_entry
+    {
+        size_t count;
+        opcode first;
+        opcode second;
+    };
+    std::vector<pair_entry> entries;
+    for (size_t i = 0; i < opcode_count; i++)
+    {
+        for (size_t j = 0; j < opcode_count; j++)
+        {
+            if (counter->pairs[i][j] != 0) entries.push_back({ counter->pairs[i][j], opcode(i), opcode(j) });
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const pair_entry& lhs, const pair_entry& rhs)
+    {
+        return lhs.count > rhs.count;
+    });
+
+    std::cout << method_count << " methods, " << counter->single_total << " instructions, " << counter->pair_total << " pairs" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < entries.size() && i < top; i++)
+    {
+        const auto& entry = entries[i];
+        const std::string name = std::string(opcode_str(entry.first)) + " " + std::string(opcode_str(entry.second));
+        std::cout << std::left << std::setw(16) << name << std::right << std::setw(12) << entry.count
+            << std::setw(8) << percentage(entry.count, counter->pair_total) << "%"
+            << std::setw(8) << percentage(entry.count, counter->singles[static_cast<size_t>(entry.first)]) << "% of " << opcode_str(entry.first) << std::endl;
+    }
+
+    delete counter;
+    return 0;
+}
\ No newline at end of file